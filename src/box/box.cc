@@ -508,6 +508,29 @@ box_check_readahead(int readahead)
 	}
 }
 
+static int
+box_check_iproto_threads(void)
+{
+	int threads = cfg_geti("iproto_threads");
+	if (threads < 1 || threads > IPROTO_THREADS_MAX) {
+		tnt_raise(ClientError, ER_CFG, "iproto_threads",
+			  tt_sprintf("must be in range [1, %d]",
+				     IPROTO_THREADS_MAX));
+	}
+	return threads;
+}
+
+static double
+box_check_iproto_rate_limit(void)
+{
+	double limit = cfg_getd("iproto_rate_limit");
+	if (limit < 0) {
+		tnt_raise(ClientError, ER_CFG, "iproto_rate_limit",
+			  "must not be less than 0");
+	}
+	return limit;
+}
+
 static void
 box_check_checkpoint_count(int checkpoint_count)
 {
@@ -559,6 +582,16 @@ box_check_vinyl_memory(int64_t memory)
 	return memory;
 }
 
+static double
+box_check_vinyl_scrub_rate(double rate)
+{
+	if (rate < 0) {
+		tnt_raise(ClientError, ER_CFG, "vinyl_scrub_rate",
+			  "must not be less than 0");
+	}
+	return rate;
+}
+
 static void
 box_check_vinyl_options(void)
 {
@@ -571,6 +604,7 @@ box_check_vinyl_options(void)
 	double bloom_fpr = cfg_getd("vinyl_bloom_fpr");
 
 	box_check_vinyl_memory(cfg_geti64("vinyl_memory"));
+	box_check_vinyl_scrub_rate(cfg_getd("vinyl_scrub_rate"));
 
 	if (read_threads < 1) {
 		tnt_raise(ClientError, ER_CFG, "vinyl_read_threads",
@@ -617,6 +651,8 @@ box_check_config()
 	box_check_replication_connect_quorum();
 	box_check_replication_sync_lag();
 	box_check_readahead(cfg_geti("readahead"));
+	box_check_iproto_threads();
+	box_check_iproto_rate_limit();
 	box_check_checkpoint_count(cfg_geti("checkpoint_count"));
 	box_check_wal_max_rows(cfg_geti64("rows_per_wal"));
 	box_check_wal_max_size(cfg_geti64("wal_max_size"));
@@ -855,14 +891,38 @@ box_set_vinyl_timeout(void)
 	vinyl_engine_set_timeout(vinyl,	cfg_getd("vinyl_timeout"));
 }
 
+void
+box_set_vinyl_scrub_rate(void)
+{
+	struct vinyl_engine *vinyl;
+	vinyl = (struct vinyl_engine *)engine_by_name("vinyl");
+	assert(vinyl != NULL);
+	vinyl_engine_set_scrub_rate(vinyl,
+		box_check_vinyl_scrub_rate(cfg_getd("vinyl_scrub_rate")));
+}
+
 void
 box_set_net_msg_max(void)
 {
 	int new_iproto_msg_max = cfg_geti("net_msg_max");
 	iproto_set_msg_max(new_iproto_msg_max);
+	/* The limit is applied to each network thread. */
 	fiber_pool_set_max_size(&tx_fiber_pool,
 				new_iproto_msg_max *
-				IPROTO_FIBER_POOL_SIZE_FACTOR);
+				IPROTO_FIBER_POOL_SIZE_FACTOR *
+				cfg_geti("iproto_threads"));
+}
+
+void
+box_set_iproto_batch_dml(void)
+{
+	iproto_set_batch_dml(cfg_getb("iproto_batch_dml"));
+}
+
+void
+box_set_iproto_rate_limit(void)
+{
+	iproto_set_rate_limit(box_check_iproto_rate_limit());
 }
 
 /* }}} configuration bindings */
@@ -1008,8 +1068,20 @@ box_select(uint32_t space_id, uint32_t index_id,
 	   int iterator, uint32_t offset, uint32_t limit,
 	   const char *key, const char *key_end,
 	   struct port *port)
+{
+	return box_select_chunked(space_id, index_id, iterator, offset, limit,
+				  key, key_end, 0, NULL, NULL, port);
+}
+
+int
+box_select_chunked(uint32_t space_id, uint32_t index_id,
+		   int iterator, uint32_t offset, uint32_t limit,
+		   const char *key, const char *key_end,
+		   uint32_t chunk_size, box_select_chunk_cb cb, void *cb_arg,
+		   struct port *port)
 {
 	(void)key_end;
+	assert(chunk_size == 0 || cb != NULL);
 
 	rmean_collect(rmean_box, IPROTO_SELECT, 1);
 
@@ -1066,6 +1138,13 @@ box_select(uint32_t space_id, uint32_t index_id,
 		if (rc != 0)
 			break;
 		found++;
+		if (chunk_size != 0 && port_tuple(port)->size == chunk_size) {
+			rc = cb(port, cb_arg);
+			port_destroy(port);
+			port_tuple_create(port);
+			if (rc != 0)
+				break;
+		}
 	}
 	iterator_delete(it);
 
@@ -1675,6 +1754,7 @@ engine_init()
 	box_set_vinyl_max_tuple_size();
 	box_set_vinyl_cache();
 	box_set_vinyl_timeout();
+	box_set_vinyl_scrub_rate();
 }
 
 /**
@@ -1999,7 +2079,7 @@ box_cfg_xc(void)
 	schema_init();
 	replication_init();
 	port_init();
-	iproto_init();
+	iproto_init(box_check_iproto_threads());
 	sql_init();
 	wal_thread_start();
 
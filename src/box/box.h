@@ -141,6 +141,21 @@ box_backup_start(int checkpoint_idx, box_backup_cb cb, void *cb_arg);
 void
 box_backup_stop(void);
 
+typedef int (*box_select_chunk_cb)(struct port *port, void *arg);
+
+/**
+ * Same as box_select(), but instead of accumulating all selected
+ * tuples in @port, call @cb for each @chunk_size of them. @port
+ * gets the last, incomplete, chunk. @cb may yield. If it fails,
+ * the select stops and fails too.
+ */
+int
+box_select_chunked(uint32_t space_id, uint32_t index_id,
+		   int iterator, uint32_t offset, uint32_t limit,
+		   const char *key, const char *key_end,
+		   uint32_t chunk_size, box_select_chunk_cb cb, void *cb_arg,
+		   struct port *port);
+
 /**
  * Spit out some basic module status (master/slave, etc.
  */
@@ -189,11 +204,14 @@ void box_set_vinyl_memory(void);
 void box_set_vinyl_max_tuple_size(void);
 void box_set_vinyl_cache(void);
 void box_set_vinyl_timeout(void);
+void box_set_vinyl_scrub_rate(void);
 void box_set_replication_timeout(void);
 void box_set_replication_connect_timeout(void);
 void box_set_replication_connect_quorum(void);
 void box_set_replication_skip_conflict(void);
 void box_set_net_msg_max(void);
+void box_set_iproto_batch_dml(void);
+void box_set_iproto_rate_limit(void);
 
 extern "C" {
 #endif /* defined(__cplusplus) */
@@ -219,6 +219,9 @@ struct errcode_record {
 	/*164 */_(ER_NO_SUCH_GROUP,		"Replication group '%s' does not exist") \
 	/*165 */_(ER_NO_SUCH_MODULE,		"Module '%s' does not exist") \
 	/*166 */_(ER_NO_SUCH_COLLATION,		"Collation '%s' does not exist") \
+	/*167 */_(ER_SQL_NO_SUCH_STATEMENT,	"Prepared statement %u does not exist") \
+	/*168 */_(ER_SQL_STMT_LIMIT,		"Session can't have more than %u prepared statements") \
+	/*169 */_(ER_TOO_MANY_STREAMS,		"Too many streams, the limit is %d") \
 
 /*
  * !IMPORTANT! Please follow instructions at start of the file
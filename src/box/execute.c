@@ -42,6 +42,8 @@
 #include "schema.h"
 #include "port.h"
 #include "tuple.h"
+#include "session.h"
+#include "assoc.h"
 
 const char *sql_type_strs[] = {
 	NULL,
@@ -266,12 +268,15 @@ error:
 
 	uint32_t map_size = mp_decode_map(&data);
 	request->sql_text = NULL;
+	request->stmt_id = 0;
 	request->bind = NULL;
 	request->bind_count = 0;
 	request->sync = row->sync;
+	bool has_stmt_id = false;
 	for (uint32_t i = 0; i < map_size; ++i) {
 		uint8_t key = *data;
-		if (key != IPROTO_SQL_BIND && key != IPROTO_SQL_TEXT) {
+		if (key != IPROTO_SQL_BIND && key != IPROTO_SQL_TEXT &&
+		    key != IPROTO_STMT_ID) {
 			mp_check(&data, end);   /* skip the key */
 			mp_check(&data, end);   /* skip the value */
 			continue;
@@ -282,11 +287,24 @@ error:
 		if (key == IPROTO_SQL_BIND) {
 			if (sql_bind_list_decode(request, value, region) != 0)
 				return -1;
+		} else if (key == IPROTO_STMT_ID) {
+			if (mp_typeof(*value) != MP_UINT)
+				goto error;
+			uint64_t stmt_id = mp_decode_uint(&value);
+			if (stmt_id > UINT32_MAX)
+				goto error;
+			request->stmt_id = stmt_id;
+			has_stmt_id = true;
 		} else {
 			request->sql_text = value;
 		}
 	}
-	if (request->sql_text == NULL) {
+	/*
+	 * EXECUTE takes either a statement text or an id of
+	 * a prepared statement. PREPARE with an id instead of
+	 * a text unprepares the statement.
+	 */
+	if (request->sql_text == NULL && !has_stmt_id) {
 		diag_set(ClientError, ER_MISSING_REQUEST_FIELD,
 			 iproto_key_name(IPROTO_SQL_TEXT));
 		return -1;
@@ -575,35 +593,253 @@ sql_execute(sqlite3 *db, struct sqlite3_stmt *stmt, struct port *port,
 	return 0;
 }
 
+/**
+ * Find a statement prepared in the current session.
+ * @param stmt_id Statement id.
+ *
+ * @retval NULL Statement is not found.
+ * @retval not NULL Prepared statement.
+ */
+static inline struct sqlite3_stmt *
+sql_stmt_cache_find(uint32_t stmt_id)
+{
+	struct mh_i32ptr_t *stmts = current_session()->sql_stmts;
+	if (stmts == NULL)
+		return NULL;
+	mh_int_t k = mh_i32ptr_find(stmts, stmt_id, NULL);
+	if (k == mh_end(stmts))
+		return NULL;
+	return (struct sqlite3_stmt *) mh_i32ptr_node(stmts, k)->val;
+}
+
+/**
+ * Get a statement prepared in the current session to execute
+ * it. A statement compiled against an old schema version is
+ * recompiled in place. A VDBE can run only one program at a
+ * time, so if the cached statement is being executed by
+ * another request of the same session, a private copy is
+ * compiled for this request.
+ * @param db SQL handle.
+ * @param stmt_id Statement id.
+ * @param[out] stmt Statement to execute.
+ * @param[out] is_cached True if @a stmt is owned by the cache.
+ *
+ * @retval  0 Success.
+ * @retval -1 Client or memory error.
+ */
+static int
+sql_stmt_cache_get(sqlite3 *db, uint32_t stmt_id,
+		   struct sqlite3_stmt **stmt, bool *is_cached)
+{
+	struct sqlite3_stmt *cached = sql_stmt_cache_find(stmt_id);
+	if (cached == NULL) {
+		diag_set(ClientError, ER_SQL_NO_SUCH_STATEMENT, stmt_id);
+		return -1;
+	}
+	if (sqlite3_stmt_busy(cached)) {
+		if (sqlite3_prepare_v2(db, sqlite3_sql(cached), -1, stmt,
+				       NULL) != SQLITE_OK)
+			goto error;
+		*is_cached = false;
+		return 0;
+	}
+	if (sql_stmt_schema_version(cached) != schema_version &&
+	    sqlite3Reprepare((Vdbe *) cached) != SQLITE_OK)
+		goto error;
+	*stmt = cached;
+	*is_cached = true;
+	return 0;
+error:
+	diag_set(ClientError, ER_SQL_EXECUTE, sqlite3_errmsg(db));
+	return -1;
+}
+
+/**
+ * Release a statement after execution. A cached statement is
+ * reset to be executed again, a one-off one is finalized.
+ * A cached statement unprepared while it was running is
+ * finalized too.
+ * @param stmt Statement to release.
+ * @param is_cached True if @a stmt was taken from the cache.
+ * @param stmt_id Id of @a stmt in the cache, if cached.
+ */
+static inline void
+sql_stmt_release(struct sqlite3_stmt *stmt, bool is_cached,
+		 uint32_t stmt_id)
+{
+	if (is_cached && sql_stmt_cache_find(stmt_id) == stmt) {
+		sqlite3_reset(stmt);
+		/*
+		 * Bound strings and blobs point into the request
+		 * packet, which is freed after the response is
+		 * sent.
+		 */
+		sqlite3_clear_bindings(stmt);
+	} else {
+		sqlite3_finalize(stmt);
+	}
+}
+
 int
 sql_prepare_and_execute(const struct sql_request *request,
 			struct sql_response *response, struct region *region)
 {
-	const char *sql = request->sql_text;
-	uint32_t len;
-	sql = mp_decode_str(&sql, &len);
 	struct sqlite3_stmt *stmt;
+	bool is_cached = false;
 	sqlite3 *db = sql_get();
 	if (db == NULL) {
 		diag_set(ClientError, ER_LOADING);
 		return -1;
 	}
-	if (sqlite3_prepare_v2(db, sql, len, &stmt, NULL) != SQLITE_OK) {
-		diag_set(ClientError, ER_SQL_EXECUTE, sqlite3_errmsg(db));
+	if (request->sql_text != NULL) {
+		const char *sql = request->sql_text;
+		uint32_t len;
+		sql = mp_decode_str(&sql, &len);
+		if (sqlite3_prepare_v2(db, sql, len, &stmt, NULL) !=
+		    SQLITE_OK) {
+			diag_set(ClientError, ER_SQL_EXECUTE,
+				 sqlite3_errmsg(db));
+			return -1;
+		}
+	} else if (sql_stmt_cache_get(db, request->stmt_id, &stmt,
+				      &is_cached) != 0) {
 		return -1;
 	}
 	assert(stmt != NULL);
 	port_tuple_create(&response->port);
 	response->prep_stmt = stmt;
+	response->is_cached = is_cached;
+	response->stmt_id = request->stmt_id;
 	response->sync = request->sync;
 	if (sql_bind(request, stmt) == 0 &&
 	    sql_execute(db, stmt, &response->port, region) == 0)
 		return 0;
 	port_destroy(&response->port);
-	sqlite3_finalize(stmt);
+	sql_stmt_release(stmt, is_cached, request->stmt_id);
 	return -1;
 }
 
+int
+sql_prepare(const struct sql_request *request, uint32_t *stmt_id)
+{
+	assert(request->sql_text != NULL);
+	const char *sql = request->sql_text;
+	uint32_t len;
+	sql = mp_decode_str(&sql, &len);
+	sqlite3 *db = sql_get();
+	if (db == NULL) {
+		diag_set(ClientError, ER_LOADING);
+		return -1;
+	}
+	struct session *session = current_session();
+	if (session->sql_stmts == NULL) {
+		session->sql_stmts = mh_i32ptr_new();
+		if (session->sql_stmts == NULL) {
+			diag_set(OutOfMemory, sizeof(*session->sql_stmts),
+				 "mh_i32ptr_new", "sql_stmts");
+			return -1;
+		}
+	}
+	struct mh_i32ptr_t *stmts = session->sql_stmts;
+	struct sqlite3_stmt *stmt;
+	if (sqlite3_prepare_v2(db, sql, len, &stmt, NULL) != SQLITE_OK) {
+		diag_set(ClientError, ER_SQL_EXECUTE, sqlite3_errmsg(db));
+		return -1;
+	}
+	assert(stmt != NULL);
+	/*
+	 * The id is a hash of the compiled statement text. On
+	 * a collision the next free id is taken, so the same
+	 * statement usually, but not necessarily, gets the same
+	 * id in all sessions.
+	 */
+	const char *text = sqlite3_sql(stmt);
+	uint32_t id = mh_strn_hash(text, strlen(text));
+	mh_int_t k;
+	while ((k = mh_i32ptr_find(stmts, id, NULL)) != mh_end(stmts)) {
+		struct sqlite3_stmt *old =
+			(struct sqlite3_stmt *) mh_i32ptr_node(stmts, k)->val;
+		if (strcmp(sqlite3_sql(old), text) == 0) {
+			/* The statement is already prepared. */
+			sqlite3_finalize(stmt);
+			*stmt_id = id;
+			return 0;
+		}
+		++id;
+	}
+	if (mh_size(stmts) >= SQL_SESSION_STMT_MAX) {
+		sqlite3_finalize(stmt);
+		diag_set(ClientError, ER_SQL_STMT_LIMIT,
+			 SQL_SESSION_STMT_MAX);
+		return -1;
+	}
+	struct mh_i32ptr_node_t node = { id, stmt };
+	if (mh_i32ptr_put(stmts, &node, NULL, NULL) == mh_end(stmts)) {
+		sqlite3_finalize(stmt);
+		diag_set(OutOfMemory, 0, "mh_i32ptr_put", "sql_stmts");
+		return -1;
+	}
+	*stmt_id = id;
+	return 0;
+}
+
+int
+sql_unprepare(uint32_t stmt_id)
+{
+	struct sqlite3_stmt *stmt = sql_stmt_cache_find(stmt_id);
+	if (stmt == NULL) {
+		diag_set(ClientError, ER_SQL_NO_SUCH_STATEMENT, stmt_id);
+		return -1;
+	}
+	struct mh_i32ptr_t *stmts = current_session()->sql_stmts;
+	mh_int_t k = mh_i32ptr_find(stmts, stmt_id, NULL);
+	assert(k != mh_end(stmts));
+	mh_i32ptr_del(stmts, k, NULL);
+	/*
+	 * A running statement is finalized by the request
+	 * executing it, see sql_stmt_release().
+	 */
+	if (!sqlite3_stmt_busy(stmt))
+		sqlite3_finalize(stmt);
+	return 0;
+}
+
+void
+sql_session_stmts_free(struct session *session)
+{
+	struct mh_i32ptr_t *stmts = session->sql_stmts;
+	if (stmts == NULL)
+		return;
+	mh_int_t k;
+	mh_foreach(stmts, k) {
+		struct sqlite3_stmt *stmt =
+			(struct sqlite3_stmt *) mh_i32ptr_node(stmts, k)->val;
+		sqlite3_finalize(stmt);
+	}
+	mh_i32ptr_delete(stmts);
+	session->sql_stmts = NULL;
+}
+
+int
+sql_prepare_response_dump(uint64_t sync, uint32_t stmt_id,
+			  struct obuf *out)
+{
+	struct obuf_svp header_svp;
+	if (iproto_prepare_header(out, &header_svp, IPROTO_SQL_HEADER_LEN) != 0)
+		return -1;
+	size_t size = mp_sizeof_uint(IPROTO_STMT_ID) + mp_sizeof_uint(stmt_id);
+	char *pos = (char *) obuf_alloc(out, size);
+	if (pos == NULL) {
+		obuf_rollback_to_svp(out, &header_svp);
+		diag_set(OutOfMemory, size, "obuf_alloc", "pos");
+		return -1;
+	}
+	pos = mp_encode_uint(pos, IPROTO_STMT_ID);
+	pos = mp_encode_uint(pos, stmt_id);
+	iproto_reply_sql(out, &header_svp, sync, schema_version, 1);
+	return 0;
+}
+
 int
 sql_response_dump(struct sql_response *response, struct obuf *out)
 {
@@ -654,6 +890,6 @@ err:
 			 keys);
 finish:
 	port_destroy(&response->port);
-	sqlite3_finalize(stmt);
+	sql_stmt_release(stmt, response->is_cached, response->stmt_id);
 	return rc;
 }
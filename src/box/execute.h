@@ -47,16 +47,28 @@ enum sql_info_key {
 
 extern const char *sql_info_key_strs[];
 
+enum {
+	/** Max number of statements prepared in a session. */
+	SQL_SESSION_STMT_MAX = 1024,
+};
+
 struct obuf;
 struct region;
+struct session;
 struct sql_bind;
 struct xrow_header;
 
-/** EXECUTE request. */
+/** EXECUTE or PREPARE request. */
 struct sql_request {
 	uint64_t sync;
-	/** SQL statement text. */
+	/**
+	 * SQL statement text. NULL if EXECUTE refers to a
+	 * statement prepared beforehand by its @stmt_id, or
+	 * if PREPARE unprepares it.
+	 */
 	const char *sql_text;
+	/** Id of a prepared statement, if @sql_text is NULL. */
+	uint32_t stmt_id;
 	/** Array of parameters. */
 	struct sql_bind *bind;
 	/** Length of the @bind. */
@@ -71,6 +83,14 @@ struct sql_response {
 	struct port port;
 	/** Prepared SQL statement with metadata. */
 	void *prep_stmt;
+	/**
+	 * True if @prep_stmt is owned by the session statement
+	 * cache: it is reset instead of being finalized once the
+	 * response is dumped.
+	 */
+	bool is_cached;
+	/** Id of @prep_stmt in the cache, if @is_cached. */
+	uint32_t stmt_id;
 };
 
 /**
@@ -110,7 +130,28 @@ int
 sql_response_dump(struct sql_response *response, struct obuf *out);
 
 /**
- * Parse the EXECUTE request.
+ * Dump a response on PREPARE request into @an out buffer.
+ * Response structure:
+ * +----------------------------------------------+
+ * | IPROTO_OK, sync, schema_version   ...        | iproto_header
+ * +----------------------------------------------+---------------
+ * | IPROTO_BODY: {                               |
+ * |     IPROTO_STMT_ID: number                   | iproto_body
+ * | }                                            |
+ * +----------------------------------------------+
+ * @param sync Request sync.
+ * @param stmt_id Id of the prepared statement.
+ * @param out Output buffer.
+ *
+ * @retval  0 Success.
+ * @retval -1 Memory error.
+ */
+int
+sql_prepare_response_dump(uint64_t sync, uint32_t stmt_id,
+			  struct obuf *out);
+
+/**
+ * Parse the EXECUTE or PREPARE request.
  * @param row Encoded data.
  * @param[out] request Request to decode to.
  * @param region Allocator.
@@ -123,7 +164,9 @@ xrow_decode_sql(const struct xrow_header *row, struct sql_request *request,
 		struct region *region);
 
 /**
- * Prepare and execute an SQL statement.
+ * Prepare and execute an SQL statement. If the request refers
+ * to a statement by id, the statement is taken from the
+ * statement cache of the current session instead.
  * @param request IProto request.
  * @param[out] response Response to store result.
  * @param region Runtime allocator for temporary objects
@@ -136,6 +179,46 @@ int
 sql_prepare_and_execute(const struct sql_request *request,
 			struct sql_response *response, struct region *region);
 
+/**
+ * Compile an SQL statement and store it in the statement cache
+ * of the current session, so that it can be executed by id
+ * without being parsed again. Preparing the same text twice
+ * in a session returns the same id. The id is derived from
+ * the statement text, but since hash collisions are resolved
+ * in the order of preparation, the same text may get
+ * different ids in different sessions. A cached statement is
+ * recompiled transparently on its next execution if the
+ * schema has changed since it was prepared. A session may
+ * have at most SQL_SESSION_STMT_MAX prepared statements.
+ * @param request PREPARE request.
+ * @param[out] stmt_id Id of the prepared statement.
+ *
+ * @retval  0 Success.
+ * @retval -1 Client or memory error.
+ */
+int
+sql_prepare(const struct sql_request *request, uint32_t *stmt_id);
+
+/**
+ * Remove a statement from the statement cache of the current
+ * session and finalize it. If the statement is being executed,
+ * it is finalized once the execution is over.
+ * @param stmt_id Id of the prepared statement.
+ *
+ * @retval  0 Success.
+ * @retval -1 The statement is not found.
+ */
+int
+sql_unprepare(uint32_t stmt_id);
+
+/**
+ * Finalize all statements prepared in a session and free
+ * the session statement cache. Called on session destroy.
+ * @param session Session to cleanup.
+ */
+void
+sql_session_stmts_free(struct session *session);
+
 #if defined(__cplusplus)
 } /* extern "C" { */
 #include "diag.h"
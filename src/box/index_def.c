@@ -45,6 +45,11 @@ const struct index_opts index_opts_default = {
 	/* .run_count_per_level = */ 2,
 	/* .run_size_ratio      = */ 3.5,
 	/* .bloom_fpr           = */ 0.05,
+	/* .is_covering         = */ false,
+	/* .prefix_compression  = */ false,
+	/* .upsert_threshold    = */ 128,
+	/* .cache_reserve       = */ 0,
+	/* .cache_limit         = */ 0,
 	/* .lsn                 = */ 0,
 	/* .sql                 = */ NULL,
 	/* .stat                = */ NULL,
@@ -60,6 +65,13 @@ const struct opt_def index_opts_reg[] = {
 	OPT_DEF("run_count_per_level", OPT_INT64, struct index_opts, run_count_per_level),
 	OPT_DEF("run_size_ratio", OPT_FLOAT, struct index_opts, run_size_ratio),
 	OPT_DEF("bloom_fpr", OPT_FLOAT, struct index_opts, bloom_fpr),
+	OPT_DEF("covering", OPT_BOOL, struct index_opts, is_covering),
+	OPT_DEF("prefix_compression", OPT_BOOL, struct index_opts,
+		prefix_compression),
+	OPT_DEF("upsert_threshold", OPT_INT64, struct index_opts,
+		upsert_threshold),
+	OPT_DEF("cache_reserve", OPT_INT64, struct index_opts, cache_reserve),
+	OPT_DEF("cache_limit", OPT_INT64, struct index_opts, cache_limit),
 	OPT_DEF("lsn", OPT_INT64, struct index_opts, lsn),
 	OPT_DEF("sql", OPT_STRPTR, struct index_opts, sql),
 	OPT_END,
@@ -153,6 +153,34 @@ struct index_opts {
 	double run_size_ratio;
 	/* Bloom filter false positive rate. */
 	double bloom_fpr;
+	/**
+	 * Vinyl only: a secondary index stores full tuples so
+	 * that reads don't need to look up the primary index.
+	 */
+	bool is_covering;
+	/**
+	 * Vinyl only: store statements in run pages with common
+	 * prefixes of adjacent statements elided.
+	 */
+	bool prefix_compression;
+	/**
+	 * Vinyl only: number of successive UPSERTs for the same
+	 * key in memory after which the chain is squashed in
+	 * background.
+	 */
+	int64_t upsert_threshold;
+	/**
+	 * Vinyl only: amount of memory reserved for the index
+	 * in the tuple cache. Entries of the index are evicted
+	 * only after entries of other indexes until the index
+	 * uses that much memory in the cache.
+	 */
+	int64_t cache_reserve;
+	/**
+	 * Vinyl only: max amount of memory the index may use
+	 * in the tuple cache, 0 means unlimited.
+	 */
+	int64_t cache_limit;
 	/**
 	 * LSN from the time of index creation.
 	 */
@@ -212,6 +240,17 @@ index_opts_cmp(const struct index_opts *o1, const struct index_opts *o2)
 		return o1->run_size_ratio < o2->run_size_ratio ? -1 : 1;
 	if (o1->bloom_fpr != o2->bloom_fpr)
 		return o1->bloom_fpr < o2->bloom_fpr ? -1 : 1;
+	if (o1->is_covering != o2->is_covering)
+		return o1->is_covering < o2->is_covering ? -1 : 1;
+	if (o1->prefix_compression != o2->prefix_compression)
+		return o1->prefix_compression < o2->prefix_compression ?
+		       -1 : 1;
+	if (o1->upsert_threshold != o2->upsert_threshold)
+		return o1->upsert_threshold < o2->upsert_threshold ? -1 : 1;
+	if (o1->cache_reserve != o2->cache_reserve)
+		return o1->cache_reserve < o2->cache_reserve ? -1 : 1;
+	if (o1->cache_limit != o2->cache_limit)
+		return o1->cache_limit < o2->cache_limit ? -1 : 1;
 	return 0;
 }
 
@@ -36,10 +36,13 @@
 #include <msgpuck.h>
 #include <small/ibuf.h>
 #include <small/obuf.h>
+#define ZSTD_STATIC_LINKING_ONLY
+#include <zstd.h>
 #include "third_party/base64.h"
 
 #include "version.h"
 #include "fiber.h"
+#include "fiber_cond.h"
 #include "cbus.h"
 #include "say.h"
 #include "sio.h"
@@ -48,25 +51,167 @@
 #include "scoped_guard.h"
 #include "memory.h"
 #include "random.h"
+#include "assoc.h"
 
 #include "port.h"
+#include "tuple.h"
 #include "box.h"
 #include "call.h"
 #include "tuple_convert.h"
 #include "session.h"
 #include "xrow.h"
-#include "schema.h" /* schema_version */
+#include "schema.h" /* schema_version, space_by_id */
+#include "space.h"
 #include "replication.h" /* instance_uuid */
 #include "iproto_constants.h"
 #include "rmean.h"
 #include "execute.h"
+#include "txn.h"
 #include "errinj.h"
 
 enum {
 	IPROTO_SALT_SIZE = 32,
 	IPROTO_PACKET_SIZE_MAX = 2UL * 1024 * 1024 * 1024,
+	/**
+	 * Tuples of a SELECT result which are at least this big
+	 * are not copied to the output buffer, but are sent
+	 * right from the tuple memory. For smaller tuples a copy
+	 * is cheaper than a reference and an extra iovec.
+	 */
+	IPROTO_TUPLE_REF_SIZE_MIN = 512,
+	/** Number of tuple references in a block. */
+	IPROTO_TUPLE_REF_BLOCK_SIZE = 256,
+	/**
+	 * Max number of tuple reference blocks per output
+	 * buffer. When all of them are used up, tuples are
+	 * copied.
+	 */
+	IPROTO_TUPLE_REF_BLOCK_MAX = 16,
+	/** Max number of iovecs written to a socket at once. */
+	IPROTO_FLUSH_IOV_MAX = 256,
+	/**
+	 * A compressed frame is ended at the first reply boundary
+	 * after this much output, so that a client doesn't have to
+	 * buffer too much to decode it. A single reply which is
+	 * bigger than that still goes in one frame.
+	 */
+	IPROTO_ZFRAME_SIZE_MAX = 256 * 1024,
+	/**
+	 * While a connection has more requests in flight, its
+	 * output is held back to be written with the replies to
+	 * them in one syscall, until it's at least this big.
+	 */
+	IPROTO_CORK_SIZE_MAX = 16384,
+	/**
+	 * A SELECT streaming its result in chunks waits for the
+	 * output of the connection to be flushed when it has
+	 * grown beyond this size.
+	 */
+	IPROTO_CHUNKED_OUTPUT_MAX = 1024 * 1024,
+};
+
+/**
+ * The maximal time output of a connection is held back while
+ * waiting for replies to more requests, see
+ * IPROTO_CORK_SIZE_MAX.
+ */
+static const double IPROTO_CORK_TIMEOUT = 0.0005;
+
+/**
+ * A tuple sent to the client right from the tuple memory,
+ * bypassing the output buffer. The tuple data is inserted
+ * into the output stream at the given output buffer position.
+ * The tuple is referenced until the output buffer is flushed
+ * and reset by the tx thread.
+ */
+struct iproto_tuple_ref {
+	/** Referenced tuple. */
+	struct tuple *tuple;
+	/** Tuple data. */
+	const char *data;
+	/** Size of the tuple data. */
+	uint32_t size;
+	/** Output buffer position (obuf_size()) of the data. */
+	size_t used;
+};
+
+/**
+ * Tuple references of an output buffer, ordered by position.
+ * References are appended by the tx thread and read by the
+ * iproto thread up to the count passed in a write position
+ * (see iproto_wpos), so they are stored in blocks which are
+ * never moved, and are released only when the buffer is
+ * reset, i.e. when the iproto thread is done with it.
+ */
+struct iproto_tuple_refs {
+	struct iproto_tuple_ref *blocks[IPROTO_TUPLE_REF_BLOCK_MAX];
+	/** Number of references, changed by the tx thread only. */
+	size_t count;
 };
 
+/** Memory pool of tuple reference blocks, used in tx thread. */
+static struct mempool iproto_tuple_ref_pool;
+
+static inline struct iproto_tuple_ref *
+iproto_tuple_refs_get(struct iproto_tuple_refs *refs, size_t i)
+{
+	assert(i < refs->count);
+	return &refs->blocks[i / IPROTO_TUPLE_REF_BLOCK_SIZE]
+			    [i % IPROTO_TUPLE_REF_BLOCK_SIZE];
+}
+
+/**
+ * Reference a tuple and append it to the output at
+ * position @a used.
+ * @retval  0 Success.
+ * @retval -1 No space for a new reference, the tuple must be
+ *            copied to the output buffer.
+ */
+static int
+iproto_tuple_refs_add(struct iproto_tuple_refs *refs, struct tuple *tuple,
+		      const char *data, uint32_t size, size_t used)
+{
+	size_t block = refs->count / IPROTO_TUPLE_REF_BLOCK_SIZE;
+	if (block >= IPROTO_TUPLE_REF_BLOCK_MAX)
+		return -1;
+	if (refs->count % IPROTO_TUPLE_REF_BLOCK_SIZE == 0) {
+		assert(refs->blocks[block] == NULL);
+		refs->blocks[block] = (struct iproto_tuple_ref *)
+			mempool_alloc(&iproto_tuple_ref_pool);
+		if (refs->blocks[block] == NULL)
+			return -1;
+	}
+	struct iproto_tuple_ref *ref =
+		&refs->blocks[block][refs->count % IPROTO_TUPLE_REF_BLOCK_SIZE];
+	ref->tuple = tuple;
+	ref->data = data;
+	ref->size = size;
+	ref->used = used;
+	tuple_ref(tuple);
+	refs->count++;
+	return 0;
+}
+
+/**
+ * Drop references appended after the first @a count ones,
+ * e.g. when the output buffer is rolled back to a savepoint.
+ */
+static void
+iproto_tuple_refs_truncate(struct iproto_tuple_refs *refs, size_t count)
+{
+	while (refs->count > count) {
+		refs->count--;
+		size_t block = refs->count / IPROTO_TUPLE_REF_BLOCK_SIZE;
+		size_t i = refs->count % IPROTO_TUPLE_REF_BLOCK_SIZE;
+		tuple_unref(refs->blocks[block][i].tuple);
+		if (i == 0) {
+			mempool_free(&iproto_tuple_ref_pool,
+				     refs->blocks[block]);
+			refs->blocks[block] = NULL;
+		}
+	}
+}
+
 /**
  * A position in connection output buffer.
  * Since we use rotating buffers to recycle memory,
@@ -76,6 +221,16 @@ enum {
 struct iproto_wpos {
 	struct obuf *obuf;
 	struct obuf_svp svp;
+	/**
+	 * Number of tuple references of the buffer before the
+	 * position, see iproto_tuple_ref.
+	 */
+	size_t ref_count;
+	/**
+	 * Number of bytes of reference #ref_count which have
+	 * been already flushed. Used by the iproto thread only.
+	 */
+	size_t ref_offset;
 };
 
 static void
@@ -83,6 +238,8 @@ iproto_wpos_create(struct iproto_wpos *wpos, struct obuf *out)
 {
 	wpos->obuf = out;
 	wpos->svp = obuf_create_svp(out);
+	wpos->ref_count = 0;
+	wpos->ref_offset = 0;
 }
 
 /**
@@ -107,6 +264,24 @@ struct iproto_kharon {
 	struct iproto_wpos wpos;
 };
 
+/**
+ * Flow control of the output of a connection. Tx thread sends
+ * the message to iproto along with the current position in the
+ * output buffer, and iproto returns it only when everything up
+ * to this position has been flushed to the socket, or the
+ * connection is closed.
+ */
+struct iproto_flow {
+	struct cmsg base;
+	/**
+	 * Tx write position on the way to iproto, the last
+	 * flushed position on the way back.
+	 */
+	struct iproto_wpos wpos;
+	/** Set by iproto if the connection is closed. */
+	bool is_closed;
+};
+
 /**
  * Network readahead. A signed integer to avoid
  * automatic type coercion to an unsigned type.
@@ -213,76 +388,48 @@ struct iproto_msg
 	 * and the connection must be closed.
 	 */
 	bool close_connection;
+	/**
+	 * Route of a request sent in a stream. The message is
+	 * first routed to tx_process_stream(), which queues it
+	 * to the stream fiber, and the fiber delivers it along
+	 * this route.
+	 */
+	const struct cmsg_hop *stream_route;
+	/** Link in iproto_stream::pending. */
+	struct stailq_entry in_stream;
+	/**
+	 * DML requests decoded from the same input right after
+	 * this one and executed along with it in one
+	 * transaction, see tx_process_batch().
+	 */
+	struct stailq batch;
+	/** Link in iproto_msg::batch of the first request. */
+	struct stailq_entry in_batch;
+	/** Result of a request executed in a batch. */
+	struct tuple *batch_result;
 };
 
-static struct mempool iproto_msg_pool;
-
 static struct iproto_msg *
 iproto_msg_new(struct iproto_connection *con);
 
+struct iproto_thread;
+
 /**
  * Resume stopped connections, if any.
  */
 static void
-iproto_resume();
+iproto_resume(struct iproto_thread *iproto_thread);
 
 static void
 iproto_msg_decode(struct iproto_msg *msg, const char **pos, const char *reqend,
 		  bool *stop_input);
 
-static inline void
-iproto_msg_delete(struct iproto_msg *msg)
-{
-	mempool_free(&iproto_msg_pool, msg);
-	iproto_resume();
-}
-
-/**
- * A single global queue for all requests in all connections. All
- * requests from all connections are processed concurrently.
- * Is also used as a queue for just established connections and to
- * execute disconnect triggers. A few notes about these triggers:
- * - they need to be run in a fiber
- * - unlike an ordinary request failure, on_connect trigger
- *   failure must lead to connection close.
- * - on_connect trigger must be processed before any other
- *   request on this connection.
- */
-static struct cpipe tx_pipe;
-static struct cpipe net_pipe;
-
-/**
- * Network thread.
- */
-static struct cord net_cord;
-
-/**
- * Slab cache used for allocating memory for output network buffers
- * in the tx thread.
- */
-static struct slab_cache net_slabc;
-
-struct rmean *rmean_net;
-
-enum rmean_net_name {
-	IPROTO_SENT,
-	IPROTO_RECEIVED,
-	IPROTO_LAST,
-};
-
-const char *rmean_net_strings[IPROTO_LAST] = { "SENT", "RECEIVED" };
-
 static void
 tx_process_disconnect(struct cmsg *m);
 
 static void
 net_finish_disconnect(struct cmsg *m);
 
-static const struct cmsg_hop disconnect_route[] = {
-	{ tx_process_disconnect, &net_pipe },
-	{ net_finish_disconnect, NULL },
-};
-
 /**
  * Kharon is in the dead world (iproto). Schedule an event to
  * flush new obuf as reflected in the fresh wpos.
@@ -300,11 +447,112 @@ iproto_process_push(struct cmsg *m);
 static void
 tx_end_push(struct cmsg *m);
 
-static const struct cmsg_hop push_route[] = {
-	{ iproto_process_push, &tx_pipe },
-	{ tx_end_push, NULL }
+/**
+ * Network io thread. Every connection is served by the thread
+ * which has accepted it, from the accept to the disconnect.
+ * Each thread has its own pair of pipes to and from tx, so a
+ * thread has to keep its own copy of cbus routes: a route
+ * refers to the pipe a message is forwarded to.
+ */
+struct iproto_thread {
+	/** Ordinal number of the thread, 0 is the first one. */
+	uint32_t id;
+	/** Network thread. */
+	struct cord net_cord;
+	/**
+	 * A single queue for all requests in all connections of
+	 * the thread. All requests from all connections are
+	 * processed concurrently. Is also used as a queue for just
+	 * established connections and to execute disconnect
+	 * triggers. A few notes about these triggers:
+	 * - they need to be run in a fiber
+	 * - unlike an ordinary request failure, on_connect trigger
+	 *   failure must lead to connection close.
+	 * - on_connect trigger must be processed before any other
+	 *   request on this connection.
+	 */
+	struct cpipe tx_pipe;
+	/** A pipe from tx to the thread. */
+	struct cpipe net_pipe;
+	/**
+	 * Slab cache used for allocating memory for output network
+	 * buffers in the tx thread.
+	 */
+	struct slab_cache net_slabc;
+	struct mempool iproto_msg_pool;
+	struct mempool iproto_connection_pool;
+	/** Connections stopped due to the net_msg_max limit. */
+	struct rlist stopped_connections;
+	/** The maximal number of iproto messages in fly. */
+	int msg_max;
+	/**
+	 * The maximal number of requests per second read from
+	 * a connection, 0 means no limit.
+	 */
+	double rate_limit;
+	/**
+	 * If set, consecutive autocommit DML requests read from
+	 * a connection at once are executed in one transaction,
+	 * see iproto_set_batch_dml().
+	 */
+	bool batch_dml;
+	/** Connections stopped due to the rate limit. */
+	struct rlist throttled_connections;
+	/**
+	 * Number of streams of the thread's connections, see
+	 * struct iproto_stream. Accessed in tx only.
+	 */
+	int tx_stream_count;
+	/** Network statistics of the thread. */
+	struct rmean *rmean;
+	/** Compression context, created on demand. */
+	ZSTD_CCtx *zctx;
+	/**
+	 * Binary protocol listener. The first thread binds the
+	 * listening socket, the others attach to it. A TCP socket
+	 * is bound with SO_REUSEPORT, so each thread gets a socket
+	 * of its own, and the kernel spreads incoming connections
+	 * among the threads evenly instead of waking all of them
+	 * on each one. A unix socket is shared by the threads.
+	 */
+	struct evio_service binary;
+	/* cbus routes of the thread. */
+	struct cmsg_hop disconnect_route[2];
+	struct cmsg_hop push_route[2];
+	struct cmsg_hop flow_route[1];
+	struct cmsg_hop flow_end_route[1];
+	struct cmsg_hop misc_route[2];
+	struct cmsg_hop call_route[2];
+	struct cmsg_hop select_route[2];
+	struct cmsg_hop process1_route[2];
+	struct cmsg_hop batch_route[2];
+	struct cmsg_hop sql_route[2];
+	struct cmsg_hop txn_route[2];
+	struct cmsg_hop stream_route[1];
+	const struct cmsg_hop *dml_route[IPROTO_TYPE_STAT_MAX];
+	struct cmsg_hop join_route[2];
+	struct cmsg_hop subscribe_route[2];
+	struct cmsg_hop error_route[2];
+	struct cmsg_hop connect_route[2];
+};
+
+/** Network threads, iproto_threads_count in total. */
+static struct iproto_thread *iproto_threads;
+static int iproto_threads_count;
+
+enum rmean_net_name {
+	IPROTO_SENT,
+	IPROTO_RECEIVED,
+	/** Write syscalls. */
+	IPROTO_WRITES,
+	/** Replies to requests. */
+	IPROTO_RESPONSES,
+	IPROTO_LAST,
 };
 
+const char *rmean_net_strings[IPROTO_LAST] = {
+	"SENT", "RECEIVED", "WRITES", "RESPONSES"
+};
 
 /* }}} */
 
@@ -363,6 +611,8 @@ struct iproto_connection
 	 * is flushed by the iproto thread.
 	 */
 	struct obuf obuf[2];
+	/** Tuple references of the output buffers. */
+	struct iproto_tuple_refs refs[2];
 	/**
 	 * Position in the output buffer that points to the beginning
 	 * of the data awaiting to be flushed. Advanced by the iproto
@@ -376,6 +626,16 @@ struct iproto_connection
 	 * output is available (see iproto_msg::wpos).
 	 */
 	struct iproto_wpos wend;
+	/**
+	 * Compression of the output, enum iproto_compression.
+	 * Is set by IPROTO_COMPRESS request.
+	 */
+	uint32_t compression;
+	/**
+	 * Compressed output which hasn't been written to the
+	 * socket yet.
+	 */
+	struct ibuf zbuf;
 	/*
 	 * Size of readahead which is not parsed yet, i.e. size of
 	 * a piece of request which is not fully read. Is always
@@ -396,9 +656,29 @@ struct iproto_connection
 	int long_poll_count;
 	struct ev_io input;
 	struct ev_io output;
+	/**
+	 * Token bucket of the request rate limit, see
+	 * iproto_thread::rate_limit: the number of requests which
+	 * may be read without waiting, and the time it was updated.
+	 */
+	double rate_tokens;
+	double rate_ts;
+	/** Resumes input throttled by the rate limit. */
+	struct ev_timer rate_timer;
+	/** Link in iproto_thread::throttled_connections. */
+	struct rlist in_throttle_list;
+	/** Flushes output held back to coalesce writes. */
+	struct ev_timer cork_timer;
+	/**
+	 * Time when the previous reply was ready to be sent,
+	 * see iproto_connection_is_corked().
+	 */
+	double last_reply_ts;
 	/** Logical session. */
 	struct session *session;
 	ev_loop *loop;
+	/** Network thread serving the connection. */
+	struct iproto_thread *iproto_thread;
 	/* Pre-allocated disconnect msg. */
 	struct cmsg disconnect;
 	/** True if disconnect message is sent. Debug-only. */
@@ -435,6 +715,10 @@ struct iproto_connection
 	 *                          ...
 	 */
 	struct iproto_kharon kharon;
+	/** Flow control of chunked SELECT output. */
+	struct iproto_flow flow;
+	/** True if the flow message waits for the output flush. */
+	bool is_flow_parked;
 	/**
 	 * The following fields are used exclusively by the tx thread.
 	 * Align them to prevent false-sharing.
@@ -450,32 +734,44 @@ struct iproto_connection
 		 * return.
 		 */
 		bool is_push_pending;
+		/**
+		 * Streams of the connection, by stream id, see
+		 * struct iproto_stream. Created on the first
+		 * stream request.
+		 */
+		struct mh_i64ptr_t *streams;
+		/** Signaled when a stream is closed. */
+		struct fiber_cond streams_cond;
+		/** True if the flow message is in iproto. */
+		bool is_flow_sent;
+		/** Signaled when the flow message is back. */
+		struct fiber_cond flow_cond;
 	} tx;
 	/** Authentication salt. */
 	char salt[IPROTO_SALT_SIZE];
 };
 
-static struct mempool iproto_connection_pool;
-static RLIST_HEAD(stopped_connections);
-
 /**
  * Return true if we have not enough spare messages
  * in the message pool.
  */
 static inline bool
-iproto_check_msg_max()
+iproto_check_msg_max(struct iproto_thread *iproto_thread)
 {
-	size_t request_count = mempool_count(&iproto_msg_pool);
-	return request_count > (size_t) iproto_msg_max;
+	size_t request_count =
+		mempool_count(&iproto_thread->iproto_msg_pool);
+	return request_count > (size_t) iproto_thread->msg_max;
 }
 
 static struct iproto_msg *
 iproto_msg_new(struct iproto_connection *con)
 {
+	struct mempool *iproto_msg_pool =
+		&con->iproto_thread->iproto_msg_pool;
 	struct iproto_msg *msg =
-		(struct iproto_msg *) mempool_alloc(&iproto_msg_pool);
+		(struct iproto_msg *) mempool_alloc(iproto_msg_pool);
 	ERROR_INJECT(ERRINJ_TESTING, {
-		mempool_free(&iproto_msg_pool, msg);
+		mempool_free(iproto_msg_pool, msg);
 		msg = NULL;
 	});
 	if (msg == NULL) {
@@ -488,6 +784,35 @@ iproto_msg_new(struct iproto_connection *con)
 	return msg;
 }
 
+static inline void
+iproto_msg_delete(struct iproto_msg *msg)
+{
+	struct iproto_thread *iproto_thread = msg->connection->iproto_thread;
+	mempool_free(&iproto_thread->iproto_msg_pool, msg);
+	iproto_resume(iproto_thread);
+}
+
+/** Return tuple references of a connection output buffer. */
+static inline struct iproto_tuple_refs *
+iproto_connection_refs(struct iproto_connection *con, struct obuf *obuf)
+{
+	assert(obuf == &con->obuf[0] || obuf == &con->obuf[1]);
+	return &con->refs[obuf - con->obuf];
+}
+
+/**
+ * Create a write position at the end of an output buffer,
+ * after all tuple references of the buffer. Used by the tx
+ * thread to tell iproto how much output is ready.
+ */
+static inline void
+iproto_connection_wpos_create(struct iproto_connection *con,
+			      struct iproto_wpos *wpos, struct obuf *out)
+{
+	iproto_wpos_create(wpos, out);
+	wpos->ref_count = iproto_connection_refs(con, out)->count;
+}
+
 /**
  * A connection is idle when the client is gone
  * and there are no outstanding msgs in the msg queue.
@@ -525,6 +850,46 @@ iproto_connection_stop_readahead_limit(struct iproto_connection *con)
 	ev_io_stop(con->loop, &con->input);
 }
 
+/**
+ * Refill the token bucket of a connection and check if it has
+ * exceeded the request rate limit. The bucket holds at most a
+ * second worth of requests, so that short bursts are let
+ * through without waiting.
+ */
+static inline bool
+iproto_connection_check_rate_limit(struct iproto_connection *con)
+{
+	double limit = con->iproto_thread->rate_limit;
+	if (limit == 0)
+		return false;
+	double now = ev_monotonic_now(con->loop);
+	con->rate_tokens += (now - con->rate_ts) * limit;
+	con->rate_tokens = MIN(con->rate_tokens, MAX(limit, 1));
+	con->rate_ts = now;
+	return con->rate_tokens < 1;
+}
+
+/**
+ * Stop input when the request rate limit is exceeded. The input
+ * is resumed by a timer when the bucket has a token again. Unlike
+ * net_msg_max, the limit doesn't affect other connections.
+ */
+static inline void
+iproto_connection_stop_rate_limit(struct iproto_connection *con)
+{
+	struct iproto_thread *iproto_thread = con->iproto_thread;
+	double limit = iproto_thread->rate_limit;
+	assert(limit > 0);
+	assert(rlist_empty(&con->in_stop_list));
+	assert(!ev_is_active(&con->rate_timer));
+	ev_io_stop(con->loop, &con->input);
+	double delay = (1 - con->rate_tokens) / limit;
+	ev_timer_set(&con->rate_timer, delay, 0);
+	ev_timer_start(con->loop, &con->rate_timer);
+	rlist_add_tail(&iproto_thread->throttled_connections,
+		       &con->in_throttle_list);
+}
+
 static inline void
 iproto_connection_stop_msg_max_limit(struct iproto_connection *con)
 {
@@ -537,7 +902,23 @@ iproto_connection_stop_msg_max_limit(struct iproto_connection *con)
 	 * Important to add to tail and fetch from head to ensure
 	 * strict lifo order (fairness) for stopped connections.
 	 */
-	rlist_add_tail(&stopped_connections, &con->in_stop_list);
+	rlist_add_tail(&con->iproto_thread->stopped_connections,
+		       &con->in_stop_list);
+}
+
+/**
+ * Return the flow message to tx along with the last flushed
+ * position of the output.
+ */
+static void
+iproto_connection_return_flow(struct iproto_connection *con)
+{
+	assert(con->is_flow_parked);
+	con->is_flow_parked = false;
+	con->flow.wpos = con->wpos;
+	con->flow.is_closed = !evio_has_fd(&con->output);
+	cmsg_init(&con->flow.base, con->iproto_thread->flow_end_route);
+	cpipe_push(&con->iproto_thread->tx_pipe, &con->flow.base);
 }
 
 /**
@@ -552,6 +933,9 @@ iproto_connection_close(struct iproto_connection *con)
 		/* Clears all pending events. */
 		ev_io_stop(con->loop, &con->input);
 		ev_io_stop(con->loop, &con->output);
+		ev_timer_stop(con->loop, &con->rate_timer);
+		rlist_del(&con->in_throttle_list);
+		ev_timer_stop(con->loop, &con->cork_timer);
 
 		int fd = con->input.fd;
 		/* Make evio_has_fd() happy */
@@ -565,6 +949,9 @@ iproto_connection_close(struct iproto_connection *con)
 		 */
 		con->p_ibuf->wpos -= con->parse_size;
 	}
+	/* The output is never going to be flushed. */
+	if (con->is_flow_parked)
+		iproto_connection_return_flow(con);
 	/*
 	 * If the connection has no outstanding requests in the
 	 * input buffer, then no one (e.g. tx thread) is referring
@@ -580,7 +967,7 @@ iproto_connection_close(struct iproto_connection *con)
 	if (iproto_connection_is_idle(con)) {
 		assert(con->is_disconnected == false);
 		con->is_disconnected = true;
-		cpipe_push(&tx_pipe, &con->disconnect);
+		cpipe_push(&con->iproto_thread->tx_pipe, &con->disconnect);
 	}
 	rlist_del(&con->in_stop_list);
 }
@@ -674,6 +1061,52 @@ iproto_connection_input_buffer(struct iproto_connection *con)
 	return new_ibuf;
 }
 
+/**
+ * Check if a decoded request can be executed in one transaction
+ * with the DML requests preceding it, see iproto_set_batch_dml().
+ * Requests to system spaces are never batched, since most of
+ * them change the schema and must run in a transaction of
+ * their own.
+ */
+static inline bool
+iproto_msg_is_batchable(struct iproto_msg *msg)
+{
+	struct iproto_thread *iproto_thread = msg->connection->iproto_thread;
+	return iproto_thread->batch_dml &&
+	       msg->base.route == iproto_thread->process1_route &&
+	       msg->dml.space_id > BOX_SYSTEM_ID_MAX;
+}
+
+/**
+ * Append a batchable request to the current batch, or start
+ * a new one. A batch is pushed to tx as its first request.
+ */
+static inline void
+iproto_batch_add(struct iproto_msg **batch, struct iproto_msg *msg)
+{
+	struct iproto_msg *first = *batch;
+	if (first == NULL) {
+		stailq_create(&msg->batch);
+		*batch = msg;
+		return;
+	}
+	if (stailq_empty(&first->batch)) {
+		cmsg_init(&first->base,
+			  first->connection->iproto_thread->batch_route);
+	}
+	stailq_add_tail_entry(&first->batch, msg, in_batch);
+}
+
+/** Push the current batch to tx, if any. */
+static inline void
+iproto_batch_push(struct cpipe *tx_pipe, struct iproto_msg **batch)
+{
+	if (*batch == NULL)
+		return;
+	cpipe_push_input(tx_pipe, &(*batch)->base);
+	*batch = NULL;
+}
+
 /**
  * Enqueue all requests which were read up. If a request limit is
  * reached - stop the connection input even if not the whole batch
@@ -689,13 +1122,17 @@ static inline int
 iproto_enqueue_batch(struct iproto_connection *con, struct ibuf *in)
 {
 	assert(rlist_empty(&con->in_stop_list));
+	struct cpipe *tx_pipe = &con->iproto_thread->tx_pipe;
 	int n_requests = 0;
 	bool stop_input = false;
 	const char *errmsg;
+	/* Consecutive DML requests executed as one transaction. */
+	struct iproto_msg *batch = NULL;
 	while (con->parse_size != 0 && !stop_input) {
-		if (iproto_check_msg_max()) {
+		if (iproto_check_msg_max(con->iproto_thread)) {
 			iproto_connection_stop_msg_max_limit(con);
-			cpipe_flush_input(&tx_pipe);
+			iproto_batch_push(tx_pipe, &batch);
+			cpipe_flush_input(tx_pipe);
 			return 0;
 		}
 		const char *reqstart = in->wpos - con->parse_size;
@@ -704,7 +1141,8 @@ iproto_enqueue_batch(struct iproto_connection *con, struct ibuf *in)
 		if (mp_typeof(*pos) != MP_UINT) {
 			errmsg = "packet length";
 err_msgpack:
-			cpipe_flush_input(&tx_pipe);
+			iproto_batch_push(tx_pipe, &batch);
+			cpipe_flush_input(tx_pipe);
 			diag_set(ClientError, ER_INVALID_MSGPACK,
 				 errmsg);
 			return -1;
@@ -721,6 +1159,12 @@ err_msgpack:
 		const char *reqend = pos + len;
 		if (reqend > in->wpos)
 			break;
+		if (iproto_connection_check_rate_limit(con)) {
+			iproto_connection_stop_rate_limit(con);
+			iproto_batch_push(tx_pipe, &batch);
+			cpipe_flush_input(tx_pipe);
+			return 0;
+		}
 		struct iproto_msg *msg = iproto_msg_new(con);
 		if (msg == NULL) {
 			/*
@@ -728,10 +1172,13 @@ err_msgpack:
 			 * until some of requests are finished.
 			 */
 			iproto_connection_stop_msg_max_limit(con);
+			iproto_batch_push(tx_pipe, &batch);
 			return 0;
 		}
 		msg->p_ibuf = con->p_ibuf;
 		msg->wpos = con->wpos;
+		if (con->iproto_thread->rate_limit != 0)
+			con->rate_tokens -= 1;
 
 		msg->len = reqend - reqstart; /* total request length */
 
@@ -740,7 +1187,12 @@ err_msgpack:
 		 * This can't throw, but should not be
 		 * done in case of exception.
 		 */
-		cpipe_push_input(&tx_pipe, &msg->base);
+		if (iproto_msg_is_batchable(msg)) {
+			iproto_batch_add(&batch, msg);
+		} else {
+			iproto_batch_push(tx_pipe, &batch);
+			cpipe_push_input(tx_pipe, &msg->base);
+		}
 		n_requests++;
 		/* Request is parsed */
 		assert(reqend > reqstart);
@@ -778,7 +1230,8 @@ err_msgpack:
 		 */
 		ev_feed_event(con->loop, &con->input, EV_READ);
 	}
-	cpipe_flush_input(&tx_pipe);
+	iproto_batch_push(tx_pipe, &batch);
+	cpipe_flush_input(tx_pipe);
 	return 0;
 }
 
@@ -790,7 +1243,7 @@ err_msgpack:
 static void
 iproto_connection_resume(struct iproto_connection *con)
 {
-	assert(! iproto_check_msg_max());
+	assert(! iproto_check_msg_max(con->iproto_thread));
 	rlist_del(&con->in_stop_list);
 	/*
 	 * Enqueue_batch() stops the connection again, if the
@@ -814,21 +1267,60 @@ iproto_connection_resume(struct iproto_connection *con)
  * necessary to use up the limit.
  */
 static void
-iproto_resume()
+iproto_resume(struct iproto_thread *iproto_thread)
 {
-	while (!iproto_check_msg_max() && !rlist_empty(&stopped_connections)) {
+	while (!iproto_check_msg_max(iproto_thread) &&
+	       !rlist_empty(&iproto_thread->stopped_connections)) {
 		/*
 		 * Shift from list head to ensure strict FIFO
 		 * (fairness) for resumed connections.
 		 */
 		struct iproto_connection *con =
-			rlist_first_entry(&stopped_connections,
+			rlist_first_entry(&iproto_thread->stopped_connections,
 					  struct iproto_connection,
 					  in_stop_list);
 		iproto_connection_resume(con);
 	}
 }
 
+/** Resume input of a connection throttled by the rate limit. */
+static void
+iproto_connection_on_rate_timer(ev_loop *loop, struct ev_timer *timer,
+				int /* revents */)
+{
+	(void) loop;
+	struct iproto_connection *con =
+		(struct iproto_connection *) timer->data;
+	rlist_del(&con->in_throttle_list);
+	if (iproto_check_msg_max(con->iproto_thread))
+		iproto_connection_stop_msg_max_limit(con);
+	else
+		iproto_connection_resume(con);
+}
+
+/**
+ * Resume all connections throttled by the rate limit, e.g.
+ * when the limit is changed. A connection is throttled again
+ * if it still exceeds the new limit.
+ */
+static void
+iproto_thread_resume_throttled(struct iproto_thread *iproto_thread)
+{
+	/*
+	 * A resumed connection may be throttled again, so move
+	 * the connections to a temporary list first.
+	 */
+	RLIST_HEAD(throttled);
+	rlist_splice(&throttled, &iproto_thread->throttled_connections);
+	while (!rlist_empty(&throttled)) {
+		struct iproto_connection *con =
+			rlist_first_entry(&throttled, struct iproto_connection,
+					  in_throttle_list);
+		ev_timer_stop(con->loop, &con->rate_timer);
+		iproto_connection_on_rate_timer(con->loop, &con->rate_timer, 0);
+	}
+}
+
 static void
 iproto_connection_on_input(ev_loop *loop, struct ev_io *watcher,
 			   int /* revents */)
@@ -839,12 +1331,21 @@ iproto_connection_on_input(ev_loop *loop, struct ev_io *watcher,
 	assert(fd >= 0);
 	assert(rlist_empty(&con->in_stop_list));
 	assert(loop == con->loop);
+	/*
+	 * The input may be fed when the output is flushed,
+	 * but a throttled connection is resumed by its timer
+	 * only.
+	 */
+	if (ev_is_active(&con->rate_timer)) {
+		ev_io_stop(loop, &con->input);
+		return;
+	}
 	/*
 	 * Throttle if there are too many pending requests,
 	 * otherwise we might deplete the fiber pool in tx
 	 * thread and deadlock.
 	 */
-	if (iproto_check_msg_max()) {
+	if (iproto_check_msg_max(con->iproto_thread)) {
 		iproto_connection_stop_msg_max_limit(con);
 		return;
 	}
@@ -867,7 +1368,7 @@ iproto_connection_on_input(ev_loop *loop, struct ev_io *watcher,
 			return;
 		}
 		/* Count statistics */
-		rmean_collect(rmean_net, IPROTO_RECEIVED, nrd);
+		rmean_collect(con->iproto_thread->rmean, IPROTO_RECEIVED, nrd);
 
 		/* Update the read position and connection state. */
 		in->wpos += nrd;
@@ -883,70 +1384,401 @@ iproto_connection_on_input(ev_loop *loop, struct ev_io *watcher,
 	}
 }
 
-/** writev() to the socket and handle the result. */
-
+/**
+ * Collect iovecs of the output to flush, interleaved with tuple
+ * references. Iovecs are built from the output buffer chunks
+ * split at the positions of the references, with the tuple data
+ * in between.
+ * @param con Connection.
+ * @param wend End of the output to flush.
+ * @param[out] iov Iovecs, at most IPROTO_FLUSH_IOV_MAX.
+ * @param[out] iov_pos Output buffer chunk of each iovec, -1
+ *             for a reference.
+ * @return The number of collected iovecs.
+ */
 static int
-iproto_flush(struct iproto_connection *con)
-{
-	int fd = con->output.fd;
-	struct obuf *obuf = con->wpos.obuf;
-	struct obuf_svp obuf_end = obuf_create_svp(obuf);
-	struct obuf_svp *begin = &con->wpos.svp;
-	struct obuf_svp *end = &con->wend.svp;
-	if (con->wend.obuf != obuf) {
+iproto_flush_collect(struct iproto_connection *con,
+		     const struct iproto_wpos *wend, struct iovec *iov,
+		     int *iov_pos)
+{
+	struct iproto_wpos *wpos = &con->wpos;
+	struct obuf *obuf = wpos->obuf;
+	struct iproto_tuple_refs *refs = iproto_connection_refs(con, obuf);
+	int iovcnt = 0;
+	size_t used = wpos->svp.used;
+	int pos = wpos->svp.pos;
+	size_t offset = wpos->svp.iov_len;
+	size_t ref = wpos->ref_count;
+	size_t ref_offset = wpos->ref_offset;
+	while (iovcnt < IPROTO_FLUSH_IOV_MAX) {
+		struct iproto_tuple_ref *next = NULL;
+		if (ref < wend->ref_count)
+			next = iproto_tuple_refs_get(refs, ref);
+		if (next != NULL && next->used == used) {
+			iov[iovcnt].iov_base = (char *) next->data + ref_offset;
+			iov[iovcnt].iov_len = next->size - ref_offset;
+			iov_pos[iovcnt++] = -1;
+			ref++;
+			ref_offset = 0;
+			continue;
+		}
+		if (used == wend->svp.used)
+			break;
 		/*
-		 * Flush the current buffer before
-		 * advancing to the next one.
+		 * iov[i].iov_len may be concurrently modified in
+		 * tx thread, but only for the last position.
 		 */
-		if (begin->used == obuf_end.used) {
-			obuf = con->wpos.obuf = con->wend.obuf;
-			obuf_svp_reset(begin);
-		} else {
-			end = &obuf_end;
+		size_t len = pos < wend->svp.pos ? obuf->iov[pos].iov_len :
+			     wend->svp.iov_len;
+		if (offset == len) {
+			pos++;
+			offset = 0;
+			continue;
 		}
+		size_t stop = next != NULL ? next->used : wend->svp.used;
+		len = MIN(len - offset, stop - used);
+		iov[iovcnt].iov_base = (char *) obuf->iov[pos].iov_base + offset;
+		iov[iovcnt].iov_len = len;
+		iov_pos[iovcnt++] = pos;
+		offset += len;
+		used += len;
 	}
-	if (begin->used == end->used) {
-		/* Nothing to do. */
-		return 1;
-	}
-	assert(begin->used < end->used);
-	struct iovec iov[SMALL_OBUF_IOV_MAX+1];
-	struct iovec *src = obuf->iov;
-	int iovcnt = end->pos - begin->pos + 1;
-	/*
-	 * iov[i].iov_len may be concurrently modified in tx thread,
-	 * but only for the last position.
-	 */
-	memcpy(iov, src + begin->pos, iovcnt * sizeof(struct iovec));
-	sio_add_to_iov(iov, -begin->iov_len);
-	/* *Overwrite* iov_len of the last pos as it may be garbage. */
-	iov[iovcnt-1].iov_len = end->iov_len - begin->iov_len * (iovcnt == 1);
-
-	ssize_t nwr = sio_writev(fd, iov, iovcnt);
+	return iovcnt;
+}
 
-	/* Count statistics */
-	rmean_collect(rmean_net, IPROTO_SENT, nwr);
-	if (nwr > 0) {
-		if (begin->used + nwr == end->used) {
-			*begin = *end;
-			return 0;
+/**
+ * Advance the write position of a connection by @a size bytes
+ * of iovecs collected by iproto_flush_collect().
+ * @retval 0 All iovecs have been advanced over.
+ * @retval -1 Some data is left.
+ */
+static int
+iproto_flush_advance(struct iproto_connection *con,
+		     const struct iovec *iov, const int *iov_pos,
+		     int iovcnt, size_t size)
+{
+	struct iproto_wpos *wpos = &con->wpos;
+	struct obuf *obuf = wpos->obuf;
+	size_t left = size;
+	for (int i = 0; i < iovcnt; i++) {
+		size_t len = MIN(left, iov[i].iov_len);
+		if (iov_pos[i] < 0) {
+			wpos->ref_offset += len;
+			if (len == iov[i].iov_len) {
+				wpos->ref_count++;
+				wpos->ref_offset = 0;
+			}
+		} else {
+			struct iovec *src = &obuf->iov[iov_pos[i]];
+			wpos->svp.pos = iov_pos[i];
+			wpos->svp.iov_len = (char *) iov[i].iov_base -
+					    (char *) src->iov_base + len;
+			wpos->svp.used += len;
 		}
-		size_t offset = 0;
-		int advance = 0;
-		advance = sio_move_iov(iov, nwr, &offset);
-		begin->used += nwr;             /* advance write position */
-		begin->iov_len = advance == 0 ? begin->iov_len + offset: offset;
-		begin->pos += advance;
-		assert(begin->pos <= end->pos);
+		if (len < iov[i].iov_len)
+			return -1;
+		left -= len;
 	}
-	return -1;
+	return 0;
 }
 
-static void
-iproto_connection_on_output(ev_loop *loop, struct ev_io *watcher,
-			    int /* revents */)
+/**
+ * writev() output interleaved with tuple references to the
+ * socket.
+ */
+static int
+iproto_flush_refs(struct iproto_connection *con,
+		  const struct iproto_wpos *wend)
+{
+	struct iovec iov[IPROTO_FLUSH_IOV_MAX];
+	int iov_pos[IPROTO_FLUSH_IOV_MAX];
+	int iovcnt = iproto_flush_collect(con, wend, iov, iov_pos);
+
+	ssize_t nwr = sio_writev(con->output.fd, iov, iovcnt);
+
+	/* Count statistics */
+	rmean_collect(con->iproto_thread->rmean, IPROTO_SENT, nwr);
+	rmean_collect(con->iproto_thread->rmean, IPROTO_WRITES, 1);
+	if (nwr <= 0)
+		return -1;
+	return iproto_flush_advance(con, iov, iov_pos, iovcnt, nwr);
+}
+
+/**
+ * write() compressed output to the socket.
+ * @retval 0 All compressed output has been written.
+ * @retval -1 Some output is left.
+ */
+static int
+iproto_flush_zbuf(struct iproto_connection *con)
+{
+	struct ibuf *zbuf = &con->zbuf;
+	ssize_t nwr = sio_write(con->output.fd, zbuf->rpos, ibuf_used(zbuf));
+
+	/* Count statistics */
+	rmean_collect(con->iproto_thread->rmean, IPROTO_SENT, nwr);
+	rmean_collect(con->iproto_thread->rmean, IPROTO_WRITES, 1);
+	if (nwr <= 0)
+		return -1;
+	zbuf->rpos += nwr;
+	if (ibuf_used(zbuf) != 0)
+		return -1;
+	ibuf_reset(zbuf);
+	return 0;
+}
+
+/**
+ * Finds reply boundaries in output, so that a compressed frame
+ * can be ended after any reply. Every reply starts with its
+ * length encoded as MP_UINT32: 0xce <length>.
+ */
+struct iproto_reply_scanner {
+	/** Bytes left to the end of the current reply. */
+	uint32_t body_left;
+	/** Number of bytes of the reply length read so far. */
+	int len_size;
+	/** Reply length, as read so far. */
+	char len[5];
+};
+
+/**
+ * Scan the output collected in @a iov and return how much of it
+ * goes to the current compressed frame, which already has
+ * @a frame_size bytes of output. The output is cut at the first
+ * reply boundary after IPROTO_ZFRAME_SIZE_MAX bytes.
+ */
+static size_t
+iproto_reply_scanner_scan(struct iproto_reply_scanner *scanner,
+			  const struct iovec *iov, int iovcnt,
+			  size_t *frame_size)
+{
+	size_t size = 0;
+	for (int i = 0; i < iovcnt; i++) {
+		const char *pos = (const char *) iov[i].iov_base;
+		size_t left = iov[i].iov_len;
+		while (left > 0) {
+			size_t len;
+			if (scanner->body_left > 0) {
+				len = MIN(left, scanner->body_left);
+				scanner->body_left -= len;
+			} else {
+				if (scanner->len_size == 0 &&
+				    *frame_size >= IPROTO_ZFRAME_SIZE_MAX)
+					return size;
+				len = MIN(left, sizeof(scanner->len) -
+						scanner->len_size);
+				memcpy(scanner->len + scanner->len_size,
+				       pos, len);
+				scanner->len_size += len;
+				if (scanner->len_size == sizeof(scanner->len)) {
+					const char *data = scanner->len;
+					assert(mp_typeof(*data) == MP_UINT);
+					scanner->body_left =
+						mp_decode_uint(&data);
+					scanner->len_size = 0;
+				}
+			}
+			pos += len;
+			left -= len;
+			size += len;
+			*frame_size += len;
+		}
+	}
+	return size;
+}
+
+/**
+ * Compress the output into a frame and write it to the socket.
+ * The frame is an iproto packet, which body is a MP_BIN with
+ * zstd-compressed iproto packets:
+ *
+ * 0xce <length> 0xc6 <compressed size> <compressed packets>
+ *
+ * The frame covers the output up to @a wend, which is always a
+ * reply boundary, or up to the first reply boundary after
+ * IPROTO_ZFRAME_SIZE_MAX bytes, so a client can decode every
+ * frame on its own. The rest of the output goes to the next
+ * frames. The output is collected in batches of at most
+ * IPROTO_FLUSH_IOV_MAX iovecs and advanced over as soon as it is
+ * compressed, so tx can reuse the output buffer while the frame
+ * is written.
+ */
+static int
+iproto_flush_compressed(struct iproto_connection *con,
+			const struct iproto_wpos *wend)
+{
+	enum { FRAME_HEADER_SIZE = 10 };
+	assert(con->compression == IPROTO_COMPRESSION_ZSTD);
+	assert(ibuf_used(&con->zbuf) == 0);
+	if (con->wpos.svp.used == wend->svp.used &&
+	    con->wpos.ref_count == wend->ref_count) {
+		/* Nothing to do. */
+		return 1;
+	}
+	struct iproto_thread *iproto_thread = con->iproto_thread;
+	if (iproto_thread->zctx == NULL) {
+		iproto_thread->zctx = ZSTD_createCCtx();
+		if (iproto_thread->zctx == NULL) {
+			tnt_raise(OutOfMemory, sizeof(ZSTD_CCtx *),
+				  "ZSTD_createCCtx", "zctx");
+		}
+	}
+	struct ibuf *zbuf = &con->zbuf;
+	if (ibuf_reserve(zbuf, FRAME_HEADER_SIZE) == NULL) {
+		tnt_raise(OutOfMemory, FRAME_HEADER_SIZE,
+			  "ibuf", "compressed output");
+	}
+	zbuf->wpos += FRAME_HEADER_SIZE;
+	/* 1 is the fastest compression level. */
+	size_t rc = ZSTD_compressBegin(iproto_thread->zctx, 1);
+	if (ZSTD_isError(rc)) {
+		tnt_raise(ClientError, ER_COMPRESSION,
+			  ZSTD_getErrorName(rc));
+	}
+	struct iproto_reply_scanner scanner;
+	memset(&scanner, 0, sizeof(scanner));
+	size_t frame_size = 0;
+	bool is_full = false;
+	struct iovec iov[IPROTO_FLUSH_IOV_MAX];
+	int iov_pos[IPROTO_FLUSH_IOV_MAX];
+	do {
+		int iovcnt = iproto_flush_collect(con, wend, iov, iov_pos);
+		size_t batch_size = 0;
+		for (int i = 0; i < iovcnt; i++)
+			batch_size += iov[i].iov_len;
+		size_t size = iproto_reply_scanner_scan(&scanner, iov, iovcnt,
+							&frame_size);
+		is_full = size < batch_size ||
+			  (frame_size >= IPROTO_ZFRAME_SIZE_MAX &&
+			   scanner.body_left == 0 && scanner.len_size == 0);
+		size_t zmax_size = 0;
+		size_t left = size;
+		for (int i = 0; i < iovcnt && left > 0; i++) {
+			size_t len = MIN(left, iov[i].iov_len);
+			zmax_size += ZSTD_compressBound(len);
+			left -= len;
+		}
+		char *zdst = (char *) ibuf_reserve(zbuf, zmax_size);
+		if (zdst == NULL) {
+			tnt_raise(OutOfMemory, zmax_size,
+				  "ibuf", "compressed output");
+		}
+		char *zend = zdst + zmax_size;
+		left = size;
+		for (int i = 0; i < iovcnt && left > 0; i++) {
+			size_t len = MIN(left, iov[i].iov_len);
+			size_t zsize = ZSTD_compressContinue(
+				iproto_thread->zctx, zdst, zend - zdst,
+				iov[i].iov_base, len);
+			if (ZSTD_isError(zsize)) {
+				tnt_raise(ClientError, ER_COMPRESSION,
+					  ZSTD_getErrorName(zsize));
+			}
+			zdst += zsize;
+			left -= len;
+		}
+		zbuf->wpos = zdst;
+		iproto_flush_advance(con, iov, iov_pos, iovcnt, size);
+	} while (!is_full && (con->wpos.svp.used != wend->svp.used ||
+			      con->wpos.ref_count != wend->ref_count));
+	/* Close the zstd frame. */
+	size_t zmax_size = ZSTD_compressBound(0);
+	char *zdst = (char *) ibuf_reserve(zbuf, zmax_size);
+	if (zdst == NULL)
+		tnt_raise(OutOfMemory, zmax_size, "ibuf", "compressed output");
+	size_t zsize = ZSTD_compressEnd(iproto_thread->zctx, zdst, zmax_size,
+					NULL, 0);
+	if (ZSTD_isError(zsize)) {
+		tnt_raise(ClientError, ER_COMPRESSION,
+			  ZSTD_getErrorName(zsize));
+	}
+	zbuf->wpos = zdst + zsize;
+	uint32_t frame_size = ibuf_used(zbuf) - FRAME_HEADER_SIZE;
+	char *data = zbuf->rpos;
+	data = mp_store_u8(data, 0xce);
+	data = mp_store_u32(data, frame_size + FRAME_HEADER_SIZE - 5);
+	data = mp_store_u8(data, 0xc6);
+	data = mp_store_u32(data, frame_size);
+	return iproto_flush_zbuf(con);
+}
+
+/** writev() to the socket and handle the result. */
+
+static int
+iproto_flush(struct iproto_connection *con)
+{
+	if (ibuf_used(&con->zbuf) != 0)
+		return iproto_flush_zbuf(con);
+	int fd = con->output.fd;
+	struct obuf *obuf = con->wpos.obuf;
+	struct iproto_wpos obuf_end;
+	struct iproto_wpos *wend = &con->wend;
+	struct obuf_svp *begin = &con->wpos.svp;
+	if (con->wend.obuf != obuf) {
+		/*
+		 * Flush the current buffer before
+		 * advancing to the next one.
+		 */
+		iproto_connection_wpos_create(con, &obuf_end, obuf);
+		if (begin->used == obuf_end.svp.used &&
+		    con->wpos.ref_count == obuf_end.ref_count) {
+			obuf = con->wpos.obuf = con->wend.obuf;
+			obuf_svp_reset(begin);
+			con->wpos.ref_count = 0;
+			con->wpos.ref_offset = 0;
+		} else {
+			wend = &obuf_end;
+		}
+	}
+	struct obuf_svp *end = &wend->svp;
+	if (con->compression != IPROTO_COMPRESSION_NONE)
+		return iproto_flush_compressed(con, wend);
+	if (con->wpos.ref_count != wend->ref_count)
+		return iproto_flush_refs(con, wend);
+	if (begin->used == end->used) {
+		/* Nothing to do. */
+		return 1;
+	}
+	assert(begin->used < end->used);
+	struct iovec iov[SMALL_OBUF_IOV_MAX+1];
+	struct iovec *src = obuf->iov;
+	int iovcnt = end->pos - begin->pos + 1;
+	/*
+	 * iov[i].iov_len may be concurrently modified in tx thread,
+	 * but only for the last position.
+	 */
+	memcpy(iov, src + begin->pos, iovcnt * sizeof(struct iovec));
+	sio_add_to_iov(iov, -begin->iov_len);
+	/* *Overwrite* iov_len of the last pos as it may be garbage. */
+	iov[iovcnt-1].iov_len = end->iov_len - begin->iov_len * (iovcnt == 1);
+
+	ssize_t nwr = sio_writev(fd, iov, iovcnt);
+
+	/* Count statistics */
+	rmean_collect(con->iproto_thread->rmean, IPROTO_SENT, nwr);
+	rmean_collect(con->iproto_thread->rmean, IPROTO_WRITES, 1);
+	if (nwr > 0) {
+		if (begin->used + nwr == end->used) {
+			*begin = *end;
+			return 0;
+		}
+		size_t offset = 0;
+		int advance = 0;
+		advance = sio_move_iov(iov, nwr, &offset);
+		begin->used += nwr;             /* advance write position */
+		begin->iov_len = advance == 0 ? begin->iov_len + offset: offset;
+		begin->pos += advance;
+		assert(begin->pos <= end->pos);
+	}
+	return -1;
+}
+
+static void
+iproto_connection_on_output(ev_loop *loop, struct ev_io *watcher,
+			    int /* revents */)
 {
 	struct iproto_connection *con = (struct iproto_connection *) watcher->data;
+	ev_timer_stop(loop, &con->cork_timer);
 
 	try {
 		int rc;
@@ -962,29 +1794,103 @@ iproto_connection_on_output(ev_loop *loop, struct ev_io *watcher,
 		}
 		if (ev_is_active(&con->output))
 			ev_io_stop(con->loop, &con->output);
+		if (con->is_flow_parked)
+			iproto_connection_return_flow(con);
 	} catch (Exception *e) {
 		e->log();
 		iproto_connection_close(con);
 	}
 }
 
+static void
+iproto_connection_on_cork_timer(ev_loop *loop, struct ev_timer *timer,
+				int /* revents */)
+{
+	struct iproto_connection *con =
+		(struct iproto_connection *) timer->data;
+	if (! ev_is_active(&con->output))
+		ev_feed_event(loop, &con->output, EV_WRITE);
+}
+
+/**
+ * Check if the output of a connection should be held back
+ * until replies to more requests are ready, so that they are
+ * written in one syscall. It makes sense only if there are
+ * requests in flight, i.e. read but not replied yet, and the
+ * pending output is small, so holding it back costs nothing
+ * but a little latency, which is capped by a timer. Long polls
+ * don't count, because they may not reply for a long time.
+ * Neither does it make sense if replies aren't ready faster
+ * than the timer fires: the output would be flushed by the
+ * timer anyway, only later.
+ */
+static inline bool
+iproto_connection_is_corked(struct iproto_connection *con)
+{
+	size_t in_flight = ibuf_used(&con->ibuf[0]) +
+			   ibuf_used(&con->ibuf[1]) - con->parse_size;
+	if (in_flight == 0)
+		return false;
+	if (ev_monotonic_now(con->loop) - con->last_reply_ts >=
+	    IPROTO_CORK_TIMEOUT)
+		return false;
+	if (con->wend.obuf != con->wpos.obuf ||
+	    con->wend.ref_count != con->wpos.ref_count ||
+	    ibuf_used(&con->zbuf) != 0)
+		return false;
+	return con->wend.svp.used - con->wpos.svp.used <
+	       IPROTO_CORK_SIZE_MAX;
+}
+
+/** Schedule flushing of the output of a connection. */
+static inline void
+iproto_connection_feed_output(struct iproto_connection *con)
+{
+	bool is_corked = !ev_is_active(&con->output) &&
+			 iproto_connection_is_corked(con);
+	con->last_reply_ts = ev_monotonic_now(con->loop);
+	if (ev_is_active(&con->output))
+		return;
+	if (is_corked) {
+		if (! ev_is_active(&con->cork_timer))
+			ev_timer_start(con->loop, &con->cork_timer);
+		return;
+	}
+	ev_feed_event(con->loop, &con->output, EV_WRITE);
+}
+
 static struct iproto_connection *
-iproto_connection_new(int fd)
+iproto_connection_new(struct iproto_thread *iproto_thread, int fd)
 {
 	struct iproto_connection *con = (struct iproto_connection *)
-		mempool_alloc(&iproto_connection_pool);
+		mempool_alloc(&iproto_thread->iproto_connection_pool);
 	if (con == NULL) {
 		diag_set(OutOfMemory, sizeof(*con), "mempool_alloc", "con");
 		return NULL;
 	}
 	con->input.data = con->output.data = con;
 	con->loop = loop();
+	con->iproto_thread = iproto_thread;
 	ev_io_init(&con->input, iproto_connection_on_input, fd, EV_READ);
 	ev_io_init(&con->output, iproto_connection_on_output, fd, EV_WRITE);
+	ev_timer_init(&con->rate_timer, iproto_connection_on_rate_timer, 0, 0);
+	con->rate_timer.data = con;
+	ev_timer_init(&con->cork_timer, iproto_connection_on_cork_timer,
+		      IPROTO_CORK_TIMEOUT, 0);
+	con->cork_timer.data = con;
+	con->last_reply_ts = 0;
+	con->rate_tokens = 0;
+	con->rate_ts = 0;
+	rlist_create(&con->in_throttle_list);
 	ibuf_create(&con->ibuf[0], cord_slab_cache(), iproto_readahead);
 	ibuf_create(&con->ibuf[1], cord_slab_cache(), iproto_readahead);
-	obuf_create(&con->obuf[0], &net_slabc, iproto_readahead);
-	obuf_create(&con->obuf[1], &net_slabc, iproto_readahead);
+	ibuf_create(&con->zbuf, cord_slab_cache(), iproto_readahead);
+	con->compression = IPROTO_COMPRESSION_NONE;
+	obuf_create(&con->obuf[0], &iproto_thread->net_slabc,
+		    iproto_readahead);
+	obuf_create(&con->obuf[1], &iproto_thread->net_slabc,
+		    iproto_readahead);
+	memset(con->refs, 0, sizeof(con->refs));
 	con->p_ibuf = &con->ibuf[0];
 	con->tx.p_obuf = &con->obuf[0];
 	iproto_wpos_create(&con->wpos, con->tx.p_obuf);
@@ -994,10 +1900,15 @@ iproto_connection_new(int fd)
 	con->session = NULL;
 	rlist_create(&con->in_stop_list);
 	/* It may be very awkward to allocate at close. */
-	cmsg_init(&con->disconnect, disconnect_route);
+	cmsg_init(&con->disconnect, iproto_thread->disconnect_route);
 	con->is_disconnected = false;
 	con->tx.is_push_pending = false;
 	con->tx.is_push_sent = false;
+	con->tx.streams = NULL;
+	fiber_cond_create(&con->tx.streams_cond);
+	con->is_flow_parked = false;
+	con->tx.is_flow_sent = false;
+	fiber_cond_create(&con->tx.flow_cond);
 	return con;
 }
 
@@ -1015,11 +1926,12 @@ iproto_connection_delete(struct iproto_connection *con)
 	 */
 	ibuf_destroy(&con->ibuf[0]);
 	ibuf_destroy(&con->ibuf[1]);
+	ibuf_destroy(&con->zbuf);
 	assert(con->obuf[0].pos == 0 &&
 	       con->obuf[0].iov[0].iov_base == NULL);
 	assert(con->obuf[1].pos == 0 &&
 	       con->obuf[1].iov[0].iov_base == NULL);
-	mempool_free(&iproto_connection_pool, con);
+	mempool_free(&con->iproto_thread->iproto_connection_pool, con);
 }
 
 /* }}} iproto_connection */
@@ -1035,12 +1947,27 @@ tx_process_call(struct cmsg *msg);
 static void
 tx_process1(struct cmsg *msg);
 
+static void
+tx_process_batch(struct cmsg *msg);
+
 static void
 tx_process_select(struct cmsg *msg);
 
+static int
+tx_push_select_chunk(struct port *port, void *arg);
+
 static void
 tx_process_sql(struct cmsg *msg);
 
+static void
+tx_process_txn(struct cmsg *msg);
+
+static void
+tx_process_stream(struct cmsg *msg);
+
+static void
+tx_close_streams(struct iproto_connection *con);
+
 static void
 tx_reply_error(struct iproto_msg *msg);
 
@@ -1062,66 +1989,11 @@ net_end_join(struct cmsg *msg);
 static void
 net_end_subscribe(struct cmsg *msg);
 
-static const struct cmsg_hop misc_route[] = {
-	{ tx_process_misc, &net_pipe },
-	{ net_send_msg, NULL },
-};
-
-static const struct cmsg_hop call_route[] = {
-	{ tx_process_call, &net_pipe },
-	{ net_send_msg, NULL },
-};
-
-static const struct cmsg_hop select_route[] = {
-	{ tx_process_select, &net_pipe },
-	{ net_send_msg, NULL },
-};
-
-static const struct cmsg_hop process1_route[] = {
-	{ tx_process1, &net_pipe },
-	{ net_send_msg, NULL },
-};
-
-static const struct cmsg_hop sql_route[] = {
-	{ tx_process_sql, &net_pipe },
-	{ net_send_msg, NULL },
-};
-
-static const struct cmsg_hop *dml_route[IPROTO_TYPE_STAT_MAX] = {
-	NULL,                                   /* IPROTO_OK */
-	select_route,                           /* IPROTO_SELECT */
-	process1_route,                         /* IPROTO_INSERT */
-	process1_route,                         /* IPROTO_REPLACE */
-	process1_route,                         /* IPROTO_UPDATE */
-	process1_route,                         /* IPROTO_DELETE */
-	call_route,                             /* IPROTO_CALL_16 */
-	misc_route,                             /* IPROTO_AUTH */
-	call_route,                             /* IPROTO_EVAL */
-	process1_route,                         /* IPROTO_UPSERT */
-	call_route,                             /* IPROTO_CALL */
-	sql_route,                              /* IPROTO_EXECUTE */
-	NULL,                                   /* IPROTO_NOP */
-};
-
-static const struct cmsg_hop join_route[] = {
-	{ tx_process_join_subscribe, &net_pipe },
-	{ net_end_join, NULL },
-};
-
-static const struct cmsg_hop subscribe_route[] = {
-	{ tx_process_join_subscribe, &net_pipe },
-	{ net_end_subscribe, NULL },
-};
-
-static const struct cmsg_hop error_route[] = {
-	{ tx_reply_iproto_error, &net_pipe },
-	{ net_send_error, NULL },
-};
-
 static void
 iproto_msg_decode(struct iproto_msg *msg, const char **pos, const char *reqend,
 		  bool *stop_input)
 {
+	struct iproto_thread *iproto_thread = msg->connection->iproto_thread;
 	uint8_t type;
 
 	if (xrow_header_decode(&msg->header, pos, reqend))
@@ -1145,53 +2017,87 @@ iproto_msg_decode(struct iproto_msg *msg, const char **pos, const char *reqend,
 		if (xrow_decode_dml(&msg->header, &msg->dml,
 				    dml_request_key_map(type)))
 			goto error;
-		assert(type < sizeof(dml_route)/sizeof(*dml_route));
-		cmsg_init(&msg->base, dml_route[type]);
+		assert(type < lengthof(iproto_thread->dml_route));
+		cmsg_init(&msg->base, iproto_thread->dml_route[type]);
 		break;
 	case IPROTO_CALL_16:
 	case IPROTO_CALL:
 	case IPROTO_EVAL:
 		if (xrow_decode_call(&msg->header, &msg->call))
 			goto error;
-		cmsg_init(&msg->base, call_route);
+		cmsg_init(&msg->base, iproto_thread->call_route);
 		break;
 	case IPROTO_EXECUTE:
+	case IPROTO_PREPARE:
 		if (xrow_decode_sql(&msg->header, &msg->sql, &fiber()->gc))
 			goto error;
-		cmsg_init(&msg->base, sql_route);
+		cmsg_init(&msg->base, iproto_thread->sql_route);
+		break;
+	case IPROTO_BEGIN:
+	case IPROTO_COMMIT:
+	case IPROTO_ROLLBACK:
+		if (msg->header.stream_id == 0) {
+			diag_set(ClientError, ER_MISSING_REQUEST_FIELD,
+				 iproto_key_name(IPROTO_STREAM_ID));
+			goto error;
+		}
+		cmsg_init(&msg->base, iproto_thread->txn_route);
 		break;
 	case IPROTO_PING:
-		cmsg_init(&msg->base, misc_route);
+		cmsg_init(&msg->base, iproto_thread->misc_route);
 		break;
 	case IPROTO_JOIN:
-		cmsg_init(&msg->base, join_route);
+		cmsg_init(&msg->base, iproto_thread->join_route);
 		*stop_input = true;
 		break;
 	case IPROTO_SUBSCRIBE:
-		cmsg_init(&msg->base, subscribe_route);
+		cmsg_init(&msg->base, iproto_thread->subscribe_route);
 		*stop_input = true;
 		break;
 	case IPROTO_VOTE_DEPRECATED:
 	case IPROTO_VOTE:
-		cmsg_init(&msg->base, misc_route);
+		cmsg_init(&msg->base, iproto_thread->misc_route);
 		break;
 	case IPROTO_AUTH:
 		if (xrow_decode_auth(&msg->header, &msg->auth))
 			goto error;
-		cmsg_init(&msg->base, misc_route);
+		cmsg_init(&msg->base, iproto_thread->misc_route);
+		break;
+	case IPROTO_COMPRESS: {
+		/*
+		 * The client is ready to receive compressed
+		 * output as soon as it sends the request, so
+		 * switch the connection right away, the reply
+		 * is compressed too.
+		 */
+		uint32_t compression;
+		if (xrow_decode_compress(&msg->header, &compression))
+			goto error;
+		msg->connection->compression = compression;
+		cmsg_init(&msg->base, iproto_thread->misc_route);
 		break;
+	}
 	default:
 		diag_set(ClientError, ER_UNKNOWN_REQUEST_TYPE,
 			 (uint32_t) type);
 		goto error;
 	}
+	if (msg->header.stream_id != 0 && type != IPROTO_JOIN &&
+	    type != IPROTO_SUBSCRIBE) {
+		/*
+		 * Requests of a stream are executed one by one
+		 * in a fiber of the stream, see tx_process_stream().
+		 */
+		msg->stream_route = msg->base.route;
+		cmsg_init(&msg->base, iproto_thread->stream_route);
+	}
 	return;
 error:
 	/** Log and send the error. */
 	diag_log();
 	diag_create(&msg->diag);
 	diag_move(&fiber()->diag, &msg->diag);
-	cmsg_init(&msg->base, error_route);
+	cmsg_init(&msg->base, iproto_thread->error_route);
 }
 
 static void
@@ -1223,6 +2129,8 @@ tx_process_disconnect(struct cmsg *m)
 {
 	struct iproto_connection *con =
 		container_of(m, struct iproto_connection, disconnect);
+	if (con->tx.streams != NULL)
+		tx_close_streams(con);
 	if (con->session) {
 		tx_fiber_init(con->session, 0);
 		if (! rlist_empty(&session_on_disconnect))
@@ -1236,6 +2144,8 @@ tx_process_disconnect(struct cmsg *m)
 	 */
 	obuf_destroy(&con->obuf[0]);
 	obuf_destroy(&con->obuf[1]);
+	iproto_tuple_refs_truncate(&con->refs[0], 0);
+	iproto_tuple_refs_truncate(&con->refs[1], 0);
 }
 
 /**
@@ -1284,7 +2194,8 @@ tx_discard_input(struct iproto_msg *msg)
 		{ net_discard_input, NULL },
 	};
 	cmsg_init(&msg->discard_input, discard_input_route);
-	cpipe_push(&net_pipe, &msg->discard_input);
+	cpipe_push(&msg->connection->iproto_thread->net_pipe,
+		   &msg->discard_input);
 }
 
 /**
@@ -1313,8 +2224,11 @@ tx_accept_wpos(struct iproto_connection *con, const struct iproto_wpos *wpos)
 		 * guaranteed to have been flushed first, since
 		 * buffers are never flushed out of order.
 		 */
-		if (obuf_size(prev) != 0)
+		if (obuf_size(prev) != 0) {
 			obuf_reset(prev);
+			iproto_tuple_refs_truncate(
+				iproto_connection_refs(con, prev), 0);
+		}
 	}
 	if (obuf_size(con->tx.p_obuf) != 0 && obuf_size(prev) == 0) {
 		/*
@@ -1345,7 +2259,7 @@ tx_reply_error(struct iproto_msg *msg)
 	struct obuf *out = msg->connection->tx.p_obuf;
 	iproto_reply_error(out, diag_last_error(&fiber()->diag),
 			   msg->header.sync, ::schema_version);
-	iproto_wpos_create(&msg->wpos, out);
+	iproto_connection_wpos_create(msg->connection, &msg->wpos, out);
 }
 
 /**
@@ -1359,7 +2273,7 @@ tx_reply_iproto_error(struct cmsg *m)
 	struct obuf *out = msg->connection->tx.p_obuf;
 	iproto_reply_error(out, diag_last_error(&msg->diag),
 			   msg->header.sync, ::schema_version);
-	iproto_wpos_create(&msg->wpos, out);
+	iproto_connection_wpos_create(msg->connection, &msg->wpos, out);
 }
 
 /** Inject a short delay on tx request processing for testing. */
@@ -1372,12 +2286,47 @@ tx_inject_delay()
 	});
 }
 
+/**
+ * Copy the request body to the fiber region. A request of a
+ * transaction is written to WAL only on commit, when the
+ * input buffer it has been read into is long gone.
+ */
+static int
+tx_stream_copy_request(struct request *request)
+{
+	struct region *region = &fiber()->gc;
+	const char **data[] = {
+		&request->key, &request->tuple, &request->ops,
+	};
+	const char **data_end[] = {
+		&request->key_end, &request->tuple_end, &request->ops_end,
+	};
+	for (unsigned i = 0; i < lengthof(data); i++) {
+		if (*data[i] == NULL)
+			continue;
+		size_t size = *data_end[i] - *data[i];
+		char *copy = (char *) region_alloc(region, size);
+		if (copy == NULL) {
+			diag_set(OutOfMemory, size, "region_alloc", "request");
+			return -1;
+		}
+		memcpy(copy, *data[i], size);
+		*data[i] = copy;
+		*data_end[i] = copy + size;
+	}
+	/* Make txn encode its own redo row from the copy. */
+	request->header = NULL;
+	return 0;
+}
+
 static void
 tx_process1(struct cmsg *m)
 {
 	struct iproto_msg *msg = tx_accept_msg(m);
 	if (tx_check_schema(msg->header.schema_version))
 		goto error;
+	if (in_txn() != NULL && tx_stream_copy_request(&msg->dml) != 0)
+		goto error;
 
 	struct tuple *tuple;
 	struct obuf_svp svp;
@@ -1392,12 +2341,178 @@ tx_process1(struct cmsg *m)
 		goto error;
 	iproto_reply_select(out, &svp, msg->header.sync, ::schema_version,
 			    tuple != 0);
-	iproto_wpos_create(&msg->wpos, out);
+	iproto_connection_wpos_create(msg->connection, &msg->wpos, out);
 	return;
 error:
 	tx_reply_error(msg);
 }
 
+/**
+ * A batch can be executed in one transaction only if all its
+ * requests go to memtx spaces: memtx doesn't yield executing
+ * a statement, and a transaction can't span several engines.
+ */
+static bool
+tx_batch_is_single_txn(struct stailq *batch)
+{
+	struct iproto_msg *msg;
+	stailq_foreach_entry(msg, batch, in_batch) {
+		struct space *space = space_by_id(msg->dml.space_id);
+		if (space != NULL && !space_is_memtx(space))
+			return false;
+	}
+	return true;
+}
+
+/**
+ * Execute a batch of DML requests in one transaction and write
+ * a reply to each of them. A failed request is rolled back
+ * alone and doesn't affect the others. If the transaction
+ * fails to commit, all requests which succeeded get the
+ * commit error.
+ */
+static void
+tx_process_batch_txn(struct iproto_connection *con, struct stailq *batch)
+{
+	struct iproto_msg *msg;
+	tx_inject_delay();
+	stailq_foreach_entry(msg, batch, in_batch) {
+		tx_fiber_init(con->session, msg->header.sync);
+		diag_create(&msg->diag);
+		msg->batch_result = NULL;
+		struct tuple *tuple;
+		if (tx_check_schema(msg->header.schema_version) != 0 ||
+		    box_process1(&msg->dml, &tuple) != 0) {
+			diag_move(diag_get(), &msg->diag);
+			continue;
+		}
+		if (tuple != NULL) {
+			tuple_ref(tuple);
+			msg->batch_result = tuple;
+		}
+	}
+	struct error *commit_error = NULL;
+	if (box_txn_commit() != 0)
+		commit_error = diag_last_error(diag_get());
+	/* Commit yields, so take an obuf only after it. */
+	struct obuf *out = con->tx.p_obuf;
+	stailq_foreach_entry(msg, batch, in_batch) {
+		struct tuple *tuple = msg->batch_result;
+		struct error *e = diag_last_error(&msg->diag);
+		if (e == NULL)
+			e = commit_error;
+		struct obuf_svp svp;
+		if (e == NULL && iproto_prepare_select(out, &svp) == 0) {
+			if (tuple == NULL || tuple_to_obuf(tuple, out) == 0) {
+				iproto_reply_select(out, &svp,
+						    msg->header.sync,
+						    ::schema_version,
+						    tuple != NULL);
+			} else {
+				obuf_rollback_to_svp(out, &svp);
+				e = diag_last_error(diag_get());
+			}
+		} else if (e == NULL) {
+			e = diag_last_error(diag_get());
+		}
+		if (e != NULL) {
+			iproto_reply_error(out, e, msg->header.sync,
+					   ::schema_version);
+		}
+		diag_clear(&msg->diag);
+		if (tuple != NULL)
+			tuple_unref(tuple);
+	}
+}
+
+/**
+ * Process DML requests read from a connection at once, see
+ * iproto_set_batch_dml(). They are executed in one transaction
+ * whenever possible, so that they are written to WAL with a
+ * single journal write. Otherwise they are executed one by one
+ * as usual. Either way, each request gets its own reply.
+ */
+static void
+tx_process_batch(struct cmsg *m)
+{
+	struct iproto_msg *first = tx_accept_msg(m);
+	struct iproto_connection *con = first->connection;
+	struct iproto_thread *iproto_thread = con->iproto_thread;
+	struct stailq batch;
+	stailq_create(&batch);
+	stailq_add_entry(&batch, first, in_batch);
+	stailq_concat(&batch, &first->batch);
+
+	struct iproto_msg *msg, *next;
+	/*
+	 * All requests of the batch have the same write position,
+	 * which has been accepted with the first one.
+	 */
+	stailq_foreach_entry(msg, &batch, in_batch)
+		msg->wpos.obuf = NULL;
+	if (tx_batch_is_single_txn(&batch) && box_txn_begin() == 0) {
+		tx_process_batch_txn(con, &batch);
+		iproto_connection_wpos_create(con, &first->wpos,
+					      con->tx.p_obuf);
+	} else {
+		stailq_foreach_entry(msg, &batch, in_batch)
+			tx_process1(&msg->base);
+		first->wpos = stailq_last_entry(&batch, struct iproto_msg,
+						in_batch)->wpos;
+	}
+	/*
+	 * Send the replies back along with the first request.
+	 * A request may be freed by the network thread as soon
+	 * as it is pushed.
+	 */
+	stailq_foreach_entry_safe(msg, next, &batch, in_batch) {
+		if (msg == first)
+			continue;
+		msg->wpos = first->wpos;
+		cmsg_init(&msg->base, &iproto_thread->batch_route[1]);
+		cpipe_push(&iproto_thread->net_pipe, &msg->base);
+	}
+}
+
+/**
+ * Dump a SELECT result to the output buffer. Big tuples are
+ * not copied: they are referenced and sent to the socket right
+ * from the tuple memory (see iproto_tuple_ref).
+ * @param con Connection.
+ * @param port Port with the result.
+ * @param out Output buffer.
+ * @param[out] ref_size Size of the referenced tuple data, which
+ *             isn't stored in the buffer.
+ *
+ * @retval -1 Memory error.
+ * @retval >= 0 Number of dumped tuples.
+ */
+static int
+tx_dump_select(struct iproto_connection *con, struct port *port,
+	       struct obuf *out, uint32_t *ref_size)
+{
+	struct port_tuple *port_tuple = port_tuple(port);
+	struct iproto_tuple_refs *refs = iproto_connection_refs(con, out);
+	*ref_size = 0;
+	struct port_tuple_entry *pe;
+	for (pe = port_tuple->first; pe != NULL; pe = pe->next) {
+		uint32_t size;
+		const char *data = tuple_data_range(pe->tuple, &size);
+		if (size >= IPROTO_TUPLE_REF_SIZE_MIN &&
+		    iproto_tuple_refs_add(refs, pe->tuple, data, size,
+					  obuf_size(out)) == 0) {
+			*ref_size += size;
+		} else if (tuple_to_obuf(pe->tuple, out) != 0) {
+			return -1;
+		}
+		ERROR_INJECT(ERRINJ_PORT_DUMP, {
+			diag_set(OutOfMemory, size, "obuf_dup", "data");
+			return -1;
+		});
+	}
+	return port_tuple->size;
+}
+
 static void
 tx_process_select(struct cmsg *m)
 {
@@ -1405,6 +2520,9 @@ tx_process_select(struct cmsg *m)
 	struct obuf *out;
 	struct obuf_svp svp;
 	struct port port;
+	struct iproto_tuple_refs *refs;
+	size_t ref_count;
+	uint32_t ref_size;
 	int count;
 	int rc;
 	struct request *req = &msg->dml;
@@ -1412,9 +2530,21 @@ tx_process_select(struct cmsg *m)
 		goto error;
 
 	tx_inject_delay();
-	rc = box_select(req->space_id, req->index_id,
-			req->iterator, req->offset, req->limit,
-			req->key, req->key_end, &port);
+	/*
+	 * Streaming a result yields, which would abort a memtx
+	 * transaction, so in a transaction the result is sent
+	 * at once.
+	 */
+	if (req->chunk_size != 0 && in_txn() == NULL) {
+		rc = box_select_chunked(req->space_id, req->index_id,
+					req->iterator, req->offset, req->limit,
+					req->key, req->key_end, req->chunk_size,
+					tx_push_select_chunk, msg, &port);
+	} else {
+		rc = box_select(req->space_id, req->index_id,
+				req->iterator, req->offset, req->limit,
+				req->key, req->key_end, &port);
+	}
 	if (rc < 0)
 		goto error;
 
@@ -1426,16 +2556,19 @@ tx_process_select(struct cmsg *m)
 	/*
 	 * SELECT output format has not changed since Tarantool 1.6
 	 */
-	count = port_dump_msgpack_16(&port, out);
+	refs = iproto_connection_refs(msg->connection, out);
+	ref_count = refs->count;
+	count = tx_dump_select(msg->connection, &port, out, &ref_size);
 	port_destroy(&port);
 	if (count < 0) {
 		/* Discard the prepared select. */
 		obuf_rollback_to_svp(out, &svp);
+		iproto_tuple_refs_truncate(refs, ref_count);
 		goto error;
 	}
-	iproto_reply_select(out, &svp, msg->header.sync,
-			    ::schema_version, count);
-	iproto_wpos_create(&msg->wpos, out);
+	iproto_reply_select_ext(out, &svp, msg->header.sync,
+				::schema_version, count, ref_size);
+	iproto_connection_wpos_create(msg->connection, &msg->wpos, out);
 	return;
 error:
 	tx_reply_error(msg);
@@ -1457,6 +2590,14 @@ tx_process_call(struct cmsg *m)
 	struct iproto_msg *msg = tx_accept_msg(m);
 	if (tx_check_schema(msg->header.schema_version))
 		goto error;
+	/*
+	 * A function is executed in its own transaction, it
+	 * can't join a transaction of a stream.
+	 */
+	if (in_txn() != NULL) {
+		diag_set(ClientError, ER_ACTIVE_TRANSACTION);
+		goto error;
+	}
 
 	/*
 	 * CALL/EVAL should copy its arguments so we can discard
@@ -1524,7 +2665,7 @@ tx_process_call(struct cmsg *m)
 
 	iproto_reply_select(out, &svp, msg->header.sync,
 			    ::schema_version, count);
-	iproto_wpos_create(&msg->wpos, out);
+	iproto_connection_wpos_create(msg->connection, &msg->wpos, out);
 	return;
 error:
 	tx_reply_error(msg);
@@ -1548,6 +2689,7 @@ tx_process_misc(struct cmsg *m)
 					   ::schema_version);
 			break;
 		case IPROTO_PING:
+		case IPROTO_COMPRESS:
 			iproto_reply_ok_xc(out, msg->header.sync,
 					   ::schema_version);
 			break;
@@ -1564,7 +2706,7 @@ tx_process_misc(struct cmsg *m)
 		default:
 			unreachable();
 		}
-		iproto_wpos_create(&msg->wpos, out);
+		iproto_connection_wpos_create(msg->connection, &msg->wpos, out);
 	} catch (Exception *e) {
 		tx_reply_error(msg);
 	}
@@ -1579,13 +2721,37 @@ tx_process_sql(struct cmsg *m)
 	struct iproto_msg *msg = tx_accept_msg(m);
 	struct obuf *out;
 	struct sql_response response;
+	uint32_t stmt_id;
 
 	tx_fiber_init(msg->connection->session, msg->header.sync);
 
 	if (tx_check_schema(msg->header.schema_version))
 		goto error;
-	assert(msg->header.type == IPROTO_EXECUTE);
 	tx_inject_delay();
+	if (msg->header.type == IPROTO_PREPARE &&
+	    msg->sql.sql_text == NULL) {
+		if (sql_unprepare(msg->sql.stmt_id) != 0)
+			goto error;
+		out = msg->connection->tx.p_obuf;
+		if (iproto_reply_ok(out, msg->header.sync,
+				    ::schema_version) != 0)
+			goto error;
+		iproto_connection_wpos_create(msg->connection, &msg->wpos,
+					      out);
+		return;
+	}
+	if (msg->header.type == IPROTO_PREPARE) {
+		if (sql_prepare(&msg->sql, &stmt_id) != 0)
+			goto error;
+		out = msg->connection->tx.p_obuf;
+		if (sql_prepare_response_dump(msg->header.sync, stmt_id,
+					      out) != 0)
+			goto error;
+		iproto_connection_wpos_create(msg->connection, &msg->wpos,
+					      out);
+		return;
+	}
+	assert(msg->header.type == IPROTO_EXECUTE);
 	if (sql_prepare_and_execute(&msg->sql, &response, &fiber()->gc) != 0)
 		goto error;
 	/*
@@ -1595,12 +2761,251 @@ tx_process_sql(struct cmsg *m)
 	out = msg->connection->tx.p_obuf;
 	if (sql_response_dump(&response, out) != 0)
 		goto error;
-	iproto_wpos_create(&msg->wpos, out);
+	iproto_connection_wpos_create(msg->connection, &msg->wpos, out);
 	return;
 error:
 	tx_reply_error(msg);
 }
 
+static void
+tx_process_txn(struct cmsg *m)
+{
+	struct iproto_msg *msg = tx_accept_msg(m);
+	struct obuf *out;
+	int rc;
+
+	if (tx_check_schema(msg->header.schema_version))
+		goto error;
+	switch (msg->header.type) {
+	case IPROTO_BEGIN:
+		rc = box_txn_begin();
+		break;
+	case IPROTO_COMMIT:
+		rc = box_txn_commit();
+		break;
+	case IPROTO_ROLLBACK:
+		rc = box_txn_rollback();
+		break;
+	default:
+		unreachable();
+	}
+	if (rc != 0)
+		goto error;
+	rmean_collect(rmean_box, msg->header.type, 1);
+	/* Commit yields, so take an obuf only after it. */
+	out = msg->connection->tx.p_obuf;
+	if (iproto_reply_ok(out, msg->header.sync, ::schema_version) != 0)
+		goto error;
+	iproto_connection_wpos_create(msg->connection, &msg->wpos, out);
+	return;
+error:
+	tx_reply_error(msg);
+}
+
+/* {{{ iproto streams */
+
+/**
+ * A stream is a sequence of requests of one connection which
+ * share the same IPROTO_STREAM_ID. Requests of a stream are
+ * executed one after another in a dedicated fiber, so the
+ * stream can hold a transaction open between requests:
+ * IPROTO_BEGIN, then any number of DML or SQL requests,
+ * then IPROTO_COMMIT or IPROTO_ROLLBACK.
+ *
+ * The fiber lives as long as the stream has pending
+ * requests or an active transaction. A transaction which is
+ * still active when the connection is closed is rolled back.
+ *
+ * A connection may have at most IPROTO_STREAMS_MAX streams.
+ * A stream waiting for the next request of its transaction
+ * holds no iproto message, but it keeps a fiber and the
+ * transaction. So streams count against net_msg_max too:
+ * all connections of a network thread together may have at
+ * most half of net_msg_max streams, the rest is left for
+ * requests, including those that end stream transactions.
+ */
+struct iproto_stream {
+	/** Stream id, unique within a connection. */
+	uint64_t id;
+	/** The connection the stream belongs to. */
+	struct iproto_connection *connection;
+	/** Requests waiting to be executed, in arrival order. */
+	struct stailq pending;
+	/** Fiber executing requests of the stream. */
+	struct fiber *fiber;
+	/** Signaled when a request is added to the stream. */
+	struct fiber_cond cond;
+	/** Set when the connection is being closed. */
+	bool is_closed;
+};
+
+static struct mempool iproto_stream_pool;
+
+static int
+iproto_stream_f(va_list ap)
+{
+	struct iproto_stream *stream = va_arg(ap, struct iproto_stream *);
+	struct iproto_connection *con = stream->connection;
+	while (true) {
+		if (stailq_empty(&stream->pending)) {
+			if (in_txn() == NULL || stream->is_closed)
+				break;
+			fiber_cond_wait(&stream->cond);
+			continue;
+		}
+		struct iproto_msg *msg =
+			stailq_shift_entry(&stream->pending,
+					   struct iproto_msg, in_stream);
+		cmsg_init(&msg->base, msg->stream_route);
+		cmsg_deliver(&msg->base);
+		/* The region keeps the requests of a transaction. */
+		if (in_txn() == NULL)
+			fiber_gc();
+	}
+	if (in_txn() != NULL)
+		txn_rollback();
+	fiber_gc();
+	mh_int_t k = mh_i64ptr_find(con->tx.streams, stream->id, NULL);
+	assert(k != mh_end(con->tx.streams));
+	mh_i64ptr_del(con->tx.streams, k, NULL);
+	assert(con->iproto_thread->tx_stream_count > 0);
+	con->iproto_thread->tx_stream_count--;
+	fiber_cond_broadcast(&con->tx.streams_cond);
+	mempool_free(&iproto_stream_pool, stream);
+	return 0;
+}
+
+static struct iproto_stream *
+tx_stream_find(struct iproto_connection *con, uint64_t id)
+{
+	if (con->tx.streams == NULL)
+		return NULL;
+	mh_int_t k = mh_i64ptr_find(con->tx.streams, id, NULL);
+	if (k == mh_end(con->tx.streams))
+		return NULL;
+	return (struct iproto_stream *) mh_i64ptr_node(con->tx.streams, k)->val;
+}
+
+/**
+ * Create a stream of a connection. The fiber of the stream
+ * is started by the caller once the first request is queued.
+ */
+static struct iproto_stream *
+tx_stream_new(struct iproto_connection *con, uint64_t id)
+{
+	struct iproto_thread *iproto_thread = con->iproto_thread;
+	if (con->tx.streams != NULL &&
+	    mh_size(con->tx.streams) >= IPROTO_STREAMS_MAX) {
+		diag_set(ClientError, ER_TOO_MANY_STREAMS,
+			 IPROTO_STREAMS_MAX);
+		return NULL;
+	}
+	if (iproto_thread->tx_stream_count >= iproto_msg_max / 2) {
+		diag_set(ClientError, ER_TOO_MANY_STREAMS,
+			 iproto_msg_max / 2);
+		return NULL;
+	}
+	if (con->tx.streams == NULL) {
+		con->tx.streams = mh_i64ptr_new();
+		if (con->tx.streams == NULL) {
+			diag_set(OutOfMemory, sizeof(*con->tx.streams),
+				 "mh_i64ptr_new", "streams");
+			return NULL;
+		}
+	}
+	struct iproto_stream *stream = (struct iproto_stream *)
+		mempool_alloc(&iproto_stream_pool);
+	if (stream == NULL) {
+		diag_set(OutOfMemory, sizeof(*stream), "mempool_alloc",
+			 "stream");
+		return NULL;
+	}
+	const struct mh_i64ptr_node_t node = { id, stream };
+	mh_int_t k = mh_i64ptr_put(con->tx.streams, &node, NULL, NULL);
+	if (k == mh_end(con->tx.streams)) {
+		mempool_free(&iproto_stream_pool, stream);
+		diag_set(OutOfMemory, sizeof(node), "mh_i64ptr_put",
+			 "stream");
+		return NULL;
+	}
+	char name[FIBER_NAME_MAX];
+	snprintf(name, sizeof(name), "iproto_stream_%llu",
+		 (unsigned long long) id);
+	stream->fiber = fiber_new(name, iproto_stream_f);
+	if (stream->fiber == NULL) {
+		mh_i64ptr_del(con->tx.streams, k, NULL);
+		mempool_free(&iproto_stream_pool, stream);
+		return NULL;
+	}
+	stream->id = id;
+	stream->connection = con;
+	stailq_create(&stream->pending);
+	fiber_cond_create(&stream->cond);
+	stream->is_closed = false;
+	iproto_thread->tx_stream_count++;
+	return stream;
+}
+
+/**
+ * Queue a request to the fiber of its stream, creating
+ * the stream on the first request.
+ */
+static void
+tx_process_stream(struct cmsg *m)
+{
+	struct iproto_msg *msg = (struct iproto_msg *) m;
+	struct iproto_connection *con = msg->connection;
+	/*
+	 * The request may be executed much later, when the
+	 * flushed write position it carries is stale. Accept it
+	 * now and only let the stream fiber rotate the buffers.
+	 */
+	tx_accept_wpos(con, &msg->wpos);
+	msg->wpos.obuf = NULL;
+
+	struct iproto_stream *stream = tx_stream_find(con,
+						      msg->header.stream_id);
+	if (stream != NULL) {
+		stailq_add_tail_entry(&stream->pending, msg, in_stream);
+		fiber_cond_signal(&stream->cond);
+		return;
+	}
+	stream = tx_stream_new(con, msg->header.stream_id);
+	if (stream == NULL) {
+		struct iproto_thread *iproto_thread = con->iproto_thread;
+		tx_fiber_init(con->session, msg->header.sync);
+		tx_reply_error(msg);
+		cmsg_init(&msg->base, &iproto_thread->misc_route[1]);
+		cpipe_push(&iproto_thread->net_pipe, &msg->base);
+		return;
+	}
+	stailq_add_tail_entry(&stream->pending, msg, in_stream);
+	fiber_start(stream->fiber, stream);
+}
+
+/**
+ * Roll back transactions of all streams of a connection and
+ * wait until the stream fibers are finished.
+ */
+static void
+tx_close_streams(struct iproto_connection *con)
+{
+	struct mh_i64ptr_t *streams = con->tx.streams;
+	mh_int_t k;
+	mh_foreach(streams, k) {
+		struct iproto_stream *stream = (struct iproto_stream *)
+			mh_i64ptr_node(streams, k)->val;
+		stream->is_closed = true;
+		fiber_cond_signal(&stream->cond);
+	}
+	while (mh_size(streams) > 0)
+		fiber_cond_wait(&con->tx.streams_cond);
+	mh_i64ptr_delete(streams);
+	con->tx.streams = NULL;
+}
+
+/* }}} */
+
 static void
 tx_process_join_subscribe(struct cmsg *m)
 {
@@ -1651,10 +3056,10 @@ net_send_msg(struct cmsg *m)
 		con->long_poll_count--;
 	}
 	con->wend = msg->wpos;
+	rmean_collect(con->iproto_thread->rmean, IPROTO_RESPONSES, 1);
 
 	if (evio_has_fd(&con->output)) {
-		if (! ev_is_active(&con->output))
-			ev_feed_event(con->loop, &con->output, EV_WRITE);
+		iproto_connection_feed_output(con);
 	} else if (iproto_connection_is_idle(con)) {
 		iproto_connection_close(con);
 	}
@@ -1734,7 +3139,7 @@ tx_process_connect(struct cmsg *m)
 			if (session_run_on_connect_triggers(con->session) != 0)
 				diag_raise();
 		}
-		iproto_wpos_create(&msg->wpos, out);
+		iproto_connection_wpos_create(msg->connection, &msg->wpos, out);
 	} catch (Exception *e) {
 		tx_reply_error(msg);
 		msg->close_connection = true;
@@ -1757,7 +3162,10 @@ net_send_greeting(struct cmsg *m)
 						 obuf_iovcnt(out));
 
 			/* Count statistics */
-			rmean_collect(rmean_net, IPROTO_SENT, nwr);
+			rmean_collect(con->iproto_thread->rmean, IPROTO_SENT,
+				      nwr);
+			rmean_collect(con->iproto_thread->rmean,
+				      IPROTO_WRITES, 1);
 		} catch (Exception *e) {
 			e->log();
 		}
@@ -1778,24 +3186,22 @@ net_send_greeting(struct cmsg *m)
 	iproto_msg_delete(msg);
 }
 
-static const struct cmsg_hop connect_route[] = {
-	{ tx_process_connect, &net_pipe },
-	{ net_send_greeting, NULL },
-};
-
 /** }}} */
 
 /**
  * Create a connection and start input.
  */
 static void
-iproto_on_accept(struct evio_service * /* service */, int fd,
+iproto_on_accept(struct evio_service *service, int fd,
 		 struct sockaddr *addr, socklen_t addrlen)
 {
 	(void) addr;
 	(void) addrlen;
+	struct iproto_thread *iproto_thread =
+		(struct iproto_thread *) service->on_accept_param;
 	struct iproto_msg *msg;
-	struct iproto_connection *con = iproto_connection_new(fd);
+	struct iproto_connection *con =
+		iproto_connection_new(iproto_thread, fd);
 	if (con == NULL)
 		goto error_conn;
 	/*
@@ -1806,64 +3212,84 @@ iproto_on_accept(struct evio_service * /* service */, int fd,
 	msg = iproto_msg_new(con);
 	if (msg == NULL)
 		goto error_msg;
-	cmsg_init(&msg->base, connect_route);
+	cmsg_init(&msg->base, iproto_thread->connect_route);
 	msg->p_ibuf = con->p_ibuf;
 	msg->wpos = con->wpos;
 	msg->close_connection = false;
-	cpipe_push(&tx_pipe, &msg->base);
+	cpipe_push(&iproto_thread->tx_pipe, &msg->base);
 	return;
 error_msg:
-	mempool_free(&iproto_connection_pool, con);
+	mempool_free(&iproto_thread->iproto_connection_pool, con);
 error_conn:
 	close(fd);
 	return;
 }
 
-static struct evio_service binary; /* iproto binary listener */
+/**
+ * Stop accepting connections in a thread. The listening socket
+ * of the first thread is closed, the rest detach from it.
+ */
+static void
+iproto_thread_stop_listen(struct iproto_thread *iproto_thread)
+{
+	if (!evio_service_is_active(&iproto_thread->binary))
+		return;
+	if (iproto_thread->id == 0)
+		evio_service_stop(&iproto_thread->binary);
+	else
+		evio_service_detach(&iproto_thread->binary);
+}
 
 /**
  * The network io thread main function:
  * begin serving the message bus.
  */
 static int
-net_cord_f(va_list /* ap */)
+net_cord_f(va_list ap)
 {
-	mempool_create(&iproto_msg_pool, &cord()->slabc,
+	struct iproto_thread *iproto_thread =
+		va_arg(ap, struct iproto_thread *);
+
+	mempool_create(&iproto_thread->iproto_msg_pool, &cord()->slabc,
 		       sizeof(struct iproto_msg));
-	mempool_create(&iproto_connection_pool, &cord()->slabc,
-		       sizeof(struct iproto_connection));
+	mempool_create(&iproto_thread->iproto_connection_pool,
+		       &cord()->slabc, sizeof(struct iproto_connection));
 
-	evio_service_init(loop(), &binary, "binary",
-			  iproto_on_accept, NULL);
+	evio_service_init(loop(), &iproto_thread->binary, "binary",
+			  iproto_on_accept, iproto_thread);
+	iproto_thread->binary.is_reuseport = iproto_threads_count > 1;
 
 
 	/* Init statistics counter */
-	rmean_net = rmean_new(rmean_net_strings, IPROTO_LAST);
+	iproto_thread->rmean = rmean_new(rmean_net_strings, IPROTO_LAST);
 
-	if (rmean_net == NULL) {
+	if (iproto_thread->rmean == NULL) {
 		tnt_raise(OutOfMemory, sizeof(struct rmean),
 			  "rmean", "struct rmean");
 	}
 
 	struct cbus_endpoint endpoint;
 	/* Create "net" endpoint. */
-	cbus_endpoint_create(&endpoint, "net", fiber_schedule_cb, fiber());
+	cbus_endpoint_create(&endpoint,
+			     tt_sprintf("net%u", iproto_thread->id),
+			     fiber_schedule_cb, fiber());
 	/* Create a pipe to "tx" thread. */
-	cpipe_create(&tx_pipe, "tx");
-	cpipe_set_max_input(&tx_pipe, iproto_msg_max / 2);
+	cpipe_create(&iproto_thread->tx_pipe, "tx");
+	cpipe_set_max_input(&iproto_thread->tx_pipe,
+			    iproto_thread->msg_max / 2);
 	/* Process incomming messages. */
 	cbus_loop(&endpoint);
 
-	cpipe_destroy(&tx_pipe);
+	cpipe_destroy(&iproto_thread->tx_pipe);
+	ZSTD_freeCCtx(iproto_thread->zctx);
 	/*
 	 * Nothing to do in the fiber so far, the service
 	 * will take care of creating events for incoming
 	 * connections.
 	 */
-	if (evio_service_is_active(&binary))
-		evio_service_stop(&binary);
+	iproto_thread_stop_listen(iproto_thread);
 
-	rmean_delete(rmean_net);
+	rmean_delete(iproto_thread->rmean);
 	return 0;
 }
 
@@ -1905,11 +3331,12 @@ static void
 tx_begin_push(struct iproto_connection *con)
 {
 	assert(! con->tx.is_push_sent);
-	cmsg_init(&con->kharon.base, push_route);
-	iproto_wpos_create(&con->kharon.wpos, con->tx.p_obuf);
+	cmsg_init(&con->kharon.base, con->iproto_thread->push_route);
+	iproto_connection_wpos_create(con, &con->kharon.wpos, con->tx.p_obuf);
 	con->tx.is_push_pending = false;
 	con->tx.is_push_sent = true;
-	cpipe_push(&net_pipe, (struct cmsg *) &con->kharon);
+	cpipe_push(&con->iproto_thread->net_pipe,
+		   (struct cmsg *) &con->kharon);
 }
 
 static void
@@ -1957,18 +3384,191 @@ iproto_session_push(struct session *session, uint64_t sync, struct port *port)
 
 /** }}} */
 
-/** Initialize the iproto subsystem and start network io thread */
-void
-iproto_init()
+/** {{{ Chunked SELECT implementation. */
+
+/**
+ * The flow message is in iproto. Make the new output visible to
+ * iproto and hold the message until the output is flushed.
+ * @param m Flow message.
+ */
+static void
+iproto_process_flow(struct cmsg *m)
+{
+	struct iproto_flow *flow = (struct iproto_flow *) m;
+	struct iproto_connection *con =
+		container_of(flow, struct iproto_connection, flow);
+	con->wend = flow->wpos;
+	con->is_flow_parked = true;
+	if (! evio_has_fd(&con->output))
+		iproto_connection_return_flow(con);
+	else if (! ev_is_active(&con->output))
+		ev_feed_event(con->loop, &con->output, EV_WRITE);
+}
+
+static void
+tx_end_flow(struct cmsg *m)
 {
-	slab_cache_create(&net_slabc, &runtime);
+	struct iproto_flow *flow = (struct iproto_flow *) m;
+	struct iproto_connection *con =
+		container_of(flow, struct iproto_connection, flow);
+	tx_accept_wpos(con, &flow->wpos);
+	con->tx.is_flow_sent = false;
+	fiber_cond_broadcast(&con->tx.flow_cond);
+}
 
-	if (cord_costart(&net_cord, "iproto", net_cord_f, NULL))
-		panic("failed to initialize iproto thread");
+/**
+ * Wait until iproto flushes the output of a connection, if it
+ * is too big to append more to it.
+ * @param con iproto connection.
+ *
+ * @retval -1 The connection is closed or the fiber is
+ *            cancelled.
+ * @retval  0 Success.
+ */
+static int
+tx_wait_output(struct iproto_connection *con)
+{
+	while (obuf_size(&con->obuf[0]) + obuf_size(&con->obuf[1]) >
+	       IPROTO_CHUNKED_OUTPUT_MAX) {
+		if (! con->tx.is_flow_sent) {
+			cmsg_init(&con->flow.base,
+				  con->iproto_thread->flow_route);
+			iproto_connection_wpos_create(con, &con->flow.wpos,
+						      con->tx.p_obuf);
+			con->tx.is_flow_sent = true;
+			cpipe_push(&con->iproto_thread->net_pipe,
+				   &con->flow.base);
+		}
+		fiber_cond_wait(&con->tx.flow_cond);
+		if (fiber_is_cancelled()) {
+			diag_set(FiberIsCancelled);
+			return -1;
+		}
+		if (! con->tx.is_flow_sent && con->flow.is_closed) {
+			diag_set(ClientError, ER_NO_CONNECTION);
+			return -1;
+		}
+	}
+	return 0;
+}
 
-	/* Create a pipe to "net" thread. */
-	cpipe_create(&net_pipe, "net");
-	cpipe_set_max_input(&net_pipe, iproto_msg_max / 2);
+/**
+ * Send a full chunk of a SELECT result to the client as
+ * IPROTO_CHUNK, like box.session.push() does.
+ */
+static int
+tx_push_select_chunk(struct port *port, void *arg)
+{
+	struct iproto_msg *msg = (struct iproto_msg *) arg;
+	struct iproto_connection *con = msg->connection;
+	if (iproto_session_push(con->session, msg->header.sync, port) != 0)
+		return -1;
+	return tx_wait_output(con);
+}
+
+/** }}} */
+
+/**
+ * Fill in cbus routes of a network thread. Every route
+ * forwards a message from tx back to the thread which has
+ * sent it.
+ */
+static void
+iproto_thread_init_routes(struct iproto_thread *iproto_thread)
+{
+	struct cpipe *net_pipe = &iproto_thread->net_pipe;
+	struct cpipe *tx_pipe = &iproto_thread->tx_pipe;
+
+	iproto_thread->disconnect_route[0] =
+		{ tx_process_disconnect, net_pipe };
+	iproto_thread->disconnect_route[1] =
+		{ net_finish_disconnect, NULL };
+	iproto_thread->push_route[0] = { iproto_process_push, tx_pipe };
+	iproto_thread->push_route[1] = { tx_end_push, NULL };
+	iproto_thread->flow_route[0] = { iproto_process_flow, NULL };
+	iproto_thread->flow_end_route[0] = { tx_end_flow, NULL };
+	iproto_thread->misc_route[0] = { tx_process_misc, net_pipe };
+	iproto_thread->misc_route[1] = { net_send_msg, NULL };
+	iproto_thread->call_route[0] = { tx_process_call, net_pipe };
+	iproto_thread->call_route[1] = { net_send_msg, NULL };
+	iproto_thread->select_route[0] = { tx_process_select, net_pipe };
+	iproto_thread->select_route[1] = { net_send_msg, NULL };
+	iproto_thread->process1_route[0] = { tx_process1, net_pipe };
+	iproto_thread->process1_route[1] = { net_send_msg, NULL };
+	iproto_thread->batch_route[0] = { tx_process_batch, net_pipe };
+	iproto_thread->batch_route[1] = { net_send_msg, NULL };
+	iproto_thread->sql_route[0] = { tx_process_sql, net_pipe };
+	iproto_thread->sql_route[1] = { net_send_msg, NULL };
+	iproto_thread->txn_route[0] = { tx_process_txn, net_pipe };
+	iproto_thread->txn_route[1] = { net_send_msg, NULL };
+	iproto_thread->stream_route[0] = { tx_process_stream, NULL };
+	iproto_thread->join_route[0] =
+		{ tx_process_join_subscribe, net_pipe };
+	iproto_thread->join_route[1] = { net_end_join, NULL };
+	iproto_thread->subscribe_route[0] =
+		{ tx_process_join_subscribe, net_pipe };
+	iproto_thread->subscribe_route[1] = { net_end_subscribe, NULL };
+	iproto_thread->error_route[0] = { tx_reply_iproto_error, net_pipe };
+	iproto_thread->error_route[1] = { net_send_error, NULL };
+	iproto_thread->connect_route[0] = { tx_process_connect, net_pipe };
+	iproto_thread->connect_route[1] = { net_send_greeting, NULL };
+
+	const struct cmsg_hop **dml_route = iproto_thread->dml_route;
+	memset(dml_route, 0, sizeof(iproto_thread->dml_route));
+	dml_route[IPROTO_SELECT] = iproto_thread->select_route;
+	dml_route[IPROTO_INSERT] = iproto_thread->process1_route;
+	dml_route[IPROTO_REPLACE] = iproto_thread->process1_route;
+	dml_route[IPROTO_UPDATE] = iproto_thread->process1_route;
+	dml_route[IPROTO_DELETE] = iproto_thread->process1_route;
+	dml_route[IPROTO_CALL_16] = iproto_thread->call_route;
+	dml_route[IPROTO_AUTH] = iproto_thread->misc_route;
+	dml_route[IPROTO_EVAL] = iproto_thread->call_route;
+	dml_route[IPROTO_UPSERT] = iproto_thread->process1_route;
+	dml_route[IPROTO_CALL] = iproto_thread->call_route;
+	dml_route[IPROTO_EXECUTE] = iproto_thread->sql_route;
+	dml_route[IPROTO_PREPARE] = iproto_thread->sql_route;
+	dml_route[IPROTO_BEGIN] = iproto_thread->txn_route;
+	dml_route[IPROTO_COMMIT] = iproto_thread->txn_route;
+	dml_route[IPROTO_ROLLBACK] = iproto_thread->txn_route;
+}
+
+/** Initialize the iproto subsystem and start network io threads */
+void
+iproto_init(int threads_count)
+{
+	assert(threads_count > 0 && threads_count <= IPROTO_THREADS_MAX);
+	iproto_threads = (struct iproto_thread *)
+		calloc(threads_count, sizeof(*iproto_threads));
+	if (iproto_threads == NULL)
+		panic("failed to allocate iproto threads");
+	iproto_threads_count = threads_count;
+	mempool_create(&iproto_tuple_ref_pool, &cord()->slabc,
+		       IPROTO_TUPLE_REF_BLOCK_SIZE *
+		       sizeof(struct iproto_tuple_ref));
+	mempool_create(&iproto_stream_pool, &cord()->slabc,
+		       sizeof(struct iproto_stream));
+
+	for (int i = 0; i < threads_count; i++) {
+		struct iproto_thread *iproto_thread = &iproto_threads[i];
+		iproto_thread->id = i;
+		iproto_thread->msg_max = iproto_msg_max;
+		rlist_create(&iproto_thread->stopped_connections);
+		iproto_thread->rate_limit = 0;
+		iproto_thread->batch_dml = false;
+		rlist_create(&iproto_thread->throttled_connections);
+		slab_cache_create(&iproto_thread->net_slabc, &runtime);
+		iproto_thread_init_routes(iproto_thread);
+
+		if (cord_costart(&iproto_thread->net_cord, "iproto",
+				 net_cord_f, iproto_thread))
+			panic("failed to initialize iproto thread");
+
+		/* Create a pipe to "net" thread. */
+		cpipe_create(&iproto_thread->net_pipe,
+			     tt_sprintf("net%u", iproto_thread->id));
+		cpipe_set_max_input(&iproto_thread->net_pipe,
+				    iproto_msg_max / 2);
+	}
 	struct session_vtab iproto_session_vtab = {
 		/* .push = */ iproto_session_push,
 		/* .fd = */ iproto_session_fd,
@@ -1980,6 +3580,8 @@ iproto_init()
 /** Available iproto configuration changes. */
 enum iproto_cfg_op {
 	IPROTO_CFG_MSG_MAX,
+	IPROTO_CFG_RATE_LIMIT,
+	IPROTO_CFG_BATCH_DML,
 	IPROTO_CFG_LISTEN
 };
 
@@ -1993,43 +3595,72 @@ struct iproto_cfg_msg: public cbus_call_msg
 {
 	/** Operation to execute in iproto thread. */
 	enum iproto_cfg_op op;
+	/** Thread to execute the operation in. */
+	struct iproto_thread *iproto_thread;
 	union {
 		/** New URI to bind to. */
 		const char *uri;
 
 		/** New iproto max message count. */
 		int iproto_msg_max;
+
+		/** New request rate limit of a connection. */
+		double rate_limit;
+
+		/** New value of iproto_thread::batch_dml. */
+		bool batch_dml;
 	};
 };
 
 static inline void
-iproto_cfg_msg_create(struct iproto_cfg_msg *msg, enum iproto_cfg_op op)
+iproto_cfg_msg_create(struct iproto_cfg_msg *msg, enum iproto_cfg_op op,
+		      struct iproto_thread *iproto_thread)
 {
 	memset(msg, 0, sizeof(*msg));
 	msg->op = op;
+	msg->iproto_thread = iproto_thread;
 }
 
 static int
 iproto_do_cfg_f(struct cbus_call_msg *m)
 {
 	struct iproto_cfg_msg *cfg_msg = (struct iproto_cfg_msg *) m;
+	struct iproto_thread *iproto_thread = cfg_msg->iproto_thread;
 	int old;
 	try {
 		switch (cfg_msg->op) {
 		case IPROTO_CFG_MSG_MAX:
-			cpipe_set_max_input(&tx_pipe,
+			cpipe_set_max_input(&iproto_thread->tx_pipe,
 					    cfg_msg->iproto_msg_max / 2);
-			old = iproto_msg_max;
-			iproto_msg_max = cfg_msg->iproto_msg_max;
-			if (old < iproto_msg_max)
-				iproto_resume();
+			old = iproto_thread->msg_max;
+			iproto_thread->msg_max = cfg_msg->iproto_msg_max;
+			if (old < iproto_thread->msg_max)
+				iproto_resume(iproto_thread);
+			break;
+		case IPROTO_CFG_RATE_LIMIT:
+			iproto_thread->rate_limit = cfg_msg->rate_limit;
+			iproto_thread_resume_throttled(iproto_thread);
+			break;
+		case IPROTO_CFG_BATCH_DML:
+			iproto_thread->batch_dml = cfg_msg->batch_dml;
 			break;
 		case IPROTO_CFG_LISTEN:
-			if (evio_service_is_active(&binary))
-				evio_service_stop(&binary);
-			if (cfg_msg->uri != NULL) {
-				evio_service_bind(&binary, cfg_msg->uri);
-				evio_service_listen(&binary);
+			iproto_thread_stop_listen(iproto_thread);
+			if (cfg_msg->uri == NULL)
+				break;
+			if (iproto_thread->id == 0) {
+				evio_service_bind(&iproto_thread->binary,
+						  cfg_msg->uri);
+				evio_service_listen(&iproto_thread->binary);
+			} else {
+				/*
+				 * The listener of the first thread
+				 * is only changed on request of tx,
+				 * which is waiting for this call, so
+				 * it's safe to read it here.
+				 */
+				evio_service_attach(&iproto_thread->binary,
+						    &iproto_threads[0].binary);
 			}
 			break;
 		default:
@@ -2044,30 +3675,118 @@ iproto_do_cfg_f(struct cbus_call_msg *m)
 static inline void
 iproto_do_cfg(struct iproto_cfg_msg *msg)
 {
-	if (cbus_call(&net_pipe, &tx_pipe, msg, iproto_do_cfg_f,
-		      NULL, TIMEOUT_INFINITY) != 0)
+	struct iproto_thread *iproto_thread = msg->iproto_thread;
+	if (cbus_call(&iproto_thread->net_pipe, &iproto_thread->tx_pipe,
+		      msg, iproto_do_cfg_f, NULL, TIMEOUT_INFINITY) != 0)
 		diag_raise();
 }
 
-void
-iproto_listen(const char *uri)
+static void
+iproto_thread_listen(struct iproto_thread *iproto_thread, const char *uri)
 {
 	struct iproto_cfg_msg cfg_msg;
-	iproto_cfg_msg_create(&cfg_msg, IPROTO_CFG_LISTEN);
+	iproto_cfg_msg_create(&cfg_msg, IPROTO_CFG_LISTEN, iproto_thread);
 	cfg_msg.uri = uri;
 	iproto_do_cfg(&cfg_msg);
 }
 
+void
+iproto_listen(const char *uri)
+{
+	/*
+	 * The listening socket is shared by all threads, so
+	 * detach the other threads before the first one closes
+	 * it, and attach them back once it's bound to the new
+	 * address.
+	 */
+	for (int i = 1; i < iproto_threads_count; i++)
+		iproto_thread_listen(&iproto_threads[i], NULL);
+	iproto_thread_listen(&iproto_threads[0], uri);
+	if (uri == NULL)
+		return;
+	for (int i = 1; i < iproto_threads_count; i++)
+		iproto_thread_listen(&iproto_threads[i], uri);
+}
+
 size_t
 iproto_mem_used(void)
 {
-	return slab_cache_used(&net_cord.slabc) + slab_cache_used(&net_slabc);
+	size_t mem = 0;
+	for (int i = 0; i < iproto_threads_count; i++) {
+		struct iproto_thread *iproto_thread = &iproto_threads[i];
+		mem += slab_cache_used(&iproto_thread->net_cord.slabc);
+		mem += slab_cache_used(&iproto_thread->net_slabc);
+	}
+	return mem;
 }
 
 void
 iproto_reset_stat(void)
 {
-	rmean_cleanup(rmean_net);
+	for (int i = 0; i < iproto_threads_count; i++)
+		rmean_cleanup(iproto_threads[i].rmean);
+}
+
+int
+iproto_rmean_foreach(rmean_cb cb, void *cb_ctx)
+{
+	for (size_t name = 0; name < IPROTO_LAST; name++) {
+		int64_t mean = 0;
+		int64_t total = 0;
+		for (int i = 0; i < iproto_threads_count; i++) {
+			struct rmean *rmean = iproto_threads[i].rmean;
+			mean += rmean_mean(rmean, name);
+			total += rmean_total(rmean, name);
+		}
+		int rc = cb(rmean_net_strings[name], mean, total, cb_ctx);
+		if (rc != 0)
+			return rc;
+	}
+	return 0;
+}
+
+int
+iproto_thread_count(void)
+{
+	return iproto_threads_count;
+}
+
+int
+iproto_thread_rmean_foreach(int thread_id, rmean_cb cb, void *cb_ctx)
+{
+	assert(thread_id >= 0 && thread_id < iproto_threads_count);
+	struct rmean *rmean = iproto_threads[thread_id].rmean;
+	for (size_t name = 0; name < IPROTO_LAST; name++) {
+		int rc = cb(rmean_net_strings[name], rmean_mean(rmean, name),
+			    rmean_total(rmean, name), cb_ctx);
+		if (rc != 0)
+			return rc;
+	}
+	return 0;
+}
+
+void
+iproto_set_rate_limit(double limit)
+{
+	for (int i = 0; i < iproto_threads_count; i++) {
+		struct iproto_cfg_msg cfg_msg;
+		iproto_cfg_msg_create(&cfg_msg, IPROTO_CFG_RATE_LIMIT,
+				      &iproto_threads[i]);
+		cfg_msg.rate_limit = limit;
+		iproto_do_cfg(&cfg_msg);
+	}
+}
+
+void
+iproto_set_batch_dml(bool value)
+{
+	for (int i = 0; i < iproto_threads_count; i++) {
+		struct iproto_cfg_msg cfg_msg;
+		iproto_cfg_msg_create(&cfg_msg, IPROTO_CFG_BATCH_DML,
+				      &iproto_threads[i]);
+		cfg_msg.batch_dml = value;
+		iproto_do_cfg(&cfg_msg);
+	}
 }
 
 void
@@ -2078,9 +3797,15 @@ iproto_set_msg_max(int new_iproto_msg_max)
 			  tt_sprintf("minimal value is %d",
 				     IPROTO_MSG_MAX_MIN));
 	}
-	struct iproto_cfg_msg cfg_msg;
-	iproto_cfg_msg_create(&cfg_msg, IPROTO_CFG_MSG_MAX);
-	cfg_msg.iproto_msg_max = new_iproto_msg_max;
-	iproto_do_cfg(&cfg_msg);
-	cpipe_set_max_input(&net_pipe, new_iproto_msg_max / 2);
+	for (int i = 0; i < iproto_threads_count; i++) {
+		struct iproto_thread *iproto_thread = &iproto_threads[i];
+		struct iproto_cfg_msg cfg_msg;
+		iproto_cfg_msg_create(&cfg_msg, IPROTO_CFG_MSG_MAX,
+				      iproto_thread);
+		cfg_msg.iproto_msg_max = new_iproto_msg_max;
+		iproto_do_cfg(&cfg_msg);
+		cpipe_set_max_input(&iproto_thread->net_pipe,
+				    new_iproto_msg_max / 2);
+	}
+	iproto_msg_max = new_iproto_msg_max;
 }
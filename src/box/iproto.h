@@ -32,6 +32,9 @@
  */
 
 #include <stddef.h>
+#include <stdbool.h>
+
+#include "rmean.h"
 
 #if defined(__cplusplus)
 extern "C" {
@@ -52,6 +55,10 @@ enum {
 	 * processing stops until some new fibers are freed up.
 	 */
 	IPROTO_FIBER_POOL_SIZE_FACTOR = 5,
+	/** The maximal number of network threads. */
+	IPROTO_THREADS_MAX = 1000,
+	/** The maximal number of streams of a connection. */
+	IPROTO_STREAMS_MAX = 1000,
 };
 
 extern unsigned iproto_readahead;
@@ -68,11 +75,33 @@ iproto_mem_used(void);
 void
 iproto_reset_stat(void);
 
+/**
+ * Invoke a callback for each network statistics counter,
+ * summed up over all network threads.
+ */
+int
+iproto_rmean_foreach(rmean_cb cb, void *cb_ctx);
+
+/** Return the number of network threads. */
+int
+iproto_thread_count(void);
+
+/**
+ * Invoke a callback for each network statistics counter
+ * of the network thread @a thread_id, counting from 0.
+ */
+int
+iproto_thread_rmean_foreach(int thread_id, rmean_cb cb, void *cb_ctx);
+
 #if defined(__cplusplus)
 } /* extern "C" */
 
+/**
+ * Initialize the iproto subsystem and start @a threads_count
+ * network threads.
+ */
 void
-iproto_init();
+iproto_init(int threads_count);
 
 void
 iproto_listen(const char *uri);
@@ -80,6 +109,22 @@ iproto_listen(const char *uri);
 void
 iproto_set_msg_max(int iproto_msg_max);
 
+/**
+ * Set the maximal number of requests per second a network thread
+ * reads from a single connection, 0 means no limit. Connections
+ * throttled by the old limit are resumed.
+ */
+void
+iproto_set_rate_limit(double limit);
+
+/**
+ * If set, consecutive autocommit DML requests read from a
+ * connection at once are executed in one transaction and
+ * written to WAL with a single journal write.
+ */
+void
+iproto_set_batch_dml(bool value);
+
 #endif /* defined(__cplusplus) */
 
 #endif
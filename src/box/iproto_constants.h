@@ -60,6 +60,11 @@ enum iproto_key {
 	IPROTO_SCHEMA_VERSION = 0x05,
 	IPROTO_SERVER_VERSION = 0x06,
 	IPROTO_GROUP_ID = 0x07,
+	/**
+	 * Requests with the same non-zero stream id are executed
+	 * one by one in a single transaction context.
+	 */
+	IPROTO_STREAM_ID = 0x08,
 	/* Leave a gap for other keys in the header. */
 	IPROTO_SPACE_ID = 0x10,
 	IPROTO_INDEX_ID = 0x11,
@@ -67,6 +72,12 @@ enum iproto_key {
 	IPROTO_OFFSET = 0x13,
 	IPROTO_ITERATOR = 0x14,
 	IPROTO_INDEX_BASE = 0x15,
+	/**
+	 * Number of tuples of SELECT result to send in one
+	 * IPROTO_CHUNK packet. The result is streamed in chunks
+	 * if set.
+	 */
+	IPROTO_CHUNK_SIZE = 0x16,
 
 	/* Leave a gap between integer values and other keys */
 	IPROTO_KEY = 0x20,
@@ -90,6 +101,16 @@ enum iproto_key {
 	IPROTO_OPS = 0x28, /* UPSERT but not UPDATE ops, because of legacy */
 	IPROTO_BALLOT = 0x29,
 	IPROTO_OPTIONS = 0x2a,
+	/**
+	 * IPROTO_TUPLE_META: {
+	 *     IPROTO_TUPLE_META_FLAGS: number
+	 * }
+	 * Auxiliary statement information stored along with
+	 * a tuple in vinyl run files. Not accepted in requests.
+	 */
+	IPROTO_TUPLE_META = 0x2b,
+	/** Compression of responses, see IPROTO_COMPRESS. */
+	IPROTO_COMPRESSION = 0x2c,
 
 	/* Leave a gap between request keys and response keys */
 	IPROTO_DATA = 0x30,
@@ -112,6 +133,8 @@ enum iproto_key {
 	 * }
 	 */
 	IPROTO_SQL_INFO = 0x42,
+	/** Id of a statement prepared by IPROTO_PREPARE. */
+	IPROTO_STMT_ID = 0x43,
 	IPROTO_KEY_MAX
 };
 
@@ -124,6 +147,10 @@ enum iproto_metadata_key {
 	IPROTO_FIELD_NAME = 0,
 };
 
+enum iproto_tuple_meta_key {
+	IPROTO_TUPLE_META_FLAGS = 0x01,
+};
+
 enum iproto_ballot_key {
 	IPROTO_BALLOT_IS_RO = 0x01,
 	IPROTO_BALLOT_VCLOCK = 0x02,
@@ -136,7 +163,8 @@ enum iproto_ballot_key {
 			  bit(LSN) | bit(SCHEMA_VERSION))
 #define IPROTO_DML_BODY_BMAP (bit(SPACE_ID) | bit(INDEX_ID) | bit(LIMIT) |\
 			      bit(OFFSET) | bit(ITERATOR) | bit(INDEX_BASE) |\
-			      bit(KEY) | bit(TUPLE) | bit(OPS))
+			      bit(KEY) | bit(TUPLE) | bit(OPS) |\
+			      bit(CHUNK_SIZE))
 
 static inline bool
 xrow_header_has_key(const char *pos, const char *end)
@@ -193,6 +221,14 @@ enum iproto_type {
 	IPROTO_EXECUTE = 11,
 	/** No operation. Treated as DML, used to bump LSN. */
 	IPROTO_NOP = 12,
+	/** Prepare an SQL statement to execute it by id. */
+	IPROTO_PREPARE = 13,
+	/** Begin a transaction in a stream. */
+	IPROTO_BEGIN = 14,
+	/** Commit the stream transaction. */
+	IPROTO_COMMIT = 15,
+	/** Roll back the stream transaction. */
+	IPROTO_ROLLBACK = 16,
 	/** The maximum typecode used for box.stat() */
 	IPROTO_TYPE_STAT_MAX,
 
@@ -206,6 +242,11 @@ enum iproto_type {
 	IPROTO_VOTE_DEPRECATED = 67,
 	/** Vote request command for master election */
 	IPROTO_VOTE = 68,
+	/**
+	 * Compress all further responses on the connection
+	 * with the algorithm given in IPROTO_COMPRESSION.
+	 */
+	IPROTO_COMPRESS = 69,
 
 	/** Vinyl run info stored in .index file */
 	VY_INDEX_RUN_INFO = 100,
@@ -213,6 +254,8 @@ enum iproto_type {
 	VY_INDEX_PAGE_INFO = 101,
 	/** Vinyl row index stored in .run file */
 	VY_RUN_ROW_INDEX = 102,
+	/** Vinyl prefix-compressed page rows stored in .run file */
+	VY_RUN_PAGE_DATA = 103,
 
 	/** Non-final response type. */
 	IPROTO_CHUNK = 128,
@@ -223,6 +266,13 @@ enum iproto_type {
 	IPROTO_TYPE_ERROR = 1 << 15
 };
 
+/** Compression algorithms of IPROTO_COMPRESS. */
+enum iproto_compression {
+	IPROTO_COMPRESSION_NONE = 0,
+	IPROTO_COMPRESSION_ZSTD = 1,
+	IPROTO_COMPRESSION_MAX
+};
+
 /** IPROTO type name by code */
 extern const char *iproto_type_strs[];
 
@@ -250,6 +300,8 @@ iproto_type_name(uint32_t type)
 		return "PAGEINFO";
 	case VY_RUN_ROW_INDEX:
 		return "ROWINDEX";
+	case VY_RUN_PAGE_DATA:
+		return "PAGEDATA";
 	default:
 		return NULL;
 	}
@@ -353,6 +405,14 @@ enum vy_run_info_key {
 	VY_RUN_INFO_BLOOM_LEGACY = 6,
 	/** Bloom filter for keys. */
 	VY_RUN_INFO_BLOOM = 7,
+	/** Number of statements in the run. */
+	VY_RUN_INFO_ROW_COUNT = 8,
+	/** Size of run pages on disk. */
+	VY_RUN_INFO_SIZE = 9,
+	/** Size of run pages in memory, i.e. unpacked. */
+	VY_RUN_INFO_UNPACKED_SIZE = 10,
+	/** Total size of min keys of run pages. */
+	VY_RUN_INFO_PAGE_KEY_SIZE = 11,
 	/** The last key in this enum + 1 */
 	VY_RUN_INFO_KEY_MAX
 };
@@ -411,6 +471,13 @@ vy_page_info_key_name(enum vy_page_info_key key)
 enum vy_row_index_key {
 	/** Array of row offsets. */
 	VY_ROW_INDEX_DATA = 1,
+	/**
+	 * Number of rows between restart points of a prefix-
+	 * compressed page. If set, the row index stores offsets
+	 * of restart points in VY_RUN_PAGE_DATA rather than
+	 * offsets of all rows in the page.
+	 */
+	VY_ROW_INDEX_RESTART_INTERVAL = 2,
 	/** The last key in this enum + 1 */
 	VY_ROW_INDEX_KEY_MAX
 };
@@ -428,6 +495,30 @@ vy_row_index_key_name(enum vy_row_index_key key)
 	return vy_row_index_key_strs[key];
 }
 
+/**
+ * Xrow keys for Vinyl prefix-compressed page rows.
+ * @sa struct vy_page.
+ */
+enum vy_page_data_key {
+	/** Prefix-compressed statements. */
+	VY_PAGE_DATA_ROWS = 1,
+	/** The last key in this enum + 1 */
+	VY_PAGE_DATA_KEY_MAX
+};
+
+/**
+ * Return vy_page_data key name by @a key code.
+ * @param key key
+ */
+static inline const char *
+vy_page_data_key_name(enum vy_page_data_key key)
+{
+	if (key <= 0 || key >= VY_PAGE_DATA_KEY_MAX)
+		return NULL;
+	extern const char *vy_page_data_key_strs[];
+	return vy_page_data_key_strs[key];
+}
+
 #if defined(__cplusplus)
 } /* extern "C" */
 #endif
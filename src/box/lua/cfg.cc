@@ -241,6 +241,17 @@ lbox_cfg_set_vinyl_timeout(struct lua_State *L)
 	return 0;
 }
 
+static int
+lbox_cfg_set_vinyl_scrub_rate(struct lua_State *L)
+{
+	try {
+		box_set_vinyl_scrub_rate();
+	} catch (Exception *) {
+		luaT_error(L);
+	}
+	return 0;
+}
+
 static int
 lbox_cfg_set_net_msg_max(struct lua_State *L)
 {
@@ -252,6 +263,22 @@ lbox_cfg_set_net_msg_max(struct lua_State *L)
 	return 0;
 }
 
+static int
+lbox_cfg_set_iproto_batch_dml(struct lua_State *L)
+{
+	(void) L;
+	box_set_iproto_batch_dml();
+	return 0;
+}
+
+static int
+lbox_cfg_set_iproto_rate_limit(struct lua_State *L)
+{
+	(void) L;
+	box_set_iproto_rate_limit();
+	return 0;
+}
+
 static int
 lbox_cfg_set_worker_pool_threads(struct lua_State *L)
 {
@@ -325,11 +352,14 @@ box_lua_cfg_init(struct lua_State *L)
 		{"cfg_set_vinyl_max_tuple_size", lbox_cfg_set_vinyl_max_tuple_size},
 		{"cfg_set_vinyl_cache", lbox_cfg_set_vinyl_cache},
 		{"cfg_set_vinyl_timeout", lbox_cfg_set_vinyl_timeout},
+		{"cfg_set_vinyl_scrub_rate", lbox_cfg_set_vinyl_scrub_rate},
 		{"cfg_set_replication_timeout", lbox_cfg_set_replication_timeout},
 		{"cfg_set_replication_connect_quorum", lbox_cfg_set_replication_connect_quorum},
 		{"cfg_set_replication_skip_conflict", lbox_cfg_set_replication_skip_conflict},
 		{"cfg_set_replication_connect_timeout", lbox_cfg_set_replication_connect_timeout},
 		{"cfg_set_net_msg_max", lbox_cfg_set_net_msg_max},
+		{"cfg_set_iproto_batch_dml", lbox_cfg_set_iproto_batch_dml},
+		{"cfg_set_iproto_rate_limit", lbox_cfg_set_iproto_rate_limit},
 		{NULL, NULL}
 	};
 
@@ -29,6 +29,7 @@ local default_cfg = {
     vinyl_range_size          = 1024 * 1024 * 1024,
     vinyl_page_size           = 8 * 1024,
     vinyl_bloom_fpr           = 0.05,
+    vinyl_scrub_rate          = 0,
     log                 = nil,
     log_nonblock        = nil,
     log_level           = 5,
@@ -64,6 +65,9 @@ local default_cfg = {
     feedback_host         = "https://feedback.tarantool.io",
     feedback_interval     = 3600,
     net_msg_max           = 768,
+    iproto_threads        = 1,
+    iproto_batch_dml      = false,
+    iproto_rate_limit     = 0,
 }
 
 -- types of available options
@@ -89,6 +93,7 @@ local template_cfg = {
     vinyl_range_size          = 'number',
     vinyl_page_size           = 'number',
     vinyl_bloom_fpr           = 'number',
+    vinyl_scrub_rate          = 'number',
 
     log              = 'string',
     log_nonblock     = 'boolean',
@@ -125,6 +130,9 @@ local template_cfg = {
     feedback_host         = 'string',
     feedback_interval     = 'number',
     net_msg_max           = 'number',
+    iproto_threads        = 'number',
+    iproto_batch_dml      = 'boolean',
+    iproto_rate_limit     = 'number',
 }
 
 local function normalize_uri(port)
@@ -197,6 +205,7 @@ local dynamic_cfg = {
     vinyl_max_tuple_size    = private.cfg_set_vinyl_max_tuple_size,
     vinyl_cache             = private.cfg_set_vinyl_cache,
     vinyl_timeout           = private.cfg_set_vinyl_timeout,
+    vinyl_scrub_rate        = private.cfg_set_vinyl_scrub_rate,
     checkpoint_count        = private.cfg_set_checkpoint_count,
     checkpoint_interval     = private.checkpoint_daemon.set_checkpoint_interval,
     worker_pool_threads     = private.cfg_set_worker_pool_threads,
@@ -216,6 +225,8 @@ local dynamic_cfg = {
     replicaset_uuid         = check_replicaset_uuid,
     replication_skip_conflict = private.cfg_set_replication_skip_conflict,
     net_msg_max             = private.cfg_set_net_msg_max,
+    iproto_batch_dml        = private.cfg_set_iproto_batch_dml,
+    iproto_rate_limit       = private.cfg_set_iproto_rate_limit,
 }
 
 local dynamic_cfg_skip_at_load = {
@@ -33,6 +33,7 @@
 
 #include <small/ibuf.h>
 #include <msgpuck.h> /* mp_store_u32() */
+#include <zstd.h>
 #include "scramble.h"
 
 #include "box/iproto_constants.h"
@@ -155,6 +156,78 @@ netbox_encode_auth(lua_State *L)
 	return 0;
 }
 
+static int
+netbox_encode_compress(lua_State *L)
+{
+	if (lua_gettop(L) < 3) {
+		return luaL_error(L, "Usage: netbox.encode_compress(ibuf, "
+				     "sync, compression)");
+	}
+
+	struct mpstream stream;
+	size_t svp = netbox_prepare_request(L, &stream, IPROTO_COMPRESS);
+
+	luamp_encode_map(cfg, &stream, 1);
+	luamp_encode_uint(cfg, &stream, IPROTO_COMPRESSION);
+	luamp_encode_uint(cfg, &stream, luaL_checkinteger(L, 3));
+
+	netbox_encode_request(&stream, svp);
+	return 0;
+}
+
+/**
+ * Decompress a frame of compressed responses, see
+ * IPROTO_COMPRESS.
+ * @param L Lua stack. The first argument is an ibuf to append
+ *        the decompressed responses to, the second one is a
+ *        pointer to the MP_BIN body of the frame.
+ * @retval nil on success.
+ * @retval Error message otherwise.
+ */
+static int
+netbox_decompress(lua_State *L)
+{
+	static ZSTD_DStream *zdctx = NULL;
+	struct ibuf *ibuf = (struct ibuf *) lua_topointer(L, 1);
+	uint32_t ctypeid;
+	const char *data = *(const char **)luaL_checkcdata(L, 2, &ctypeid);
+	assert(mp_typeof(*data) == MP_BIN);
+	uint32_t size;
+	ZSTD_inBuffer input;
+	input.src = mp_decode_bin(&data, &size);
+	input.size = size;
+	input.pos = 0;
+	if (zdctx == NULL) {
+		zdctx = ZSTD_createDStream();
+		if (zdctx == NULL)
+			return luaL_error(L, "out of memory");
+	}
+	size_t rc = ZSTD_initDStream(zdctx);
+	bool is_full = false;
+	/*
+	 * Continue while there is input or the output buffer
+	 * has been filled up, and so some output may be left.
+	 */
+	while (!ZSTD_isError(rc) && (input.pos < input.size || is_full)) {
+		size_t reserve = ZSTD_DStreamOutSize();
+		if (ibuf_reserve(ibuf, reserve) == NULL)
+			return luaL_error(L, "out of memory");
+		ZSTD_outBuffer output;
+		output.dst = ibuf->wpos;
+		output.size = ibuf_unused(ibuf);
+		output.pos = 0;
+		rc = ZSTD_decompressStream(zdctx, &output, &input);
+		ibuf->wpos += output.pos;
+		is_full = output.pos == output.size;
+	}
+	if (ZSTD_isError(rc)) {
+		lua_pushstring(L, ZSTD_getErrorName(rc));
+		return 1;
+	}
+	lua_pushnil(L);
+	return 1;
+}
+
 static int
 netbox_encode_call_impl(lua_State *L, enum iproto_type type)
 {
@@ -227,19 +300,20 @@ netbox_encode_select(lua_State *L)
 	if (lua_gettop(L) < 8) {
 		return luaL_error(L, "Usage netbox.encode_select(ibuf, sync, "
 				     "space_id, index_id, iterator, offset, "
-				     "limit, key)");
+				     "limit, key[, chunk_size])");
 	}
 
 	struct mpstream stream;
 	size_t svp = netbox_prepare_request(L, &stream, IPROTO_SELECT);
 
-	luamp_encode_map(cfg, &stream, 6);
-
 	uint32_t space_id = lua_tonumber(L, 3);
 	uint32_t index_id = lua_tonumber(L, 4);
 	int iterator = lua_tointeger(L, 5);
 	uint32_t offset = lua_tonumber(L, 6);
 	uint32_t limit = lua_tonumber(L, 7);
+	uint32_t chunk_size = lua_gettop(L) >= 9 ? lua_tonumber(L, 9) : 0;
+
+	luamp_encode_map(cfg, &stream, chunk_size != 0 ? 7 : 6);
 
 	/* encode space_id */
 	luamp_encode_uint(cfg, &stream, IPROTO_SPACE_ID);
@@ -265,6 +339,12 @@ netbox_encode_select(lua_State *L)
 	luamp_encode_uint(cfg, &stream, IPROTO_KEY);
 	luamp_convert_key(L, cfg, &stream, 8);
 
+	/* encode chunk_size */
+	if (chunk_size != 0) {
+		luamp_encode_uint(cfg, &stream, IPROTO_CHUNK_SIZE);
+		luamp_encode_uint(cfg, &stream, chunk_size);
+	}
+
 	netbox_encode_request(&stream, svp);
 	return 0;
 }
@@ -568,10 +648,16 @@ netbox_encode_execute(lua_State *L)
 
 	luamp_encode_map(cfg, &stream, 3);
 
-	size_t len;
-	const char *query = lua_tolstring(L, 3, &len);
-	luamp_encode_uint(cfg, &stream, IPROTO_SQL_TEXT);
-	luamp_encode_str(cfg, &stream, query, len);
+	/* A number is an id of a prepared statement. */
+	if (lua_type(L, 3) == LUA_TNUMBER) {
+		luamp_encode_uint(cfg, &stream, IPROTO_STMT_ID);
+		luamp_encode_uint(cfg, &stream, luaL_touint64(L, 3));
+	} else {
+		size_t len;
+		const char *query = lua_tolstring(L, 3, &len);
+		luamp_encode_uint(cfg, &stream, IPROTO_SQL_TEXT);
+		luamp_encode_str(cfg, &stream, query, len);
+	}
 
 	luamp_encode_uint(cfg, &stream, IPROTO_SQL_BIND);
 	luamp_encode_tuple(L, cfg, &stream, 4);
@@ -583,6 +669,32 @@ netbox_encode_execute(lua_State *L)
 	return 0;
 }
 
+static int
+netbox_encode_prepare(lua_State *L)
+{
+	if (lua_gettop(L) < 3)
+		return luaL_error(L, "Usage: netbox.encode_prepare(ibuf, "\
+				  "sync, query)");
+	struct mpstream stream;
+	size_t svp = netbox_prepare_request(L, &stream, IPROTO_PREPARE);
+
+	luamp_encode_map(cfg, &stream, 1);
+
+	/* A statement id unprepares the statement. */
+	if (lua_type(L, 3) == LUA_TNUMBER) {
+		luamp_encode_uint(cfg, &stream, IPROTO_STMT_ID);
+		luamp_encode_uint(cfg, &stream, luaL_touint64(L, 3));
+	} else {
+		size_t len;
+		const char *query = lua_tolstring(L, 3, &len);
+		luamp_encode_uint(cfg, &stream, IPROTO_SQL_TEXT);
+		luamp_encode_str(cfg, &stream, query, len);
+	}
+
+	netbox_encode_request(&stream, svp);
+	return 0;
+}
+
 /**
  * Decode IPROTO_DATA into tuples array.
  * @param L Lua stack to push result on.
@@ -631,6 +743,39 @@ netbox_decode_select(struct lua_State *L)
 	return 2;
 }
 
+/**
+ * Find IPROTO_DATA in a response body and return it as is, as a
+ * MessagePack string, without decoding it into Lua objects.
+ * @param Lua stack[1] Raw MessagePack pointer.
+ * @retval MessagePack of IPROTO_DATA or nil, if the body has no
+ *         such key, and position of the body end.
+ */
+static int
+netbox_decode_raw(struct lua_State *L)
+{
+	uint32_t ctypeid;
+	const char *data = *(const char **)luaL_checkcdata(L, 1, &ctypeid);
+	assert(mp_typeof(*data) == MP_MAP);
+	uint32_t map_size = mp_decode_map(&data);
+	const char *raw = NULL, *raw_end = NULL;
+	for (uint32_t i = 0; i < map_size; ++i) {
+		uint32_t key = mp_decode_uint(&data);
+		if (key != IPROTO_DATA) {
+			mp_next(&data);
+			continue;
+		}
+		raw = data;
+		mp_next(&data);
+		raw_end = data;
+	}
+	if (raw != NULL)
+		lua_pushlstring(L, raw, raw_end - raw);
+	else
+		lua_pushnil(L);
+	*(const char **)luaL_pushcdata(L, ctypeid) = data;
+	return 2;
+}
+
 /**
  * Decode IPROTO_METADATA into array of maps.
  * @param L Lua stack to push result on.
@@ -736,11 +881,15 @@ luaopen_net_box(struct lua_State *L)
 		{ "encode_update",  netbox_encode_update },
 		{ "encode_upsert",  netbox_encode_upsert },
 		{ "encode_execute", netbox_encode_execute},
+		{ "encode_prepare", netbox_encode_prepare},
 		{ "encode_auth",    netbox_encode_auth },
+		{ "encode_compress",netbox_encode_compress },
 		{ "decode_greeting",netbox_decode_greeting },
 		{ "communicate",    netbox_communicate },
 		{ "decode_select",  netbox_decode_select },
 		{ "decode_execute", netbox_decode_execute },
+		{ "decode_raw",     netbox_decode_raw },
+		{ "decompress",     netbox_decompress },
 		{ NULL, NULL}
 	};
 	/* luaL_register_module polutes _G */
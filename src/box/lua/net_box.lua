@@ -24,13 +24,16 @@ local check_primary_index = box.internal.check_primary_index
 
 local communicate     = internal.communicate
 local encode_auth     = internal.encode_auth
+local encode_compress = internal.encode_compress
 local encode_select   = internal.encode_select
 local decode_greeting = internal.decode_greeting
+local decode_raw      = internal.decode_raw
 
 local TIMEOUT_INFINITY = 500 * 365 * 86400
 local VSPACE_ID        = 281
 local VINDEX_ID        = 289
 local DEFAULT_CONNECT_TIMEOUT = 10
+local DEFAULT_POOL_SIZE = 4
 
 local IPROTO_STATUS_KEY    = 0x00
 local IPROTO_ERRNO_MASK    = 0x7FFF
@@ -38,6 +41,7 @@ local IPROTO_SYNC_KEY      = 0x01
 local IPROTO_SCHEMA_VERSION_KEY = 0x05
 local IPROTO_METADATA_KEY = 0x32
 local IPROTO_SQL_INFO_KEY = 0x42
+local IPROTO_STMT_ID_KEY = 0x43
 local SQL_INFO_ROW_COUNT_KEY = 0
 local IPROTO_FIELD_NAME_KEY = 0
 local IPROTO_DATA_KEY      = 0x30
@@ -45,6 +49,10 @@ local IPROTO_ERROR_KEY     = 0x31
 local IPROTO_GREETING_SIZE = 128
 local IPROTO_CHUNK_KEY     = 128
 local IPROTO_OK_KEY        = 0
+-- MP_BIN body of a frame of compressed responses.
+local IPROTO_COMPRESSED_FRAME = 0xc6
+-- Codes of enum iproto_compression.
+local IPROTO_COMPRESSION = {zstd = 1}
 
 -- select errors from box.error
 local E_UNKNOWN              = box.error.UNKNOWN
@@ -77,6 +85,10 @@ local function decode_count(raw_data)
     local response, raw_end = decode(raw_data)
     return response[IPROTO_DATA_KEY][1], raw_end
 end
+local function decode_prepare(raw_data)
+    local response, raw_end = decode(raw_data)
+    return response[IPROTO_STMT_ID_KEY], raw_end
+end
 local function decode_push(raw_data)
     local response, raw_end = decode(raw_data)
     return response[IPROTO_DATA_KEY][1], raw_end
@@ -94,6 +106,8 @@ local method_encoder = {
     upsert  = internal.encode_upsert,
     select  = internal.encode_select,
     execute = internal.encode_execute,
+    prepare = internal.encode_prepare,
+    unprepare = internal.encode_prepare,
     get     = internal.encode_select,
     min     = internal.encode_select,
     max     = internal.encode_select,
@@ -118,6 +132,8 @@ local method_decoder = {
     upsert  = decode_nil,
     select  = internal.decode_select,
     execute = internal.decode_execute,
+    prepare = decode_prepare,
+    unprepare = decode_nil,
     get     = decode_get,
     min     = decode_get,
     max     = decode_get,
@@ -206,7 +222,8 @@ local function on_push_sync_default(...) end
 --
 --  'state_changed', state, errno, error
 --  'handshake', greeting -> nil (accept) / errno, error (reject)
---  'will_fetch_schema'   -> true (approve) / false (skip fetch)
+--  'will_fetch_schema', schema_version -> true (approve) / false
+--                        (skip fetch)
 --  'did_fetch_schema', schema_version, spaces, indices
 --  'reconnect_timeout'   -> get reconnect timeout if set and > 0,
 --                           else nil is returned.
@@ -238,10 +255,16 @@ local function create_transport(host, port, user, password, callback,
     -- wait for a result.
     local requests         = setmetatable({}, { __mode = 'v' })
     local next_request_id  = 1
+    -- Ids of requests sent and not answered yet. Unlike
+    -- requests, it holds discarded and collected requests too.
+    local inflight         = {}
+    local inflight_count   = 0
 
     local worker_fiber
     local send_buf         = buffer.ibuf(buffer.READAHEAD)
     local recv_buf         = buffer.ibuf(buffer.READAHEAD)
+    -- Decompressed responses, always complete.
+    local zrecv_buf        = buffer.ibuf(buffer.READAHEAD)
 
     --
     -- Async request metamethods.
@@ -404,6 +427,8 @@ local function create_transport(host, port, user, password, callback,
                 request.cond:broadcast()
             end
             requests = {}
+            inflight = {}
+            inflight_count = 0
         end
     end
 
@@ -465,6 +490,7 @@ local function create_transport(host, port, user, password, callback,
             end
             send_buf:recycle()
             recv_buf:recycle()
+            zrecv_buf:recycle()
             worker_fiber = nil
         end)
     end
@@ -484,8 +510,8 @@ local function create_transport(host, port, user, password, callback,
     -- @retval nil, error Error occured.
     -- @retval not nil Future object.
     --
-    local function perform_async_request(buffer, method, on_push, on_push_ctx,
-                                         ...)
+    local function perform_async_request(buffer, raw, method, on_push,
+                                         on_push_ctx, ...)
         if state ~= 'active' and state ~= 'fetch_schema' then
             return nil, box.error.new({code = last_errno or E_NO_CONNECTION,
                                        reason = last_error})
@@ -498,12 +524,15 @@ local function create_transport(host, port, user, password, callback,
         local id = next_request_id
         method_encoder[method](send_buf, id, ...)
         next_request_id = next_id(id)
-        -- Request in most cases has maximum 8 members:
-        -- method, buffer, id, cond, errno, response, on_push,
+        inflight[id] = true
+        inflight_count = inflight_count + 1
+        -- Request in most cases has maximum 9 members:
+        -- method, buffer, raw, id, cond, errno, response, on_push,
         -- on_push_ctx.
-        local request = setmetatable(table_new(0, 8), request_mt)
+        local request = setmetatable(table_new(0, 9), request_mt)
         request.method = method
         request.buffer = buffer
+        request.raw = raw
         request.id = id
         request.cond = fiber.cond()
         requests[id] = request
@@ -517,10 +546,11 @@ local function create_transport(host, port, user, password, callback,
     -- @retval nil, error Error occured.
     -- @retval not nil Response object.
     --
-    local function perform_request(timeout, buffer, method, on_push,
+    local function perform_request(timeout, buffer, raw, method, on_push,
                                    on_push_ctx, ...)
         local request, err =
-            perform_async_request(buffer, method, on_push, on_push_ctx, ...)
+            perform_async_request(buffer, raw, method, on_push, on_push_ctx,
+                                  ...)
         if not request then
             return nil, err
         end
@@ -529,11 +559,15 @@ local function create_transport(host, port, user, password, callback,
 
     local function dispatch_response_iproto(hdr, body_rpos, body_end)
         local id = hdr[IPROTO_SYNC_KEY]
+        local status = hdr[IPROTO_STATUS_KEY]
+        if status ~= IPROTO_CHUNK_KEY and inflight[id] then
+            inflight[id] = nil
+            inflight_count = inflight_count - 1
+        end
         local request = requests[id]
         if request == nil then -- nobody is waiting for the response
             return
         end
-        local status = hdr[IPROTO_STATUS_KEY]
         local body, body_end_check
 
         if status > IPROTO_CHUNK_KEY then
@@ -567,17 +601,20 @@ local function create_transport(host, port, user, password, callback,
         end
 
         local real_end
-        -- Decode xrow.body[DATA] to Lua objects
+        -- Decode xrow.body[DATA] to Lua objects, or leave it as
+        -- a MessagePack string in raw mode.
         if status == IPROTO_OK_KEY then
+            local decoder = request.raw and decode_raw or
+                            method_decoder[request.method]
             request.response, real_end, request.errno =
-                method_decoder[request.method](body_rpos, body_end)
+                decoder(body_rpos, body_end)
             assert(real_end == body_end, "invalid body length")
             requests[id] = nil
             request.id = nil
         else
             local msg
-            msg, real_end, request.errno =
-                method_decoder.push(body_rpos, body_end)
+            local decoder = request.raw and decode_raw or method_decoder.push
+            msg, real_end, request.errno = decoder(body_rpos, body_end)
             assert(real_end == body_end, "invalid body length")
             request.on_push(request.on_push_ctx, msg)
         end
@@ -597,6 +634,13 @@ local function create_transport(host, port, user, password, callback,
     end
 
     local function send_and_recv_iproto(timeout)
+        if zrecv_buf.rpos ~= zrecv_buf.wpos then
+            local len, rpos = decode(zrecv_buf.rpos)
+            local body_end = rpos + len
+            local hdr, body_rpos = decode(rpos)
+            zrecv_buf.rpos = body_end
+            return nil, hdr, body_rpos, body_end
+        end
         local data_len = recv_buf.wpos - recv_buf.rpos
         local required = 0
         if data_len < 5 then
@@ -608,6 +652,16 @@ local function create_transport(host, port, user, password, callback,
             required = (rpos - bufpos) + len
             if data_len >= required then
                 local body_end = rpos + len
+                if ffi.cast('const uint8_t *', rpos)[0] ==
+                   IPROTO_COMPRESSED_FRAME then
+                    zrecv_buf:reset()
+                    local err = internal.decompress(zrecv_buf, rpos)
+                    recv_buf.rpos = body_end
+                    if err then
+                        return E_NO_CONNECTION, err
+                    end
+                    return send_and_recv_iproto(timeout)
+                end
                 local hdr, body_rpos = decode(rpos)
                 recv_buf.rpos = body_end
                 return nil, hdr, body_rpos, body_end
@@ -639,7 +693,8 @@ local function create_transport(host, port, user, password, callback,
     -- tail-recursive calls to each other. Yep, Lua optimizes
     -- such calls, and yep, this is the canonical way to implement
     -- a state machine in Lua.
-    local console_sm, iproto_auth_sm, iproto_schema_sm, iproto_sm, error_sm
+    local console_sm, iproto_compress_sm, iproto_auth_sm, iproto_schema_sm
+    local iproto_sm, error_sm
 
     --
     -- Protocol_sm is a core function of netbox. It calls all
@@ -672,7 +727,7 @@ local function create_transport(host, port, user, password, callback,
             set_state('active')
             return console_sm(rid)
         elseif greeting.protocol == 'Binary' then
-            return iproto_auth_sm(greeting.salt)
+            return iproto_compress_sm(greeting.salt)
         else
             return error_sm(E_NO_CONNECTION,
                             'Unknown protocol: '..greeting.protocol)
@@ -697,6 +752,28 @@ local function create_transport(host, port, user, password, callback,
         end
     end
 
+    iproto_compress_sm = function(salt)
+        local compression = callback('fetch_compression')
+        if compression == nil then
+            return iproto_auth_sm(salt)
+        end
+        local code = IPROTO_COMPRESSION[compression]
+        if code == nil then
+            return error_sm(E_NO_CONNECTION,
+                            'Unknown compression: '..tostring(compression))
+        end
+        encode_compress(send_buf, new_request_id(), code)
+        local err, hdr, body_rpos = send_and_recv_iproto()
+        if err then
+            return error_sm(err, hdr)
+        end
+        if hdr[IPROTO_STATUS_KEY] ~= 0 then
+            local body = decode(body_rpos)
+            return error_sm(E_NO_CONNECTION, body[IPROTO_ERROR_KEY])
+        end
+        return iproto_auth_sm(salt)
+    end
+
     iproto_auth_sm = function(salt)
         set_state('auth')
         if not user or not password then
@@ -718,7 +795,7 @@ local function create_transport(host, port, user, password, callback,
     end
 
     iproto_schema_sm = function(schema_version)
-        if not callback('will_fetch_schema') then
+        if not callback('will_fetch_schema', schema_version) then
             set_state('active')
             return iproto_sm(schema_version)
         end
@@ -775,7 +852,7 @@ local function create_transport(host, port, user, password, callback,
             local body
             body, body_end = decode(body_rpos)
             set_state('fetch_schema')
-            return iproto_schema_sm(schema_version)
+            return iproto_schema_sm(response_schema_version)
         end
         return iproto_sm(schema_version)
     end
@@ -784,6 +861,7 @@ local function create_transport(host, port, user, password, callback,
         if connection then connection:close(); connection = nil end
         send_buf:recycle()
         recv_buf:recycle()
+        zrecv_buf:recycle()
         if state ~= 'closed' then
             if callback('reconnect_timeout') then
                 set_state('error_reconnect', err, msg)
@@ -799,6 +877,7 @@ local function create_transport(host, port, user, password, callback,
         wait_state      = wait_state,
         perform_request = perform_request,
         perform_async_request = perform_async_request,
+        inflight_count  = function() return inflight_count end,
     }
 end
 
@@ -884,7 +963,7 @@ local console_mt = {
 
 local space_metatable, index_metatable
 
-local function new_sm(host, port, opts, connection, greeting)
+local function new_sm(host, port, opts, connection, greeting, owner)
     local user, password = opts.user, opts.password; opts.password = nil
     local last_reconnect_error
     local remote = {host = host, port = port, opts = opts, state = 'initial'}
@@ -921,7 +1000,15 @@ local function new_sm(host, port, opts, connection, greeting)
             remote.peer_uuid = greeting.uuid
             remote.peer_version_id = greeting.version_id
         elseif what == 'will_fetch_schema' then
+            if opts.fetch_schema == false then
+                -- Remember the version, so that a pool can tell
+                -- its schema is out of date.
+                remote.schema_version = ...
+                return false
+            end
             return not opts.console
+        elseif what == 'fetch_compression' then
+            return opts.compression
         elseif what == 'fetch_connect_timeout' then
             return opts.connect_timeout or DEFAULT_CONNECT_TIMEOUT
         elseif what == 'did_fetch_schema' then
@@ -943,8 +1030,10 @@ local function new_sm(host, port, opts, connection, greeting)
         -- @deprecated since 1.7.4
         remote._deadlines = setmetatable({}, {__mode = 'k'})
 
-        remote._space_mt = space_metatable(remote)
-        remote._index_mt = index_metatable(remote)
+        -- Space objects of a pooled connection send requests
+        -- through the pool.
+        remote._space_mt = space_metatable(owner or remote)
+        remote._index_mt = index_metatable(owner or remote)
         if opts.call_16 then
             remote.call = remote.call_16
             remote.eval = remote.eval_16
@@ -981,6 +1070,21 @@ local function wrap(connection, greeting, host, port, opts)
     return new_sm(host, port, opts, connection, greeting)
 end
 
+--
+-- Connect and wrap the connection into net.box API. @a owner is a
+-- pool the connection belongs to, if any.
+--
+local function connect_sm(host, port, opts, owner)
+    local connection, greeting =
+        establish_connection(host, port, opts.connect_timeout)
+    if not connection then
+        local dummy_conn = new_sm(host, port, opts, nil, nil, owner)
+        dummy_conn.error = greeting
+        return dummy_conn
+    end
+    return new_sm(host, port, opts, connection, greeting, owner)
+end
+
 --
 -- Connect to a remote server.
 -- @param uri OR host and port. URI is a string like
@@ -993,14 +1097,7 @@ end
 --
 local function connect(...)
     local host, port, opts = parse_connect_params(...)
-    local connection, greeting =
-        establish_connection(host, port, opts.connect_timeout)
-    if not connection then
-        local dummy_conn = new_sm(host, port, opts)
-        dummy_conn.error = greeting
-        return dummy_conn
-    end
-    return new_sm(host, port, opts, connection, greeting)
+    return connect_sm(host, port, opts)
 end
 
 local function check_remote_arg(remote, method)
@@ -1056,17 +1153,21 @@ end
 
 function remote_methods:_request(method, opts, ...)
     local transport = self._transport
-    local on_push, on_push_ctx, buffer, deadline
+    local on_push, on_push_ctx, buffer, raw, deadline
     -- Extract options, set defaults, check if the request is
     -- async.
     if opts then
         buffer = opts.buffer
+        raw = opts.raw
+        if buffer and raw then
+            error('`buffer` and `raw` options are mutually exclusive')
+        end
         if opts.is_async then
             if opts.on_push or opts.on_push_ctx then
                 error('To handle pushes in an async request use future:pairs()')
             end
-            return transport.perform_async_request(buffer, method, table.insert,
-                                                   {}, ...)
+            return transport.perform_async_request(buffer, raw, method,
+                                                   table.insert, {}, ...)
         end
         if opts.timeout then
             -- conn.space:request(, { timeout = timeout })
@@ -1088,7 +1189,7 @@ function remote_methods:_request(method, opts, ...)
         transport.wait_state('active', timeout)
         timeout = deadline and max(0, deadline - fiber_clock())
     end
-    local res, err = transport.perform_request(timeout, buffer, method,
+    local res, err = transport.perform_request(timeout, buffer, raw, method,
                                                on_push, on_push_ctx, ...)
     if err then
         box.error(err)
@@ -1156,6 +1257,19 @@ function remote_methods:execute(query, parameters, sql_opts, netbox_opts)
                          sql_opts or {})
 end
 
+function remote_methods:prepare(query, netbox_opts)
+    check_remote_arg(self, "prepare")
+    return self:_request('prepare', netbox_opts, query)
+end
+
+function remote_methods:unprepare(stmt_id, netbox_opts)
+    check_remote_arg(self, "unprepare")
+    if type(stmt_id) ~= 'number' then
+        error("Usage: conn:unprepare(stmt_id)")
+    end
+    return self:_request('unprepare', netbox_opts, stmt_id)
+end
+
 function remote_methods:wait_state(state, timeout)
     check_remote_arg(self, 'wait_state')
     if timeout == nil then
@@ -1292,10 +1406,10 @@ function console_methods:eval(line, timeout)
     end
     if self.protocol == 'Binary' then
         local loader = 'return require("console").eval(...)'
-        res, err = pr(timeout, nil, 'eval', nil, nil, loader, {line})
+        res, err = pr(timeout, nil, nil, 'eval', nil, nil, loader, {line})
     else
         assert(self.protocol == 'Lua console')
-        res, err = pr(timeout, nil, 'inject', nil, nil, line..'$EOF$\n')
+        res, err = pr(timeout, nil, nil, 'inject', nil, nil, line..'$EOF$\n')
     end
     if err then
         box.error(err)
@@ -1303,6 +1417,148 @@ function console_methods:eval(line, timeout)
     return res[1] or res
 end
 
+--
+-- A pool of connections to the same peer. A request is sent over
+-- the connection having the least requests in flight. Only the
+-- first connection fetches the schema, its space objects send
+-- requests through the pool.
+--
+local pool_methods = {}
+
+local function pool_serialize(self)
+    return {
+        host = self.host,
+        port = self.port,
+        opts = next(self.opts) and self.opts,
+        size = #self._connections,
+        schema_version = self.schema_version,
+    }
+end
+
+local pool_mt = {
+    __index = function(self, key)
+        if key == 'space' or key == 'schema_version' then
+            return self._connections[1][key]
+        end
+        return pool_methods[key]
+    end,
+    __serialize = pool_serialize,
+    __metatable = false
+}
+
+function pool_methods:_request(method, opts, ...)
+    local connections = self._connections
+    local best, best_count
+    for _, conn in ipairs(connections) do
+        if conn:is_connected() then
+            local count = conn._transport.inflight_count()
+            if best == nil or count < best_count then
+                best, best_count = conn, count
+            end
+        end
+    end
+    -- If nothing is connected, let the first connection raise
+    -- the error.
+    local main = connections[1]
+    best = best or main
+    local res = best:_request(method, opts, ...)
+    -- A connection not fetching the schema has seen a newer
+    -- schema version. Reload the schema on the first connection
+    -- and wait for it, like a single connection does.
+    if best ~= main and best.schema_version ~= nil and
+       main.schema_version ~= nil and
+       best.schema_version > main.schema_version and
+       not (opts and opts.is_async) then
+        local ping_opts
+        if opts and opts.timeout then
+            ping_opts = {timeout = opts.timeout}
+        end
+        main:ping(ping_opts)
+    end
+    return res
+end
+
+pool_methods.ping = remote_methods.ping
+pool_methods.call_16 = remote_methods.call_16
+pool_methods.call = remote_methods.call
+pool_methods.eval_16 = remote_methods.eval_16
+pool_methods.eval = remote_methods.eval
+pool_methods.execute = remote_methods.execute
+
+function pool_methods:reload_schema()
+    check_remote_arg(self, 'reload_schema')
+    self._connections[1]:ping()
+end
+
+function pool_methods:on_schema_reload(...)
+    check_remote_arg(self, 'on_schema_reload')
+    return self._connections[1]:on_schema_reload(...)
+end
+
+function pool_methods:close()
+    check_remote_arg(self, 'close')
+    for _, conn in ipairs(self._connections) do
+        conn:close()
+    end
+end
+
+function pool_methods:is_connected()
+    check_remote_arg(self, 'is_connected')
+    for _, conn in ipairs(self._connections) do
+        if conn:is_connected() then
+            return true
+        end
+    end
+    return false
+end
+
+function pool_methods:wait_connected(timeout)
+    check_remote_arg(self, 'wait_connected')
+    local deadline = fiber_clock() + (timeout or TIMEOUT_INFINITY)
+    for _, conn in ipairs(self._connections) do
+        if not conn:wait_connected(max(0, deadline - fiber_clock())) then
+            return false
+        end
+    end
+    return true
+end
+
+--
+-- Connect to a remote server with several connections.
+-- @param uri OR host and port, @sa connect().
+-- @param opts @sa wrap(), and size - number of connections,
+--        DEFAULT_POOL_SIZE by default.
+--
+-- @retval Net.box pool object.
+--
+local function connect_pool(...)
+    local host, port, opts = parse_connect_params(...)
+    local size = opts.size or DEFAULT_POOL_SIZE
+    if type(size) ~= 'number' or size < 1 or size ~= math.floor(size) then
+        box.error(E_PROC_LUA, "connect_pool(): size must be a positive integer")
+    end
+    opts.size = nil
+    local pool = setmetatable({host = host, port = port, _connections = {}},
+                              pool_mt)
+    for i = 1, size do
+        local conn_opts = {}
+        for k, v in pairs(opts) do conn_opts[k] = v end
+        conn_opts.fetch_schema = i == 1 and opts.fetch_schema
+        conn_opts.wait_connected = false
+        pool._connections[i] = connect_sm(host, port, conn_opts, pool)
+    end
+    if opts.call_16 then
+        pool.call = pool.call_16
+        pool.eval = pool.eval_16
+    end
+    opts.password = nil
+    pool.opts = opts
+    if opts.wait_connected ~= false then
+        pool:wait_connected(tonumber(opts.wait_connected))
+    end
+    return pool
+end
+
 local function nothing_or_data(value)
     if value ~= nil then
         return value
@@ -1369,8 +1625,37 @@ index_metatable = function(remote)
         local iterator = check_iterator_type(opts, key_is_nil)
         local offset = tonumber(opts and opts.offset) or 0
         local limit = tonumber(opts and opts.limit) or 0xFFFFFFFF
-        return (remote:_request('select', opts, self.space.id, self.id,
-                                iterator, offset, limit, key))
+        -- With chunk_size the result is streamed in pushes of
+        -- chunk_size tuples, the response has the rest of them.
+        local chunk_size = tonumber(opts and opts.chunk_size) or 0
+        if chunk_size == 0 or opts.is_async or opts.on_push then
+            return (remote:_request('select', opts, self.space.id, self.id,
+                                    iterator, offset, limit, key,
+                                    chunk_size))
+        end
+        -- A synchronous select without on_push returns all
+        -- tuples, both streamed and sent in the response.
+        if opts.buffer or opts.raw then
+            error('index:select() with `chunk_size` and `buffer` or '..
+                  '`raw` requires `on_push`')
+        end
+        local chunks = {}
+        local chunk_opts = setmetatable({on_push = table.insert,
+                                         on_push_ctx = chunks},
+                                        {__index = opts})
+        local tail = remote:_request('select', chunk_opts, self.space.id,
+                                     self.id, iterator, offset, limit, key,
+                                     chunk_size)
+        local result = {}
+        for _, chunk in ipairs(chunks) do
+            for _, tuple in ipairs(chunk) do
+                table.insert(result, tuple)
+            end
+        end
+        for _, tuple in ipairs(tail) do
+            table.insert(result, tuple)
+        end
+        return result
     end
 
     function methods:get(key, opts)
@@ -1378,6 +1663,9 @@ index_metatable = function(remote)
         if opts and opts.buffer then
             error("index:get() doesn't support `buffer` argument")
         end
+        if opts and opts.raw then
+            error("index:get() doesn't support `raw` argument")
+        end
         return nothing_or_data(remote:_request('get', opts, self.space.id,
                                self.id, box.index.EQ, 0, 2, key))
     end
@@ -1387,6 +1675,9 @@ index_metatable = function(remote)
         if opts and opts.buffer then
             error("index:min() doesn't support `buffer` argument")
         end
+        if opts and opts.raw then
+            error("index:min() doesn't support `raw` argument")
+        end
         return nothing_or_data(remote:_request('min', opts, self.space.id,
                                                self.id, box.index.GE, 0, 1,
                                                key))
@@ -1397,6 +1688,9 @@ index_metatable = function(remote)
         if opts and opts.buffer then
             error("index:max() doesn't support `buffer` argument")
         end
+        if opts and opts.raw then
+            error("index:max() doesn't support `raw` argument")
+        end
         return nothing_or_data(remote:_request('max', opts, self.space.id,
                                                self.id, box.index.LE, 0, 1,
                                                key))
@@ -1407,6 +1701,9 @@ index_metatable = function(remote)
         if opts and opts.buffer then
             error("index:count() doesn't support `buffer` argument")
         end
+        if opts and opts.raw then
+            error("index:count() doesn't support `raw` argument")
+        end
         local code = string.format('box.space.%s.index.%s:count',
                                    self.space.name, self.name)
         return remote:_request('count', opts, code, { key, opts })
@@ -1432,6 +1729,7 @@ local this_module = {
     connect = connect,
     new = connect, -- Tarantool < 1.7.1 compatibility,
     wrap = wrap,
+    connect_pool = connect_pool,
     establish_connection = establish_connection,
 }
 
@@ -427,6 +427,8 @@ box.schema.space.create = function(name, options)
         format = 'table',
         is_local = 'boolean',
         temporary = 'boolean',
+        defer_deletes = 'boolean',
+        ttl_field = 'number',
     }
     local options_defaults = {
         engine = 'memtx',
@@ -471,6 +473,8 @@ box.schema.space.create = function(name, options)
     local space_options = setmap({
         group_id = options.is_local and 1 or nil,
         temporary = options.temporary and true or nil,
+        defer_deletes = options.defer_deletes and true or nil,
+        ttl_field = options.ttl_field,
     })
     _space:insert{id, uid, name, options.engine, options.field_count,
         space_options, format}
@@ -691,6 +695,11 @@ local index_options = {
     range_size = 'number',
     page_size = 'number',
     bloom_fpr = 'number',
+    covering = 'boolean',
+    prefix_compression = 'boolean',
+    upsert_threshold = 'number',
+    cache_reserve = 'number',
+    cache_limit = 'number',
 }
 
 --
@@ -796,6 +805,11 @@ box.schema.index.create = function(space_id, name, options)
             run_count_per_level = options.run_count_per_level,
             run_size_ratio = options.run_size_ratio,
             bloom_fpr = options.bloom_fpr,
+            covering = options.covering,
+            prefix_compression = options.prefix_compression,
+            upsert_threshold = options.upsert_threshold,
+            cache_reserve = options.cache_reserve,
+            cache_limit = options.cache_limit,
     }
     local field_type_aliases = {
         num = 'unsigned'; -- Deprecated since 1.7.2
@@ -1502,6 +1516,25 @@ space_mt.run_triggers = function(space, yesno)
     end
     builtin.space_run_triggers(s, yesno)
 end
+space_mt.bulk_load = function(space, tuples)
+    check_space_arg(space, 'bulk_load')
+    local next_tuple
+    if type(tuples) == 'table' then
+        local i = 0
+        next_tuple = function() i = i + 1 return tuples[i] end
+    elseif type(tuples) == 'function' then
+        next_tuple = tuples
+    else
+        error('Usage: space:bulk_load(tuples)')
+    end
+    return box.internal.space.bulk_load(space.id, function()
+        local tuple = next_tuple()
+        if tuple ~= nil and not is_tuple(tuple) then
+            tuple = box.tuple.new(tuple)
+        end
+        return tuple
+    end)
+end
 space_mt.frommap = box.internal.space.frommap
 space_mt.__index = space_mt
 
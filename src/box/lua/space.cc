@@ -49,6 +49,8 @@ extern "C" {
 #include "box/sequence.h"
 #include "box/coll_id_cache.h"
 #include "box/replication.h" /* GROUP_LOCAL */
+#include "box/box.h" /* box_is_ro() */
+#include "box/vinyl.h" /* vinyl_bulk_load_new() */
 
 /**
  * Trigger function for all spaces
@@ -508,6 +510,65 @@ usage_error:
 	return luaL_error(L, "Usage: space:frommap(map, opts)");
 }
 
+/**
+ * Load tuples into an empty vinyl space bypassing WAL,
+ * see vinyl_bulk_load_new().
+ * @param Lua space id.
+ * @param Lua function returning the next tuple to load or
+ *        nil if there are no more tuples.
+ */
+static int
+lbox_space_bulk_load(struct lua_State *L)
+{
+	if (lua_gettop(L) != 2 || !lua_isnumber(L, 1) ||
+	    !lua_isfunction(L, 2))
+		return luaL_error(L, "Usage: space:bulk_load(tuples)");
+	uint32_t space_id = lua_tointeger(L, 1);
+	struct space *space = space_cache_find(space_id);
+	if (space == NULL)
+		return luaT_error(L);
+	if (box_is_ro()) {
+		diag_set(ClientError, ER_READONLY);
+		return luaT_error(L);
+	}
+	if (access_check_space(space, PRIV_W) != 0)
+		return luaT_error(L);
+	if (!space_is_vinyl(space)) {
+		diag_set(ClientError, ER_UNSUPPORTED, space->engine->name,
+			 "bulk load");
+		return luaT_error(L);
+	}
+	struct vinyl_bulk_load *load = vinyl_bulk_load_new(space);
+	if (load == NULL)
+		return luaT_error(L);
+	while (true) {
+		lua_pushvalue(L, 2);
+		if (luaT_call(L, 0, 1) != 0)
+			goto fail;
+		if (lua_isnil(L, -1)) {
+			lua_pop(L, 1);
+			break;
+		}
+		struct tuple *tuple = luaT_istuple(L, -1);
+		if (tuple == NULL) {
+			diag_set(IllegalParams, "tuple expected");
+			goto fail;
+		}
+		uint32_t bsize;
+		const char *data = tuple_data_range(tuple, &bsize);
+		if (vinyl_bulk_load_add(load, data, data + bsize) != 0)
+			goto fail;
+		lua_pop(L, 1);
+	}
+	if (vinyl_bulk_load_commit(load) != 0)
+		goto fail;
+	vinyl_bulk_load_delete(load);
+	return 0;
+fail:
+	vinyl_bulk_load_delete(load);
+	return luaT_error(L);
+}
+
 void
 box_lua_space_init(struct lua_State *L)
 {
@@ -599,6 +660,7 @@ box_lua_space_init(struct lua_State *L)
 
 	static const struct luaL_Reg space_internal_lib[] = {
 		{"frommap", lbox_space_frommap},
+		{"bulk_load", lbox_space_bulk_load},
 		{NULL, NULL}
 	};
 	luaL_register(L, "box.internal.space", space_internal_lib);
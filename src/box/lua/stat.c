@@ -48,8 +48,6 @@
 
 extern struct rmean *rmean_box;
 extern struct rmean *rmean_error;
-/** network statistics (iproto & cbus) */
-extern struct rmean *rmean_net;
 extern struct rmean *rmean_tx_wal_bus;
 
 static void
@@ -140,14 +138,31 @@ static int
 lbox_stat_net_index(struct lua_State *L)
 {
 	luaL_checkstring(L, -1);
-	return rmean_foreach(rmean_net, seek_stat_item, L);
+	return iproto_rmean_foreach(seek_stat_item, L);
 }
 
 static int
 lbox_stat_net_call(struct lua_State *L)
 {
 	lua_newtable(L);
-	rmean_foreach(rmean_net, set_stat_item, L);
+	iproto_rmean_foreach(set_stat_item, L);
+	return 1;
+}
+
+/**
+ * Return network statistics of each network thread,
+ * e.g. box.stat.net.thread()[1].SENT.
+ */
+static int
+lbox_stat_net_thread(struct lua_State *L)
+{
+	int count = iproto_thread_count();
+	lua_createtable(L, count, 0);
+	for (int i = 0; i < count; i++) {
+		lua_newtable(L);
+		iproto_thread_rmean_foreach(i, set_stat_item, L);
+		lua_rawseti(L, -2, i + 1);
+	}
 	return 1;
 }
 
@@ -181,6 +196,7 @@ box_lua_stat_init(struct lua_State *L)
 	lua_pop(L, 1); /* stat module */
 
 	static const struct luaL_Reg netstatlib [] = {
+		{"thread", lbox_stat_net_thread},
 		{NULL, NULL}
 	};
 
@@ -35,6 +35,7 @@
 #include "trigger.h"
 #include "user.h"
 #include "error.h"
+#include "execute.h"
 
 const char *session_type_strs[] = {
 	"background",
@@ -108,6 +109,7 @@ session_create(enum session_type type)
 	session->type = type;
 	session->sql_flags = default_flags;
 	session->sql_default_engine = SQL_STORAGE_ENGINE_MEMTX;
+	session->sql_stmts = NULL;
 
 	/* For on_connect triggers. */
 	credentials_init(&session->credentials, guest_user->auth_token,
@@ -198,6 +200,7 @@ void
 session_destroy(struct session *session)
 {
 	session_storage_cleanup(session->id);
+	sql_session_stmts_free(session);
 	struct mh_i64ptr_node_t node = { session->id, NULL };
 	mh_i64ptr_remove(session_registry, &node, NULL);
 	mempool_free(&session_pool, session);
@@ -43,6 +43,7 @@ extern "C" {
 
 struct port;
 struct session_vtab;
+struct mh_i32ptr_t;
 
 void
 session_init();
@@ -96,6 +97,11 @@ struct session {
 	uint8_t sql_default_engine;
 	/** SQL Connection flag for current user session */
 	uint32_t sql_flags;
+	/**
+	 * Statements prepared in the session, by statement id.
+	 * Created on the first PREPARE request.
+	 */
+	struct mh_i32ptr_t *sql_stmts;
 	enum session_type type;
 	/** Session metadata. */
 	union session_meta meta;
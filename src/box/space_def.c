@@ -56,6 +56,8 @@ const struct space_opts space_opts_default = {
 	/* .view = */ false,
 	/* .sql        = */ NULL,
 	/* .checks     = */ NULL,
+	/* .defer_deletes = */ false,
+	/* .ttl_field  = */ 0,
 };
 
 const struct opt_def space_opts_reg[] = {
@@ -65,6 +67,8 @@ const struct opt_def space_opts_reg[] = {
 	OPT_DEF("sql", OPT_STRPTR, struct space_opts, sql),
 	OPT_DEF_ARRAY("checks", struct space_opts, checks,
 		      checks_array_decode),
+	OPT_DEF("defer_deletes", OPT_BOOL, struct space_opts, defer_deletes),
+	OPT_DEF("ttl_field", OPT_UINT32, struct space_opts, ttl_field),
 	OPT_END,
 };
 
@@ -68,6 +68,20 @@ struct space_opts {
 	char *sql;
 	/** SQL Checks expressions list. */
 	struct ExprList *checks;
+	/**
+	 * Vinyl only: do not look up the overwritten tuple on
+	 * REPLACE and DELETE. Secondary index entries of the
+	 * overwritten tuple are deleted when the primary index
+	 * is dumped or compacted.
+	 */
+	bool defer_deletes;
+	/**
+	 * Vinyl only: 1-based number of the field that stores
+	 * the tuple expiration time, in seconds since the Epoch,
+	 * or 0 if tuples never expire. Expired tuples are not
+	 * returned by reads and are dropped by compaction.
+	 */
+	uint32_t ttl_field;
 };
 
 extern const struct space_opts space_opts_default;
@@ -1022,6 +1022,16 @@ int
 sqlite3_bind_parameter_lindex(sqlite3_stmt * pStmt, const char *zName,
 			      int nName);
 
+/**
+ * Get schema version the prepared statement was compiled
+ * against.
+ * @param stmt Prepared statement.
+ *
+ * @retval Schema version.
+ */
+uint32_t
+sql_stmt_schema_version(sqlite3_stmt *stmt);
+
 /*
  * If compiling for a processor that lacks floating point support,
  * substitute integer for floating-point
@@ -1495,6 +1495,13 @@ sqlite3_stmt_busy(sqlite3_stmt * pStmt)
 	return v != 0 && v->magic == VDBE_MAGIC_RUN && v->pc >= 0;
 }
 
+uint32_t
+sql_stmt_schema_version(sqlite3_stmt *stmt)
+{
+	Vdbe *v = (Vdbe *) stmt;
+	return v->schema_ver;
+}
+
 /*
  * Return a pointer to the next prepared statement after pStmt associated
  * with database connection pDb.  If pStmt is NULL, return the first
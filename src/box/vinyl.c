@@ -54,6 +54,7 @@
 #include <small/lsregion.h>
 #include <small/region.h>
 #include <small/mempool.h>
+#include <third_party/qsort_arg.h>
 
 #include "coio_task.h"
 #include "cbus.h"
@@ -72,6 +73,8 @@
 #include "checkpoint.h"
 #include "session.h"
 #include "wal.h" /* wal_mode() */
+#include "schema.h" /* space_foreach() */
+#include "replication.h" /* replicaset_foreach() */
 
 /**
  * Yield after iterating over this many objects (e.g. ranges).
@@ -84,6 +87,7 @@ enum { VY_YIELD_LOOPS = 2 };
 #endif
 
 struct vy_squash_queue;
+struct vy_scrubber;
 
 enum vy_status {
 	VINYL_OFFLINE,
@@ -101,6 +105,8 @@ struct vy_env {
 	struct tx_manager   *xm;
 	/** Upsert squash queue */
 	struct vy_squash_queue *squash_queue;
+	/** Background run scrubber */
+	struct vy_scrubber *scrubber;
 	/** Memory pool for index iterator. */
 	struct mempool iterator_pool;
 	/** Memory quota */
@@ -180,6 +186,11 @@ enum {
 	 * is averaged, in seconds.
 	 */
 	VY_QUOTA_RATE_AVG_PERIOD = 5,
+	/**
+	 * Page index of a run that hasn't been read for
+	 * this long is freed, in seconds.
+	 */
+	VY_PAGE_INDEX_UNLOAD_TIMEOUT = 600,
 };
 
 static inline int64_t
@@ -227,6 +238,15 @@ static void
 vy_gc(struct vy_env *env, struct vy_recovery *recovery,
       unsigned int gc_mask, int64_t gc_lsn);
 
+enum {
+	/**
+	 * Max number of secondary index statements read ahead
+	 * by an iterator to look them up in the primary index
+	 * at once, see vinyl_iterator_secondary_fetch().
+	 */
+	VY_ITERATOR_BATCH_SIZE = 16,
+};
+
 struct vinyl_iterator {
 	struct iterator base;
 	/** Vinyl environment. */
@@ -250,6 +270,16 @@ struct vinyl_iterator {
 	struct vy_tx tx_autocommit;
 	/** Trigger invoked when tx ends to close the iterator. */
 	struct trigger on_tx_destroy;
+	/** Statements read from a secondary index. */
+	struct tuple *batch_keys[VY_ITERATOR_BATCH_SIZE];
+	/** Tuples found in the primary index for @batch_keys. */
+	struct tuple *batch_tuples[VY_ITERATOR_BATCH_SIZE];
+	/** Number of statements in the batch. */
+	int batch_count;
+	/** Position of the next statement to return from the batch. */
+	int batch_pos;
+	/** Set if the read iterator has returned all statements. */
+	bool is_eof;
 };
 
 static const struct engine_vtab vinyl_engine_vtab;
@@ -322,6 +352,11 @@ vy_info_append_cache(struct vy_env *env, struct info_handler *h)
 	info_table_end(h);
 }
 
+static void
+vy_info_append_scrub(struct vy_env *env, struct info_handler *h);
+static void
+vy_scrubber_reset_stat(struct vy_scrubber *scrubber);
+
 static void
 vy_info_append_tx(struct vy_env *env, struct info_handler *h)
 {
@@ -355,6 +390,7 @@ vinyl_engine_stat(struct vinyl_engine *vinyl, struct info_handler *h)
 	vy_info_append_quota(env, h);
 	vy_info_append_cache(env, h);
 	vy_info_append_tx(env, h);
+	vy_info_append_scrub(env, h);
 	info_end(h);
 }
 
@@ -384,6 +420,21 @@ vy_info_append_disk_stmt_counter(struct info_handler *h, const char *name,
 		info_table_end(h);
 }
 
+static void
+vy_info_append_latency(struct info_handler *h, const char *name,
+		       struct latency *latency)
+{
+	if (name != NULL)
+		info_table_begin(h, name);
+	info_append_double(h, "p50", latency_get(latency, 50));
+	info_append_double(h, "p75", latency_get(latency, 75));
+	info_append_double(h, "p90", latency_get(latency, 90));
+	info_append_double(h, "p95", latency_get(latency, 95));
+	info_append_double(h, "p99", latency_get(latency, 99));
+	if (name != NULL)
+		info_table_end(h);
+}
+
 static void
 vy_info_append_compact_stat(struct info_handler *h, const char *name,
 			    const struct vy_compact_stat *stat)
@@ -414,16 +465,22 @@ vinyl_index_stat(struct index *index, struct info_handler *h)
 	vy_info_append_stmt_counter(h, "put", &stat->put);
 
 	info_table_begin(h, "latency");
-	info_append_double(h, "p50", latency_get(&stat->latency, 50));
-	info_append_double(h, "p75", latency_get(&stat->latency, 75));
-	info_append_double(h, "p90", latency_get(&stat->latency, 90));
-	info_append_double(h, "p95", latency_get(&stat->latency, 95));
-	info_append_double(h, "p99", latency_get(&stat->latency, 99));
+	vy_info_append_latency(h, NULL, &stat->latency);
+	vy_info_append_latency(h, "cache",
+			&stat->read_latency[VY_READ_SOURCE_CACHE]);
+	vy_info_append_latency(h, "memory",
+			&stat->read_latency[VY_READ_SOURCE_MEMORY]);
+	vy_info_append_latency(h, "disk",
+			&stat->read_latency[VY_READ_SOURCE_DISK]);
+	vy_info_append_latency(h, "dump", &stat->disk.dump_latency);
+	vy_info_append_latency(h, "compact", &stat->disk.compact_latency);
 	info_table_end(h);
 
 	info_table_begin(h, "upsert");
 	info_append_int(h, "squashed", stat->upsert.squashed);
 	info_append_int(h, "applied", stat->upsert.applied);
+	histogram_snprint(buf, sizeof(buf), stat->upsert_chain_hist);
+	info_append_str(h, "chain_histogram", buf);
 	info_table_end(h);
 
 	info_table_begin(h, "memory");
@@ -461,6 +518,9 @@ vinyl_index_stat(struct index *index, struct info_handler *h)
 	vy_info_append_stmt_counter(h, "evict", &cache_stat->evict);
 	info_append_int(h, "index_size",
 			vy_cache_tree_mem_used(&lsm->cache.cache_tree));
+	info_append_int(h, "used", lsm->cache.mem_used);
+	info_append_int(h, "reserve", lsm->cache.mem_reserve);
+	info_append_int(h, "limit", lsm->cache.mem_limit);
 	info_table_end(h);
 
 	info_table_begin(h, "txw");
@@ -477,6 +537,26 @@ vinyl_index_stat(struct index *index, struct info_handler *h)
 	histogram_snprint(buf, sizeof(buf), lsm->run_hist);
 	info_append_str(h, "run_histogram", buf);
 
+	/*
+	 * Read amplification is the average number of runs
+	 * searched per lookup (runs filtered out by bloom are
+	 * not counted), while the histogram shows its
+	 * distribution. Write amplification is the ratio of
+	 * bytes written by dumps and compactions to bytes
+	 * written by dumps.
+	 */
+	info_table_begin(h, "amplification");
+	info_append_double(h, "read", stat->read_run_hist->total == 0 ? 0 :
+			   (double)stat->read_run_count /
+			   stat->read_run_hist->total);
+	histogram_snprint(buf, sizeof(buf), stat->read_run_hist);
+	info_append_str(h, "read_histogram", buf);
+	info_append_double(h, "write", stat->disk.dump.out.bytes == 0 ? 0 :
+			   (double)(stat->disk.dump.out.bytes +
+				    stat->disk.compact.out.bytes) /
+			   stat->disk.dump.out.bytes);
+	info_table_end(h);
+
 	info_end(h);
 }
 
@@ -489,6 +569,13 @@ vinyl_index_reset_stat(struct index *index)
 
 	stat->lookup = 0;
 	latency_reset(&stat->latency);
+	for (int i = 0; i < vy_read_source_MAX; i++)
+		latency_reset(&stat->read_latency[i]);
+	latency_reset(&stat->disk.dump_latency);
+	latency_reset(&stat->disk.compact_latency);
+	histogram_reset(stat->read_run_hist);
+	stat->read_run_count = 0;
+	histogram_reset(stat->upsert_chain_hist);
 	memset(&stat->get, 0, sizeof(stat->get));
 	memset(&stat->put, 0, sizeof(stat->put));
 	memset(&stat->upsert, 0, sizeof(stat->upsert));
@@ -535,6 +622,7 @@ vinyl_engine_reset_stat(struct engine *engine)
 	struct tx_manager *xm = env->xm;
 
 	memset(&xm->stat, 0, sizeof(xm->stat));
+	vy_scrubber_reset_stat(env->scrubber);
 }
 
 /** }}} Introspection */
@@ -644,6 +732,13 @@ vinyl_engine_create_space(struct engine *engine, struct space_def *def,
 	/* Format is now referenced by the space. */
 	tuple_format_unref(format);
 
+	for (uint32_t i = 0; i < space->index_count; i++) {
+		struct vy_lsm *lsm = vy_lsm(space->index[i]);
+		lsm->defer_deletes = def->opts.defer_deletes;
+		if (vy_lsm_is_covering(lsm))
+			lsm->ttl_field = def->opts.ttl_field;
+	}
+
 	/*
 	 * Check if there are unique indexes that are contained
 	 * by other unique indexes. For them, we can skip check
@@ -697,6 +792,29 @@ vinyl_space_check_index_def(struct space *space, struct index_def *index_def)
 			return -1;
 		}
 	}
+	if (index_def->opts.upsert_threshold <= 0 ||
+	    index_def->opts.upsert_threshold > VY_UPSERT_THRESHOLD) {
+		diag_set(ClientError, ER_WRONG_INDEX_OPTIONS,
+			 BOX_INDEX_FIELD_OPTS,
+			 tt_sprintf("upsert_threshold must be greater than 0 "
+				    "and less than or equal to %d",
+				    VY_UPSERT_THRESHOLD));
+		return -1;
+	}
+	if (index_def->opts.cache_reserve < 0 ||
+	    index_def->opts.cache_limit < 0) {
+		diag_set(ClientError, ER_WRONG_INDEX_OPTIONS,
+			 BOX_INDEX_FIELD_OPTS,
+			 "cache_reserve and cache_limit must not be negative");
+		return -1;
+	}
+	if (index_def->opts.cache_limit != 0 &&
+	    index_def->opts.cache_reserve > index_def->opts.cache_limit) {
+		diag_set(ClientError, ER_WRONG_INDEX_OPTIONS,
+			 BOX_INDEX_FIELD_OPTS,
+			 "cache_reserve must not be greater than cache_limit");
+		return -1;
+	}
 	return 0;
 }
 
@@ -972,6 +1090,11 @@ vinyl_index_def_change_requires_rebuild(struct index *index,
 	if (!old_def->opts.is_unique && new_def->opts.is_unique)
 		return true;
 
+	/* Covering indexes store full tuples on disk. */
+	if (old_def->iid > 0 &&
+	    old_def->opts.is_covering != new_def->opts.is_covering)
+		return true;
+
 	assert(index_depends_on_pk(index));
 	const struct key_def *old_cmp_def = old_def->cmp_def;
 	const struct key_def *new_cmp_def = new_def->cmp_def;
@@ -1006,12 +1129,47 @@ vinyl_index_def_change_requires_rebuild(struct index *index,
 static int
 vinyl_space_prepare_alter(struct space *old_space, struct space *new_space)
 {
-	(void)new_space;
 	struct vy_env *env = vy_env(old_space->engine);
 
 	if (vinyl_check_wal(env, "DDL") != 0)
 		return -1;
 
+	/*
+	 * Secondary indexes of a space with deferred DELETEs may
+	 * store entries for overwritten tuples, which are only
+	 * filtered out on read if the option is set.
+	 */
+	if (old_space->def->opts.defer_deletes &&
+	    !new_space->def->opts.defer_deletes &&
+	    old_space->index_count > 1) {
+		struct vy_lsm *pk = vy_lsm(old_space->index[0]);
+		if (pk->stat.memory.count.rows > 0 ||
+		    pk->stat.disk.count.rows > 0) {
+			diag_set(ClientError, ER_ALTER_SPACE,
+				 space_name(old_space),
+				 "can not disable defer_deletes "
+				 "for a non-empty space");
+			return -1;
+		}
+	}
+	/*
+	 * Expiration time is stored in a tuple field, so only
+	 * LSM trees storing full tuples can filter out expired
+	 * tuples. Entries of a non-covering secondary index
+	 * would never be purged.
+	 */
+	if (new_space->def->opts.ttl_field != 0) {
+		for (uint32_t i = 1; i < new_space->index_count; i++) {
+			struct vy_lsm *lsm = vy_lsm(new_space->index[i]);
+			if (vy_lsm_is_covering(lsm))
+				continue;
+			diag_set(ClientError, ER_ALTER_SPACE,
+				 space_name(new_space),
+				 "secondary indexes of a space with "
+				 "ttl_field must be covering");
+			return -1;
+		}
+	}
 	return 0;
 }
 
@@ -1088,6 +1246,8 @@ vinyl_space_check_format(struct space *space, struct tuple_format *format)
 	struct vy_read_iterator itr;
 	vy_read_iterator_open(&itr, pk, NULL, ITER_ALL, key,
 			      &env->xm->p_global_read_view);
+	/* Don't let the full scan flush the cache. */
+	itr.skip_cache = true;
 	int rc;
 	int loops = 0;
 	struct tuple *tuple;
@@ -1134,11 +1294,15 @@ vinyl_space_swap_index(struct space *old_space, struct space *new_space,
 
 	SWAP(old_lsm, new_lsm);
 	SWAP(old_lsm->check_is_unique, new_lsm->check_is_unique);
+	SWAP(old_lsm->defer_deletes, new_lsm->defer_deletes);
+	SWAP(old_lsm->ttl_field, new_lsm->ttl_field);
 	SWAP(old_lsm->mem_format, new_lsm->mem_format);
 	SWAP(old_lsm->mem_format_with_colmask,
 	     new_lsm->mem_format_with_colmask);
 	SWAP(old_lsm->disk_format, new_lsm->disk_format);
 	SWAP(old_lsm->opts, new_lsm->opts);
+	SWAP(old_lsm->cache.mem_reserve, new_lsm->cache.mem_reserve);
+	SWAP(old_lsm->cache.mem_limit, new_lsm->cache.mem_limit);
 	key_def_swap(old_lsm->key_def, new_lsm->key_def);
 	key_def_swap(old_lsm->cmp_def, new_lsm->cmp_def);
 
@@ -1487,6 +1651,31 @@ error_unref:
 	return -1;
 }
 
+/**
+ * Check if REPLACE and DELETE by the primary key may skip looking
+ * up the old tuple in a space with secondary indexes. In this
+ * case the statement is marked with VY_STMT_DEFERRED_DELETE and
+ * DELETEs for secondary indexes are generated when the primary
+ * index is dumped or compacted.
+ *
+ * This is impossible if the old tuple is needed by on_replace
+ * triggers or if the space has unique secondary indexes, because
+ * a stale entry can't be told from a duplicate without reading
+ * the primary index anyway.
+ */
+static bool
+vy_space_defers_deletes(struct space *space)
+{
+	if (!space->def->opts.defer_deletes ||
+	    !rlist_empty(&space->on_replace))
+		return false;
+	for (uint32_t i = 1; i < space->index_count; i++) {
+		if (space->index[i]->def->opts.is_unique)
+			return false;
+	}
+	return true;
+}
+
 /**
  * Execute REPLACE in a space with multiple indexes and lookup for
  * an old tuple, that should has been set in \p stmt->old_tuple if
@@ -1524,12 +1713,21 @@ vy_replace_impl(struct vy_env *env, struct vy_tx *tx, struct space *space,
 	if (new_stmt == NULL)
 		return -1;
 
-	/* Get full tuple from the primary index. */
-	if (vy_lsm_get(pk, tx, vy_tx_read_view(tx),
-			 new_stmt, &old_stmt) != 0)
+	bool is_deferred = vy_space_defers_deletes(space);
+	if (is_deferred) {
+		/*
+		 * Don't read the old tuple. Secondary index entries
+		 * corresponding to it will be deleted on primary
+		 * index dump or compaction.
+		 */
+		vy_stmt_set_flags(new_stmt, VY_STMT_DEFERRED_DELETE);
+	} else if (vy_lsm_get(pk, tx, vy_tx_read_view(tx),
+			      new_stmt, &old_stmt) != 0) {
+		/* Get full tuple from the primary index. */
 		goto error;
+	}
 
-	if (old_stmt == NULL) {
+	if (old_stmt == NULL && !is_deferred) {
 		/*
 		 * We can turn REPLACE into INSERT if the new key
 		 * does not have history.
@@ -1656,7 +1854,9 @@ vy_lsm_full_by_key(struct vy_lsm *lsm, struct vy_tx *tx,
 	tuple_unref(key);
 	if (rc != 0)
 		return -1;
-	if (lsm->index_id == 0 || found == NULL) {
+	if (lsm->index_id == 0 || found == NULL ||
+	    (lsm->opts.is_covering && !lsm->defer_deletes)) {
+		/* The found tuple is full. */
 		*result = found;
 		return 0;
 	}
@@ -1665,6 +1865,12 @@ vy_lsm_full_by_key(struct vy_lsm *lsm, struct vy_tx *tx,
 	 * tracked in the secondary index LSM tree.
 	 */
 	rc = vy_point_lookup(lsm->pk, tx, rv, found, result);
+	if (rc == 0 && *result != NULL && lsm->defer_deletes &&
+	    vy_tuple_compare(*result, found, lsm->cmp_def) != 0) {
+		/* Stale entry of an overwritten tuple. */
+		tuple_unref(*result);
+		*result = NULL;
+	}
 	tuple_unref(found);
 	return rc;
 }
@@ -1740,6 +1946,14 @@ vy_delete(struct vy_env *env, struct vy_tx *tx, struct txn_stmt *stmt,
 	uint32_t part_count = mp_decode_array(&key);
 	if (vy_unique_key_validate(lsm, key, part_count))
 		return -1;
+	/*
+	 * DELETE by the primary key doesn't need the old tuple
+	 * if the space defers deletes from secondary indexes.
+	 */
+	bool is_deferred = has_secondary && lsm->index_id == 0 &&
+			   vy_space_defers_deletes(space);
+	if (is_deferred)
+		has_secondary = false;
 	/*
 	 * There are two cases when need to get the full tuple
 	 * before deletion.
@@ -1768,6 +1982,8 @@ vy_delete(struct vy_env *env, struct vy_tx *tx, struct txn_stmt *stmt,
 							      pk->mem_format);
 		if (delete == NULL)
 			return -1;
+		if (is_deferred)
+			vy_stmt_set_flags(delete, VY_STMT_DEFERRED_DELETE);
 		int rc = vy_tx_set(tx, pk, delete);
 		tuple_unref(delete);
 		return rc;
@@ -2452,6 +2668,22 @@ vinyl_engine_rollback(struct engine *engine, struct txn *txn)
 		trigger_clear(&txn->fiber_on_stop);
 }
 
+/**
+ * Check that a transaction may go on reading and writing,
+ * i.e. it hasn't been aborted by a conflict, e.g. by a bulk
+ * load into a space it has read.
+ */
+static int
+vy_tx_check_aborted(struct vy_tx *tx)
+{
+	if (tx != NULL && (tx->state == VINYL_TX_ABORT ||
+			   tx->read_view->is_aborted)) {
+		diag_set(ClientError, ER_READ_VIEW_ABORTED);
+		return -1;
+	}
+	return 0;
+}
+
 static int
 vinyl_engine_begin_statement(struct engine *engine, struct txn *txn)
 {
@@ -2460,7 +2692,7 @@ vinyl_engine_begin_statement(struct engine *engine, struct txn *txn)
 	struct txn_stmt *stmt = txn_current_stmt(txn);
 	assert(tx != NULL);
 	stmt->engine_savepoint = vy_tx_savepoint(tx);
-	return 0;
+	return vy_tx_check_aborted(tx);
 }
 
 static void
@@ -2510,6 +2742,13 @@ vy_env_quota_timer_cb(ev_loop *loop, ev_timer *timer, int events)
 			    (dump_bandwidth + e->quota_use_rate + 1));
 
 	vy_quota_set_watermark(&e->quota, watermark);
+
+	/*
+	 * Free page indexes of runs that haven't been read
+	 * for a while. They will be reloaded on demand.
+	 */
+	vy_run_env_unload_page_indexes(&e->run_env,
+				       VY_PAGE_INDEX_UNLOAD_TIMEOUT);
 }
 
 static void
@@ -2568,10 +2807,17 @@ vy_env_dump_complete_cb(struct vy_scheduler *scheduler,
 				  mem_dumped / dump_duration);
 }
 
+static int
+vy_env_deferred_delete_cb(struct vy_scheduler *scheduler, struct vy_lsm *pk,
+			  const struct vy_deferred_delete *stmts, int count);
 static struct vy_squash_queue *
 vy_squash_queue_new(void);
 static void
 vy_squash_queue_delete(struct vy_squash_queue *q);
+static struct vy_scrubber *
+vy_scrubber_new(void);
+static void
+vy_scrubber_delete(struct vy_scrubber *scrubber);
 static void
 vy_squash_schedule(struct vy_lsm *lsm, struct tuple *stmt,
 		   void /* struct vy_env */ *arg);
@@ -2633,10 +2879,14 @@ vy_env_new(const char *path, size_t memory,
 	e->squash_queue = vy_squash_queue_new();
 	if (e->squash_queue == NULL)
 		goto error_squash_queue;
+	e->scrubber = vy_scrubber_new();
+	if (e->scrubber == NULL)
+		goto error_scrubber;
 
 	vy_mem_env_create(&e->mem_env, e->memory);
 	vy_scheduler_create(&e->scheduler, e->write_threads,
 			    vy_env_dump_complete_cb,
+			    vy_env_deferred_delete_cb,
 			    &e->run_env, &e->xm->read_views);
 
 	if (vy_lsm_env_create(&e->lsm_env, e->path,
@@ -2659,6 +2909,8 @@ vy_env_new(const char *path, size_t memory,
 error_lsm_env:
 	vy_mem_env_destroy(&e->mem_env);
 	vy_scheduler_destroy(&e->scheduler);
+	vy_scrubber_delete(e->scrubber);
+error_scrubber:
 	vy_squash_queue_delete(e->squash_queue);
 error_squash_queue:
 	tx_manager_delete(e->xm);
@@ -2677,6 +2929,7 @@ vy_env_delete(struct vy_env *e)
 	ev_timer_stop(loop(), &e->quota_timer);
 	vy_scheduler_destroy(&e->scheduler);
 	vy_squash_queue_delete(e->squash_queue);
+	vy_scrubber_delete(e->scrubber);
 	tx_manager_delete(e->xm);
 	free(e->path);
 	histogram_delete(e->dump_bw);
@@ -2755,6 +3008,15 @@ vinyl_engine_set_timeout(struct vinyl_engine *vinyl, double timeout)
 	vinyl->env->timeout = timeout;
 }
 
+static void
+vy_scrubber_set_rate(struct vy_env *env, double rate);
+
+void
+vinyl_engine_set_scrub_rate(struct vinyl_engine *vinyl, double rate)
+{
+	vy_scrubber_set_rate(vinyl->env, rate);
+}
+
 void
 vinyl_engine_set_too_long_threshold(struct vinyl_engine *vinyl,
 				    double too_long_threshold)
@@ -3061,7 +3323,7 @@ vy_send_range(struct vy_join_ctx *ctx,
 	struct rlist fake_read_views;
 	rlist_create(&fake_read_views);
 	ctx->wi = vy_write_iterator_new(ctx->key_def, ctx->format,
-					true, true, &fake_read_views);
+					true, true, 0, &fake_read_views, NULL);
 	if (ctx->wi == NULL) {
 		rc = -1;
 		goto out;
@@ -3781,6 +4043,335 @@ fail:
 	diag_clear(diag_get());
 }
 
+/* {{{ Scrubber */
+
+enum {
+	/**
+	 * Time to wait before starting a new pass if the
+	 * previous one didn't find any runs, in seconds.
+	 */
+	VY_SCRUB_IDLE_TIMEOUT = 1,
+	/**
+	 * Max number of bytes verified in one go, i.e. without
+	 * checking the rate and pausing.
+	 */
+	VY_SCRUB_CHUNK_MAX = 1024 * 1024,
+};
+
+/**
+ * A run to verify, see vy_scrubber::runs. The run isn't
+ * referenced, because the pass may take long, so it is looked
+ * up by id when its turn comes, see vy_scrubber_find_run().
+ */
+struct vy_scrubber_run {
+	/** Space and index the run belongs to. */
+	uint32_t space_id;
+	uint32_t index_id;
+	/** Id of the LSM tree the run belongs to. */
+	int64_t lsm_id;
+	/** Id of the run. */
+	int64_t run_id;
+};
+
+struct vy_scrubber {
+	/** Fiber verifying runs in background. */
+	struct fiber *fiber;
+	/**
+	 * Used to wake up the fiber when scrubbing is enabled
+	 * or the rate is changed.
+	 */
+	struct fiber_cond cond;
+	/** Max read rate, in bytes per second, 0 if disabled. */
+	double rate;
+	/**
+	 * Runs to verify in the current pass, in the order of
+	 * space_foreach(). Collected when a pass starts, so that
+	 * looking up the next run doesn't need to walk over all
+	 * spaces. Runs created during the pass are verified by
+	 * the next one, runs deleted during the pass are skipped.
+	 */
+	struct vy_scrubber_run *runs;
+	/** Number of runs in the current pass. */
+	int run_count;
+	/** Number of entries allocated for @runs. */
+	int run_capacity;
+	/** Index of the next run to verify in @runs. */
+	int next_run;
+	struct {
+		/** Number of verified runs. */
+		int64_t runs;
+		/** Number of bytes read from disk. */
+		int64_t bytes;
+		/** Number of checks that found a run corrupted. */
+		int64_t corrupted;
+	} stat;
+};
+
+static struct vy_scrubber *
+vy_scrubber_new(void)
+{
+	struct vy_scrubber *scrubber = calloc(1, sizeof(*scrubber));
+	if (scrubber == NULL) {
+		diag_set(OutOfMemory, sizeof(*scrubber),
+			 "malloc", "struct vy_scrubber");
+		return NULL;
+	}
+	fiber_cond_create(&scrubber->cond);
+	return scrubber;
+}
+
+static void
+vy_scrubber_delete(struct vy_scrubber *scrubber)
+{
+	struct fiber *fiber = scrubber->fiber;
+	if (fiber != NULL) {
+		scrubber->fiber = NULL;
+		/*
+		 * The fiber may be verifying a run in a coio thread,
+		 * in which case it accesses the scrubber when it
+		 * resumes, so wait for it to stop. Don't wait if the
+		 * event loop is already stopped, as it is at exit:
+		 * then the fiber won't ever resume.
+		 */
+		fiber_cancel(fiber);
+		if (fiber() != &cord()->sched)
+			fiber_join(fiber);
+	}
+	free(scrubber->runs);
+	free(scrubber);
+}
+
+static void
+vy_scrubber_reset_stat(struct vy_scrubber *scrubber)
+{
+	memset(&scrubber->stat, 0, sizeof(scrubber->stat));
+}
+
+static void
+vy_info_append_scrub(struct vy_env *env, struct info_handler *h)
+{
+	struct vy_scrubber *scrubber = env->scrubber;
+	info_table_begin(h, "scrub");
+	info_append_int(h, "runs", scrubber->stat.runs);
+	info_append_int(h, "bytes", scrubber->stat.bytes);
+	info_append_int(h, "corrupted", scrubber->stat.corrupted);
+	info_table_end(h);
+}
+
+/** Add runs of a space to the current scrubber pass. */
+static int
+vy_scrubber_collect_cb(struct space *space, void *cb_arg)
+{
+	struct vy_scrubber *scrubber = cb_arg;
+	if (space->vtab != &vinyl_space_vtab)
+		return 0;
+	for (uint32_t i = 0; i < space->index_count; i++) {
+		struct vy_lsm *lsm = vy_lsm(space->index[i]);
+		if (lsm->is_dropped)
+			continue;
+		struct vy_run *run;
+		rlist_foreach_entry(run, &lsm->runs, in_lsm) {
+			if (scrubber->run_count == scrubber->run_capacity) {
+				int capacity = scrubber->run_capacity > 0 ?
+					       scrubber->run_capacity * 2 : 16;
+				struct vy_scrubber_run *runs = realloc(
+					scrubber->runs,
+					capacity * sizeof(*runs));
+				if (runs == NULL) {
+					diag_set(OutOfMemory,
+						 capacity * sizeof(*runs),
+						 "realloc",
+						 "struct vy_scrubber_run");
+					return -1;
+				}
+				scrubber->runs = runs;
+				scrubber->run_capacity = capacity;
+			}
+			struct vy_scrubber_run *entry =
+				&scrubber->runs[scrubber->run_count++];
+			entry->space_id = lsm->space_id;
+			entry->index_id = lsm->index_id;
+			entry->lsm_id = lsm->id;
+			entry->run_id = run->id;
+		}
+	}
+	return 0;
+}
+
+/** Forget the runs of the current scrubber pass. */
+static void
+vy_scrubber_end_pass(struct vy_scrubber *scrubber)
+{
+	scrubber->run_count = 0;
+	scrubber->next_run = 0;
+}
+
+/**
+ * Look up a run collected for the current scrubber pass.
+ * Returns NULL if the run has been deleted by compaction or
+ * index drop since the pass started.
+ */
+static struct vy_run *
+vy_scrubber_find_run(const struct vy_scrubber_run *entry,
+		     struct vy_lsm **p_lsm)
+{
+	struct space *space = space_by_id(entry->space_id);
+	if (space == NULL || space->vtab != &vinyl_space_vtab)
+		return NULL;
+	struct index *index = space_index(space, entry->index_id);
+	if (index == NULL)
+		return NULL;
+	struct vy_lsm *lsm = vy_lsm(index);
+	if (lsm->id != entry->lsm_id || lsm->is_dropped)
+		return NULL;
+	struct vy_run *run;
+	rlist_foreach_entry(run, &lsm->runs, in_lsm) {
+		if (run->id == entry->run_id) {
+			*p_lsm = lsm;
+			return run;
+		}
+	}
+	return NULL;
+}
+
+/** Start a new scrubber pass. */
+static void
+vy_scrubber_start_pass(struct vy_scrubber *scrubber)
+{
+	vy_scrubber_end_pass(scrubber);
+	if (space_foreach(vy_scrubber_collect_cb, scrubber) != 0) {
+		/* Verify the runs collected so far. */
+		diag_log();
+		diag_clear(diag_get());
+	}
+}
+
+static ssize_t
+vy_scrubber_verify_f(va_list ap)
+{
+	const char *dir = va_arg(ap, const char *);
+	uint32_t space_id = va_arg(ap, uint32_t);
+	uint32_t index_id = va_arg(ap, uint32_t);
+	int64_t run_id = va_arg(ap, int64_t);
+	struct vy_run_verify_pos *pos = va_arg(ap, struct vy_run_verify_pos *);
+	size_t chunk_size = va_arg(ap, size_t);
+	size_t *bytes = va_arg(ap, size_t *);
+	return vy_run_verify(dir, space_id, index_id, run_id,
+			     pos, chunk_size, bytes);
+}
+
+/**
+ * Verify a run chunk by chunk, pausing between chunks so as
+ * not to exceed the configured rate. The rate is re-read before
+ * each chunk, so that a change takes effect immediately.
+ * Verification is interrupted if scrubbing is disabled.
+ */
+static void
+vy_scrubber_verify_run(struct vy_env *env, struct vy_lsm *lsm,
+		       struct vy_run *run)
+{
+	struct vy_scrubber *scrubber = env->scrubber;
+	struct vy_run_verify_pos pos = { false, 0 };
+	int rc = 0;
+	while (rc == 0) {
+		if (scrubber->fiber == NULL || scrubber->rate == 0)
+			return;
+		/*
+		 * The run could have been deleted by compaction
+		 * or index drop, in which case its files could
+		 * have been removed.
+		 */
+		if (lsm->is_dropped || rlist_empty(&run->in_lsm))
+			return;
+		size_t chunk_size = MIN(scrubber->rate, VY_SCRUB_CHUNK_MAX);
+		size_t bytes = 0;
+		rc = coio_call(vy_scrubber_verify_f, env->path,
+			       lsm->space_id, lsm->index_id, run->id,
+			       &pos, MAX(chunk_size, (size_t)1), &bytes);
+		scrubber->stat.bytes += bytes;
+		if (rc < 0)
+			break;
+		/* Pause in tx so as not to hold a coio thread. */
+		if (scrubber->rate > 0 && bytes > 0) {
+			fiber_cond_wait_timeout(&scrubber->cond,
+						bytes / scrubber->rate);
+		}
+	}
+	scrubber->stat.runs++;
+	if (rc < 0) {
+		/* Same as above: the files could have been removed. */
+		if (!lsm->is_dropped && !rlist_empty(&run->in_lsm)) {
+			scrubber->stat.corrupted++;
+			diag_log();
+			say_error("%s: run %lld is corrupted",
+				  vy_lsm_name(lsm), (long long)run->id);
+		}
+		diag_clear(diag_get());
+	}
+}
+
+static int
+vy_scrubber_f(va_list va)
+{
+	struct vy_env *env = va_arg(va, struct vy_env *);
+	struct vy_scrubber *scrubber = env->scrubber;
+	while (scrubber->fiber != NULL && !fiber_is_cancelled()) {
+		if (scrubber->rate == 0) {
+			/* Start from scratch when re-enabled. */
+			vy_scrubber_end_pass(scrubber);
+			fiber_cond_wait(&scrubber->cond);
+			continue;
+		}
+		if (env->status != VINYL_ONLINE) {
+			fiber_cond_wait_timeout(&scrubber->cond,
+						VY_SCRUB_IDLE_TIMEOUT);
+			continue;
+		}
+		if (scrubber->next_run == scrubber->run_count) {
+			/* The pass is complete, start over. */
+			vy_scrubber_start_pass(scrubber);
+			if (scrubber->run_count == 0) {
+				fiber_cond_wait_timeout(&scrubber->cond,
+							VY_SCRUB_IDLE_TIMEOUT);
+			}
+			continue;
+		}
+		struct vy_scrubber_run *entry =
+			&scrubber->runs[scrubber->next_run++];
+		struct vy_lsm *lsm;
+		struct vy_run *run = vy_scrubber_find_run(entry, &lsm);
+		if (run == NULL)
+			continue;
+		vy_lsm_ref(lsm);
+		vy_run_ref(run);
+		vy_scrubber_verify_run(env, lsm, run);
+		vy_run_unref(run);
+		vy_lsm_unref(lsm);
+	}
+	return 0;
+}
+
+static void
+vy_scrubber_set_rate(struct vy_env *env, double rate)
+{
+	struct vy_scrubber *scrubber = env->scrubber;
+	scrubber->rate = rate;
+	/* Start the scrubber fiber on demand. */
+	if (rate > 0 && scrubber->fiber == NULL) {
+		scrubber->fiber = fiber_new("vinyl.scrubber", vy_scrubber_f);
+		if (scrubber->fiber == NULL) {
+			diag_log();
+			diag_clear(diag_get());
+			return;
+		}
+		fiber_set_joinable(scrubber->fiber, true);
+		fiber_start(scrubber->fiber, env);
+	}
+	fiber_cond_signal(&scrubber->cond);
+}
+
+/* }}} Scrubber */
+
 /* {{{ Cursor */
 
 static void
@@ -3800,9 +4391,23 @@ vinyl_iterator_last(struct iterator *base, struct tuple **ret)
 	return 0;
 }
 
+/** Release statements of the batch read by a secondary index iterator. */
+static void
+vinyl_iterator_batch_reset(struct vinyl_iterator *it)
+{
+	for (int i = 0; i < it->batch_count; i++) {
+		tuple_unref(it->batch_keys[i]);
+		if (it->batch_tuples[i] != NULL)
+			tuple_unref(it->batch_tuples[i]);
+	}
+	it->batch_count = 0;
+	it->batch_pos = 0;
+}
+
 static void
 vinyl_iterator_close(struct vinyl_iterator *it)
 {
+	vinyl_iterator_batch_reset(it);
 	vy_read_iterator_close(&it->iterator);
 	vy_lsm_unref(it->lsm);
 	it->lsm = NULL;
@@ -3872,6 +4477,71 @@ fail:
 	return -1;
 }
 
+/**
+ * Read the next batch of statements from a secondary index and
+ * look them up in the primary index.
+ *
+ * In autocommit mode the iterator transaction can't modify the
+ * space, so we read ahead up to VY_ITERATOR_BATCH_SIZE statements
+ * and look them up in the primary index at once: disk reads for
+ * all of them are issued to reader threads in parallel, see
+ * vy_point_lookup_batch(). In a multi-statement transaction,
+ * statements are read one by one, because the transaction may
+ * modify the space between iterations.
+ */
+static int
+vinyl_iterator_secondary_fetch(struct vinyl_iterator *it)
+{
+	assert(it->batch_pos == it->batch_count);
+	vinyl_iterator_batch_reset(it);
+
+	int batch_size = 1;
+	if (it->tx == &it->tx_autocommit)
+		batch_size = VY_ITERATOR_BATCH_SIZE;
+	while (!it->is_eof && it->batch_count < batch_size) {
+		struct tuple *tuple;
+		if (vy_read_iterator_next(&it->iterator, &tuple) != 0)
+			return -1;
+		if (tuple == NULL) {
+			it->is_eof = true;
+			break;
+		}
+		tuple_ref(tuple);
+		it->batch_keys[it->batch_count] = tuple;
+		it->batch_tuples[it->batch_count] = NULL;
+		it->batch_count++;
+	}
+	if (it->batch_count == 0)
+		return 0;
+	if (it->lsm->opts.is_covering && !it->lsm->defer_deletes) {
+		/*
+		 * A covering index stores full tuples, no need
+		 * to look up the primary index.
+		 */
+		for (int i = 0; i < it->batch_count; i++) {
+			it->batch_tuples[i] = it->batch_keys[i];
+			tuple_ref(it->batch_tuples[i]);
+		}
+		return 0;
+	}
+#ifndef NDEBUG
+	struct errinj *delay = errinj(ERRINJ_VY_DELAY_PK_LOOKUP,
+				      ERRINJ_BOOL);
+	if (delay && delay->bparam) {
+		while (delay->bparam)
+			fiber_sleep(0.01);
+	}
+#endif
+	/*
+	 * Get full tuples from the primary index.
+	 * Note, there's no need in vy_tx_track() as the
+	 * tuples are already tracked in the secondary index.
+	 */
+	return vy_point_lookup_batch(it->lsm->pk, it->tx,
+				     vy_tx_read_view(it->tx), it->batch_keys,
+				     it->batch_count, it->batch_tuples);
+}
+
 static int
 vinyl_iterator_secondary_next(struct iterator *base, struct tuple **ret)
 {
@@ -3884,31 +4554,29 @@ next:
 	if (vinyl_iterator_check_tx(it) != 0)
 		goto fail;
 
-	if (vy_read_iterator_next(&it->iterator, &tuple) != 0)
+	if (it->batch_pos == it->batch_count &&
+	    vinyl_iterator_secondary_fetch(it) != 0)
 		goto fail;
 
-	if (tuple == NULL) {
+	if (it->batch_count == 0) {
 		/* EOF. Close the iterator immediately. */
 		vinyl_iterator_close(it);
 		*ret = NULL;
 		return 0;
 	}
-#ifndef NDEBUG
-	struct errinj *delay = errinj(ERRINJ_VY_DELAY_PK_LOOKUP,
-				      ERRINJ_BOOL);
-	if (delay && delay->bparam) {
-		while (delay->bparam)
-			fiber_sleep(0.01);
+	tuple = it->batch_keys[it->batch_pos];
+	*ret = it->batch_tuples[it->batch_pos];
+	it->batch_pos++;
+	if (it->lsm->defer_deletes) {
+		/*
+		 * Secondary indexes of a space with deferred
+		 * DELETEs may store entries of overwritten tuples
+		 * until the primary index is compacted. Skip them.
+		 */
+		if (*ret == NULL ||
+		    vy_tuple_compare(*ret, tuple, it->lsm->cmp_def) != 0)
+			goto next;
 	}
-#endif
-	/*
-	 * Get the full tuple from the primary index.
-	 * Note, there's no need in vy_tx_track() as the
-	 * tuple is already tracked in the secondary index.
-	 */
-	if (vy_point_lookup(it->lsm->pk, it->tx, vy_tx_read_view(it->tx),
-			    tuple, ret) != 0)
-		goto fail;
 	if (*ret == NULL) {
 		/*
 		 * All indexes of a space must be consistent, i.e.
@@ -3924,7 +4592,6 @@ next:
 		goto next;
 	}
 	tuple_bless(*ret);
-	tuple_unref(*ret);
 	return 0;
 fail:
 	vinyl_iterator_close(it);
@@ -3953,6 +4620,9 @@ vinyl_index_create_iterator(struct index *base, enum iterator_type type,
 			 "requested iterator type");
 		return NULL;
 	}
+	struct vy_tx *tx = in_txn() ? in_txn()->engine_tx : NULL;
+	if (vy_tx_check_aborted(tx) != 0)
+		return NULL;
 
 	struct vinyl_iterator *it = mempool_alloc(&env->iterator_pool);
 	if (it == NULL) {
@@ -3976,8 +4646,10 @@ vinyl_index_create_iterator(struct index *base, enum iterator_type type,
 	it->env = env;
 	it->lsm = lsm;
 	vy_lsm_ref(lsm);
+	it->batch_count = 0;
+	it->batch_pos = 0;
+	it->is_eof = false;
 
-	struct vy_tx *tx = in_txn() ? in_txn()->engine_tx : NULL;
 	assert(tx == NULL || tx->state == VINYL_TX_READY);
 	if (tx != NULL) {
 		/*
@@ -4011,6 +4683,8 @@ vinyl_index_get(struct index *index, const char *key,
 	const struct vy_read_view **rv = (tx != NULL ? vy_tx_read_view(tx) :
 					  &env->xm->p_global_read_view);
 
+	if (vy_tx_check_aborted(tx) != 0)
+		return -1;
 	if (vy_lsm_full_by_key(lsm, tx, rv, key, part_count, ret) != 0)
 		return -1;
 	if (*ret != NULL) {
@@ -4183,8 +4857,781 @@ vy_build_insert_tuple(struct vy_env *env, struct vy_lsm *lsm,
 }
 
 /**
- * Recover a single statement that was inserted into the space
- * while the newly built index was dumped to disk.
+ * Statements collected for writing to a new run when an index
+ * that doesn't need uniqueness checks is built, see
+ * vinyl_space_build_index().
+ */
+struct vy_build_batch {
+	/** Array of statements, in no particular order. */
+	struct tuple **stmts;
+	/** Number of statements in the batch. */
+	size_t count;
+	/** Number of statements the array can hold. */
+	size_t capacity;
+	/** Total size of statements in the batch, in bytes. */
+	size_t size;
+	/** Max size of the batch, in bytes. */
+	size_t size_limit;
+};
+
+static void
+vy_build_batch_create(struct vy_build_batch *batch, size_t size_limit)
+{
+	memset(batch, 0, sizeof(*batch));
+	batch->size_limit = size_limit;
+}
+
+static void
+vy_build_batch_reset(struct vy_build_batch *batch)
+{
+	for (size_t i = 0; i < batch->count; i++)
+		tuple_unref(batch->stmts[i]);
+	batch->count = 0;
+	batch->size = 0;
+}
+
+static void
+vy_build_batch_destroy(struct vy_build_batch *batch)
+{
+	vy_build_batch_reset(batch);
+	free(batch->stmts);
+}
+
+static int
+vy_build_batch_add(struct vy_build_batch *batch, struct tuple *stmt)
+{
+	if (batch->count == batch->capacity) {
+		size_t capacity = MAX(batch->capacity * 2, 1024);
+		struct tuple **stmts = realloc(batch->stmts,
+					       capacity * sizeof(*stmts));
+		if (stmts == NULL) {
+			diag_set(OutOfMemory, capacity * sizeof(*stmts),
+				 "realloc", "struct tuple *");
+			return -1;
+		}
+		batch->stmts = stmts;
+		batch->capacity = capacity;
+	}
+	tuple_ref(stmt);
+	batch->stmts[batch->count++] = stmt;
+	batch->size += tuple_size(stmt);
+	return 0;
+}
+
+static int
+vy_build_batch_cmp(const void *a, const void *b, void *arg)
+{
+	const struct tuple *stmt_a = *(const struct tuple **)a;
+	const struct tuple *stmt_b = *(const struct tuple **)b;
+	int rc = vy_tuple_compare(stmt_a, stmt_b, (struct key_def *)arg);
+	if (rc != 0)
+		return rc;
+	/* Newer statements go first, as in runs. */
+	int64_t lsn_a = vy_stmt_lsn(stmt_a);
+	int64_t lsn_b = vy_stmt_lsn(stmt_b);
+	return lsn_a > lsn_b ? -1 : lsn_a < lsn_b;
+}
+
+/**
+ * Sort statements of a batch and write them to a run file.
+ * If @lsn is not negative, only the newest statement is written
+ * for each key and its LSN is replaced with @lsn.
+ * Called from a coio thread.
+ */
+static ssize_t
+vy_build_write_run_f(va_list ap)
+{
+	struct vy_lsm *lsm = va_arg(ap, struct vy_lsm *);
+	struct vy_run *run = va_arg(ap, struct vy_run *);
+	struct vy_build_batch *batch = va_arg(ap, struct vy_build_batch *);
+	int64_t lsn = va_arg(ap, int64_t);
+
+	qsort_arg(batch->stmts, batch->count, sizeof(*batch->stmts),
+		  vy_build_batch_cmp, (void *)lsm->cmp_def);
+
+	struct vy_run_writer writer;
+	if (vy_run_writer_create(&writer, run, lsm->env->path,
+				 lsm->space_id, lsm->index_id,
+				 vy_lsm_is_covering(lsm),
+				 lsm->cmp_def, lsm->key_def,
+				 lsm->opts.page_size, lsm->opts.bloom_fpr,
+				 lsm->opts.prefix_compression ?
+				 VY_PAGE_RESTART_INTERVAL : 0) != 0)
+		return -1;
+	for (size_t i = 0; i < batch->count; i++) {
+		struct tuple *stmt = batch->stmts[i];
+		if (lsn >= 0) {
+			if (i > 0 && vy_tuple_compare(batch->stmts[i - 1],
+						stmt, lsm->cmp_def) == 0)
+				continue;
+			vy_stmt_set_lsn(stmt, lsn);
+		}
+		if (vy_run_writer_append_stmt(&writer, stmt) != 0)
+			goto fail;
+	}
+	if (vy_run_writer_commit(&writer) != 0)
+		goto fail;
+	return 0;
+fail:
+	vy_run_writer_abort(&writer);
+	return -1;
+}
+
+/**
+ * Sorted runs written by an index build or a bulk load. They
+ * aren't added to the LSM tree until the build is complete,
+ * see vy_build_runs_merge() and vy_lsm_add_sorted_runs().
+ */
+struct vy_build_runs {
+	/** Array of runs. */
+	struct vy_run **runs;
+	/** Number of runs in the array. */
+	int count;
+};
+
+static void
+vy_build_runs_create(struct vy_build_runs *runs)
+{
+	runs->runs = NULL;
+	runs->count = 0;
+}
+
+/** Append a run to the array, taking the caller's reference. */
+static int
+vy_build_runs_add(struct vy_build_runs *runs, struct vy_run *run)
+{
+	struct vy_run **array = realloc(runs->runs, (runs->count + 1) *
+					sizeof(*array));
+	if (array == NULL) {
+		diag_set(OutOfMemory, (runs->count + 1) * sizeof(*array),
+			 "realloc", "struct vy_run *");
+		return -1;
+	}
+	runs->runs = array;
+	runs->runs[runs->count++] = run;
+	return 0;
+}
+
+/**
+ * Discard runs that haven't been added to the LSM tree,
+ * e.g. because the build failed.
+ */
+static void
+vy_build_runs_discard(struct vy_build_runs *runs)
+{
+	for (int i = 0; i < runs->count; i++)
+		vy_run_discard(runs->runs[i]);
+	free(runs->runs);
+	vy_build_runs_create(runs);
+}
+
+/**
+ * Delete sorted runs once they have been merged. They may take
+ * as much space as the loaded data so remove their files right
+ * away rather than wait for garbage collection.
+ */
+static void
+vy_build_runs_drop(struct vy_build_runs *runs, struct vy_lsm *lsm)
+{
+	if (runs->count == 0)
+		return;
+	vy_log_tx_begin();
+	for (int i = 0; i < runs->count; i++)
+		vy_log_drop_run(runs->runs[i]->id, 0);
+	vy_log_tx_try_commit();
+	vy_log_tx_begin();
+	for (int i = 0; i < runs->count; i++) {
+		struct vy_run *run = runs->runs[i];
+		if (vy_run_remove_files(lsm->env->path, lsm->space_id,
+					lsm->index_id, run->id) == 0)
+			vy_log_forget_run(run->id);
+		vy_run_unref(run);
+	}
+	vy_log_tx_try_commit();
+	free(runs->runs);
+	vy_build_runs_create(runs);
+}
+
+/**
+ * Write statements accumulated in a batch to a new sorted run.
+ */
+static int
+vy_build_batch_flush(struct vy_env *env, struct vy_lsm *lsm,
+		     struct vy_build_batch *batch, struct vy_build_runs *runs)
+{
+	if (batch->count == 0)
+		return 0;
+	struct vy_run *run = vy_run_prepare(&env->run_env, lsm);
+	if (run == NULL)
+		return -1;
+	if (coio_call(vy_build_write_run_f, lsm, run, batch,
+		      (int64_t)-1) != 0 ||
+	    vy_build_runs_add(runs, run) != 0) {
+		vy_run_discard(run);
+		return -1;
+	}
+	vy_build_batch_reset(batch);
+	return 0;
+}
+
+/**
+ * Merge sorted runs read by a write iterator into @runs. Each
+ * output run but the last one is filled until its size reaches
+ * @run_size. If @lsn is not negative, LSNs of all statements
+ * are replaced with it. The number of used output runs is
+ * returned in @used_count. Called from a coio thread.
+ */
+static ssize_t
+vy_build_merge_f(va_list ap)
+{
+	struct vy_lsm *lsm = va_arg(ap, struct vy_lsm *);
+	struct vy_stmt_stream *wi = va_arg(ap, struct vy_stmt_stream *);
+	struct vy_run **runs = va_arg(ap, struct vy_run **);
+	int run_count = va_arg(ap, int);
+	int64_t run_size = va_arg(ap, int64_t);
+	int64_t lsn = va_arg(ap, int64_t);
+	int *used_count = va_arg(ap, int *);
+
+	*used_count = 0;
+	if (wi->iface->start(wi) != 0)
+		return -1;
+	int rc;
+	bool is_writer_open = false;
+	struct vy_run_writer writer;
+	struct tuple *stmt = NULL;
+	while ((rc = wi->iface->next(wi, &stmt)) == 0 && stmt != NULL) {
+		if (is_writer_open && *used_count < run_count &&
+		    runs[*used_count - 1]->count.bytes_compressed >= run_size) {
+			/* Keys are unique so we may cut anywhere. */
+			is_writer_open = false;
+			rc = vy_run_writer_commit(&writer);
+			if (rc != 0)
+				break;
+		}
+		if (!is_writer_open) {
+			struct vy_run *run = runs[(*used_count)++];
+			rc = vy_run_writer_create(&writer, run, lsm->env->path,
+					lsm->space_id, lsm->index_id,
+					vy_lsm_is_covering(lsm),
+					lsm->cmp_def, lsm->key_def,
+					lsm->opts.page_size,
+					lsm->opts.bloom_fpr,
+					lsm->opts.prefix_compression ?
+					VY_PAGE_RESTART_INTERVAL : 0);
+			if (rc != 0)
+				break;
+			is_writer_open = true;
+		}
+		/*
+		 * The statement was read from a sorted run and
+		 * isn't referenced by anyone but the iterator so
+		 * we may update its LSN in place.
+		 */
+		if (lsn >= 0)
+			vy_stmt_set_lsn(stmt, lsn);
+		rc = vy_run_writer_append_stmt(&writer, stmt);
+		if (rc != 0)
+			break;
+	}
+	wi->iface->stop(wi);
+	if (rc == 0 && is_writer_open) {
+		is_writer_open = false;
+		rc = vy_run_writer_commit(&writer);
+	}
+	if (is_writer_open)
+		vy_run_writer_abort(&writer);
+	return rc;
+}
+
+/**
+ * Merge sorted runs written by an index build or a bulk load
+ * into runs of about range_size bytes each, so that each of
+ * them can be put in a separate range, see
+ * vy_lsm_add_sorted_runs(). Only the newest statement is kept
+ * for each key. If @lsn is not negative, LSNs of all statements
+ * are replaced with it. Output runs are returned in @result.
+ */
+static int
+vy_build_runs_merge(struct vy_env *env, struct vy_lsm *lsm,
+		    struct vy_build_runs *src, int64_t lsn,
+		    struct vy_build_runs *result)
+{
+	vy_build_runs_create(result);
+
+	int64_t total_size = 0;
+	for (int i = 0; i < src->count; i++)
+		total_size += src->runs[i]->count.bytes_compressed;
+	int run_count = MAX(DIV_ROUND_UP(total_size,
+					 lsm->opts.range_size), 1);
+	int64_t run_size = DIV_ROUND_UP(total_size, run_count);
+	for (int i = 0; i < run_count; i++) {
+		struct vy_run *run = vy_run_prepare(&env->run_env, lsm);
+		if (run == NULL)
+			goto fail;
+		if (vy_build_runs_add(result, run) != 0) {
+			vy_run_discard(run);
+			goto fail;
+		}
+	}
+
+	RLIST_HEAD(read_views);
+	struct vy_stmt_stream *wi;
+	wi = vy_write_iterator_new(lsm->cmp_def, lsm->disk_format,
+				   vy_lsm_is_covering(lsm), true,
+				   lsm->ttl_field, &read_views, NULL);
+	if (wi == NULL)
+		goto fail;
+	int rc = 0;
+	int used_count = 0;
+	struct vy_slice **slices = calloc(src->count, sizeof(*slices));
+	if (slices == NULL) {
+		diag_set(OutOfMemory, src->count * sizeof(*slices),
+			 "calloc", "struct vy_slice *");
+		rc = -1;
+		goto out;
+	}
+	for (int i = 0; i < src->count; i++) {
+		slices[i] = vy_slice_new(vy_log_next_id(), src->runs[i],
+					 NULL, NULL, lsm->cmp_def);
+		if (slices[i] == NULL ||
+		    vy_write_iterator_new_slice(wi, slices[i]) != 0) {
+			rc = -1;
+			goto out;
+		}
+	}
+	rc = coio_call(vy_build_merge_f, lsm, wi, result->runs, run_count,
+		       run_size, lsn, &used_count);
+out:
+	wi->iface->close(wi);
+	if (slices != NULL) {
+		for (int i = 0; i < src->count; i++) {
+			if (slices[i] != NULL)
+				vy_slice_delete(slices[i]);
+		}
+		free(slices);
+	}
+	if (rc != 0)
+		goto fail;
+	/* Discard output runs that turned out to be unnecessary. */
+	while (result->count > used_count)
+		vy_run_discard(result->runs[--result->count]);
+	return 0;
+fail:
+	vy_build_runs_discard(result);
+	return -1;
+}
+
+/**
+ * Replace the only range of an LSM tree with ranges spanning
+ * the given runs, one run per range. The runs must be sorted
+ * by key and must not intersect. Their statements must be older
+ * than any statement stored in the LSM tree, because they were
+ * read before an index build started or loaded into an empty
+ * space. Slices of runs dumped while the runs were being written
+ * are cut by the new range boundaries.
+ *
+ * On success references to the runs are passed to the LSM tree
+ * and the array is emptied.
+ */
+static int
+vy_lsm_add_sorted_runs(struct vy_env *env, struct vy_lsm *lsm,
+		       struct vy_build_runs *runs, int64_t dump_lsn)
+{
+	assert(lsm->range_count == 1);
+	if (runs->count == 0)
+		return 0;
+
+	/*
+	 * Dump completion adds slices to the ranges a new run
+	 * intersects and yields in between, so make sure the
+	 * LSM tree isn't dumped while we are replacing ranges.
+	 */
+	while (lsm->is_dumping) {
+		if (vy_scheduler_dump(&env->scheduler) != 0)
+			return -1;
+	}
+	vy_scheduler_pin_lsm(&env->scheduler, lsm);
+
+	struct vy_range *range = vy_range_tree_first(lsm->tree);
+	assert(!vy_range_is_scheduled(range));
+	int part_count = runs->count;
+	struct vy_range **parts = calloc(part_count, sizeof(*parts));
+	if (parts == NULL) {
+		diag_set(OutOfMemory, part_count * sizeof(*parts),
+			 "calloc", "struct vy_range *");
+		goto fail;
+	}
+	struct tuple_format *key_format = env->lsm_env.key_format;
+	struct tuple *begin = range->begin;
+	for (int i = 0; i < part_count; i++) {
+		struct vy_run *run = runs->runs[i];
+		run->dump_lsn = dump_lsn;
+		struct tuple *end = range->end;
+		if (i < part_count - 1) {
+			end = vy_key_from_msgpack(key_format,
+					runs->runs[i + 1]->info.min_key);
+			if (end == NULL)
+				goto fail;
+		}
+		struct vy_range *part = vy_range_new(vy_log_next_id(),
+						     begin, end, lsm->cmp_def);
+		if (end != range->end)
+			tuple_unref(end);
+		if (part == NULL)
+			goto fail;
+		parts[i] = part;
+		begin = part->end;
+		/*
+		 * vy_range_add_slice() adds a slice to the list head,
+		 * so to preserve the order of the slices list, we have
+		 * to iterate backward. The new run is the oldest one.
+		 */
+		struct vy_slice *slice = vy_slice_new(vy_log_next_id(), run,
+						      part->begin, part->end,
+						      lsm->cmp_def);
+		if (slice == NULL)
+			goto fail;
+		vy_range_add_slice(part, slice);
+		struct vy_slice *old_slice, *new_slice;
+		rlist_foreach_entry_reverse(old_slice, &range->slices,
+					    in_range) {
+			if (vy_slice_cut(old_slice, vy_log_next_id(),
+					 part->begin, part->end, lsm->cmp_def,
+					 &new_slice) != 0)
+				goto fail;
+			if (new_slice != NULL)
+				vy_range_add_slice(part, new_slice);
+		}
+		vy_range_update_compact_priority(part, &lsm->opts);
+	}
+
+	vy_log_tx_begin();
+	for (int i = 0; i < part_count; i++)
+		vy_log_create_run(lsm->id, runs->runs[i]->id, dump_lsn);
+	struct vy_slice *slice;
+	rlist_foreach_entry(slice, &range->slices, in_range)
+		vy_log_delete_slice(slice->id);
+	vy_log_delete_range(range->id);
+	for (int i = 0; i < part_count; i++) {
+		struct vy_range *part = parts[i];
+		vy_log_insert_range(lsm->id, part->id,
+				    tuple_data_or_null(part->begin),
+				    tuple_data_or_null(part->end));
+		rlist_foreach_entry(slice, &part->slices, in_range)
+			vy_log_insert_slice(part->id, slice->run->id, slice->id,
+					    tuple_data_or_null(slice->begin),
+					    tuple_data_or_null(slice->end));
+	}
+	vy_log_dump_lsm(lsm->id, dump_lsn);
+	if (vy_log_tx_commit() < 0)
+		goto fail;
+
+	vy_lsm_unacct_range(lsm, range);
+	vy_lsm_remove_range(lsm, range);
+	for (int i = 0; i < part_count; i++) {
+		vy_lsm_add_run(lsm, runs->runs[i]);
+		vy_run_unref(runs->runs[i]);
+		vy_lsm_add_range(lsm, parts[i]);
+		vy_lsm_acct_range(lsm, parts[i]);
+	}
+	lsm->range_tree_version++;
+	lsm->dump_lsn = MAX(lsm->dump_lsn, dump_lsn);
+	runs->count = 0;
+	free(parts);
+	vy_scheduler_unpin_lsm(&env->scheduler, lsm);
+
+	rlist_foreach_entry(slice, &range->slices, in_range)
+		vy_slice_wait_pinned(slice);
+	vy_range_delete(range);
+	return 0;
+fail:
+	for (int i = 0; parts != NULL && i < part_count; i++) {
+		if (parts[i] != NULL)
+			vy_range_delete(parts[i]);
+	}
+	free(parts);
+	vy_scheduler_unpin_lsm(&env->scheduler, lsm);
+	return -1;
+}
+
+/**
+ * Complete an index build: write the last batch and merge all
+ * sorted runs into range-sized runs, then add them to the LSM
+ * tree, each in its own range, so that the new index is a
+ * levelled tree right away rather than a pile of sorted runs.
+ */
+static int
+vy_build_complete(struct vy_env *env, struct vy_lsm *lsm,
+		  struct vy_build_batch *batch, struct vy_build_runs *runs,
+		  int64_t build_lsn)
+{
+	if (vy_build_batch_flush(env, lsm, batch, runs) != 0)
+		return -1;
+	struct vy_build_runs result;
+	if (runs->count <= 1) {
+		/* A batch isn't bigger than a range, use it as is. */
+		result = *runs;
+		vy_build_runs_create(runs);
+	} else if (vy_build_runs_merge(env, lsm, runs, -1, &result) != 0) {
+		return -1;
+	}
+	int rc = vy_lsm_add_sorted_runs(env, lsm, &result, build_lsn);
+	vy_build_runs_discard(&result);
+	return rc;
+}
+
+/**
+ * Write deferred DELETEs collected in a batch to a new run of
+ * a secondary index and add it to the LSM tree.
+ *
+ * The DELETEs have LSNs of the statements that overwrote the
+ * deleted tuples so they may be older than statements already
+ * dumped to the index. That's why they can't be inserted into
+ * the in-memory tree. A run, on the contrary, is merged with
+ * other runs by LSN on compaction, which purges stale entries.
+ * Readers ignore the DELETEs (see VY_STMT_SKIP_READ), so the
+ * new run doesn't break the order of slices of a range.
+ *
+ * The run gets the current dump LSN of the LSM tree, so as not
+ * to make WAL recovery skip statements that haven't been dumped.
+ */
+static int
+vy_lsm_write_deferred_deletes(struct vy_env *env, struct vy_lsm *lsm,
+			      struct vy_build_batch *batch)
+{
+	assert(lsm->index_id > 0);
+	if (batch->count == 0)
+		return 0;
+
+	struct vy_run *run = vy_run_prepare(&env->run_env, lsm);
+	if (run == NULL)
+		return -1;
+	run->dump_lsn = lsm->dump_lsn;
+
+	if (coio_call(vy_build_write_run_f, lsm, run, batch,
+		      (int64_t)-1) != 0)
+		goto fail;
+	if (lsm->is_dropped) {
+		vy_run_discard(run);
+		return 0;
+	}
+
+	/* Slice the run by all ranges it intersects, like dump does. */
+	struct tuple_format *key_format = env->lsm_env.key_format;
+	struct tuple *min_key = vy_key_from_msgpack(key_format,
+						    run->info.min_key);
+	if (min_key == NULL)
+		goto fail;
+	struct tuple *max_key = vy_key_from_msgpack(key_format,
+						    run->info.max_key);
+	if (max_key == NULL) {
+		tuple_unref(min_key);
+		goto fail;
+	}
+	struct vy_range *begin_range = vy_range_tree_psearch(lsm->tree,
+							     min_key);
+	struct vy_range *end_range = vy_range_tree_psearch(lsm->tree,
+							   max_key);
+	end_range = vy_range_tree_next(lsm->tree, end_range);
+	tuple_unref(min_key);
+	tuple_unref(max_key);
+
+	struct vy_slice **slices = calloc(lsm->range_count, sizeof(*slices));
+	if (slices == NULL) {
+		diag_set(OutOfMemory, lsm->range_count * sizeof(*slices),
+			 "malloc", "struct vy_slice *");
+		goto fail;
+	}
+	struct vy_range *range;
+	int i;
+	for (range = begin_range, i = 0; range != end_range;
+	     range = vy_range_tree_next(lsm->tree, range), i++) {
+		slices[i] = vy_slice_new(vy_log_next_id(), run, range->begin,
+					 range->end, lsm->cmp_def);
+		if (slices[i] == NULL)
+			goto fail_free_slices;
+	}
+
+	vy_log_tx_begin();
+	vy_log_create_run(lsm->id, run->id, run->dump_lsn);
+	for (range = begin_range, i = 0; range != end_range;
+	     range = vy_range_tree_next(lsm->tree, range), i++) {
+		vy_log_insert_slice(range->id, run->id, slices[i]->id,
+				    tuple_data_or_null(slices[i]->begin),
+				    tuple_data_or_null(slices[i]->end));
+	}
+	if (vy_log_tx_commit() < 0)
+		goto fail_free_slices;
+
+	vy_lsm_add_run(lsm, run);
+	vy_run_unref(run);
+
+	for (range = begin_range, i = 0; range != end_range;
+	     range = vy_range_tree_next(lsm->tree, range), i++) {
+		vy_lsm_unacct_range(lsm, range);
+		vy_range_add_slice(range, slices[i]);
+		vy_lsm_acct_range(lsm, range);
+		vy_range_update_compact_priority(range, &lsm->opts);
+		if (!vy_range_is_scheduled(range))
+			vy_range_heap_update(&lsm->range_heap,
+					     &range->heap_node);
+		range->version++;
+	}
+	free(slices);
+	return 0;
+
+fail_free_slices:
+	for (i = 0; i < lsm->range_count; i++) {
+		if (slices[i] != NULL)
+			vy_slice_delete(slices[i]);
+	}
+	free(slices);
+fail:
+	vy_run_discard(run);
+	return -1;
+}
+
+/**
+ * Write DELETE statements generated on primary index dump or
+ * compaction to secondary indexes of the space. The scheduler
+ * fails the task that generated the statements if this function
+ * fails, so no DELETE is lost: the overwriting statements keep
+ * VY_STMT_DEFERRED_DELETE in the primary index then.
+ */
+static int
+vy_env_deferred_delete_cb(struct vy_scheduler *scheduler, struct vy_lsm *pk,
+			  const struct vy_deferred_delete *stmts, int count)
+{
+	struct vy_env *env = container_of(scheduler, struct vy_env, scheduler);
+	assert(pk->index_id == 0);
+
+	struct space *space = space_by_id(pk->space_id);
+	if (space == NULL || space->index_count <= 1 ||
+	    vy_lsm(space->index[0]) != pk)
+		return 0;
+
+	int rc = -1;
+	struct vy_build_batch batch;
+	vy_build_batch_create(&batch, 0);
+	uint32_t lsm_count = space->index_count - 1;
+	struct vy_lsm **lsms = calloc(lsm_count, sizeof(*lsms));
+	struct tuple **deletes = calloc(count, sizeof(*deletes));
+	struct tuple **new_tuples = calloc(count, sizeof(*new_tuples));
+	if (lsms == NULL || deletes == NULL || new_tuples == NULL) {
+		diag_set(OutOfMemory, count * sizeof(*deletes),
+			 "malloc", "struct tuple *");
+		goto out;
+	}
+	/*
+	 * Writing a run yields so pin the secondary indexes,
+	 * because the space may be altered meanwhile.
+	 */
+	for (uint32_t i = 0; i < lsm_count; i++) {
+		lsms[i] = vy_lsm(space->index[i + 1]);
+		vy_lsm_ref(lsms[i]);
+	}
+	for (int i = 0; i < count; i++) {
+		const struct vy_deferred_delete *stmt = &stmts[i];
+		struct tuple *old_tuple = vy_stmt_new_replace(pk->mem_format,
+							stmt->old_data,
+							stmt->old_data_end);
+		if (old_tuple == NULL)
+			goto out;
+		deletes[i] = vy_stmt_new_surrogate_delete(pk->mem_format,
+							  old_tuple);
+		tuple_unref(old_tuple);
+		if (deletes[i] == NULL)
+			goto out;
+		vy_stmt_set_lsn(deletes[i], stmt->lsn);
+		vy_stmt_set_flags(deletes[i], VY_STMT_SKIP_READ);
+		if (stmt->new_data == NULL)
+			continue;
+		new_tuples[i] = vy_stmt_new_replace(pk->mem_format,
+						    stmt->new_data,
+						    stmt->new_data_end);
+		if (new_tuples[i] == NULL)
+			goto out;
+	}
+
+	for (uint32_t i = 0; i < lsm_count; i++) {
+		struct vy_lsm *lsm = lsms[i];
+		/*
+		 * An index that is being built is filled from
+		 * the primary index, so it doesn't have entries
+		 * overwritten before the build. Stale entries
+		 * inserted during the build are filtered on read.
+		 */
+		if (lsm->is_dropped || lsm->is_building)
+			continue;
+		for (int j = 0; j < count; j++) {
+			/* Skip DELETEs for unchanged keys. */
+			if (new_tuples[j] != NULL &&
+			    vy_tuple_compare(deletes[j], new_tuples[j],
+					     lsm->cmp_def) == 0)
+				continue;
+			if (vy_build_batch_add(&batch, deletes[j]) != 0)
+				goto out;
+		}
+		if (vy_lsm_write_deferred_deletes(env, lsm, &batch) != 0)
+			goto out;
+		vy_build_batch_reset(&batch);
+	}
+	rc = 0;
+out:
+	vy_build_batch_destroy(&batch);
+	for (int i = 0; deletes != NULL && i < count; i++) {
+		if (deletes[i] != NULL)
+			tuple_unref(deletes[i]);
+		if (new_tuples != NULL && new_tuples[i] != NULL)
+			tuple_unref(new_tuples[i]);
+	}
+	for (uint32_t i = 0; lsms != NULL && i < lsm_count; i++) {
+		if (lsms[i] != NULL)
+			vy_lsm_unref(lsms[i]);
+	}
+	free(new_tuples);
+	free(deletes);
+	free(lsms);
+	return rc;
+}
+
+/**
+ * Add a tuple fetched from the space to the batch of statements
+ * to be written to the LSM tree that is currently being built.
+ * Flush the batch if it gets too big.
+ */
+static int
+vy_build_batch_insert_tuple(struct vy_env *env, struct vy_lsm *lsm,
+			    struct vy_build_batch *batch,
+			    struct vy_build_runs *runs,
+			    struct tuple_format *new_format,
+			    struct tuple *tuple)
+{
+	/* Check the tuple against the new space format. */
+	if (tuple_validate(new_format, tuple) != 0)
+		return -1;
+
+	/* Reallocate the new tuple using the new space format. */
+	uint32_t data_len;
+	const char *data = tuple_data_range(tuple, &data_len);
+	struct tuple *stmt = vy_stmt_new_replace(new_format, data,
+						 data + data_len);
+	if (stmt == NULL)
+		return -1;
+	vy_stmt_set_lsn(stmt, vy_stmt_lsn(tuple));
+	int rc = vy_build_batch_add(batch, stmt);
+	tuple_unref(stmt);
+	if (rc != 0)
+		return -1;
+
+	if (batch->size >= batch->size_limit)
+		return vy_build_batch_flush(env, lsm, batch, runs);
+	return 0;
+}
+
+/**
+ * Recover a single statement that was inserted into the space
+ * while the newly built index was dumped to disk.
  */
 static int
 vy_build_recover_stmt(struct vy_lsm *lsm, struct vy_lsm *pk,
@@ -4342,11 +5789,31 @@ vinyl_space_build_index(struct space *src_space, struct index *new_index,
 	 * each of them into the new LSM tree. Since read iterator
 	 * may yield, we install an on_replace trigger to forward
 	 * DML requests issued during the build.
+	 *
+	 * If the new index doesn't need uniqueness checks, we
+	 * don't need to make built tuples visible to concurrent
+	 * transactions until the build is complete. In this case
+	 * we bypass the memory level and write tuples directly
+	 * to disk in sorted batches, which is much faster and
+	 * doesn't consume memory quota. The batches are merged
+	 * into range-sized runs when the build is complete, see
+	 * vy_build_complete(). Otherwise tuples are inserted
+	 * into the in-memory index, see vy_build_insert_tuple().
 	 */
 	struct tuple *key = vy_stmt_new_select(pk->env->key_format, NULL, 0);
 	if (key == NULL)
 		return -1;
 
+	struct vy_build_runs runs;
+	vy_build_runs_create(&runs);
+	struct vy_build_batch batch;
+	vy_build_batch_create(&batch, MIN((size_t)new_lsm->opts.range_size,
+					  env->quota.limit / 4));
+	if (!new_lsm->check_is_unique) {
+		new_lsm->is_building = true;
+		vy_scheduler_update_lsm(&env->scheduler, new_lsm);
+	}
+
 	struct trigger on_replace;
 	struct vy_build_ctx ctx;
 	ctx.env = env;
@@ -4362,6 +5829,7 @@ vinyl_space_build_index(struct space *src_space, struct index *new_index,
 	struct vy_read_iterator itr;
 	vy_read_iterator_open(&itr, pk, NULL, ITER_ALL, key,
 			      &env->xm->p_committed_read_view);
+	itr.skip_cache = true;
 	int rc;
 	int loops = 0;
 	struct tuple *tuple;
@@ -4383,10 +5851,16 @@ vinyl_space_build_index(struct space *src_space, struct index *new_index,
 		 * in which case we would insert an outdated tuple.
 		 */
 		if (vy_stmt_lsn(tuple) <= build_lsn) {
-			rc = vy_build_insert_tuple(env, new_lsm,
-						   space_name(src_space),
-						   new_index->def->name,
-						   new_format, tuple);
+			if (new_lsm->is_building) {
+				rc = vy_build_batch_insert_tuple(env, new_lsm,
+						&batch, &runs, new_format,
+						tuple);
+			} else {
+				rc = vy_build_insert_tuple(env, new_lsm,
+						space_name(src_space),
+						new_index->def->name,
+						new_format, tuple);
+			}
 			if (rc != 0)
 				break;
 		}
@@ -4407,6 +5881,16 @@ vinyl_space_build_index(struct space *src_space, struct index *new_index,
 	vy_read_iterator_close(&itr);
 	tuple_unref(key);
 
+	if (new_lsm->is_building) {
+		if (rc == 0)
+			rc = vy_build_complete(env, new_lsm, &batch, &runs,
+					       build_lsn);
+		vy_build_runs_drop(&runs, new_lsm);
+		new_lsm->is_building = false;
+		vy_scheduler_update_lsm(&env->scheduler, new_lsm);
+	}
+	vy_build_batch_destroy(&batch);
+
 	/*
 	 * Dump the new index upon build completion so that we don't
 	 * have to rebuild it on recovery.
@@ -4426,6 +5910,229 @@ vinyl_space_build_index(struct space *src_space, struct index *new_index,
 
 /* }}} Index build */
 
+/* {{{ Bulk load */
+
+struct vinyl_bulk_load {
+	/** Vinyl environment. */
+	struct vy_env *env;
+	/** Primary index LSM tree of the space being loaded. */
+	struct vy_lsm *lsm;
+	/** Statements that haven't been written to disk yet. */
+	struct vy_build_batch batch;
+	/**
+	 * Sorted runs written so far. They are not added to
+	 * the LSM tree, but merged into range-sized runs on
+	 * commit.
+	 */
+	struct vy_build_runs runs;
+	/**
+	 * LSN assigned to the last added statement. Used to
+	 * order statements with the same key in sorted runs.
+	 */
+	int64_t lsn;
+};
+
+/**
+ * Check that a space is still suitable for bulk load:
+ * it is empty and has no secondary indexes.
+ */
+static int
+vy_bulk_load_check(struct vy_lsm *lsm)
+{
+	struct space *space = space_by_id(lsm->space_id);
+	if (lsm->is_dropped || space == NULL ||
+	    vy_lsm(space->index[0]) != lsm) {
+		diag_set(ClientError, ER_UNSUPPORTED, "Vinyl",
+			 "bulk load into an altered space");
+		return -1;
+	}
+	if (space->index_count > 1) {
+		diag_set(ClientError, ER_UNSUPPORTED, "Vinyl",
+			 "bulk load into a space with secondary indexes");
+		return -1;
+	}
+	if (lsm->run_count > 0 || lsm->mem->tree.size > 0 ||
+	    !rlist_empty(&lsm->sealed)) {
+		diag_set(ClientError, ER_UNSUPPORTED, "Vinyl",
+			 "bulk load into a non-empty space");
+		return -1;
+	}
+	assert(lsm->range_count == 1);
+	return 0;
+}
+
+/**
+ * Check that the instance has no replicas and doesn't replicate
+ * from anyone: loaded tuples bypass WAL and so would never get
+ * to other members of the replica set.
+ */
+static int
+vy_bulk_load_check_replicaset(void)
+{
+	bool is_replicated = replicaset.applier.total > 0;
+	replicaset_foreach(replica) {
+		if (replica->id != instance_id)
+			is_replicated = true;
+	}
+	if (is_replicated) {
+		diag_set(ClientError, ER_UNSUPPORTED, "Vinyl",
+			 "bulk load into a replicated space");
+		return -1;
+	}
+	return 0;
+}
+
+struct vinyl_bulk_load *
+vinyl_bulk_load_new(struct space *space)
+{
+	assert(space->vtab == &vinyl_space_vtab);
+	struct vy_env *env = vy_env(space->engine);
+	if (env->status != VINYL_ONLINE) {
+		diag_set(ClientError, ER_UNSUPPORTED, "Vinyl",
+			 "bulk load during recovery");
+		return NULL;
+	}
+	if (space->index_count == 0) {
+		diag_set(ClientError, ER_UNSUPPORTED, "Vinyl",
+			 "bulk load into a space without indexes");
+		return NULL;
+	}
+	if (vy_bulk_load_check_replicaset() != 0)
+		return NULL;
+	struct vy_lsm *lsm = vy_lsm(space->index[0]);
+	if (vy_bulk_load_check(lsm) != 0)
+		return NULL;
+	if (lsm->is_building) {
+		diag_set(ClientError, ER_UNSUPPORTED, "Vinyl",
+			 "concurrent bulk loads into the same space");
+		return NULL;
+	}
+	struct vinyl_bulk_load *load = calloc(1, sizeof(*load));
+	if (load == NULL) {
+		diag_set(OutOfMemory, sizeof(*load),
+			 "malloc", "struct vinyl_bulk_load");
+		return NULL;
+	}
+	load->env = env;
+	load->lsm = lsm;
+	vy_lsm_ref(lsm);
+	vy_build_runs_create(&load->runs);
+	vy_build_batch_create(&load->batch,
+			      MIN((size_t)lsm->opts.range_size,
+				  env->quota.limit / 4));
+	lsm->is_building = true;
+	vy_scheduler_update_lsm(&env->scheduler, lsm);
+	return load;
+}
+
+int
+vinyl_bulk_load_add(struct vinyl_bulk_load *load,
+		    const char *data, const char *data_end)
+{
+	struct vy_lsm *lsm = load->lsm;
+	if (tuple_validate_raw(lsm->mem_format, data) != 0)
+		return -1;
+	struct tuple *stmt = vy_stmt_new_replace(lsm->mem_format,
+						 data, data_end);
+	if (stmt == NULL)
+		return -1;
+	vy_stmt_set_lsn(stmt, ++load->lsn);
+	int rc = vy_build_batch_add(&load->batch, stmt);
+	tuple_unref(stmt);
+	if (rc != 0)
+		return -1;
+	if (load->batch.size >= load->batch.size_limit)
+		return vy_build_batch_flush(load->env, lsm, &load->batch,
+					    &load->runs);
+	return 0;
+}
+
+int
+vinyl_bulk_load_commit(struct vinyl_bulk_load *load)
+{
+	struct vy_env *env = load->env;
+	struct vy_lsm *lsm = load->lsm;
+	if (vy_bulk_load_check_replicaset() != 0 ||
+	    vy_bulk_load_check(lsm) != 0)
+		return -1;
+	if (load->batch.count == 0 && load->runs.count == 0)
+		return 0; /* nothing to do */
+
+	/*
+	 * Loaded statements are assigned the LSN of the last
+	 * committed transaction so that they are visible to
+	 * new transactions, but older than any statement that
+	 * will be committed after them. Open read views and
+	 * readers of the space are sent to conflict on commit,
+	 * see below.
+	 */
+	int64_t dump_lsn = MAX(env->xm->lsn, 1);
+	struct vy_build_runs result;
+	vy_build_runs_create(&result);
+	if (load->runs.count == 0) {
+		/* The batch isn't bigger than a range, write it as is. */
+		struct vy_run *run = vy_run_prepare(&env->run_env, lsm);
+		if (run == NULL)
+			return -1;
+		if (coio_call(vy_build_write_run_f, lsm, run, &load->batch,
+			      dump_lsn) != 0 ||
+		    vy_build_runs_add(&result, run) != 0) {
+			vy_run_discard(run);
+			return -1;
+		}
+	} else if (vy_build_batch_flush(env, lsm, &load->batch,
+					&load->runs) != 0 ||
+		   vy_build_runs_merge(env, lsm, &load->runs, dump_lsn,
+				       &result) != 0) {
+		return -1;
+	}
+
+	if (result.count == 1 && vy_run_is_empty(result.runs[0]))
+		vy_build_runs_discard(&result);
+	if (result.count == 0) {
+		/* All loaded tuples have expired. */
+		return 0;
+	}
+	int64_t row_count = 0;
+	for (int i = 0; i < result.count; i++)
+		row_count += result.runs[i]->count.rows;
+	/*
+	 * The space must not have been written to while we were
+	 * writing the runs, because we are about to mark all
+	 * statements up to the run LSN as dumped.
+	 */
+	int rc = vy_bulk_load_check(lsm);
+	if (rc == 0)
+		rc = vy_lsm_add_sorted_runs(env, lsm, &result, dump_lsn);
+	vy_build_runs_discard(&result);
+	if (rc != 0)
+		return -1;
+	/*
+	 * Transactions that have read the empty space or opened
+	 * a read view that would see the loaded statements must
+	 * not see them, because that would break isolation.
+	 */
+	tx_manager_abort_readers(env->xm, lsm, dump_lsn);
+
+	say_info("%s: bulk loaded %lld statements", vy_lsm_name(lsm),
+		 (long long)row_count);
+	return 0;
+}
+
+void
+vinyl_bulk_load_delete(struct vinyl_bulk_load *load)
+{
+	struct vy_lsm *lsm = load->lsm;
+	vy_build_runs_drop(&load->runs, lsm);
+	vy_build_batch_destroy(&load->batch);
+	lsm->is_building = false;
+	vy_scheduler_update_lsm(&load->env->scheduler, lsm);
+	vy_lsm_unref(lsm);
+	free(load);
+}
+
+/* }}} Bulk load */
+
 static const struct engine_vtab vinyl_engine_vtab = {
 	/* .shutdown = */ vinyl_engine_shutdown,
 	/* .create_space = */ vinyl_engine_create_space,
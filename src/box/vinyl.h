@@ -39,6 +39,8 @@ extern "C" {
 #endif /* defined(__cplusplus) */
 
 struct info_handler;
+struct space;
+struct vinyl_bulk_load;
 struct vinyl_engine;
 
 struct vinyl_engine *
@@ -75,6 +77,13 @@ vinyl_engine_set_max_tuple_size(struct vinyl_engine *vinyl, size_t max_size);
 void
 vinyl_engine_set_timeout(struct vinyl_engine *vinyl, double timeout);
 
+/**
+ * Update the max read rate of the background run scrubber,
+ * in bytes per second. 0 disables scrubbing.
+ */
+void
+vinyl_engine_set_scrub_rate(struct vinyl_engine *vinyl, double rate);
+
 /**
  * Update too_long_threshold.
  */
@@ -88,6 +97,49 @@ vinyl_engine_set_too_long_threshold(struct vinyl_engine *vinyl,
 void
 vinyl_engine_set_snap_io_rate_limit(struct vinyl_engine *vinyl, double limit);
 
+/**
+ * Start loading tuples into an empty vinyl space that has
+ * no secondary indexes. Loaded tuples bypass WAL and the
+ * memory level: they are sorted in batches and written
+ * to disk directly. The result is a single run that becomes
+ * visible on commit, as if all tuples were inserted with
+ * REPLACE in one transaction, in the order they were added.
+ *
+ * Since loaded tuples are not written to WAL, bulk load is
+ * refused if the instance has replicas or replicates from
+ * another instance. Note that replicas that join before the
+ * next checkpoint won't get the loaded tuples either. The
+ * space must not be written to while the load is in progress.
+ * Transactions that have read the space or opened a read view
+ * that would see the loaded tuples are aborted on commit.
+ *
+ * Returns NULL and sets diag on error.
+ */
+struct vinyl_bulk_load *
+vinyl_bulk_load_new(struct space *space);
+
+/**
+ * Add a tuple, given as a MsgPack array, to a bulk load.
+ * May yield. Returns 0 on success, -1 on error.
+ */
+int
+vinyl_bulk_load_add(struct vinyl_bulk_load *load,
+		    const char *data, const char *data_end);
+
+/**
+ * Write all added tuples to the space.
+ * Returns 0 on success, -1 on error.
+ */
+int
+vinyl_bulk_load_commit(struct vinyl_bulk_load *load);
+
+/**
+ * Free a bulk load. Tuples that were added, but not
+ * committed, are discarded.
+ */
+void
+vinyl_bulk_load_delete(struct vinyl_bulk_load *load);
+
 #ifdef __cplusplus
 } /* extern "C" */
 
@@ -50,13 +50,21 @@ enum {
 	/* Max number of deletes that are made by cleanup action per one
 	 * cache operation */
 	VY_CACHE_CLEANUP_MAX_STEPS = 10,
+	/* Percentage of the quota the probationary segment may
+	 * occupy before it is preferred for eviction */
+	VY_CACHE_PROBATION_PCT = 25,
+	/* Max number of LRU entries looked through in search of
+	 * an entry to evict */
+	VY_CACHE_GC_SCAN_MAX = 32,
 };
 
 void
 vy_cache_env_create(struct vy_cache_env *e, struct slab_cache *slab_cache)
 {
 	rlist_create(&e->cache_lru);
+	rlist_create(&e->cache_probation);
 	e->mem_used = 0;
+	e->probation_mem_used = 0;
 	e->mem_quota = 0;
 	mempool_create(&e->cache_entry_mempool, slab_cache,
 		       sizeof(struct vy_cache_entry));
@@ -88,8 +96,12 @@ vy_cache_entry_new(struct vy_cache_env *env, struct vy_cache *cache,
 	entry->flags = 0;
 	entry->left_boundary_level = cache->cmp_def->part_count;
 	entry->right_boundary_level = cache->cmp_def->part_count;
-	rlist_add(&env->cache_lru, &entry->in_lru);
+	entry->is_protected = false;
+	rlist_add(&env->cache_probation, &entry->in_lru);
+	rlist_add(&cache->lru, &entry->in_cache_lru);
 	env->mem_used += vy_cache_entry_size(entry);
+	env->probation_mem_used += vy_cache_entry_size(entry);
+	cache->mem_used += vy_cache_entry_size(entry);
 	vy_stmt_counter_acct_tuple(&cache->stat.count, stmt);
 	return entry;
 }
@@ -100,12 +112,33 @@ vy_cache_entry_delete(struct vy_cache_env *env, struct vy_cache_entry *entry)
 	vy_stmt_counter_unacct_tuple(&entry->cache->stat.count, entry->stmt);
 	assert(env->mem_used >= vy_cache_entry_size(entry));
 	env->mem_used -= vy_cache_entry_size(entry);
+	assert(entry->cache->mem_used >= vy_cache_entry_size(entry));
+	entry->cache->mem_used -= vy_cache_entry_size(entry);
+	if (!entry->is_protected) {
+		assert(env->probation_mem_used >= vy_cache_entry_size(entry));
+		env->probation_mem_used -= vy_cache_entry_size(entry);
+	}
 	tuple_unref(entry->stmt);
 	rlist_del(&entry->in_lru);
+	rlist_del(&entry->in_cache_lru);
 	TRASH(entry);
 	mempool_free(&env->cache_entry_mempool, entry);
 }
 
+/**
+ * Move a probationary cache entry to the protected segment.
+ */
+static void
+vy_cache_entry_protect(struct vy_cache_env *env, struct vy_cache_entry *entry)
+{
+	assert(!entry->is_protected);
+	assert(env->probation_mem_used >= vy_cache_entry_size(entry));
+	env->probation_mem_used -= vy_cache_entry_size(entry);
+	entry->is_protected = true;
+	rlist_del(&entry->in_lru);
+	rlist_add(&env->cache_lru, &entry->in_lru);
+}
+
 static void *
 vy_cache_tree_page_alloc(void *ctx)
 {
@@ -133,6 +166,10 @@ vy_cache_create(struct vy_cache *cache, struct vy_cache_env *env,
 	cache->env = env;
 	cache->cmp_def = cmp_def;
 	cache->version = 1;
+	cache->mem_used = 0;
+	cache->mem_reserve = 0;
+	cache->mem_limit = 0;
+	rlist_create(&cache->lru);
 	vy_cache_tree_create(&cache->cache_tree, cmp_def,
 			     vy_cache_tree_page_alloc,
 			     vy_cache_tree_page_free, env);
@@ -154,12 +191,32 @@ vy_cache_destroy(struct vy_cache *cache)
 	vy_cache_tree_destroy(&cache->cache_tree);
 }
 
+/**
+ * Look through the oldest entries of an LRU list in search of
+ * an entry of a cache that uses more memory than reserved for
+ * it. Return NULL if there's no such entry among
+ * VY_CACHE_GC_SCAN_MAX oldest entries.
+ */
+static struct vy_cache_entry *
+vy_cache_lru_victim(struct rlist *lru)
+{
+	int steps = 0;
+	struct vy_cache_entry *entry;
+	rlist_foreach_entry_reverse(entry, lru, in_lru) {
+		if (entry->cache->mem_used > entry->cache->mem_reserve)
+			return entry;
+		if (++steps >= VY_CACHE_GC_SCAN_MAX)
+			break;
+	}
+	return NULL;
+}
+
+/**
+ * Remove an entry from the cache due to memory shortage.
+ */
 static void
-vy_cache_gc_step(struct vy_cache_env *env)
+vy_cache_evict(struct vy_cache_entry *entry)
 {
-	struct rlist *lru = &env->cache_lru;
-	struct vy_cache_entry *entry =
-	rlist_last_entry(lru, struct vy_cache_entry, in_lru);
 	struct vy_cache *cache = entry->cache;
 	struct vy_cache_tree *tree = &cache->cache_tree;
 	if (entry->flags & (VY_CACHE_LEFT_LINKED |
@@ -193,6 +250,30 @@ vy_cache_gc_step(struct vy_cache_env *env)
 	vy_cache_entry_delete(cache->env, entry);
 }
 
+static void
+vy_cache_gc_step(struct vy_cache_env *env)
+{
+	/*
+	 * Evict probationary entries first unless there are
+	 * too few of them so that entries read only once can't
+	 * push out the protected working set.
+	 */
+	struct rlist *lru = &env->cache_probation;
+	if (rlist_empty(lru) ||
+	    (!rlist_empty(&env->cache_lru) &&
+	     env->probation_mem_used * 100 <=
+	     env->mem_quota * VY_CACHE_PROBATION_PCT))
+		lru = &env->cache_lru;
+	/*
+	 * Spare entries of caches that fit in their reservation
+	 * unless all entries at the LRU tail belong to them.
+	 */
+	struct vy_cache_entry *entry = vy_cache_lru_victim(lru);
+	if (entry == NULL)
+		entry = rlist_last_entry(lru, struct vy_cache_entry, in_lru);
+	vy_cache_evict(entry);
+}
+
 static void
 vy_cache_gc(struct vy_cache_env *env)
 {
@@ -203,6 +284,24 @@ vy_cache_gc(struct vy_cache_env *env)
 	}
 }
 
+/**
+ * Evict the oldest entries of a cache that exceeds its limit.
+ * Return true if the cache still exceeds the limit.
+ */
+static bool
+vy_cache_gc_limit(struct vy_cache *cache)
+{
+	for (uint32_t i = 0;
+	     cache->mem_used >= cache->mem_limit &&
+	     i < VY_CACHE_CLEANUP_MAX_STEPS; i++) {
+		assert(!rlist_empty(&cache->lru));
+		vy_cache_evict(rlist_last_entry(&cache->lru,
+						struct vy_cache_entry,
+						in_cache_lru));
+	}
+	return cache->mem_used >= cache->mem_limit;
+}
+
 void
 vy_cache_env_set_quota(struct vy_cache_env *env, size_t quota)
 {
@@ -230,6 +329,15 @@ vy_cache_add(struct vy_cache *cache, struct tuple *stmt,
 	/* Delete some entries if quota overused */
 	vy_cache_gc(cache->env);
 
+	if (cache->mem_limit != 0 && vy_cache_gc_limit(cache)) {
+		/*
+		 * The cache is still full after a bounded number
+		 * of evictions. Don't admit anything until the
+		 * following calls free enough memory.
+		 */
+		return;
+	}
+
 	if (stmt != NULL && vy_stmt_lsn(stmt) == INT64_MAX) {
 		/* Do not store a statement from write set of a tx */
 		return;
@@ -237,6 +345,11 @@ vy_cache_add(struct vy_cache *cache, struct tuple *stmt,
 
 	/* The case of the first or the last result in key+order query */
 	bool is_boundary = (stmt != NULL) != (prev_stmt != NULL);
+	/*
+	 * If stmt is NULL, prev_stmt was returned by the same
+	 * reader and so must not be considered read again.
+	 */
+	bool is_read = stmt != NULL;
 
 	if (prev_stmt != NULL && vy_stmt_lsn(prev_stmt) == INT64_MAX) {
 		/* Previous statement is from tx write set, can't store it */
@@ -311,6 +424,9 @@ vy_cache_add(struct vy_cache *cache, struct tuple *stmt,
 		entry->flags = replaced->flags;
 		entry->left_boundary_level = replaced->left_boundary_level;
 		entry->right_boundary_level = replaced->right_boundary_level;
+		/* Protect the entry if it is read again. */
+		if (is_read || replaced->is_protected)
+			vy_cache_entry_protect(cache->env, entry);
 		vy_cache_entry_delete(cache->env, replaced);
 	}
 	if (direction > 0 && boundary_level < entry->left_boundary_level)
@@ -398,6 +514,8 @@ vy_cache_add(struct vy_cache *cache, struct tuple *stmt,
 		prev_entry->flags = replaced->flags;
 		prev_entry->left_boundary_level = replaced->left_boundary_level;
 		prev_entry->right_boundary_level = replaced->right_boundary_level;
+		if (replaced->is_protected)
+			vy_cache_entry_protect(cache->env, prev_entry);
 		vy_cache_entry_delete(cache->env, replaced);
 	}
 
@@ -56,8 +56,10 @@ struct vy_cache_entry {
 	struct vy_cache *cache;
 	/* Statement in cache */
 	struct tuple *stmt;
-	/* Link in LRU list */
+	/* Link in the probationary or the protected LRU list */
 	struct rlist in_lru;
+	/* Link in the LRU list of the cache, vy_cache::lru */
+	struct rlist in_cache_lru;
 	/* VY_CACHE_LEFT_LINKED and/or VY_CACHE_RIGHT_LINKED, see
 	 * description of them for more information */
 	uint32_t flags;
@@ -65,6 +67,8 @@ struct vy_cache_entry {
 	uint8_t left_boundary_level;
 	/* Number of parts in key when the value was the last in EQ search */
 	uint8_t right_boundary_level;
+	/* Set if the entry is linked in the protected LRU list */
+	bool is_protected;
 };
 
 /**
@@ -113,14 +117,33 @@ vy_cache_tree_key_cmp(struct vy_cache_entry *a,
 
 /**
  * Environment of the cache
+ *
+ * To make the cache scan resistant, entries are split in two
+ * segments as in the 2Q algorithm. A new entry is admitted to
+ * the probationary segment. It is moved to the protected segment
+ * only when it is read again, so a single scan over a big range
+ * can't flush entries that are read frequently. Entries are
+ * evicted from the probationary segment first unless it uses
+ * less than VY_CACHE_PROBATION_PCT percent of the quota.
  */
 struct vy_cache_env {
-	/** Common LRU list of read cache. The first element is the newest */
+	/**
+	 * Common LRU list of protected entries, i.e. entries
+	 * that were read more than once. The first element is
+	 * the newest.
+	 */
 	struct rlist cache_lru;
+	/**
+	 * Common LRU list of probationary entries, i.e. entries
+	 * that were read only once. The first element is the newest.
+	 */
+	struct rlist cache_probation;
 	/** Common mempool for vy_cache_entry struct */
 	struct mempool cache_entry_mempool;
 	/** Size of memory occupied by cached tuples */
 	size_t mem_used;
+	/** Size of memory occupied by probationary entries */
+	size_t probation_mem_used;
 	/** Max memory size that can be used for cache */
 	size_t mem_quota;
 };
@@ -166,6 +189,21 @@ struct vy_cache {
 	uint32_t version;
 	/* Saved pointer to common cache environment */
 	struct vy_cache_env *env;
+	/* Size of memory occupied by entries of this cache */
+	size_t mem_used;
+	/*
+	 * Entries of this cache are evicted only after entries
+	 * of other caches while mem_used is less than this value
+	 */
+	size_t mem_reserve;
+	/* Max memory size that can be used by this cache, 0 if unlimited */
+	size_t mem_limit;
+	/*
+	 * Entries of this cache in LRU order, the newest first.
+	 * Used to evict the oldest entry when the cache reaches
+	 * its limit.
+	 */
+	struct rlist lru;
 	/* Cache statistics. */
 	struct vy_cache_stat stat;
 };
@@ -145,11 +145,11 @@ vy_lsm_new(struct vy_lsm_env *lsm_env, struct vy_cache_env *cache_env,
 
 	lsm->cmp_def = cmp_def;
 	lsm->key_def = key_def;
-	if (index_def->iid == 0) {
+	if (index_def->iid == 0 || index_def->opts.is_covering) {
 		/*
 		 * Disk tuples can be returned to an user from a
-		 * primary key. And they must have field
-		 * definitions as well as space->format tuples.
+		 * primary or a covering key. And they must have
+		 * field definitions as well as space->format tuples.
 		 */
 		lsm->disk_format = format;
 	} else {
@@ -205,6 +205,8 @@ vy_lsm_new(struct vy_lsm_env *lsm_env, struct vy_cache_env *cache_env,
 	lsm->group_id = group_id;
 	lsm->opts = index_def->opts;
 	lsm->check_is_unique = lsm->opts.is_unique;
+	lsm->cache.mem_reserve = lsm->opts.cache_reserve;
+	lsm->cache.mem_limit = lsm->opts.cache_limit;
 	vy_lsm_read_set_new(&lsm->read_set);
 
 	lsm_env->lsm_count++;
@@ -675,6 +677,8 @@ vy_lsm_generation(struct vy_lsm *lsm)
 int
 vy_lsm_compact_priority(struct vy_lsm *lsm)
 {
+	if (lsm->is_building)
+		return 0;
 	struct heap_node *n = vy_range_heap_top(&lsm->range_heap);
 	if (n == NULL)
 		return 0;
@@ -695,6 +699,9 @@ vy_lsm_add_run(struct vy_lsm *lsm, struct vy_run *run)
 
 	lsm->env->bloom_size += vy_run_bloom_size(run);
 	lsm->env->page_index_size += run->page_index_size;
+
+	/* The page index of a new run may be unloaded if unused. */
+	vy_run_page_index_release(run);
 }
 
 void
@@ -735,12 +742,15 @@ void
 vy_lsm_acct_range(struct vy_lsm *lsm, struct vy_range *range)
 {
 	histogram_collect(lsm->run_hist, range->slice_count);
+	lsm->range_load += vy_range_load(range);
 }
 
 void
 vy_lsm_unacct_range(struct vy_lsm *lsm, struct vy_range *range)
 {
 	histogram_discard(lsm->run_hist, range->slice_count);
+	assert(lsm->range_load >= vy_range_load(range));
+	lsm->range_load -= vy_range_load(range);
 }
 
 int
@@ -838,9 +848,9 @@ vy_lsm_commit_upsert(struct vy_lsm *lsm, struct vy_mem *mem,
 	/*
 	 * If there are a lot of successive upserts for the same key,
 	 * select might take too long to squash them all. So once the
-	 * number of upserts exceeds a certain threshold, we schedule
-	 * a fiber to merge them and insert the resulting statement
-	 * after the latest upsert.
+	 * number of upserts reaches the threshold configured for
+	 * the index, we schedule a fiber to merge them and insert
+	 * the resulting statement after the latest upsert.
 	 */
 	if (n_upserts == VY_UPSERT_INF) {
 		/*
@@ -853,7 +863,9 @@ vy_lsm_commit_upsert(struct vy_lsm *lsm, struct vy_mem *mem,
 		 */
 		return;
 	}
-	if (n_upserts == VY_UPSERT_THRESHOLD) {
+	assert(lsm->opts.upsert_threshold > 0 &&
+	       lsm->opts.upsert_threshold <= VY_UPSERT_THRESHOLD);
+	if (n_upserts == lsm->opts.upsert_threshold) {
 		/*
 		 * Start single squashing task per one-mem and
 		 * one-key continous UPSERTs sequence.
@@ -861,7 +873,7 @@ vy_lsm_commit_upsert(struct vy_lsm *lsm, struct vy_mem *mem,
 #ifndef NDEBUG
 		older = vy_mem_older_lsn(mem, stmt);
 		assert(older != NULL && vy_stmt_type(older) == IPROTO_UPSERT &&
-		       vy_stmt_n_upserts(older) == VY_UPSERT_THRESHOLD - 1);
+		       vy_stmt_n_upserts(older) == n_upserts - 1);
 #endif
 		if (lsm->env->upsert_thresh_cb == NULL) {
 			/* Squash callback is not installed. */
@@ -966,13 +978,24 @@ vy_lsm_rollback_stmt(struct vy_lsm *lsm, struct vy_mem *mem,
 	vy_cache_on_write(&lsm->cache, stmt, NULL);
 }
 
+/**
+ * Return the average load of a range of an LSM tree,
+ * see vy_range::load.
+ */
+static int64_t
+vy_lsm_avg_range_load(struct vy_lsm *lsm)
+{
+	return lsm->range_load / lsm->range_count;
+}
+
 bool
 vy_lsm_split_range(struct vy_lsm *lsm, struct vy_range *range)
 {
 	struct tuple_format *key_format = lsm->env->key_format;
 
 	const char *split_key_raw;
-	if (!vy_range_needs_split(range, &lsm->opts, &split_key_raw))
+	if (!vy_range_needs_split(range, &lsm->opts,
+				  vy_lsm_avg_range_load(lsm), &split_key_raw))
 		return false;
 
 	/* Split a range in two parts. */
@@ -1017,6 +1040,9 @@ vy_lsm_split_range(struct vy_lsm *lsm, struct vy_range *range)
 				vy_range_add_slice(part, new_slice);
 		}
 		part->compact_priority = range->compact_priority;
+		/* Assume the load is evenly distributed. */
+		part->load.reads = range->load.reads / n_parts;
+		part->load.writes = range->load.writes / n_parts;
 	}
 
 	/*
@@ -1079,7 +1105,7 @@ vy_lsm_coalesce_range(struct vy_lsm *lsm, struct vy_range *range)
 {
 	struct vy_range *first, *last;
 	if (!vy_range_needs_coalesce(range, lsm->tree, &lsm->opts,
-				     &first, &last))
+				     vy_lsm_avg_range_load(lsm), &first, &last))
 		return false;
 
 	struct vy_range *result = vy_range_new(vy_log_next_id(),
@@ -1123,6 +1149,8 @@ vy_lsm_coalesce_range(struct vy_lsm *lsm, struct vy_range *range)
 		rlist_splice(&result->slices, &it->slices);
 		result->slice_count += it->slice_count;
 		vy_disk_stmt_counter_add(&result->count, &it->count);
+		result->load.reads += it->load.reads;
+		result->load.writes += it->load.writes;
 		vy_range_delete(it);
 		it = next;
 	}
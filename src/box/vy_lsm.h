@@ -174,6 +174,19 @@ struct vy_lsm {
 	 * of another unique index.
 	 */
 	bool check_is_unique;
+	/**
+	 * Set if the space this LSM tree belongs to was created
+	 * with the defer_deletes option. Secondary index entries
+	 * of such a space may refer to overwritten tuples and so
+	 * must be checked against the primary index on read.
+	 */
+	bool defer_deletes;
+	/**
+	 * Number of the field storing the tuple expiration time,
+	 * see space_opts::ttl_field. Only set for LSM trees that
+	 * store full tuples, 0 otherwise.
+	 */
+	uint32_t ttl_field;
 	/**
 	 * Tuple format for tuples of this LSM tree created when
 	 * reading pages from disk.
@@ -226,6 +239,8 @@ struct vy_lsm {
 	vy_range_tree_t *tree;
 	/** Number of ranges in this LSM tree. */
 	int range_count;
+	/** Sum of loads of all ranges, see vy_range::load. */
+	int64_t range_load;
 	/** Heap of ranges, prioritized by compact_priority. */
 	heap_t range_heap;
 	/**
@@ -279,6 +294,15 @@ struct vy_lsm {
 	int pin_count;
 	/** Set if the LSM tree is currently being dumped. */
 	bool is_dumping;
+	/**
+	 * Set while the LSM tree is being built by writing runs
+	 * directly to disk, see vinyl_space_build_index(). Such
+	 * runs contain statements older than those dumped during
+	 * the build and are added to the LSM tree only when the
+	 * build is complete, by splitting its only range, so the
+	 * LSM tree must not be compacted until then.
+	 */
+	bool is_building;
 	/** Link in vy_scheduler->dump_heap. */
 	struct heap_node in_dump;
 	/** Link in vy_scheduler->compact_heap. */
@@ -300,6 +324,16 @@ vy_lsm_name(struct vy_lsm *lsm);
 size_t
 vy_lsm_mem_tree_size(struct vy_lsm *lsm);
 
+/**
+ * Return true if the LSM tree stores full tuples on disk,
+ * i.e. it is either a primary or a covering secondary index.
+ */
+static inline bool
+vy_lsm_is_covering(struct vy_lsm *lsm)
+{
+	return lsm->index_id == 0 || lsm->opts.is_covering;
+}
+
 /** Allocate a new LSM tree object. */
 struct vy_lsm *
 vy_lsm_new(struct vy_lsm_env *lsm_env, struct vy_cache_env *cache_env,
@@ -394,7 +428,10 @@ vy_lsm_recover(struct vy_lsm *lsm, struct vy_recovery *recovery,
 int64_t
 vy_lsm_generation(struct vy_lsm *lsm);
 
-/** Return max compact_priority among ranges of an LSM tree. */
+/**
+ * Return max compact_priority among ranges of an LSM tree
+ * or 0 if the LSM tree must not be compacted now.
+ */
 int
 vy_lsm_compact_priority(struct vy_lsm *lsm);
 
@@ -420,14 +457,31 @@ vy_lsm_add_range(struct vy_lsm *lsm, struct vy_range *range);
 void
 vy_lsm_remove_range(struct vy_lsm *lsm, struct vy_range *range);
 
-/** Account a range to the run histogram of an LSM tree. */
+/**
+ * Account a range to the run histogram and the range load
+ * of an LSM tree.
+ */
 void
 vy_lsm_acct_range(struct vy_lsm *lsm, struct vy_range *range);
 
-/** Unaccount a range from the run histogram of an LSM tree. */
+/**
+ * Unaccount a range from the run histogram and the range load
+ * of an LSM tree.
+ */
 void
 vy_lsm_unacct_range(struct vy_lsm *lsm, struct vy_range *range);
 
+/**
+ * Account a read that had to scan runs of a range,
+ * see vy_range::load.
+ */
+static inline void
+vy_lsm_acct_range_read(struct vy_lsm *lsm, struct vy_range *range)
+{
+	range->load.reads++;
+	lsm->range_load++;
+}
+
 /**
  * Allocate a new active in-memory index for an LSM tree while
  * moving the old one to the sealed list. Used by the dump task
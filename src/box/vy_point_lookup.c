@@ -130,11 +130,13 @@ vy_point_lookup_scan_mems(struct vy_lsm *lsm, const struct vy_read_view **rv,
 /**
  * Scan one particular slice.
  * Add found statements to the history list up to terminal statement.
+ * @run_count is incremented unless the run is filtered out by
+ * the bloom filter.
  */
 static int
 vy_point_lookup_scan_slice(struct vy_lsm *lsm, struct vy_slice *slice,
 			   const struct vy_read_view **rv, struct tuple *key,
-			   struct vy_history *history)
+			   struct vy_history *history, int *run_count)
 {
 	/*
 	 * The format of the statement must be exactly the space
@@ -144,11 +146,13 @@ vy_point_lookup_scan_slice(struct vy_lsm *lsm, struct vy_slice *slice,
 	struct vy_run_iterator run_itr;
 	vy_run_iterator_open(&run_itr, &lsm->stat.disk.iterator, slice,
 			     ITER_EQ, key, rv, lsm->cmp_def, lsm->key_def,
-			     lsm->disk_format, lsm->index_id == 0);
+			     lsm->disk_format, vy_lsm_is_covering(lsm));
 	struct vy_history slice_history;
 	vy_history_create(&slice_history, &lsm->env->history_node_pool);
 	int rc = vy_run_iterator_next(&run_itr, &slice_history);
 	vy_history_splice(history, &slice_history);
+	if (!run_itr.bloom_hit)
+		++*run_count;
 	vy_run_iterator_close(&run_itr);
 	return rc;
 }
@@ -158,14 +162,17 @@ vy_point_lookup_scan_slice(struct vy_lsm *lsm, struct vy_slice *slice,
  * Add found statements to the history list up to terminal statement.
  * All slices are pinned before first slice scan, so it's guaranteed
  * that complete history from runs will be extracted.
+ * @run_count is incremented by the number of searched runs.
  */
 static int
 vy_point_lookup_scan_slices(struct vy_lsm *lsm, const struct vy_read_view **rv,
-			    struct tuple *key, struct vy_history *history)
+			    struct tuple *key, struct vy_history *history,
+			    int *run_count)
 {
 	struct vy_range *range = vy_range_tree_find_by_key(lsm->tree,
 							   ITER_EQ, key);
 	assert(range != NULL);
+	vy_lsm_acct_range_read(lsm, range);
 	int slice_count = range->slice_count;
 	struct vy_slice **slices = (struct vy_slice **)
 		region_alloc(&fiber()->gc, slice_count * sizeof(*slices));
@@ -183,48 +190,64 @@ vy_point_lookup_scan_slices(struct vy_lsm *lsm, const struct vy_read_view **rv,
 	assert(i == slice_count);
 	int rc = 0;
 	for (i = 0; i < slice_count; i++) {
-		if (rc == 0 && !vy_history_is_terminal(history))
-			rc = vy_point_lookup_scan_slice(lsm, slices[i],
-							rv, key, history);
+		if (rc == 0 && !vy_history_is_terminal(history)) {
+			rc = vy_point_lookup_scan_slice(lsm, slices[i], rv,
+							key, history, run_count);
+		}
 		vy_slice_unpin(slices[i]);
 	}
 	return rc;
 }
 
-int
-vy_point_lookup(struct vy_lsm *lsm, struct vy_tx *tx,
-		const struct vy_read_view **rv,
-		struct tuple *key, struct tuple **ret)
+/**
+ * Scan the transaction write set, the cache and all mems of
+ * the LSM tree for the given key. Doesn't yield.
+ * Add found statements to the history list up to terminal statement.
+ * @source is set to the source the terminal statement was found in.
+ */
+static int
+vy_point_lookup_scan_memory(struct vy_lsm *lsm, struct vy_tx *tx,
+			    const struct vy_read_view **rv,
+			    struct tuple *key, struct vy_history *history,
+			    enum vy_read_source *source)
 {
-	assert(tuple_field_count(key) >= lsm->cmp_def->part_count);
-
-	*ret = NULL;
-	double start_time = ev_monotonic_now(loop());
-	int rc = 0;
+	*source = VY_READ_SOURCE_MEMORY;
+	int rc = vy_point_lookup_scan_txw(lsm, tx, key, history);
+	if (rc != 0 || vy_history_is_terminal(history))
+		return rc;
 
-	lsm->stat.lookup++;
-	/* History list */
-	struct vy_history history;
-	vy_history_create(&history, &lsm->env->history_node_pool);
-restart:
-	rc = vy_point_lookup_scan_txw(lsm, tx, key, &history);
-	if (rc != 0 || vy_history_is_terminal(&history))
-		goto done;
-
-	rc = vy_point_lookup_scan_cache(lsm, rv, key, &history);
-	if (rc != 0 || vy_history_is_terminal(&history))
-		goto done;
+	*source = VY_READ_SOURCE_CACHE;
+	rc = vy_point_lookup_scan_cache(lsm, rv, key, history);
+	if (rc != 0 || vy_history_is_terminal(history))
+		return rc;
 
-	rc = vy_point_lookup_scan_mems(lsm, rv, key, &history);
-	if (rc != 0 || vy_history_is_terminal(&history))
-		goto done;
+	*source = VY_READ_SOURCE_MEMORY;
+	return vy_point_lookup_scan_mems(lsm, rv, key, history);
+}
 
+/**
+ * Complete the history collected by vy_point_lookup_scan_memory()
+ * with statements stored on disk. May yield. If the list of mems
+ * changes while we are waiting for disk, the history is reread
+ * from scratch. @run_count is incremented by the number of
+ * searched runs.
+ */
+static int
+vy_point_lookup_scan_disk(struct vy_lsm *lsm, struct vy_tx *tx,
+			  const struct vy_read_view **rv,
+			  struct tuple *key, struct vy_history *history,
+			  int *run_count)
+{
+	int rc;
+	uint32_t mem_list_version;
+	enum vy_read_source unused;
+restart:
 	/* Save version before yield */
-	uint32_t mem_list_version = lsm->mem_list_version;
+	mem_list_version = lsm->mem_list_version;
 
-	rc = vy_point_lookup_scan_slices(lsm, rv, key, &history);
+	rc = vy_point_lookup_scan_slices(lsm, rv, key, history, run_count);
 	if (rc != 0)
-		goto done;
+		return rc;
 
 	ERROR_INJECT(ERRINJ_VY_POINT_ITER_WAIT, {
 		while (mem_list_version == lsm->mem_list_version)
@@ -241,22 +264,41 @@ restart:
 		 * This in unnecessary in case of rotation but since we
 		 * cannot distinguish these two cases we always restart.
 		 */
-		vy_history_cleanup(&history);
+		vy_history_cleanup(history);
+		rc = vy_point_lookup_scan_memory(lsm, tx, rv, key, history,
+						 &unused);
+		if (rc != 0 || vy_history_is_terminal(history))
+			return rc;
 		goto restart;
 	}
+	return 0;
+}
 
-done:
-	if (rc == 0) {
-		int upserts_applied;
-		rc = vy_history_apply(&history, lsm->cmp_def, lsm->mem_format,
-				      false, &upserts_applied, ret);
-		lsm->stat.upsert.applied += upserts_applied;
-	}
-	vy_history_cleanup(&history);
+/**
+ * Compute the resultant statement from the collected history,
+ * add it to the cache and account the lookup in statistics.
+ * The history is destroyed.
+ */
+static int
+vy_point_lookup_finish(struct vy_lsm *lsm, const struct vy_read_view **rv,
+		       struct tuple *key, struct vy_history *history,
+		       enum vy_read_source source, int run_count,
+		       double start_time, struct tuple **ret)
+{
+	int upserts_applied;
+	int rc = vy_history_apply(history, lsm->cmp_def, lsm->mem_format,
+				  false, &upserts_applied, ret);
+	vy_lsm_stat_acct_upsert_chain(&lsm->stat, upserts_applied);
+	vy_history_cleanup(history);
 
 	if (rc != 0)
 		return -1;
 
+	if (*ret != NULL &&
+	    vy_stmt_is_expired(*ret, lsm->ttl_field, fiber_time())) {
+		tuple_unref(*ret);
+		*ret = NULL;
+	}
 	if (*ret != NULL) {
 		vy_stmt_counter_acct_tuple(&lsm->stat.get, *ret);
 		if ((*rv)->vlsn == INT64_MAX)
@@ -264,7 +306,7 @@ done:
 	}
 
 	double latency = ev_monotonic_now(loop()) - start_time;
-	latency_collect(&lsm->stat.latency, latency);
+	vy_lsm_stat_acct_read(&lsm->stat, source, run_count, latency);
 
 	if (latency > lsm->env->too_long_threshold) {
 		say_warn("%s: get(%s) => %s took too long: %.3f sec",
@@ -273,3 +315,201 @@ done:
 	}
 	return 0;
 }
+
+int
+vy_point_lookup(struct vy_lsm *lsm, struct vy_tx *tx,
+		const struct vy_read_view **rv,
+		struct tuple *key, struct tuple **ret)
+{
+	assert(tuple_field_count(key) >= lsm->cmp_def->part_count);
+
+	*ret = NULL;
+	double start_time = ev_monotonic_now(loop());
+
+	lsm->stat.lookup++;
+	/* History list */
+	struct vy_history history;
+	vy_history_create(&history, &lsm->env->history_node_pool);
+
+	enum vy_read_source source;
+	int run_count = 0;
+	int rc = vy_point_lookup_scan_memory(lsm, tx, rv, key, &history,
+					     &source);
+	if (rc == 0 && !vy_history_is_terminal(&history)) {
+		source = VY_READ_SOURCE_DISK;
+		rc = vy_point_lookup_scan_disk(lsm, tx, rv, key, &history,
+					       &run_count);
+	}
+	if (rc != 0) {
+		vy_history_cleanup(&history);
+		return -1;
+	}
+	return vy_point_lookup_finish(lsm, rv, key, &history, source,
+				      run_count, start_time, ret);
+}
+
+/** State of one key lookup in a batch. */
+struct vy_point_lookup_batch_entry {
+	/** LSM tree to look up in. */
+	struct vy_lsm *lsm;
+	/** Transaction or NULL. */
+	struct vy_tx *tx;
+	/** Read view. */
+	const struct vy_read_view **rv;
+	/** Key to look up. */
+	struct tuple *key;
+	/** Statements of the key collected so far. */
+	struct vy_history history;
+	/**
+	 * Version of the mem list the history was collected at.
+	 * The history may refer to statements stored in mems so
+	 * it has to be reread if the list changes.
+	 */
+	uint32_t mem_list_version;
+	/** Oldest source accessed to look up the key. */
+	enum vy_read_source source;
+	/** Number of runs scanned for the key. */
+	int run_count;
+	/** Fiber reading the disk or NULL. */
+	struct fiber *fiber;
+	/** Set if the history still has to be applied. */
+	bool is_pending;
+};
+
+static int
+vy_point_lookup_batch_f(va_list ap)
+{
+	struct vy_point_lookup_batch_entry *entry =
+		va_arg(ap, struct vy_point_lookup_batch_entry *);
+	int rc = vy_point_lookup_scan_disk(entry->lsm, entry->tx, entry->rv,
+					   entry->key, &entry->history,
+					   &entry->run_count);
+	entry->mem_list_version = entry->lsm->mem_list_version;
+	return rc;
+}
+
+int
+vy_point_lookup_batch(struct vy_lsm *lsm, struct vy_tx *tx,
+		      const struct vy_read_view **rv,
+		      struct tuple **keys, int count, struct tuple **ret)
+{
+	double start_time = ev_monotonic_now(loop());
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
+	struct vy_point_lookup_batch_entry *entries =
+		(struct vy_point_lookup_batch_entry *)
+		region_alloc(region, count * sizeof(*entries));
+	if (entries == NULL) {
+		diag_set(OutOfMemory, count * sizeof(*entries),
+			 "region", "point lookup batch");
+		return -1;
+	}
+
+	/*
+	 * First, resolve all keys we can without yielding, then
+	 * start a fiber for each key that needs to read disk so
+	 * that page reads of all keys are issued to reader threads
+	 * at once. A fiber runs until its first yield on start,
+	 * i.e. until it sends its first read request.
+	 */
+	int rc = 0;
+	for (int i = 0; i < count; i++) {
+		struct vy_point_lookup_batch_entry *entry = &entries[i];
+		assert(tuple_field_count(keys[i]) >=
+		       lsm->cmp_def->part_count);
+		ret[i] = NULL;
+		entry->lsm = lsm;
+		entry->tx = tx;
+		entry->rv = rv;
+		entry->key = keys[i];
+		entry->fiber = NULL;
+		entry->run_count = 0;
+		entry->is_pending = false;
+		if (rc != 0)
+			continue;
+		lsm->stat.lookup++;
+		vy_history_create(&entry->history,
+				  &lsm->env->history_node_pool);
+		rc = vy_point_lookup_scan_memory(lsm, tx, rv, keys[i],
+						 &entry->history,
+						 &entry->source);
+		if (rc != 0) {
+			vy_history_cleanup(&entry->history);
+			continue;
+		}
+		if (vy_history_is_terminal(&entry->history)) {
+			/* Apply the history before it's freed by dump. */
+			rc = vy_point_lookup_finish(lsm, rv, keys[i],
+						    &entry->history,
+						    entry->source, 0,
+						    start_time, &ret[i]);
+			continue;
+		}
+		entry->source = VY_READ_SOURCE_DISK;
+		entry->is_pending = true;
+		entry->fiber = fiber_new("vinyl.point_lookup",
+					 vy_point_lookup_batch_f);
+		if (entry->fiber == NULL) {
+			/* Fall back on reading in this fiber. */
+			diag_clear(diag_get());
+			rc = vy_point_lookup_scan_disk(lsm, tx, rv, keys[i],
+						       &entry->history,
+						       &entry->run_count);
+			entry->mem_list_version = lsm->mem_list_version;
+			continue;
+		}
+		fiber_set_joinable(entry->fiber, true);
+		fiber_start(entry->fiber, entry);
+	}
+
+	/* Wait for all disk reads to complete. */
+	for (int i = 0; i < count; i++) {
+		struct vy_point_lookup_batch_entry *entry = &entries[i];
+		if (entry->fiber != NULL && fiber_join(entry->fiber) != 0)
+			rc = -1;
+	}
+
+	for (int i = 0; i < count; i++) {
+		struct vy_point_lookup_batch_entry *entry = &entries[i];
+		if (!entry->is_pending)
+			continue;
+		if (rc == 0 &&
+		    entry->mem_list_version != lsm->mem_list_version) {
+			/*
+			 * Mems were dumped or rotated while we were
+			 * waiting for other keys. Reread the history.
+			 */
+			enum vy_read_source unused;
+			vy_history_cleanup(&entry->history);
+			rc = vy_point_lookup_scan_memory(lsm, tx, rv,
+							 entry->key,
+							 &entry->history,
+							 &unused);
+			if (rc == 0 && !vy_history_is_terminal(&entry->history))
+				rc = vy_point_lookup_scan_disk(lsm, tx, rv,
+							entry->key,
+							&entry->history,
+							&entry->run_count);
+		}
+		if (rc == 0) {
+			rc = vy_point_lookup_finish(lsm, rv, entry->key,
+						    &entry->history,
+						    entry->source,
+						    entry->run_count,
+						    start_time, &ret[i]);
+		} else {
+			vy_history_cleanup(&entry->history);
+		}
+	}
+	region_truncate(region, region_svp);
+
+	if (rc != 0) {
+		for (int i = 0; i < count; i++) {
+			if (ret[i] != NULL)
+				tuple_unref(ret[i]);
+			ret[i] = NULL;
+		}
+		return -1;
+	}
+	return 0;
+}
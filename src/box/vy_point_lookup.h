@@ -74,6 +74,26 @@ vy_point_lookup(struct vy_lsm *lsm, struct vy_tx *tx,
 		const struct vy_read_view **rv,
 		struct tuple *key, struct tuple **ret);
 
+/**
+ * Look up @count keys in the LSM tree at once. Keys that can be
+ * resolved from memory are looked up right away, while disk reads
+ * needed for the rest of the keys are issued to reader threads in
+ * parallel, so the total latency is close to the latency of one
+ * point lookup rather than the sum of them.
+ *
+ * The tuple found for @keys[i] is returned in @ret[i] (NULL if
+ * not found) with its reference counter elevated. On error, -1 is
+ * returned and no tuples are referenced. The same requirements as
+ * for vy_point_lookup() apply to each key.
+ *
+ * A fiber is started for each key that has to be read from disk,
+ * so the caller is supposed to limit @count.
+ */
+int
+vy_point_lookup_batch(struct vy_lsm *lsm, struct vy_tx *tx,
+		      const struct vy_read_view **rv,
+		      struct tuple **keys, int count, struct tuple **ret);
+
 #if defined(__cplusplus)
 } /* extern "C" */
 #endif /* defined(__cplusplus) */
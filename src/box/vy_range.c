@@ -399,10 +399,13 @@ vy_range_update_compact_priority(struct vy_range *range,
  * - We should split around the last run middle key.
  * - We should only split if the last run size is greater than
  *   4/3 * range_size.
+ * - A hot range, see VY_RANGE_HOT_LOAD_RATIO, is split as long as
+ *   the last run is bigger than range_size / VY_RANGE_HOT_LOAD_RATIO
+ *   so that compaction of hot keys can proceed in parallel.
  */
 bool
 vy_range_needs_split(struct vy_range *range, const struct index_opts *opts,
-		     const char **p_split_key)
+		     int64_t avg_load, const char **p_split_key)
 {
 	struct vy_slice *slice;
 
@@ -415,9 +418,25 @@ vy_range_needs_split(struct vy_range *range, const struct index_opts *opts,
 	slice = rlist_last_entry(&range->slices, struct vy_slice, in_range);
 
 	/* The range is too small to be split. */
-	if (slice->count.bytes_compressed < opts->range_size * 4 / 3)
+	int64_t min_size = opts->range_size * 4 / 3;
+	if (avg_load > 0 &&
+	    vy_range_load(range) > avg_load * VY_RANGE_HOT_LOAD_RATIO)
+		min_size = opts->range_size / VY_RANGE_HOT_LOAD_RATIO;
+	if (slice->count.bytes_compressed < min_size)
 		return false;
 
+	/*
+	 * The split key is looked up in the page index of the
+	 * oldest run. Don't load it here, because this function
+	 * must not yield. A page index is loaded as soon as the
+	 * run is read, and a new run written by compaction has
+	 * it in memory, so the range will be split later if it
+	 * is still too big.
+	 */
+	if (!vy_run_page_index_is_loaded(slice->run))
+		return false;
+	vy_slice_load_page_bounds(slice, range->cmp_def);
+
 	/* Find the median key in the oldest run (approximately). */
 	struct vy_page_info *mid_page;
 	mid_page = vy_run_page_info(slice->run, slice->first_page_no +
@@ -461,6 +480,34 @@ vy_range_needs_split(struct vy_range *range, const struct index_opts *opts,
 	return true;
 }
 
+/**
+ * Check if a range may be added to a group of ranges being
+ * coalesced.
+ *
+ * @param range       Range to check.
+ * @param avg_load    Average range load of the LSM tree.
+ * @param total_size  Size of the ranges already in the group.
+ * @param is_cold[in,out] Set if all ranges in the group are cold.
+ * @param opts        Index options.
+ */
+static bool
+vy_range_can_coalesce(struct vy_range *range, int64_t avg_load,
+		      uint64_t total_size, bool *is_cold,
+		      const struct index_opts *opts)
+{
+	int64_t load = vy_range_load(range);
+	if (avg_load > 0 && load > avg_load * 2)
+		return false;
+	bool range_is_cold = avg_load > 0 &&
+			     load * VY_RANGE_HOT_LOAD_RATIO <= avg_load;
+	uint64_t max_size = *is_cold && range_is_cold ?
+			    opts->range_size : opts->range_size / 2;
+	if (total_size + range->count.bytes_compressed > max_size)
+		return false;
+	*is_cold = *is_cold && range_is_cold;
+	return true;
+}
+
 /**
  * Check if a range should be coalesced with one or more its neighbors.
  * If it should, return true and set @p_first and @p_last to the first
@@ -468,18 +515,27 @@ vy_range_needs_split(struct vy_range *range, const struct index_opts *opts,
  *
  * We coalesce ranges together when they become too small, less than
  * half the target range size to avoid split-coalesce oscillations.
+ * If all coalesced ranges are cold, see VY_RANGE_HOT_LOAD_RATIO, the
+ * resulting range may be as big as the target range size. Ranges
+ * with more than twice the average load are never coalesced, so as
+ * not to undo splitting of a hot range.
  */
 bool
 vy_range_needs_coalesce(struct vy_range *range, vy_range_tree_t *tree,
-			const struct index_opts *opts,
+			const struct index_opts *opts, int64_t avg_load,
 			struct vy_range **p_first, struct vy_range **p_last)
 {
 	struct vy_range *it;
 
 	/* Size of the coalesced range. */
 	uint64_t total_size = range->count.bytes_compressed;
-	/* Coalesce ranges until total_size > max_size. */
-	uint64_t max_size = opts->range_size / 2;
+	/* Set if all coalesced ranges are cold. */
+	bool is_cold = avg_load > 0 &&
+		vy_range_load(range) * VY_RANGE_HOT_LOAD_RATIO <= avg_load;
+
+	/* Don't coalesce a range that was split due to high load. */
+	if (avg_load > 0 && vy_range_load(range) > avg_load * 2)
+		return false;
 
 	/*
 	 * We can't coalesce a range that was scheduled for dump
@@ -492,19 +548,19 @@ vy_range_needs_coalesce(struct vy_range *range, vy_range_tree_t *tree,
 	for (it = vy_range_tree_next(tree, range);
 	     it != NULL && !vy_range_is_scheduled(it);
 	     it = vy_range_tree_next(tree, it)) {
-		uint64_t size = it->count.bytes_compressed;
-		if (total_size + size > max_size)
+		if (!vy_range_can_coalesce(it, avg_load, total_size,
+					   &is_cold, opts))
 			break;
-		total_size += size;
+		total_size += it->count.bytes_compressed;
 		*p_last = it;
 	}
 	for (it = vy_range_tree_prev(tree, range);
 	     it != NULL && !vy_range_is_scheduled(it);
 	     it = vy_range_tree_prev(tree, it)) {
-		uint64_t size = it->count.bytes_compressed;
-		if (total_size + size > max_size)
+		if (!vy_range_can_coalesce(it, avg_load, total_size,
+					   &is_cold, opts))
 			break;
-		total_size += size;
+		total_size += it->count.bytes_compressed;
 		*p_first = it;
 	}
 	return *p_first != *p_last;
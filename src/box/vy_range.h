@@ -116,6 +116,18 @@ struct vy_range {
 	bool needs_compaction;
 	/** Number of times the range was compacted. */
 	int n_compactions;
+	/**
+	 * Load counters used for splitting hot ranges and
+	 * coalescing cold ones. Halved every time the range
+	 * is compacted, so that recent load weighs more.
+	 * Not persistent.
+	 */
+	struct {
+		/** Number of reads that scanned runs of this range. */
+		int64_t reads;
+		/** Number of statements dumped to this range. */
+		int64_t writes;
+	} load;
 	/** Link in vy_lsm->tree. */
 	rb_node(struct vy_range) tree_node;
 	/** Link in vy_lsm->range_heap. */
@@ -127,6 +139,23 @@ struct vy_range {
 	uint32_t version;
 };
 
+/**
+ * A range whose load is more than VY_RANGE_HOT_LOAD_RATIO times
+ * greater than the average range load of the LSM tree is hot.
+ * A hot range is split even if it is smaller than range_size,
+ * but not smaller than range_size / VY_RANGE_HOT_LOAD_RATIO.
+ * A range whose load is that many times less than the average
+ * is cold and may be coalesced into a bigger range.
+ */
+enum { VY_RANGE_HOT_LOAD_RATIO = 4 };
+
+/** Return the load of a range, see vy_range::load. */
+static inline int64_t
+vy_range_load(struct vy_range *range)
+{
+	return range->load.reads + range->load.writes;
+}
+
 /**
  * Heap of all ranges of the same LSM tree, prioritized by
  * vy_range->compact_priority.
@@ -248,13 +277,14 @@ vy_range_update_compact_priority(struct vy_range *range,
  *
  * @param range             The range.
  * @param opts              Index options.
+ * @param avg_load          Average range load of the LSM tree.
  * @param[out] p_split_key  Key to split the range by.
  *
  * @retval true             If the range needs to be split.
  */
 bool
 vy_range_needs_split(struct vy_range *range, const struct index_opts *opts,
-		     const char **p_split_key);
+		     int64_t avg_load, const char **p_split_key);
 
 /**
  * Check if a range needs to be coalesced with adjacent
@@ -263,6 +293,7 @@ vy_range_needs_split(struct vy_range *range, const struct index_opts *opts,
  * @param range         The range.
  * @param tree          The range tree.
  * @param opts          Index options.
+ * @param avg_load      Average range load of the LSM tree.
  * @param[out] p_first  The first range in the tree to coalesce.
  * @param[out] p_last   The last range in the tree to coalesce.
  *
@@ -270,7 +301,7 @@ vy_range_needs_split(struct vy_range *range, const struct index_opts *opts,
  */
 bool
 vy_range_needs_coalesce(struct vy_range *range, vy_range_tree_t *tree,
-			const struct index_opts *opts,
+			const struct index_opts *opts, int64_t avg_load,
 			struct vy_range **p_first, struct vy_range **p_last);
 
 #if defined(__cplusplus)
@@ -438,11 +438,17 @@ vy_read_iterator_next_range(struct vy_read_iterator *itr);
 
 /**
  * Advance the iterator to the next key.
+ * @source is set to the oldest source accessed while looking
+ * up the next key, @run_count to the number of searched runs,
+ * not counting runs filtered out by bloom filters.
  * Returns 0 on success, -1 on error.
  */
 static NODISCARD int
-vy_read_iterator_advance(struct vy_read_iterator *itr)
+vy_read_iterator_advance(struct vy_read_iterator *itr,
+			 enum vy_read_source *source, int *run_count)
 {
+	*source = VY_READ_SOURCE_MEMORY;
+	*run_count = 0;
 	if (itr->last_stmt != NULL && (itr->iterator_type == ITER_EQ ||
 				       itr->iterator_type == ITER_REQ) &&
 	    tuple_field_count(itr->key) >= itr->lsm->cmp_def->part_count) {
@@ -479,8 +485,10 @@ restart:
 		goto done;
 	if (vy_read_iterator_scan_cache(itr, &next_key, &stop) != 0)
 		return -1;
-	if (stop)
+	if (stop) {
+		*source = VY_READ_SOURCE_CACHE;
 		goto done;
+	}
 
 	for (uint32_t i = itr->mem_src; i < itr->disk_src; i++) {
 		if (vy_read_iterator_scan_mem(itr, i, &next_key, &stop) != 0)
@@ -489,13 +497,18 @@ restart:
 			goto done;
 	}
 rescan_disk:
+	vy_lsm_acct_range_read(itr->lsm, itr->curr_range);
 	/* The following code may yield as it needs to access disk. */
 	vy_read_iterator_pin_slices(itr);
 	for (uint32_t i = itr->disk_src; i < itr->src_count; i++) {
+		*source = VY_READ_SOURCE_DISK;
 		if (vy_read_iterator_scan_disk(itr, i, &next_key, &stop) != 0) {
 			vy_read_iterator_unpin_slices(itr);
 			return -1;
 		}
+		/* Don't count runs filtered out by the bloom filter. */
+		if (!itr->src[i].run_iterator.bloom_hit)
+			++*run_count;
 		if (stop)
 			break;
 	}
@@ -623,7 +636,7 @@ vy_read_iterator_add_disk(struct vy_read_iterator *itr)
 				     iterator_type, itr->key,
 				     itr->read_view, lsm->cmp_def,
 				     lsm->key_def, lsm->disk_format,
-				     lsm->index_id == 0);
+				     vy_lsm_is_covering(lsm));
 	}
 }
 
@@ -807,7 +820,7 @@ vy_read_iterator_apply_history(struct vy_read_iterator *itr,
 	int rc = vy_history_apply(&history, lsm->cmp_def, lsm->mem_format,
 				  true, &upserts_applied, ret);
 
-	lsm->stat.upsert.applied += upserts_applied;
+	vy_lsm_stat_acct_upsert_chain(&lsm->stat, upserts_applied);
 	vy_history_cleanup(&history);
 	return rc;
 }
@@ -843,9 +856,12 @@ NODISCARD int
 vy_read_iterator_next(struct vy_read_iterator *itr, struct tuple **result)
 {
 	ev_tstamp start_time = ev_monotonic_now(loop());
+	double now = fiber_time();
 
 	struct vy_lsm *lsm = itr->lsm;
 	struct tuple *stmt, *prev_stmt;
+	enum vy_read_source source, last_source;
+	int run_count = 0, last_run_count;
 
 	/*
 	 * Remember the statement returned by the last iteration.
@@ -856,9 +872,12 @@ vy_read_iterator_next(struct vy_read_iterator *itr, struct tuple **result)
 		tuple_ref(prev_stmt);
 	else /* first iteration */
 		lsm->stat.lookup++;
+	source = VY_READ_SOURCE_CACHE;
 next_key:
-	if (vy_read_iterator_advance(itr) != 0)
+	if (vy_read_iterator_advance(itr, &last_source, &last_run_count) != 0)
 		goto err;
+	source = MAX(source, last_source);
+	run_count += last_run_count;
 	if (vy_read_iterator_apply_history(itr, &stmt) != 0)
 		goto err;
 	if (vy_read_iterator_track_read(itr, stmt) != 0)
@@ -868,13 +887,15 @@ next_key:
 		tuple_unref(itr->last_stmt);
 	itr->last_stmt = stmt;
 
-	if (stmt != NULL && vy_stmt_type(stmt) == IPROTO_DELETE) {
+	if (stmt != NULL && (vy_stmt_type(stmt) == IPROTO_DELETE ||
+			     vy_stmt_is_expired(stmt, lsm->ttl_field, now))) {
 		/*
-		 * We don't return DELETEs so skip to the next key.
-		 * If the DELETE was read from TX write set, there
-		 * is a good chance that the space actually has
-		 * the deleted key and hence we must not consider
-		 * previous + current tuple as an unbroken chain.
+		 * We don't return DELETEs and expired tuples so
+		 * skip to the next key. If the statement was read
+		 * from TX write set, there is a good chance that
+		 * the space actually has the key and hence we
+		 * must not consider previous + current tuple as
+		 * an unbroken chain.
 		 */
 		if (vy_stmt_lsn(stmt) == INT64_MAX) {
 			if (prev_stmt != NULL)
@@ -889,9 +910,9 @@ next_key:
 
 	/*
 	 * Store the result in the cache provided we are reading
-	 * the latest data.
+	 * the latest data and the caller didn't opt out.
 	 */
-	if ((**itr->read_view).vlsn == INT64_MAX) {
+	if ((**itr->read_view).vlsn == INT64_MAX && !itr->skip_cache) {
 		vy_cache_add(&lsm->cache, stmt, prev_stmt,
 			     itr->key, itr->iterator_type);
 	}
@@ -903,7 +924,7 @@ next_key:
 		vy_stmt_counter_acct_tuple(&lsm->stat.get, stmt);
 
 	ev_tstamp latency = ev_monotonic_now(loop()) - start_time;
-	latency_collect(&lsm->stat.latency, latency);
+	vy_lsm_stat_acct_read(&lsm->stat, source, run_count, latency);
 
 	if (latency > lsm->env->too_long_threshold) {
 		say_warn("%s: select(%s, %s) => %s took too long: %.3f sec",
@@ -62,6 +62,12 @@ struct vy_read_iterator {
 	 * checked to match the search key.
 	 */
 	bool need_check_eq;
+	/**
+	 * Set if the iterator must not populate the cache,
+	 * e.g. because it is going to scan the whole index
+	 * only once. May be set after vy_read_iterator_open().
+	 */
+	bool skip_cache;
 	/** Last statement returned by vy_read_iterator_next(). */
 	struct tuple *last_stmt;
 	/**
@@ -31,6 +31,7 @@
 #include "vy_run.h"
 
 #include <zstd.h>
+#include <pmatomic.h>
 
 #include "fiber.h"
 #include "fiber_cond.h"
@@ -59,6 +60,13 @@ static const uint64_t vy_run_info_key_map = (1 << VY_RUN_INFO_MIN_KEY) |
 					    (1 << VY_RUN_INFO_MAX_LSN) |
 					    (1 << VY_RUN_INFO_PAGE_COUNT);
 
+/** Optional run info keys storing run statistics. */
+static const uint64_t vy_run_info_stat_key_map =
+					(1 << VY_RUN_INFO_ROW_COUNT) |
+					(1 << VY_RUN_INFO_SIZE) |
+					(1 << VY_RUN_INFO_UNPACKED_SIZE) |
+					(1 << VY_RUN_INFO_PAGE_KEY_SIZE);
+
 /** xlog meta type for .run files */
 #define XLOG_META_TYPE_RUN "RUN"
 
@@ -97,6 +105,16 @@ struct vy_page_read_task {
 	struct vy_page *page;
 };
 
+/** Cbus task for loading a run page index. */
+struct vy_page_index_read_task {
+	/** parent */
+	struct cbus_call_msg base;
+	/** vy_run to load the page index of - ref. counted */
+	struct vy_run *run;
+	/** [out] loaded page index */
+	struct vy_page_info *page_info;
+};
+
 /** Destructor for env->zdctx_key thread-local variable */
 static void
 vy_free_zdctx(void *arg)
@@ -169,6 +187,7 @@ void
 vy_run_env_create(struct vy_run_env *env)
 {
 	memset(env, 0, sizeof(*env));
+	rlist_create(&env->page_index_lru);
 	tt_pthread_key_create(&env->zdctx_key, vy_free_zdctx);
 	mempool_create(&env->read_task_pool, cord_slab_cache(),
 		       sizeof(struct vy_page_read_task));
@@ -240,18 +259,26 @@ vy_run_new(struct vy_run_env *env, int64_t id)
 	run->refs = 1;
 	rlist_create(&run->in_lsm);
 	rlist_create(&run->in_unused);
+	rlist_create(&run->in_page_index_lru);
 	return run;
 }
 
+/** Free a page index of @page_count pages. */
+static void
+vy_page_index_delete(struct vy_page_info *page_info, uint32_t page_count)
+{
+	if (page_info == NULL)
+		return;
+	for (uint32_t page_no = 0; page_no < page_count; page_no++)
+		vy_page_info_destroy(&page_info[page_no]);
+	free(page_info);
+}
+
 static void
 vy_run_clear(struct vy_run *run)
 {
-	if (run->page_info != NULL) {
-		uint32_t page_no;
-		for (page_no = 0; page_no < run->info.page_count; ++page_no)
-			vy_page_info_destroy(run->page_info + page_no);
-		free(run->page_info);
-	}
+	vy_page_index_delete(run->page_info, run->info.page_count);
+	rlist_del(&run->in_page_index_lru);
 	run->page_info = NULL;
 	run->page_index_size = 0;
 	run->info.page_count = 0;
@@ -265,6 +292,36 @@ vy_run_clear(struct vy_run *run)
 	run->info.max_key = NULL;
 }
 
+void
+vy_run_page_index_release(struct vy_run *run)
+{
+	assert(run->page_index_pins == 0);
+	run->page_index_last_used = ev_monotonic_now(loop());
+	if (run->page_info != NULL && run->dir != NULL)
+		rlist_move(&run->env->page_index_lru, &run->in_page_index_lru);
+}
+
+/**
+ * Pin the page index of a run so that it isn't unloaded.
+ * The page index must be loaded.
+ */
+static void
+vy_run_pin_page_index(struct vy_run *run)
+{
+	assert(vy_run_page_index_is_loaded(run));
+	if (run->page_index_pins++ == 0)
+		rlist_del(&run->in_page_index_lru);
+}
+
+/** Unpin the page index of a run. */
+static void
+vy_run_unpin_page_index(struct vy_run *run)
+{
+	assert(run->page_index_pins > 0);
+	if (--run->page_index_pins == 0)
+		vy_run_page_index_release(run);
+}
+
 void
 vy_run_delete(struct vy_run *run)
 {
@@ -291,17 +348,19 @@ vy_run_bloom_size(struct vy_run *run)
  *  for iteration start. In this case it is certain that the iteration
  *  must be started from the beginning of the next page.
  *
- * @param run - run
+ * @param page_info - page index of the run
+ * @param page_count - number of pages in the run
  * @param key - key to find
  * @param key_def - key_def for comparison
  * @param itype - iterator type (see above)
  * @param equal_key: *equal_key is set to true if there is a page
  *  with min_key equal to the given key.
- * @return offset of the page in page index OR run->info.page_count if
+ * @return offset of the page in page index OR page_count if
  *  there no pages fulfilling the conditions.
  */
 static uint32_t
-vy_page_index_find_page(struct vy_run *run, const struct tuple *key,
+vy_page_index_find_page(const struct vy_page_info *page_info,
+			uint32_t page_count, const struct tuple *key,
 			const struct key_def *cmp_def,
 			enum iterator_type itype, bool *equal_key)
 {
@@ -335,13 +394,12 @@ vy_page_index_find_page(struct vy_run *run, const struct tuple *key,
 	 */
 	bool is_lower_bound = itype == ITER_LT || itype == ITER_GE;
 
-	assert(run->info.page_count > 0);
+	assert(page_count > 0);
 	/* Initially the range is set with virtual positions */
-	int32_t range[2] = { -1, run->info.page_count };
-	assert(run->info.page_count > 0);
+	int32_t range[2] = { -1, page_count };
 	do {
 		int32_t mid = range[0] + (range[1] - range[0]) / 2;
-		struct vy_page_info *info = vy_run_page_info(run, mid);
+		const struct vy_page_info *info = &page_info[mid];
 		int cmp = vy_stmt_compare_with_raw_key(key, info->min_key,
 						       cmp_def);
 		if (is_lower_bound)
@@ -351,7 +409,7 @@ vy_page_index_find_page(struct vy_run *run, const struct tuple *key,
 		*equal_key = *equal_key || cmp == 0;
 	} while (range[1] - range[0] > 1);
 	if (range[0] < 0)
-		range[0] = run->info.page_count;
+		range[0] = page_count;
 	uint32_t page = range[dir > 0];
 
 	/**
@@ -364,6 +422,58 @@ vy_page_index_find_page(struct vy_run *run, const struct tuple *key,
 	return page;
 }
 
+/**
+ * Find the first and the last pages of a run spanned by a slice
+ * in the given page index of the run. Return the number of pages
+ * spanned by the slice, which is 0 if the slice is empty.
+ */
+static uint32_t
+vy_slice_find_page_bounds(struct vy_slice *slice,
+			  const struct vy_page_info *page_info,
+			  const struct key_def *cmp_def,
+			  uint32_t *first_page_no, uint32_t *last_page_no)
+{
+	struct vy_run *run = slice->run;
+	uint32_t page_count = run->info.page_count;
+	assert(page_count > 0);
+	bool unused;
+	if (slice->begin == NULL) {
+		*first_page_no = 0;
+	} else {
+		*first_page_no = vy_page_index_find_page(page_info, page_count,
+							 slice->begin, cmp_def,
+							 ITER_GE, &unused);
+		assert(*first_page_no < page_count);
+	}
+	if (slice->end == NULL) {
+		*last_page_no = page_count - 1;
+	} else {
+		*last_page_no = vy_page_index_find_page(page_info, page_count,
+							slice->end, cmp_def,
+							ITER_LT, &unused);
+		if (*last_page_no == page_count) {
+			/* It's an empty slice */
+			*first_page_no = 0;
+			*last_page_no = 0;
+			return 0;
+		}
+	}
+	assert(*last_page_no >= *first_page_no);
+	return *last_page_no - *first_page_no + 1;
+}
+
+void
+vy_slice_load_page_bounds(struct vy_slice *slice,
+			  const struct key_def *cmp_def)
+{
+	if (slice->has_page_bounds)
+		return;
+	assert(vy_run_page_index_is_loaded(slice->run));
+	vy_slice_find_page_bounds(slice, slice->run->page_info, cmp_def,
+				  &slice->first_page_no, &slice->last_page_no);
+	slice->has_page_bounds = true;
+}
+
 struct vy_slice *
 vy_slice_new(int64_t id, struct vy_run *run,
 	     struct tuple *begin, struct tuple *end,
@@ -390,35 +500,48 @@ vy_slice_new(int64_t id, struct vy_run *run,
 	fiber_cond_create(&slice->pin_cond);
 	if (run->info.page_count == 0) {
 		/* The run is empty hence the slice is empty too. */
+		slice->has_page_bounds = true;
 		return slice;
 	}
-	/** Lookup the first and the last pages spanned by the slice. */
-	bool unused;
-	if (slice->begin == NULL) {
+	/*
+	 * Check if the slice boundaries cut the run. If they
+	 * don't, the slice spans all pages of the run.
+	 */
+	int cut_count = 0;
+	if (slice->begin != NULL &&
+	    vy_stmt_compare_with_raw_key(slice->begin, run->info.min_key,
+					 cmp_def) > 0)
+		cut_count++;
+	if (slice->end != NULL &&
+	    vy_stmt_compare_with_raw_key(slice->end, run->info.max_key,
+					 cmp_def) <= 0)
+		cut_count++;
+	/** Estimate the number of statements in the slice. */
+	uint32_t run_pages = run->info.page_count;
+	uint32_t slice_pages;
+	if (cut_count == 0) {
 		slice->first_page_no = 0;
+		slice->last_page_no = run_pages - 1;
+		slice->has_page_bounds = true;
+		slice_pages = run_pages;
+	} else if (vy_run_page_index_is_loaded(run)) {
+		slice_pages = vy_slice_find_page_bounds(slice, run->page_info,
+							cmp_def,
+							&slice->first_page_no,
+							&slice->last_page_no);
+		slice->has_page_bounds = true;
 	} else {
-		slice->first_page_no =
-			vy_page_index_find_page(run, slice->begin, cmp_def,
-						ITER_GE, &unused);
-		assert(slice->first_page_no < run->info.page_count);
-	}
-	if (slice->end == NULL) {
-		slice->last_page_no = run->info.page_count - 1;
-	} else {
-		slice->last_page_no =
-			vy_page_index_find_page(run, slice->end, cmp_def,
-						ITER_LT, &unused);
-		if (slice->last_page_no == run->info.page_count) {
-			/* It's an empty slice */
-			slice->first_page_no = 0;
-			slice->last_page_no = 0;
-			return slice;
-		}
+		/*
+		 * Don't load the page index only to look up the
+		 * pages spanned by the slice, it's done on first
+		 * access, see vy_slice_load_page_bounds(). Assume
+		 * that the boundaries are uniformly distributed
+		 * over the run pages instead. The estimate isn't
+		 * updated when the page index is loaded, because
+		 * it is accounted to the range.
+		 */
+		slice_pages = DIV_ROUND_UP(run_pages, cut_count + 1);
 	}
-	assert(slice->last_page_no >= slice->first_page_no);
-	/** Estimate the number of statements in the slice. */
-	uint32_t run_pages = run->info.page_count;
-	uint32_t slice_pages = slice->last_page_no - slice->first_page_no + 1;
 	slice->count.pages = slice_pages;
 	slice->count.rows = DIV_ROUND_UP(run->count.rows *
 					 slice_pages, run_pages);
@@ -481,6 +604,9 @@ vy_slice_cut(struct vy_slice *slice, int64_t id,
 /**
  * Decode page information from xrow.
  *
+ * Note, page->min_key points to the xrow body on success,
+ * it's up to the caller to copy it if necessary.
+ *
  * @param[out] page Page information.
  * @param xrow      Xrow to decode.
  * @param filename  Filename for error reporting.
@@ -498,7 +624,6 @@ vy_page_info_decode(struct vy_page_info *page, const struct xrow_header *xrow,
 	uint64_t key_map = vy_page_info_key_map;
 	uint32_t map_size = mp_decode_map(&pos);
 	uint32_t map_item;
-	const char *key_beg;
 	for (map_item = 0; map_item < map_size; ++map_item) {
 		uint32_t key = mp_decode_uint(&pos);
 		key_map &= ~(1ULL << key);
@@ -513,11 +638,8 @@ vy_page_info_decode(struct vy_page_info *page, const struct xrow_header *xrow,
 			page->row_count = mp_decode_uint(&pos);
 			break;
 		case VY_PAGE_INFO_MIN_KEY:
-			key_beg = pos;
+			page->min_key = (char *)pos;
 			mp_next(&pos);
-			page->min_key = vy_key_dup(key_beg);
-			if (page->min_key == NULL)
-				return -1;
 			break;
 		case VY_PAGE_INFO_UNPACKED_SIZE:
 			page->unpacked_size = mp_decode_uint(&pos);
@@ -563,7 +685,7 @@ vy_run_info_decode(struct vy_run_info *run_info,
 	/* decode run */
 	const char *pos = xrow->body->iov_base;
 	memset(run_info, 0, sizeof(*run_info));
-	uint64_t key_map = vy_run_info_key_map;
+	uint64_t key_map = vy_run_info_key_map | vy_run_info_stat_key_map;
 	uint32_t map_size = mp_decode_map(&pos);
 	uint32_t map_item;
 	const char *tmp;
@@ -605,6 +727,18 @@ vy_run_info_decode(struct vy_run_info *run_info,
 			if (run_info->bloom == NULL)
 				return -1;
 			break;
+		case VY_RUN_INFO_ROW_COUNT:
+			run_info->row_count = mp_decode_uint(&pos);
+			break;
+		case VY_RUN_INFO_SIZE:
+			run_info->size = mp_decode_uint(&pos);
+			break;
+		case VY_RUN_INFO_UNPACKED_SIZE:
+			run_info->unpacked_size = mp_decode_uint(&pos);
+			break;
+		case VY_RUN_INFO_PAGE_KEY_SIZE:
+			run_info->page_key_size = mp_decode_uint(&pos);
+			break;
 		default:
 			diag_set(ClientError, ER_INVALID_INDEX_FILE, filename,
 				"Can't decode run info: unknown key %u",
@@ -612,6 +746,9 @@ vy_run_info_decode(struct vy_run_info *run_info,
 			return -1;
 		}
 	}
+	/* Run statistics are missing in files written by old versions. */
+	run_info->has_stat = (key_map & vy_run_info_stat_key_map) == 0;
+	key_map &= ~vy_run_info_stat_key_map;
 	if (key_map) {
 		enum vy_run_info_key key = bit_ctz_u64(key_map);
 		diag_set(ClientError, ER_INVALID_INDEX_FILE, filename,
@@ -634,6 +771,13 @@ vy_page_new(const struct vy_page_info *page_info)
 	}
 	page->unpacked_size = page_info->unpacked_size;
 	page->row_count = page_info->row_count;
+	page->restart_interval = 0;
+	page->rows = page->rows_end = NULL;
+	page->row_buf = NULL;
+	page->row_buf_size = 0;
+	page->row_len = 0;
+	page->row_no = UINT32_MAX;
+	page->row_next = NULL;
 	page->row_index = calloc(page_info->row_count, sizeof(uint32_t));
 	if (page->row_index == NULL) {
 		diag_set(OutOfMemory, page_info->row_count * sizeof(uint32_t),
@@ -658,6 +802,7 @@ vy_page_delete(struct vy_page *page)
 {
 	uint32_t *row_index = page->row_index;
 	char *data = page->data;
+	char *row_buf = page->row_buf;
 #if !defined(NDEBUG)
 	memset(row_index, '#', sizeof(uint32_t) * page->row_count);
 	memset(data, '#', page->unpacked_size);
@@ -665,14 +810,141 @@ vy_page_delete(struct vy_page *page)
 #endif /* !defined(NDEBUG) */
 	free(row_index);
 	free(data);
+	free(row_buf);
 	free(page);
 }
 
+/**
+ * Decode the next row of a prefix compressed page.
+ *
+ * A row is stored as the length of the prefix it shares with the
+ * previous row, encoded as MP_UINT, followed by the rest of the
+ * row, encoded as MP_BIN. The prefix length of a row at a restart
+ * point is always 0.
+ *
+ * @param[in/out] pos   Row position, advanced to the next row.
+ * @param end           End of the page rows.
+ * @param[in/out] buf   Buffer storing the previous row. The
+ *                      decoded row replaces it. Reallocated if
+ *                      it is too small.
+ * @param[in/out] buf_size  Size of @buf.
+ * @param[in/out] len   Length of the row stored in @buf.
+ *
+ * @retval  0 Success.
+ * @retval -1 Memory error or corrupted data.
+ */
+static int
+vy_page_row_decode(const char **pos, const char *end,
+		   char **buf, uint32_t *buf_size, uint32_t *len)
+{
+	const char *p = *pos;
+	if (p >= end || mp_typeof(*p) != MP_UINT ||
+	    mp_check_uint(p, end) > 0)
+		goto error;
+	uint64_t shared = mp_decode_uint(&p);
+	if (p >= end || mp_typeof(*p) != MP_BIN ||
+	    mp_check_binl(p, end) > 0)
+		goto error;
+	uint32_t unshared = mp_decode_binl(&p);
+	if (shared > *len || unshared > (size_t)(end - p))
+		goto error;
+	uint32_t row_len = shared + unshared;
+	if (row_len > *buf_size) {
+		uint32_t size = MAX(row_len, *buf_size * 2);
+		char *new_buf = realloc(*buf, size);
+		if (new_buf == NULL) {
+			diag_set(OutOfMemory, size, "malloc", "row buffer");
+			return -1;
+		}
+		*buf = new_buf;
+		*buf_size = size;
+	}
+	memcpy(*buf + shared, p, unshared);
+	*len = row_len;
+	*pos = p + unshared;
+	return 0;
+error:
+	diag_set(ClientError, ER_INVALID_RUN_FILE,
+		 "Invalid prefix compressed row");
+	return -1;
+}
+
+/**
+ * Decode a row restored by vy_page_row_decode(). To let adjacent
+ * rows share longer prefixes, the row body, which starts with the
+ * tuple, is stored before the row header, which contains the LSN.
+ */
+static int
+vy_page_row_xrow(const char *row, uint32_t len, struct xrow_header *xrow)
+{
+	const char *row_end = row + len;
+	const char *body_end = row;
+	if (mp_check(&body_end, row_end) != 0) {
+		diag_set(ClientError, ER_INVALID_MSGPACK, "packet body");
+		return -1;
+	}
+	const char *header = body_end;
+	if (xrow_header_decode(xrow, &header, row_end) != 0)
+		return -1;
+	if (header != row_end) {
+		diag_set(ClientError, ER_INVALID_RUN_FILE,
+			 "Invalid prefix compressed row");
+		return -1;
+	}
+	xrow->bodycnt = 1;
+	xrow->body[0].iov_base = (void *)row;
+	xrow->body[0].iov_len = body_end - row;
+	return 0;
+}
+
+/**
+ * Restore a row of a prefix compressed page. Rows are decoded
+ * starting from the closest restart point unless the requested
+ * row follows the last decoded one, which makes sequential scans
+ * cheap.
+ */
+static int
+vy_page_compressed_xrow(struct vy_page *page, uint32_t stmt_no,
+			struct xrow_header *xrow)
+{
+	uint32_t interval = page->restart_interval;
+	uint32_t row_no;
+	const char *pos;
+	if (page->row_no != UINT32_MAX && page->row_no <= stmt_no &&
+	    page->row_no / interval == stmt_no / interval) {
+		row_no = page->row_no;
+		pos = page->row_next;
+	} else {
+		row_no = stmt_no / interval * interval;
+		pos = page->rows + page->row_index[stmt_no / interval];
+		page->row_no = UINT32_MAX;
+		page->row_len = 0;
+		if (vy_page_row_decode(&pos, page->rows_end, &page->row_buf,
+				       &page->row_buf_size,
+				       &page->row_len) != 0)
+			return -1;
+	}
+	while (row_no < stmt_no) {
+		if (vy_page_row_decode(&pos, page->rows_end, &page->row_buf,
+				       &page->row_buf_size,
+				       &page->row_len) != 0) {
+			page->row_no = UINT32_MAX;
+			return -1;
+		}
+		row_no++;
+	}
+	page->row_no = row_no;
+	page->row_next = pos;
+	return vy_page_row_xrow(page->row_buf, page->row_len, xrow);
+}
+
 static int
 vy_page_xrow(struct vy_page *page, uint32_t stmt_no,
 	     struct xrow_header *xrow)
 {
 	assert(stmt_no < page->row_count);
+	if (page->restart_interval > 0)
+		return vy_page_compressed_xrow(page, stmt_no, xrow);
 	const char *data = page->data + page->row_index[stmt_no];
 	const char *data_end = stmt_no + 1 < page->row_count ?
 			       page->data + page->row_index[stmt_no + 1] :
@@ -724,37 +996,87 @@ vy_run_iterator_stop(struct vy_run_iterator *itr)
 }
 
 static int
-vy_row_index_decode(uint32_t *row_index, uint32_t row_count,
-		    struct xrow_header *xrow)
+vy_row_index_decode(struct vy_page *page, struct xrow_header *xrow)
 {
 	assert(xrow->type == VY_RUN_ROW_INDEX);
 	const char *pos = xrow->body->iov_base;
 	uint32_t map_size = mp_decode_map(&pos);
 	uint32_t map_item;
 	uint32_t size = 0;
+	const char *data = NULL;
 	for (map_item = 0; map_item < map_size; ++map_item) {
 		uint32_t key = mp_decode_uint(&pos);
 		switch (key) {
 		case VY_ROW_INDEX_DATA:
 			size = mp_decode_binl(&pos);
+			data = pos;
+			pos += size;
+			break;
+		case VY_ROW_INDEX_RESTART_INTERVAL:
+			page->restart_interval = mp_decode_uint(&pos);
+			break;
+		default:
+			mp_next(&pos);
 			break;
 		}
 	}
-	if (size != sizeof(uint32_t) * row_count) {
+	assert(pos == xrow->body->iov_base + xrow->body->iov_len);
+	/*
+	 * A prefix compressed page stores offsets of restart
+	 * points only.
+	 */
+	uint32_t count = page->restart_interval == 0 ? page->row_count :
+			 DIV_ROUND_UP(page->row_count, page->restart_interval);
+	if (size != sizeof(uint32_t) * count) {
 		diag_set(ClientError, ER_INVALID_RUN_FILE,
 			 tt_sprintf("Wrong row index size "
 				    "(expected %zu, got %u",
-				    sizeof(uint32_t) * row_count,
+				    sizeof(uint32_t) * count,
 				    (unsigned)size));
 		return -1;
 	}
-	for (uint32_t i = 0; i < row_count; ++i) {
-		row_index[i] = mp_load_u32(&pos);
+	for (uint32_t i = 0; i < count; ++i) {
+		page->row_index[i] = mp_load_u32(&data);
 	}
-	assert(pos == xrow->body->iov_base + xrow->body->iov_len);
 	return 0;
 }
 
+/**
+ * Get prefix compressed rows stored in a VY_RUN_PAGE_DATA row.
+ */
+static int
+vy_page_data_decode(const struct xrow_header *xrow,
+		    const char **rows, const char **rows_end)
+{
+	assert(xrow->type == VY_RUN_PAGE_DATA);
+	*rows = *rows_end = NULL;
+	if (xrow->bodycnt == 0)
+		goto error;
+	const char *pos = xrow->body->iov_base;
+	uint32_t map_size = mp_decode_map(&pos);
+	for (uint32_t i = 0; i < map_size; i++) {
+		uint32_t key = mp_decode_uint(&pos);
+		switch (key) {
+		case VY_PAGE_DATA_ROWS: {
+			uint32_t size = mp_decode_binl(&pos);
+			*rows = pos;
+			*rows_end = pos + size;
+			pos += size;
+			break;
+		}
+		default:
+			mp_next(&pos);
+			break;
+		}
+	}
+	if (*rows == NULL)
+		goto error;
+	return 0;
+error:
+	diag_set(ClientError, ER_INVALID_RUN_FILE, "Missing page rows");
+	return -1;
+}
+
 /** Return the name of a run data file. */
 static inline const char *
 vy_run_filename(struct vy_run *run)
@@ -820,8 +1142,36 @@ vy_page_read(struct vy_page *page, const struct vy_page_info *page_info,
 				    VY_RUN_ROW_INDEX, (unsigned)xrow.type));
 		goto error;
 	}
-	if (vy_row_index_decode(page->row_index, page->row_count, &xrow) != 0)
+	if (vy_row_index_decode(page, &xrow) != 0)
 		goto error;
+	if (page->restart_interval > 0) {
+		/* Prefix compressed rows go first in the page. */
+		data_pos = page->data;
+		data_end = page->data + page_info->row_index_offset;
+		if (xrow_header_decode(&xrow, &data_pos, data_end) == -1)
+			goto error;
+		if (xrow.type != VY_RUN_PAGE_DATA) {
+			diag_set(ClientError, ER_INVALID_RUN_FILE,
+				 tt_sprintf("Wrong page data type "
+					    "(expected %d, got %u)",
+					    VY_RUN_PAGE_DATA,
+					    (unsigned)xrow.type));
+			goto error;
+		}
+		if (vy_page_data_decode(&xrow, &page->rows,
+					&page->rows_end) != 0)
+			goto error;
+		uint32_t restart_count = DIV_ROUND_UP(page->row_count,
+						page->restart_interval);
+		uint32_t rows_size = page->rows_end - page->rows;
+		for (uint32_t i = 0; i < restart_count; i++) {
+			if (page->row_index[i] >= rows_size) {
+				diag_set(ClientError, ER_INVALID_RUN_FILE,
+					 "Wrong restart point offset");
+				goto error;
+			}
+		}
+	}
 	region_truncate(&fiber()->gc, region_svp);
 	ERROR_INJECT(ERRINJ_VY_READ_PAGE, {
 		diag_set(ClientError, ER_INJECTION, "vinyl page read");
@@ -1011,6 +1361,64 @@ vy_run_iterator_read(struct vy_run_iterator *itr,
 	return 0;
 }
 
+/**
+ * Search in a prefix compressed page. First, do binary search
+ * among rows stored at restart points, which can be decoded
+ * independently, then scan rows following the found restart
+ * point sequentially.
+ * @sa vy_run_iterator_search_in_page()
+ */
+static uint32_t
+vy_run_iterator_search_in_compressed_page(struct vy_run_iterator *itr,
+					  int zero_cmp,
+					  const struct tuple *key,
+					  struct vy_page *page,
+					  bool *equal_key)
+{
+	uint32_t interval = page->restart_interval;
+	uint32_t beg = 0;
+	uint32_t end = DIV_ROUND_UP(page->row_count, interval);
+	struct tuple *fnd_key;
+	int cmp;
+	while (beg != end) {
+		uint32_t mid = beg + (end - beg) / 2;
+		fnd_key = vy_page_stmt(page, mid * interval, itr->cmp_def,
+				       itr->format, itr->is_primary);
+		if (fnd_key == NULL)
+			return page->row_count;
+		cmp = vy_stmt_compare(fnd_key, key, itr->cmp_def);
+		cmp = cmp ? cmp : zero_cmp;
+		*equal_key = *equal_key || cmp == 0;
+		if (cmp < 0)
+			beg = mid + 1;
+		else
+			end = mid;
+		tuple_unref(fnd_key);
+	}
+	/*
+	 * The row at restart point @beg, if any, is not less than
+	 * the key, so the position we are looking for is either
+	 * there or among the rows following the previous restart
+	 * point.
+	 */
+	end = MIN(beg * interval, page->row_count);
+	if (beg == 0)
+		return end;
+	for (uint32_t i = (beg - 1) * interval + 1; i < end; i++) {
+		fnd_key = vy_page_stmt(page, i, itr->cmp_def,
+				       itr->format, itr->is_primary);
+		if (fnd_key == NULL)
+			return page->row_count;
+		cmp = vy_stmt_compare(fnd_key, key, itr->cmp_def);
+		cmp = cmp ? cmp : zero_cmp;
+		*equal_key = *equal_key || cmp == 0;
+		tuple_unref(fnd_key);
+		if (cmp >= 0)
+			return i;
+	}
+	return end;
+}
+
 /**
  * Binary search in page
  * In terms of STL, makes lower_bound for EQ,GE,LT and upper_bound for GT,LE
@@ -1029,6 +1437,9 @@ vy_run_iterator_search_in_page(struct vy_run_iterator *itr,
 	/* for upper bound we change zero comparison result to -1 */
 	int zero_cmp = (iterator_type == ITER_GT ||
 			iterator_type == ITER_LE ? -1 : 0);
+	if (page->restart_interval > 0)
+		return vy_run_iterator_search_in_compressed_page(itr,
+					zero_cmp, key, page, equal_key);
 	while (beg != end) {
 		uint32_t mid = beg + (end - beg) / 2;
 		struct tuple *fnd_key = vy_page_stmt(page, mid, itr->cmp_def,
@@ -1064,10 +1475,12 @@ vy_run_iterator_search(struct vy_run_iterator *itr,
 		       const struct tuple *key,
 		       struct vy_run_iterator_pos *pos, bool *equal_key)
 {
-	pos->page_no = vy_page_index_find_page(itr->slice->run, key,
+	struct vy_run *run = itr->slice->run;
+	pos->page_no = vy_page_index_find_page(run->page_info,
+					       run->info.page_count, key,
 					       itr->cmp_def, iterator_type,
 					       equal_key);
-	if (pos->page_no == itr->slice->run->info.page_count) {
+	if (pos->page_no == run->info.page_count) {
 		itr->search_ended = true;
 		return 0;
 	}
@@ -1240,6 +1653,7 @@ vy_run_iterator_do_seek(struct vy_run_iterator *itr,
 		}
 		if (!need_lookup) {
 			itr->search_ended = true;
+			itr->bloom_hit = true;
 			itr->stat->bloom_hit++;
 			return 0;
 		}
@@ -1247,6 +1661,13 @@ vy_run_iterator_do_seek(struct vy_run_iterator *itr,
 
 	itr->stat->lookup++;
 
+	if (vy_run_load_page_index(run) != 0)
+		return -1;
+	if (!itr->is_page_index_pinned) {
+		vy_run_pin_page_index(run);
+		itr->is_page_index_pinned = true;
+	}
+
 	struct vy_run_iterator_pos end_pos = {run->info.page_count, 0};
 	bool equal_found = false;
 	int rc;
@@ -1401,6 +1822,7 @@ vy_run_iterator_open(struct vy_run_iterator *itr,
 	itr->format = format;
 	itr->is_primary = is_primary;
 	itr->slice = slice;
+	itr->is_page_index_pinned = false;
 
 	itr->iterator_type = iterator_type;
 	itr->key = key;
@@ -1413,6 +1835,7 @@ vy_run_iterator_open(struct vy_run_iterator *itr,
 
 	itr->search_started = false;
 	itr->search_ended = false;
+	itr->bloom_hit = false;
 }
 
 /**
@@ -1501,22 +1924,43 @@ vy_run_iterator_next_lsn(struct vy_run_iterator *itr, struct tuple **ret)
 	return 0;
 }
 
+/**
+ * Append statements of the current key, starting from @stmt,
+ * to a history until a terminal statement is found. Statements
+ * marked with VY_STMT_SKIP_READ are invisible to readers and
+ * so are skipped.
+ * Returns 0 on success, -1 on memory allocation or IO error.
+ */
+static NODISCARD int
+vy_run_iterator_read_history(struct vy_run_iterator *itr,
+			     struct tuple *stmt, struct vy_history *history)
+{
+	while (stmt != NULL) {
+		if ((vy_stmt_flags(stmt) & VY_STMT_SKIP_READ) == 0) {
+			if (vy_history_append_stmt(history, stmt) != 0)
+				return -1;
+			if (vy_history_is_terminal(history))
+				break;
+		}
+		if (vy_run_iterator_next_lsn(itr, &stmt) != 0)
+			return -1;
+	}
+	return 0;
+}
+
 NODISCARD int
 vy_run_iterator_next(struct vy_run_iterator *itr,
 		     struct vy_history *history)
 {
 	vy_history_cleanup(history);
 	struct tuple *stmt;
-	if (vy_run_iterator_next_key(itr, &stmt) != 0)
-		return -1;
-	while (stmt != NULL) {
-		if (vy_history_append_stmt(history, stmt) != 0)
+	do {
+		if (vy_run_iterator_next_key(itr, &stmt) != 0)
 			return -1;
-		if (vy_history_is_terminal(history))
-			break;
-		if (vy_run_iterator_next_lsn(itr, &stmt) != 0)
+		if (vy_run_iterator_read_history(itr, stmt, history) != 0)
 			return -1;
-	}
+		/* Skip keys having only statements hidden from reads. */
+	} while (stmt != NULL && vy_history_last_stmt(history) == NULL);
 	return 0;
 }
 
@@ -1561,14 +2005,10 @@ vy_run_iterator_skip(struct vy_run_iterator *itr,
 		return 0;
 	}
 
-	while (stmt != NULL) {
-		if (vy_history_append_stmt(history, stmt) != 0)
-			return -1;
-		if (vy_history_is_terminal(history))
-			break;
-		if (vy_run_iterator_next_lsn(itr, &stmt) != 0)
-			return -1;
-	}
+	if (vy_run_iterator_read_history(itr, stmt, history) != 0)
+		return -1;
+	if (stmt != NULL && vy_history_last_stmt(history) == NULL)
+		return vy_run_iterator_next(itr, history);
 	return 0;
 }
 
@@ -1576,12 +2016,18 @@ void
 vy_run_iterator_close(struct vy_run_iterator *itr)
 {
 	vy_run_iterator_stop(itr);
+	if (itr->is_page_index_pinned)
+		vy_run_unpin_page_index(itr->slice->run);
 	TRASH(itr);
 }
 
 /* }}} vy_run_iterator API implementation */
 
-/** Account a page to run statistics. */
+/**
+ * Account a page to run statistics. The statistics are also
+ * stored in the run info so that they can be restored without
+ * reading page info on recovery, see vy_run_acct_info().
+ */
 static void
 vy_run_acct_page(struct vy_run *run, struct vy_page_info *page)
 {
@@ -1593,21 +2039,39 @@ vy_run_acct_page(struct vy_run *run, struct vy_page_info *page)
 	run->count.bytes += page->unpacked_size;
 	run->count.bytes_compressed += page->size;
 	run->count.pages++;
+	run->info.row_count += page->row_count;
+	run->info.size += page->size;
+	run->info.unpacked_size += page->unpacked_size;
+	run->info.page_key_size += min_key_end - page->min_key;
 }
 
-int
-vy_run_recover(struct vy_run *run, const char *dir,
-	       uint32_t space_id, uint32_t iid)
+/** Restore run statistics from the run info. */
+static void
+vy_run_acct_info(struct vy_run *run)
 {
-	char path[PATH_MAX];
-	vy_run_snprint_path(path, sizeof(path), dir,
-			    space_id, iid, run->id, VY_FILE_INDEX);
+	assert(run->info.has_stat);
+	run->page_index_size = run->info.page_count *
+			       sizeof(struct vy_page_info) +
+			       run->info.page_key_size;
+	run->count.rows = run->info.row_count;
+	run->count.bytes = run->info.unpacked_size;
+	run->count.bytes_compressed = run->info.size;
+	run->count.pages = run->info.page_count;
+}
 
-	struct xlog_cursor cursor;
-	if (xlog_cursor_open(&cursor, path))
-		goto fail;
+/**
+ * Open a run index file and read the run info row into @xrow.
+ * On success the cursor is positioned at the first page info
+ * row.
+ */
+static int
+vy_run_open_index(struct xlog_cursor *cursor, const char *path,
+		  struct xrow_header *xrow)
+{
+	if (xlog_cursor_open(cursor, path))
+		return -1;
 
-	struct xlog_meta *meta = &cursor.meta;
+	struct xlog_meta *meta = &cursor->meta;
 	if (strcmp(meta->filetype, XLOG_META_TYPE_INDEX) != 0) {
 		diag_set(ClientError, ER_INVALID_XLOG_TYPE,
 			 XLOG_META_TYPE_INDEX, meta->filetype);
@@ -1615,12 +2079,11 @@ vy_run_recover(struct vy_run *run, const char *dir,
 	}
 
 	/* Read run header. */
-	struct xrow_header xrow;
 	ERROR_INJECT(ERRINJ_VYRUN_INDEX_GARBAGE, {
 		errinj(ERRINJ_XLOG_GARBAGE, ERRINJ_BOOL)->bparam = true;
 	});
 	/* all rows should be in one tx */
-	int rc = xlog_cursor_next_tx(&cursor);
+	int rc = xlog_cursor_next_tx(cursor);
 	ERROR_INJECT(ERRINJ_VYRUN_INDEX_GARBAGE, {
 		errinj(ERRINJ_XLOG_GARBAGE, ERRINJ_BOOL)->bparam = false;
 	});
@@ -1631,7 +2094,7 @@ vy_run_recover(struct vy_run *run, const char *dir,
 				 path, "Unexpected end of file");
 		goto fail_close;
 	}
-	rc = xlog_cursor_next_row(&cursor, &xrow);
+	rc = xlog_cursor_next_row(cursor, xrow);
 	if (rc != 0) {
 		if (rc > 0)
 			diag_set(ClientError, ER_INVALID_INDEX_FILE,
@@ -1639,59 +2102,80 @@ vy_run_recover(struct vy_run *run, const char *dir,
 		goto fail_close;
 	}
 
-	if (xrow.type != VY_INDEX_RUN_INFO) {
+	if (xrow->type != VY_INDEX_RUN_INFO) {
 		diag_set(ClientError, ER_INVALID_INDEX_FILE, path,
 			 tt_sprintf("Wrong xrow type (expected %d, got %u)",
-				    VY_INDEX_RUN_INFO, (unsigned)xrow.type));
+				    VY_INDEX_RUN_INFO, (unsigned)xrow->type));
 		goto fail_close;
 	}
+	return 0;
 
-	if (vy_run_info_decode(&run->info, &xrow, path) != 0)
-		goto fail_close;
-
-	/* Allocate buffer for page info. */
-	run->page_info = calloc(run->info.page_count,
-				      sizeof(struct vy_page_info));
-	if (run->page_info == NULL) {
-		diag_set(OutOfMemory,
-			 run->info.page_count * sizeof(struct vy_page_info),
-			 "malloc", "struct vy_page_info");
-		goto fail_close;
-	}
+fail_close:
+	xlog_cursor_close(cursor, false);
+	return -1;
+}
 
-	for (uint32_t page_no = 0; page_no < run->info.page_count; page_no++) {
-		int rc = xlog_cursor_next_row(&cursor, &xrow);
-		if (rc != 0) {
-			if (rc > 0) {
-				/** To few pages in file */
-				diag_set(ClientError, ER_INVALID_INDEX_FILE,
-					 path, "Unexpected end of file");
-			}
-			/*
-			 * Limit the count of pages to
-			 * successfully created pages.
-			 */
-			run->info.page_count = page_no;
-			goto fail_close;
-		}
-		if (xrow.type != VY_INDEX_PAGE_INFO) {
+/**
+ * Read the next page info row from a run index file opened
+ * with vy_run_open_index(). Note, page->min_key points to
+ * the cursor buffer, see vy_page_info_decode().
+ */
+static int
+vy_run_read_page_info(struct xlog_cursor *cursor, const char *path,
+		      struct vy_page_info *page)
+{
+	struct xrow_header xrow;
+	int rc = xlog_cursor_next_row(cursor, &xrow);
+	if (rc != 0) {
+		if (rc > 0) {
+			/** To few pages in file */
 			diag_set(ClientError, ER_INVALID_INDEX_FILE,
-				 tt_sprintf("Wrong xrow type "
-					    "(expected %d, got %u)",
-					    VY_INDEX_PAGE_INFO,
-					    (unsigned)xrow.type));
-			goto fail_close;
+				 path, "Unexpected end of file");
 		}
-		struct vy_page_info *page = run->page_info + page_no;
-		if (vy_page_info_decode(page, &xrow, path) < 0) {
-			/**
-			 * Limit the count of pages to successfully
-			 * created pages
-			 */
-			run->info.page_count = page_no;
-			goto fail_close;
+		return -1;
+	}
+	if (xrow.type != VY_INDEX_PAGE_INFO) {
+		diag_set(ClientError, ER_INVALID_INDEX_FILE, path,
+			 tt_sprintf("Wrong xrow type "
+				    "(expected %d, got %u)",
+				    VY_INDEX_PAGE_INFO,
+				    (unsigned)xrow.type));
+		return -1;
+	}
+	return vy_page_info_decode(page, &xrow, path);
+}
+
+int
+vy_run_recover(struct vy_run *run, const char *dir,
+	       uint32_t space_id, uint32_t iid)
+{
+	char path[PATH_MAX];
+	vy_run_snprint_path(path, sizeof(path), dir,
+			    space_id, iid, run->id, VY_FILE_INDEX);
+
+	struct xlog_cursor cursor;
+	struct xrow_header xrow;
+	if (vy_run_open_index(&cursor, path, &xrow) != 0)
+		goto fail;
+	if (vy_run_info_decode(&run->info, &xrow, path) != 0)
+		goto fail_close;
+
+	/*
+	 * The page index is loaded on demand by vy_run_load_page_index()
+	 * so as not to waste time and memory on runs that are never read.
+	 * Run statistics are stored in the run info, only index files
+	 * written by old versions need to be scanned to account pages.
+	 */
+	if (run->info.has_stat) {
+		vy_run_acct_info(run);
+	} else {
+		for (uint32_t page_no = 0; page_no < run->info.page_count;
+		     page_no++) {
+			struct vy_page_info page;
+			if (vy_run_read_page_info(&cursor, path, &page) != 0)
+				goto fail_close;
+			vy_run_acct_page(run, &page);
 		}
-		vy_run_acct_page(run, page);
 	}
 
 	/* We don't need to keep metadata file open any longer. */
@@ -1702,7 +2186,7 @@ vy_run_recover(struct vy_run *run, const char *dir,
 			    space_id, iid, run->id, VY_FILE_RUN);
 	if (xlog_cursor_open(&cursor, path))
 		goto fail;
-	meta = &cursor.meta;
+	struct xlog_meta *meta = &cursor.meta;
 	if (strcmp(meta->filetype, XLOG_META_TYPE_RUN) != 0) {
 		diag_set(ClientError, ER_INVALID_XLOG_TYPE,
 			 XLOG_META_TYPE_RUN, meta->filetype);
@@ -1710,17 +2194,259 @@ vy_run_recover(struct vy_run *run, const char *dir,
 	}
 	run->fd = cursor.fd;
 	xlog_cursor_close(&cursor, true);
+	run->dir = dir;
+	run->space_id = space_id;
+	run->iid = iid;
 	return 0;
 
 fail_close:
 	xlog_cursor_close(&cursor, false);
 fail:
 	vy_run_clear(run);
+	memset(&run->count, 0, sizeof(run->count));
 	diag_log();
 	say_error("failed to load `%s'", path);
 	return -1;
 }
 
+/**
+ * Read the page index of a run from the index file.
+ * Blocks, so in tx it may only be called when reader threads
+ * aren't running. Doesn't modify the run.
+ */
+static struct vy_page_info *
+vy_run_read_page_index(struct vy_run *run)
+{
+	assert(run->dir != NULL);
+	char path[PATH_MAX];
+	vy_run_snprint_path(path, sizeof(path), run->dir,
+			    run->space_id, run->iid, run->id, VY_FILE_INDEX);
+
+	/* The run info was decoded by vy_run_recover(), skip it. */
+	struct xlog_cursor cursor;
+	struct xrow_header xrow;
+	if (vy_run_open_index(&cursor, path, &xrow) != 0)
+		goto fail;
+
+	struct vy_page_info *page_info = calloc(run->info.page_count,
+						sizeof(*page_info));
+	if (page_info == NULL) {
+		diag_set(OutOfMemory,
+			 run->info.page_count * sizeof(*page_info),
+			 "malloc", "struct vy_page_info");
+		goto fail_close;
+	}
+	uint32_t page_no;
+	for (page_no = 0; page_no < run->info.page_count; page_no++) {
+		struct vy_page_info *page = &page_info[page_no];
+		if (vy_run_read_page_info(&cursor, path, page) != 0)
+			goto fail_free;
+		page->min_key = vy_key_dup(page->min_key);
+		if (page->min_key == NULL)
+			goto fail_free;
+	}
+	xlog_cursor_close(&cursor, false);
+	return page_info;
+
+fail_free:
+	vy_page_index_delete(page_info, page_no);
+fail_close:
+	xlog_cursor_close(&cursor, false);
+fail:
+	diag_log();
+	say_error("failed to load page index from `%s'", path);
+	return NULL;
+}
+
+/**
+ * vinyl page index read task callback
+ */
+static int
+vy_page_index_read_cb(struct cbus_call_msg *base)
+{
+	struct vy_page_index_read_task *task =
+		(struct vy_page_index_read_task *)base;
+	task->page_info = vy_run_read_page_index(task->run);
+	return task->page_info == NULL ? -1 : 0;
+}
+
+/**
+ * vinyl page index read task cleanup callback
+ */
+static int
+vy_page_index_read_cb_free(struct cbus_call_msg *base)
+{
+	struct vy_page_index_read_task *task =
+		(struct vy_page_index_read_task *)base;
+	vy_page_index_delete(task->page_info, task->run->info.page_count);
+	vy_run_unref(task->run);
+	free(task);
+	return 0;
+}
+
+int
+vy_run_load_page_index(struct vy_run *run)
+{
+	if (vy_run_page_index_is_loaded(run))
+		return 0;
+
+	struct vy_run_env *env = run->env;
+	struct vy_page_info *page_info;
+	if (env->reader_pool != NULL) {
+		struct vy_page_index_read_task *task = malloc(sizeof(*task));
+		if (task == NULL) {
+			diag_set(OutOfMemory, sizeof(*task), "malloc",
+				 "struct vy_page_index_read_task");
+			return -1;
+		}
+		struct vy_run_reader *reader;
+		reader = &env->reader_pool[env->next_reader++];
+		env->next_reader %= env->reader_pool_size;
+
+		task->run = run;
+		task->page_info = NULL;
+		vy_run_ref(run);
+
+		int rc = cbus_call(&reader->reader_pipe, &reader->tx_pipe,
+				   &task->base, vy_page_index_read_cb,
+				   vy_page_index_read_cb_free,
+				   TIMEOUT_INFINITY);
+		if (!task->base.complete)
+			return -1; /* timed out or cancelled */
+		page_info = task->page_info;
+		vy_run_unref(run);
+		free(task);
+		if (rc != 0)
+			return -1;
+	} else {
+		page_info = vy_run_read_page_index(run);
+		if (page_info == NULL)
+			return -1;
+	}
+	if (vy_run_page_index_is_loaded(run)) {
+		/* Loaded by another fiber while we were waiting. */
+		vy_page_index_delete(page_info, run->info.page_count);
+		return 0;
+	}
+	run->page_info = page_info;
+	if (run->page_index_pins == 0)
+		vy_run_page_index_release(run);
+	return 0;
+}
+
+void
+vy_run_env_unload_page_indexes(struct vy_run_env *env, double timeout)
+{
+	double deadline = ev_monotonic_now(loop()) - timeout;
+	while (!rlist_empty(&env->page_index_lru)) {
+		struct vy_run *run = rlist_last_entry(&env->page_index_lru,
+						      struct vy_run,
+						      in_page_index_lru);
+		if (run->page_index_last_used >= deadline)
+			break;
+		assert(run->page_index_pins == 0);
+		assert(run->dir != NULL);
+		if (pm_atomic_load(&run->page_index_stream_pins) > 0) {
+			/*
+			 * The page index is used by a worker thread.
+			 * Give it another timeout.
+			 */
+			vy_run_page_index_release(run);
+			continue;
+		}
+		rlist_del(&run->in_page_index_lru);
+		vy_page_index_delete(run->page_info, run->info.page_count);
+		run->page_info = NULL;
+	}
+}
+
+/**
+ * Read transactions of a run file starting at @offset so that
+ * their checksums are checked, until @chunk_size bytes are read
+ * or the end of the file is reached, see vy_run_verify().
+ *
+ * @retval  1 The end of the file is reached.
+ * @retval  0 There's more to read, @offset is updated.
+ * @retval -1 Corruption or read error.
+ */
+static int
+vy_run_verify_file(const char *path, enum vy_file_type type,
+		   off_t *offset, size_t chunk_size, size_t *bytes)
+{
+	const char *filetype = type == VY_FILE_INDEX ?
+			       XLOG_META_TYPE_INDEX : XLOG_META_TYPE_RUN;
+	struct xlog_cursor cursor;
+	if (xlog_cursor_open(&cursor, path) != 0)
+		return -1;
+	if (strcmp(cursor.meta.filetype, filetype) != 0) {
+		diag_set(ClientError, ER_INVALID_XLOG_TYPE,
+			 filetype, cursor.meta.filetype);
+		goto fail;
+	}
+	if (*offset > 0)
+		xlog_cursor_seek(&cursor, *offset);
+	int rc;
+	off_t pos = xlog_cursor_pos(&cursor);
+	while ((rc = xlog_cursor_next_tx(&cursor)) == 0) {
+		struct xrow_header xrow;
+		while ((rc = xlog_cursor_next_row(&cursor, &xrow)) == 0)
+			;
+		if (rc < 0)
+			goto fail;
+		off_t next_pos = xlog_cursor_pos(&cursor);
+		*bytes += next_pos - pos;
+		pos = next_pos;
+		if (*bytes >= chunk_size) {
+			*offset = pos;
+			xlog_cursor_close(&cursor, false);
+			return 0;
+		}
+	}
+	if (rc < 0)
+		goto fail;
+	if (!xlog_cursor_is_eof(&cursor)) {
+		if (type == VY_FILE_INDEX)
+			diag_set(ClientError, ER_INVALID_INDEX_FILE,
+				 path, "Unexpected end of file");
+		else
+			diag_set(ClientError, ER_INVALID_RUN_FILE,
+				 tt_sprintf("%s: Unexpected end of file",
+					    path));
+		goto fail;
+	}
+	xlog_cursor_close(&cursor, false);
+	return 1;
+fail:
+	xlog_cursor_close(&cursor, false);
+	return -1;
+}
+
+int
+vy_run_verify(const char *dir, uint32_t space_id, uint32_t iid,
+	      int64_t run_id, struct vy_run_verify_pos *pos,
+	      size_t chunk_size, size_t *bytes)
+{
+	*bytes = 0;
+	char path[PATH_MAX];
+	int rc;
+	if (!pos->is_run_file) {
+		vy_run_snprint_path(path, sizeof(path), dir,
+				    space_id, iid, run_id, VY_FILE_INDEX);
+		rc = vy_run_verify_file(path, VY_FILE_INDEX, &pos->offset,
+					chunk_size, bytes);
+		if (rc <= 0)
+			return rc;
+		pos->is_run_file = true;
+		pos->offset = 0;
+		if (*bytes >= chunk_size)
+			return 0;
+	}
+	vy_run_snprint_path(path, sizeof(path), dir,
+			    space_id, iid, run_id, VY_FILE_RUN);
+	return vy_run_verify_file(path, VY_FILE_RUN, &pos->offset,
+				  chunk_size, bytes);
+}
+
 /* dump statement to the run page buffers (stmt header and data) */
 static int
 vy_run_dump_stmt(const struct tuple *value, struct xlog *data_xlog,
@@ -1748,27 +2474,39 @@ vy_run_dump_stmt(const struct tuple *value, struct xlog *data_xlog,
  *
  * @param row_index row index
  * @param row_count size of row index
+ * @param restart_interval number of rows between restart points
+ *        if the page is prefix compressed, 0 otherwise
  * @param[out] xrow xrow to fill.
  * @retval 0 for success
  * @retval -1 for error
  */
 static int
 vy_row_index_encode(const uint32_t *row_index, uint32_t row_count,
-		    struct xrow_header *xrow)
+		    uint32_t restart_interval, struct xrow_header *xrow)
 {
 	memset(xrow, 0, sizeof(*xrow));
 	xrow->type = VY_RUN_ROW_INDEX;
 
-	size_t size = mp_sizeof_map(1) +
-		      mp_sizeof_uint(VY_ROW_INDEX_DATA) +
+	uint32_t map_size = 1;
+	size_t size = mp_sizeof_uint(VY_ROW_INDEX_DATA) +
 		      mp_sizeof_bin(sizeof(uint32_t) * row_count);
+	if (restart_interval > 0) {
+		map_size++;
+		size += mp_sizeof_uint(VY_ROW_INDEX_RESTART_INTERVAL) +
+			mp_sizeof_uint(restart_interval);
+	}
+	size += mp_sizeof_map(map_size);
 	char *pos = region_alloc(&fiber()->gc, size);
 	if (pos == NULL) {
 		diag_set(OutOfMemory, size, "region", "row index");
 		return -1;
 	}
 	xrow->body->iov_base = pos;
-	pos = mp_encode_map(pos, 1);
+	pos = mp_encode_map(pos, map_size);
+	if (restart_interval > 0) {
+		pos = mp_encode_uint(pos, VY_ROW_INDEX_RESTART_INTERVAL);
+		pos = mp_encode_uint(pos, restart_interval);
+	}
 	pos = mp_encode_uint(pos, VY_ROW_INDEX_DATA);
 	pos = mp_encode_binl(pos, sizeof(uint32_t) * row_count);
 	for (uint32_t i = 0; i < row_count; ++i)
@@ -1779,6 +2517,41 @@ vy_row_index_encode(const uint32_t *row_index, uint32_t row_count,
 	return 0;
 }
 
+/**
+ * Encode prefix compressed rows of a page as xrow.
+ *
+ * @param rows rows
+ * @param size size of rows
+ * @param[out] xrow xrow to fill, refers to @rows.
+ * @retval 0 for success
+ * @retval -1 for error
+ */
+static int
+vy_page_data_encode(const char *rows, uint32_t size,
+		    struct xrow_header *xrow)
+{
+	memset(xrow, 0, sizeof(*xrow));
+	xrow->type = VY_RUN_PAGE_DATA;
+
+	size_t header_size = mp_sizeof_map(1) +
+			     mp_sizeof_uint(VY_PAGE_DATA_ROWS) +
+			     mp_sizeof_binl(size);
+	char *pos = region_alloc(&fiber()->gc, header_size);
+	if (pos == NULL) {
+		diag_set(OutOfMemory, header_size, "region", "page data");
+		return -1;
+	}
+	xrow->body[0].iov_base = pos;
+	pos = mp_encode_map(pos, 1);
+	pos = mp_encode_uint(pos, VY_PAGE_DATA_ROWS);
+	pos = mp_encode_binl(pos, size);
+	xrow->body[0].iov_len = header_size;
+	xrow->body[1].iov_base = (void *)rows;
+	xrow->body[1].iov_len = size;
+	xrow->bodycnt = 2;
+	return 0;
+}
+
 /**
  * Helper to extend run page info array
  */
@@ -1896,7 +2669,7 @@ vy_run_info_encode(const struct vy_run_info *run_info,
 	mp_next(&tmp);
 	size_t max_key_size = tmp - run_info->max_key;
 
-	uint32_t key_count = 5;
+	uint32_t key_count = 9;
 	if (run_info->bloom != NULL)
 		key_count++;
 
@@ -1912,6 +2685,14 @@ vy_run_info_encode(const struct vy_run_info *run_info,
 	if (run_info->bloom != NULL)
 		size += mp_sizeof_uint(VY_RUN_INFO_BLOOM) +
 			tuple_bloom_size(run_info->bloom);
+	size += mp_sizeof_uint(VY_RUN_INFO_ROW_COUNT) +
+		mp_sizeof_uint(run_info->row_count);
+	size += mp_sizeof_uint(VY_RUN_INFO_SIZE) +
+		mp_sizeof_uint(run_info->size);
+	size += mp_sizeof_uint(VY_RUN_INFO_UNPACKED_SIZE) +
+		mp_sizeof_uint(run_info->unpacked_size);
+	size += mp_sizeof_uint(VY_RUN_INFO_PAGE_KEY_SIZE) +
+		mp_sizeof_uint(run_info->page_key_size);
 
 	char *pos = region_alloc(&fiber()->gc, size);
 	if (pos == NULL) {
@@ -1938,6 +2719,14 @@ vy_run_info_encode(const struct vy_run_info *run_info,
 		pos = mp_encode_uint(pos, VY_RUN_INFO_BLOOM);
 		pos = tuple_bloom_encode(run_info->bloom, pos);
 	}
+	pos = mp_encode_uint(pos, VY_RUN_INFO_ROW_COUNT);
+	pos = mp_encode_uint(pos, run_info->row_count);
+	pos = mp_encode_uint(pos, VY_RUN_INFO_SIZE);
+	pos = mp_encode_uint(pos, run_info->size);
+	pos = mp_encode_uint(pos, VY_RUN_INFO_UNPACKED_SIZE);
+	pos = mp_encode_uint(pos, run_info->unpacked_size);
+	pos = mp_encode_uint(pos, VY_RUN_INFO_PAGE_KEY_SIZE);
+	pos = mp_encode_uint(pos, run_info->page_key_size);
 	xrow->body->iov_len = (void *)pos - xrow->body->iov_base;
 	xrow->bodycnt = 1;
 	xrow->type = VY_INDEX_RUN_INFO;
@@ -2015,14 +2804,17 @@ fail:
 int
 vy_run_writer_create(struct vy_run_writer *writer, struct vy_run *run,
 		const char *dirpath, uint32_t space_id, uint32_t iid,
-		const struct key_def *cmp_def, const struct key_def *key_def,
-		uint64_t page_size, double bloom_fpr)
+		bool is_primary, const struct key_def *cmp_def,
+		const struct key_def *key_def,
+		uint64_t page_size, double bloom_fpr,
+		uint32_t restart_interval)
 {
 	memset(writer, 0, sizeof(*writer));
 	writer->run = run;
 	writer->dirpath = dirpath;
 	writer->space_id = space_id;
 	writer->iid = iid;
+	writer->is_primary = is_primary;
 	writer->cmp_def = cmp_def;
 	writer->key_def = key_def;
 	writer->page_size = page_size;
@@ -2035,6 +2827,8 @@ vy_run_writer_create(struct vy_run_writer *writer, struct vy_run *run,
 	xlog_clear(&writer->data_xlog);
 	ibuf_create(&writer->row_index_buf, &cord()->slabc,
 		    4096 * sizeof(uint32_t));
+	writer->restart_interval = restart_interval;
+	ibuf_create(&writer->rows_buf, &cord()->slabc, page_size);
 	run->info.min_lsn = INT64_MAX;
 	run->info.max_lsn = -1;
 	assert(run->page_info == NULL);
@@ -2097,6 +2891,93 @@ vy_run_writer_start_page(struct vy_run_writer *writer,
 	return 0;
 }
 
+/**
+ * Append @a stmt to prefix compressed rows of a current page.
+ * The row body, which starts with the tuple, is stored before
+ * the row header, which contains the LSN, so that adjacent rows
+ * share longer prefixes. @sa vy_page_row_decode().
+ *
+ * @param writer Run writer.
+ * @param stmt Statement to write.
+ * @param page Current page info.
+ *
+ * @retval -1 Memory error.
+ * @retval  0 Success.
+ */
+static int
+vy_run_writer_compress_stmt(struct vy_run_writer *writer,
+			    const struct tuple *stmt,
+			    struct vy_page_info *page)
+{
+	struct xrow_header xrow;
+	int rc = (writer->is_primary ?
+		  vy_stmt_encode_primary(stmt, writer->cmp_def, 0, &xrow) :
+		  vy_stmt_encode_secondary(stmt, writer->cmp_def, &xrow));
+	if (rc != 0)
+		return -1;
+	struct iovec iov[XROW_IOVMAX];
+	int iovcnt = xrow_header_encode(&xrow, 0, iov, 0);
+	if (iovcnt < 0)
+		return -1;
+	uint32_t row_len = 0;
+	for (int i = 0; i < iovcnt; i++)
+		row_len += iov[i].iov_len;
+	char *row = region_alloc(&fiber()->gc, row_len);
+	if (row == NULL) {
+		diag_set(OutOfMemory, row_len, "region", "row");
+		return -1;
+	}
+	char *pos = row;
+	for (int i = 1; i < iovcnt; i++) {
+		memcpy(pos, iov[i].iov_base, iov[i].iov_len);
+		pos += iov[i].iov_len;
+	}
+	memcpy(pos, iov[0].iov_base, iov[0].iov_len);
+
+	uint32_t shared = 0;
+	if (page->row_count % writer->restart_interval == 0) {
+		/* Store the row in full at a restart point. */
+		uint32_t *offset = (uint32_t *)
+			ibuf_alloc(&writer->row_index_buf, sizeof(uint32_t));
+		if (offset == NULL) {
+			diag_set(OutOfMemory, sizeof(uint32_t),
+				 "ibuf", "row index");
+			return -1;
+		}
+		*offset = ibuf_used(&writer->rows_buf);
+	} else {
+		uint32_t max_shared = MIN(row_len, writer->prev_row_len);
+		while (shared < max_shared &&
+		       row[shared] == writer->prev_row[shared])
+			shared++;
+	}
+	uint32_t unshared = row_len - shared;
+	size_t size = mp_sizeof_uint(shared) + mp_sizeof_binl(unshared) +
+		      unshared;
+	char *data = (char *)ibuf_alloc(&writer->rows_buf, size);
+	if (data == NULL) {
+		diag_set(OutOfMemory, size, "ibuf", "page rows");
+		return -1;
+	}
+	data = mp_encode_uint(data, shared);
+	data = mp_encode_binl(data, unshared);
+	memcpy(data, row + shared, unshared);
+
+	if (row_len > writer->prev_row_size) {
+		char *prev_row = realloc(writer->prev_row, row_len);
+		if (prev_row == NULL) {
+			diag_set(OutOfMemory, row_len, "malloc", "row");
+			return -1;
+		}
+		writer->prev_row = prev_row;
+		writer->prev_row_size = row_len;
+	}
+	memcpy(writer->prev_row, row, row_len);
+	writer->prev_row_len = row_len;
+	page->row_count++;
+	return 0;
+}
+
 /**
  * Write @a stmt into a current page.
  * @param writer Run writer.
@@ -2121,16 +3002,23 @@ vy_run_writer_write_to_page(struct vy_run_writer *writer, struct tuple *stmt)
 	vy_stmt_ref_if_possible(stmt);
 	struct vy_run *run = writer->run;
 	struct vy_page_info *page = run->page_info + run->info.page_count;
-	uint32_t *offset = (uint32_t *)ibuf_alloc(&writer->row_index_buf,
-						  sizeof(uint32_t));
-	if (offset == NULL) {
-		diag_set(OutOfMemory, sizeof(uint32_t), "ibuf", "row index");
-		return -1;
+	if (writer->restart_interval > 0) {
+		if (vy_run_writer_compress_stmt(writer, stmt, page) != 0)
+			return -1;
+	} else {
+		uint32_t *offset = (uint32_t *)
+			ibuf_alloc(&writer->row_index_buf, sizeof(uint32_t));
+		if (offset == NULL) {
+			diag_set(OutOfMemory, sizeof(uint32_t),
+				 "ibuf", "row index");
+			return -1;
+		}
+		*offset = page->unpacked_size;
+		if (vy_run_dump_stmt(stmt, &writer->data_xlog, page,
+				     writer->cmp_def,
+				     writer->is_primary) != 0)
+			return -1;
 	}
-	*offset = page->unpacked_size;
-	if (vy_run_dump_stmt(stmt, &writer->data_xlog, page,
-			     writer->cmp_def, writer->iid == 0) != 0)
-		return -1;
 	int64_t lsn = vy_stmt_lsn(stmt);
 	run->info.min_lsn = MIN(run->info.min_lsn, lsn);
 	run->info.max_lsn = MAX(run->info.max_lsn, lsn);
@@ -2150,14 +3038,30 @@ vy_run_writer_end_page(struct vy_run_writer *writer)
 	struct vy_page_info *page = run->page_info + run->info.page_count;
 
 	assert(page->row_count > 0);
+	uint32_t row_index_size = writer->restart_interval == 0 ?
+		page->row_count :
+		DIV_ROUND_UP(page->row_count, writer->restart_interval);
 	assert(ibuf_used(&writer->row_index_buf) ==
-	       sizeof(uint32_t) * page->row_count);
+	       sizeof(uint32_t) * row_index_size);
 
 	struct xrow_header xrow;
+	ssize_t written;
+	if (writer->restart_interval > 0) {
+		if (vy_page_data_encode(writer->rows_buf.rpos,
+					ibuf_used(&writer->rows_buf),
+					&xrow) != 0)
+			return -1;
+		written = xlog_write_row(&writer->data_xlog, &xrow);
+		if (written < 0)
+			return -1;
+		page->unpacked_size += written;
+		ibuf_reset(&writer->rows_buf);
+	}
 	uint32_t *row_index = (uint32_t *)writer->row_index_buf.rpos;
-	if (vy_row_index_encode(row_index, page->row_count, &xrow) < 0)
+	if (vy_row_index_encode(row_index, row_index_size,
+				writer->restart_interval, &xrow) < 0)
 		return -1;
-	ssize_t written = xlog_write_row(&writer->data_xlog, &xrow);
+	written = xlog_write_row(&writer->data_xlog, &xrow);
 	if (written < 0)
 		return -1;
 	page->row_index_offset = page->unpacked_size;
@@ -2175,6 +3079,15 @@ vy_run_writer_end_page(struct vy_run_writer *writer)
 	return 0;
 }
 
+/** Return the size of the current page written so far. */
+static inline size_t
+vy_run_writer_page_size(struct vy_run_writer *writer)
+{
+	if (writer->restart_interval > 0)
+		return ibuf_used(&writer->rows_buf);
+	return obuf_size(&writer->data_xlog.obuf);
+}
+
 int
 vy_run_writer_append_stmt(struct vy_run_writer *writer, struct tuple *stmt)
 {
@@ -2188,7 +3101,7 @@ vy_run_writer_append_stmt(struct vy_run_writer *writer, struct tuple *stmt)
 		goto out;
 	if (vy_run_writer_write_to_page(writer, stmt) != 0)
 		goto out;
-	if (obuf_size(&writer->data_xlog.obuf) >= writer->page_size &&
+	if (vy_run_writer_page_size(writer) >= writer->page_size &&
 	    vy_run_writer_end_page(writer) != 0)
 		goto out;
 	rc = 0;
@@ -2213,6 +3126,8 @@ vy_run_writer_destroy(struct vy_run_writer *writer, bool reuse_fd)
 	if (writer->bloom != NULL)
 		tuple_bloom_builder_delete(writer->bloom);
 	ibuf_destroy(&writer->row_index_buf);
+	ibuf_destroy(&writer->rows_buf);
+	free(writer->prev_row);
 }
 
 int
@@ -2289,6 +3204,8 @@ vy_run_rebuild_index(struct vy_run *run, const char *dir,
 	assert(run->page_info == NULL);
 	struct region *region = &fiber()->gc;
 	size_t mem_used = region_used(region);
+	/* Covering secondary indexes store full tuples. */
+	bool is_primary = (iid == 0 || opts->is_covering);
 
 	struct xlog_cursor cursor;
 	char path[PATH_MAX];
@@ -2306,6 +3223,10 @@ vy_run_rebuild_index(struct vy_run *run, const char *dir,
 	int64_t max_lsn = 0;
 	int64_t min_lsn = INT64_MAX;
 	struct tuple *prev_tuple = NULL;
+	/* Prefix compressed rows of the current page. */
+	const char *rows = NULL, *rows_end = NULL;
+	char *row_buf = NULL;
+	uint32_t row_buf_size = 0, row_len = 0;
 
 	struct tuple_bloom_builder *bloom_builder = NULL;
 	if (opts->bloom_fpr < 1) {
@@ -2328,15 +3249,39 @@ vy_run_rebuild_index(struct vy_run *run, const char *dir,
 		uint64_t row_offset = xlog_cursor_tx_pos(&cursor);
 
 		struct xrow_header xrow;
-		while ((rc = xlog_cursor_next_row(&cursor, &xrow)) == 0) {
-			if (xrow.type == VY_RUN_ROW_INDEX) {
-				page_row_index_offset = row_offset;
-				row_offset = xlog_cursor_tx_pos(&cursor);
-				continue;
+		rows = rows_end = NULL;
+		while (true) {
+			if (rows != rows_end) {
+				/* Next row of a prefix compressed page. */
+				if (vy_page_row_decode(&rows, rows_end,
+						       &row_buf, &row_buf_size,
+						       &row_len) != 0 ||
+				    vy_page_row_xrow(row_buf, row_len,
+						     &xrow) != 0)
+					goto close_err;
+			} else {
+				rc = xlog_cursor_next_row(&cursor, &xrow);
+				if (rc != 0)
+					break;
+				if (xrow.type == VY_RUN_ROW_INDEX) {
+					page_row_index_offset = row_offset;
+					row_offset =
+						xlog_cursor_tx_pos(&cursor);
+					continue;
+				}
+				if (xrow.type == VY_RUN_PAGE_DATA) {
+					if (vy_page_data_decode(&xrow, &rows,
+								&rows_end) != 0)
+						goto close_err;
+					row_len = 0;
+					row_offset =
+						xlog_cursor_tx_pos(&cursor);
+					continue;
+				}
 			}
 			++page_row_count;
 			struct tuple *tuple = vy_stmt_decode(&xrow, cmp_def,
-							     format, iid == 0);
+							     format, is_primary);
 			if (tuple == NULL)
 				goto close_err;
 			if (bloom_builder != NULL) {
@@ -2382,6 +3327,8 @@ vy_run_rebuild_index(struct vy_run *run, const char *dir,
 		tuple_unref(prev_tuple);
 		prev_tuple = NULL;
 	}
+	free(row_buf);
+	row_buf = NULL;
 
 	if (key != NULL) {
 		run->info.max_key = vy_key_dup(key);
@@ -2418,6 +3365,7 @@ vy_run_rebuild_index(struct vy_run *run, const char *dir,
 close_err:
 	vy_run_clear(run);
 	region_truncate(region, mem_used);
+	free(row_buf);
 	if (prev_tuple != NULL)
 		tuple_unref(prev_tuple);
 	if (bloom_builder != NULL)
@@ -2450,6 +3398,15 @@ vy_run_remove_files(const char *dir, uint32_t space_id,
 	return ret;
 }
 
+/** Return the page info of the current page of a slice stream. */
+static struct vy_page_info *
+vy_slice_stream_page_info(struct vy_slice_stream *stream)
+{
+	assert(stream->page_no < stream->slice->run->info.page_count);
+	assert(stream->page_info != NULL);
+	return &stream->page_info[stream->page_no];
+}
+
 /**
  * Read a page with stream->page_no from the run and save it in stream->page.
  * Support function of slice stream.
@@ -2466,7 +3423,7 @@ vy_slice_stream_read_page(struct vy_slice_stream *stream)
 	if (zdctx == NULL)
 		return -1;
 
-	struct vy_page_info *page_info = vy_run_page_info(run, stream->page_no);
+	struct vy_page_info *page_info = vy_slice_stream_page_info(stream);
 	stream->page = vy_page_new(page_info);
 	if (stream->page == NULL)
 		return -1;
@@ -2491,6 +3448,21 @@ vy_slice_stream_search(struct vy_stmt_stream *virt_stream)
 	assert(virt_stream->iface->start == vy_slice_stream_search);
 	struct vy_slice_stream *stream = (struct vy_slice_stream *)virt_stream;
 	assert(stream->page == NULL);
+	struct vy_run *run = stream->slice->run;
+	if (stream->page_info == NULL && run->info.page_count > 0 &&
+	    !stream->is_page_index_pinned) {
+		/* Called from a worker thread, may block. */
+		stream->page_info = vy_run_read_page_index(run);
+		if (stream->page_info == NULL)
+			return -1;
+	}
+	if (!stream->has_page_bounds && run->info.page_count > 0) {
+		/* Called from a worker thread, don't modify the slice. */
+		vy_slice_find_page_bounds(stream->slice, stream->page_info,
+					  stream->cmp_def, &stream->page_no,
+					  &stream->last_page_no);
+		stream->has_page_bounds = true;
+	}
 	if (stream->slice->begin == NULL) {
 		/* Already at the beginning */
 		assert(stream->page_no == 0);
@@ -2549,7 +3521,7 @@ vy_slice_stream_next(struct vy_stmt_stream *virt_stream, struct tuple **ret)
 	*ret = NULL;
 
 	/* If the slice is ended, return EOF */
-	if (stream->page_no > stream->slice->last_page_no)
+	if (stream->page_no > stream->last_page_no)
 		return 0;
 
 	/* If current page is not already read, read it */
@@ -2565,7 +3537,7 @@ vy_slice_stream_next(struct vy_stmt_stream *virt_stream, struct tuple **ret)
 
 	/* Check that the tuple is not out of slice bounds = */
 	if (stream->slice->end != NULL &&
-	    stream->page_no >= stream->slice->last_page_no &&
+	    stream->page_no >= stream->last_page_no &&
 	    vy_tuple_compare_with_key(tuple, stream->slice->end,
 				      stream->cmp_def) >= 0)
 		return 0;
@@ -2580,8 +3552,7 @@ vy_slice_stream_next(struct vy_stmt_stream *virt_stream, struct tuple **ret)
 	stream->pos_in_page++;
 
 	/* Check whether the position is out of page */
-	struct vy_page_info *page_info = vy_run_page_info(stream->slice->run,
-							  stream->page_no);
+	struct vy_page_info *page_info = vy_slice_stream_page_info(stream);
 	if (stream->pos_in_page >= page_info->row_count) {
 		/**
 		 * Out of page. Free page, move the position to the next page
@@ -2612,6 +3583,15 @@ vy_slice_stream_close(struct vy_stmt_stream *virt_stream)
 		tuple_unref(stream->tuple);
 		stream->tuple = NULL;
 	}
+	struct vy_run *run = stream->slice->run;
+	if (stream->is_page_index_pinned) {
+		/* May be called from a worker thread. */
+		pm_atomic_fetch_sub(&run->page_index_stream_pins, 1);
+		stream->is_page_index_pinned = false;
+	} else {
+		vy_page_index_delete(stream->page_info, run->info.page_count);
+	}
+	stream->page_info = NULL;
 }
 
 static const struct vy_stmt_stream_iface vy_slice_stream_iface = {
@@ -2629,6 +3609,8 @@ vy_slice_stream_open(struct vy_slice_stream *stream, struct vy_slice *slice,
 	stream->base.iface = &vy_slice_stream_iface;
 
 	stream->page_no = slice->first_page_no;
+	stream->last_page_no = slice->last_page_no;
+	stream->has_page_bounds = slice->has_page_bounds;
 	stream->pos_in_page = 0; /* We'll find it later */
 	stream->page = NULL;
 	stream->tuple = NULL;
@@ -2637,4 +3619,13 @@ vy_slice_stream_open(struct vy_slice_stream *stream, struct vy_slice *slice,
 	stream->cmp_def = cmp_def;
 	stream->format = format;
 	stream->is_primary = is_primary;
+
+	struct vy_run *run = slice->run;
+	stream->page_info = NULL;
+	stream->is_page_index_pinned = false;
+	if (vy_run_page_index_is_loaded(run)) {
+		stream->page_info = run->page_info;
+		stream->is_page_index_pinned = true;
+		pm_atomic_fetch_add(&run->page_index_stream_pins, 1);
+	}
 }
@@ -52,6 +52,16 @@ extern "C" {
 struct vy_history;
 struct vy_run_reader;
 
+enum {
+	/**
+	 * Number of statements between restart points of a page
+	 * written with prefix compression. A statement at a
+	 * restart point is stored in full so that it can be
+	 * decoded without decoding preceding statements.
+	 */
+	VY_PAGE_RESTART_INTERVAL = 16,
+};
+
 /** Part of vinyl environment for run read/write */
 struct vy_run_env {
 	/** Write rate limit, in bytes per second. */
@@ -69,6 +79,12 @@ struct vy_run_env {
 	 * processing the next read request.
 	 */
 	int next_reader;
+	/**
+	 * Runs whose page index is in memory, but not in use,
+	 * the most recently used first. Linked by
+	 * vy_run::in_page_index_lru.
+	 */
+	struct rlist page_index_lru;
 };
 
 /**
@@ -87,6 +103,19 @@ struct vy_run_info {
 	uint32_t page_count;
 	/** Bloom filter of all tuples in run */
 	struct tuple_bloom *bloom;
+	/** Number of statements in the run. */
+	uint64_t row_count;
+	/** Size of run pages on disk. */
+	uint64_t size;
+	/** Size of run pages in memory, i.e. unpacked. */
+	uint64_t unpacked_size;
+	/** Total size of min keys of run pages. */
+	uint64_t page_key_size;
+	/**
+	 * Set if the above statistics were read from the index
+	 * file. Files written by older versions don't have them.
+	 */
+	bool has_stat;
 };
 
 /**
@@ -115,16 +144,47 @@ struct vy_run {
 	struct vy_run_env *env;
 	/** Info about the run stored in the index file. */
 	struct vy_run_info info;
-	/** Info about the run pages stored in the index file. */
+	/**
+	 * Info about the run pages stored in the index file.
+	 * For a run recovered from disk, it is loaded on demand,
+	 * see vy_run_load_page_index(), and is NULL until then.
+	 */
 	struct vy_page_info *page_info;
 	/** Run data file. */
 	int fd;
+	/**
+	 * Location of the run files, used for loading the page
+	 * index on demand. Not set for runs that are never read
+	 * from disk, e.g. in unit tests.
+	 */
+	const char *dir;
+	uint32_t space_id;
+	uint32_t iid;
 	/** Unique ID of this run. */
 	int64_t id;
 	/** Number of statements in this run. */
 	struct vy_disk_stmt_counter count;
-	/** Size of memory used for storing page index. */
+	/**
+	 * Size of memory used for storing page index.
+	 * Accounted even if the page index hasn't been
+	 * loaded yet.
+	 */
 	size_t page_index_size;
+	/**
+	 * Number of run iterators using the page index. The page
+	 * index may be unloaded only if it isn't used.
+	 */
+	int page_index_pins;
+	/**
+	 * Number of slice streams using the page index. Slice
+	 * streams are closed in worker threads, so the counter
+	 * is updated atomically.
+	 */
+	int page_index_stream_pins;
+	/** Time when the page index was last used. */
+	double page_index_last_used;
+	/** Link in vy_run_env::page_index_lru. */
+	struct rlist in_page_index_lru;
 	/** Max LSN stored on disk. */
 	int64_t dump_lsn;
 	/**
@@ -187,10 +247,13 @@ struct vy_slice {
 	};
 	/**
 	 * Indexes of the first and the last page in the run
-	 * that belong to this slice.
+	 * that belong to this slice. Valid only if
+	 * @has_page_bounds is set, see vy_slice_load_page_bounds().
 	 */
 	uint32_t first_page_no;
 	uint32_t last_page_no;
+	/** Set if @first_page_no and @last_page_no are known. */
+	bool has_page_bounds;
 	/** An estimate of the number of statements in this slice. */
 	struct vy_disk_stmt_counter count;
 };
@@ -230,6 +293,8 @@ struct vy_run_iterator {
 	bool is_primary;
 	/** The run slice to iterate. */
 	struct vy_slice *slice;
+	/** Set if the iterator pinned the run page index. */
+	bool is_page_index_pinned;
 
 	/* Search options */
 	/**
@@ -261,6 +326,11 @@ struct vy_run_iterator {
 	bool search_started;
 	/** Search is finished, you will not get more values from iterator */
 	bool search_ended;
+	/**
+	 * Set if the bloom filter showed that the run doesn't
+	 * have the key, so the run wasn't searched.
+	 */
+	bool bloom_hit;
 };
 
 /**
@@ -273,10 +343,33 @@ struct vy_page {
 	uint32_t unpacked_size;
 	/** Number of statements in the page. */
 	uint32_t row_count;
-	/** Array of row offsets. */
+	/**
+	 * Array of row offsets or, if the page is prefix
+	 * compressed, offsets of restart points in @rows.
+	 */
 	uint32_t *row_index;
 	/** Pointer to the page data. */
 	char *data;
+	/**
+	 * Number of rows between restart points if the page is
+	 * prefix compressed, 0 otherwise. The rest of the members
+	 * are only used for prefix compressed pages.
+	 */
+	uint32_t restart_interval;
+	/** Prefix compressed rows, points to @data. */
+	const char *rows;
+	/** End of prefix compressed rows. */
+	const char *rows_end;
+	/** Buffer storing the last decoded row. */
+	char *row_buf;
+	/** Size of @row_buf. */
+	uint32_t row_buf_size;
+	/** Length of the last decoded row. */
+	uint32_t row_len;
+	/** Number of the last decoded row or UINT32_MAX. */
+	uint32_t row_no;
+	/** Position of the row following the last decoded one. */
+	const char *row_next;
 };
 
 /**
@@ -309,10 +402,86 @@ vy_run_env_enable_coio(struct vy_run_env *env, int threads);
 size_t
 vy_run_bloom_size(struct vy_run *run);
 
+/**
+ * Return true if the page index of a run is in memory.
+ */
+static inline bool
+vy_run_page_index_is_loaded(struct vy_run *run)
+{
+	return run->page_info != NULL || run->info.page_count == 0;
+}
+
+/**
+ * Load the page index of a run recovered from disk if it
+ * hasn't been loaded yet. To speed up recovery, vy_run_recover()
+ * only reads the run info and page statistics from the index
+ * file, while the page index is decoded by this function when
+ * it's accessed for the first time.
+ *
+ * If reader threads are running, the index file is read by
+ * one of them and the function yields, otherwise it blocks.
+ *
+ * @retval  0 Success.
+ * @retval -1 Read error or OOM.
+ */
+int
+vy_run_load_page_index(struct vy_run *run);
+
+/**
+ * Make the page index of a run that isn't used by any run
+ * iterator subject to unloading, see vy_run_env_unload_page_indexes().
+ * Does nothing if the page index isn't loaded.
+ */
+void
+vy_run_page_index_release(struct vy_run *run);
+
+/**
+ * Unload page indexes that haven't been used for more than
+ * @timeout seconds. They will be loaded again on demand, see
+ * vy_run_load_page_index().
+ */
+void
+vy_run_env_unload_page_indexes(struct vy_run_env *env, double timeout);
+
+/** Position of run verification, see vy_run_verify(). */
+struct vy_run_verify_pos {
+	/** Set once the index file is verified. */
+	bool is_run_file;
+	/**
+	 * Offset of the next xlog transaction in the file being
+	 * verified, 0 if the file hasn't been read yet.
+	 */
+	off_t offset;
+};
+
+/**
+ * Read the next chunk of the index and data files of a run
+ * and check its checksums. The index file is read first, then
+ * the data file. The chunk starts at @pos, which must be zeroed
+ * before the first call, and ends at the first xlog transaction
+ * boundary after @chunk_size bytes. @pos is advanced past
+ * the chunk. The number of bytes read is returned in @bytes.
+ *
+ * Each call opens the file anew, so calls may be made from
+ * different threads. The caller throttles reading by pausing
+ * between calls.
+ *
+ * The function blocks so it must be called from a coio thread.
+ *
+ * @retval  1 The run is intact, the whole run is verified.
+ * @retval  0 The chunk is intact, there's more to verify.
+ * @retval -1 Corruption or read error.
+ */
+int
+vy_run_verify(const char *dir, uint32_t space_id, uint32_t iid,
+	      int64_t run_id, struct vy_run_verify_pos *pos,
+	      size_t chunk_size, size_t *bytes);
+
 static inline struct vy_page_info *
 vy_run_page_info(struct vy_run *run, uint32_t pos)
 {
 	assert(pos < run->info.page_count);
+	assert(vy_run_page_index_is_loaded(run));
 	return &run->page_info[pos];
 }
 
@@ -344,7 +513,8 @@ vy_run_unref(struct vy_run *run)
 }
 
 /**
- * Load run from disk
+ * Load run from disk. The page index is not loaded,
+ * see vy_run_load_page_index().
  * @param run - run to laod
  * @param dir - path to the vinyl directory
  * @param space_id - space id
@@ -426,12 +596,24 @@ vy_run_remove_files(const char *dir, uint32_t space_id,
 /**
  * Allocate a new run slice.
  * This function increments @run->refs.
+ * If the slice boundaries cut the run and the run page index
+ * isn't loaded, pages spanned by the slice are looked up on
+ * first access, see vy_slice_load_page_bounds().
  */
 struct vy_slice *
 vy_slice_new(int64_t id, struct vy_run *run,
 	     struct tuple *begin, struct tuple *end,
 	     const struct key_def *cmp_def);
 
+/**
+ * Look up the first and the last pages of the run spanned
+ * by a slice unless it has already been done. The run page
+ * index must be loaded.
+ */
+void
+vy_slice_load_page_bounds(struct vy_slice *slice,
+			  const struct key_def *cmp_def);
+
 /**
  * Free a run slice.
  * This function decrements @run->refs and
@@ -535,6 +717,14 @@ struct vy_slice_stream {
 	/** Current position */
 	uint32_t page_no;
 	uint32_t pos_in_page;
+	/** Index of the last page of the run spanned by the slice. */
+	uint32_t last_page_no;
+	/**
+	 * Set if @page_no was initialized with the first page
+	 * of the slice on open. Otherwise pages spanned by the
+	 * slice are looked up on start.
+	 */
+	bool has_page_bounds;
 	/** Last page read */
 	struct vy_page *page;
 	/** The last tuple returned to user */
@@ -543,6 +733,16 @@ struct vy_slice_stream {
 	/** Members needed for memory allocation and disk access */
 	/** Slice to stream */
 	struct vy_slice *slice;
+	/**
+	 * Page index of the run. If the run page index is in
+	 * memory when the stream is opened, it is pinned and
+	 * used by the stream. Otherwise the stream reads its own
+	 * copy on start so as not to block tx and frees it on
+	 * close.
+	 */
+	struct vy_page_info *page_info;
+	/** Set if the stream pinned the run page index. */
+	bool is_page_index_pinned;
 	/**
 	 * Key def for comparing with slice boundaries,
 	 * includes secondary key parts.
@@ -575,6 +775,11 @@ struct vy_run_writer {
 	uint32_t space_id;
 	/** Identifier of an index owning the run. */
 	uint32_t iid;
+	/**
+	 * Set if the run stores full tuples, i.e. it belongs to
+	 * a primary or a covering secondary index.
+	 */
+	bool is_primary;
 	/**
 	 * Key definition to extract from tuple and store as page
 	 * min key, run min/max keys, and secondary index
@@ -600,6 +805,19 @@ struct vy_run_writer {
 	struct tuple_bloom_builder *bloom;
 	/** Buffer of a current page row offsets. */
 	struct ibuf row_index_buf;
+	/**
+	 * Number of rows between restart points in a prefix
+	 * compressed page or 0 if prefix compression is off.
+	 */
+	uint32_t restart_interval;
+	/** Buffer of prefix compressed rows of a current page. */
+	struct ibuf rows_buf;
+	/** Last row written to the current page. */
+	char *prev_row;
+	/** Length of @prev_row. */
+	uint32_t prev_row_len;
+	/** Size of memory allocated for @prev_row. */
+	uint32_t prev_row_size;
 	/**
 	 * Remember a last written statement to use it as a source
 	 * of max key of a finished run.
@@ -611,8 +829,10 @@ struct vy_run_writer {
 int
 vy_run_writer_create(struct vy_run_writer *writer, struct vy_run *run,
 		const char *dirpath, uint32_t space_id, uint32_t iid,
-		const struct key_def *cmp_def, const struct key_def *key_def,
-		uint64_t page_size, double bloom_fpr);
+		bool is_primary, const struct key_def *cmp_def,
+		const struct key_def *key_def,
+		uint64_t page_size, double bloom_fpr,
+		uint32_t restart_interval);
 
 /**
  * Write a specified statement into a run.
@@ -53,6 +53,7 @@
 #include "vy_mem.h"
 #include "vy_range.h"
 #include "vy_run.h"
+#include "vy_stmt.h"
 #include "vy_write_iterator.h"
 #include "trivia/util.h"
 #include "tt_pthread.h"
@@ -96,6 +97,8 @@ struct vy_task {
 	const struct vy_task_ops *ops;
 	/** Return code of ->execute. */
 	int status;
+	/** Time it took to execute the task, in seconds. */
+	double exec_time;
 	/** If ->execute fails, the error is stored here. */
 	struct diag diag;
 	/** LSM tree this task is for. */
@@ -132,6 +135,177 @@ struct vy_task {
 	 */
 	double bloom_fpr;
 	int64_t page_size;
+	uint32_t restart_interval;
+	/** Scheduler this task was created by. */
+	struct vy_scheduler *scheduler;
+	/**
+	 * Handler of deferred DELETEs passed to the write
+	 * iterator of a primary index task.
+	 */
+	struct vy_deferred_delete_handler deferred_delete_handler;
+	/**
+	 * Deferred DELETEs generated by the write iterator that
+	 * haven't been sent to tx yet. Accessed only by the worker
+	 * thread executing the task.
+	 */
+	struct vy_deferred_delete_batch *deferred_delete_batch;
+	/**
+	 * Number of batches of deferred DELETEs sent to tx, but
+	 * not processed yet. Protected by vy_scheduler::mutex.
+	 */
+	int deferred_delete_batch_count;
+	/**
+	 * Set by tx if it failed to process a batch of deferred
+	 * DELETEs. The task must fail then, otherwise the DELETEs
+	 * would be lost with the overwriting statements flags.
+	 */
+	struct diag deferred_delete_diag;
+};
+
+/**
+ * Max size of tuple data stored in a batch of deferred DELETEs.
+ * When it is exceeded, the worker sends the batch to tx.
+ */
+enum { VY_DEFERRED_DELETE_BATCH_SIZE = 4 * 1024 * 1024 };
+
+/**
+ * Max number of batches of deferred DELETEs a task may have in
+ * flight. When it is reached, the worker waits for tx to catch
+ * up, so the memory used by a task is bounded.
+ */
+enum { VY_DEFERRED_DELETE_BATCH_MAX = 2 };
+
+/** Batch of deferred DELETEs sent by a worker to tx. */
+struct vy_deferred_delete_batch {
+	/** Task that generated the statements. */
+	struct vy_task *task;
+	/** Link in vy_scheduler::deferred_delete_queue. */
+	struct stailq_entry in_queue;
+	/** Array of statements. */
+	struct vy_deferred_delete *stmts;
+	/** Number of statements in the batch. */
+	int count;
+	/** Number of statements the array can hold. */
+	int capacity;
+	/** Size of tuple data copied to the batch, in bytes. */
+	size_t size;
+};
+
+static struct vy_deferred_delete_batch *
+vy_deferred_delete_batch_new(struct vy_task *task)
+{
+	struct vy_deferred_delete_batch *batch = calloc(1, sizeof(*batch));
+	if (batch == NULL) {
+		diag_set(OutOfMemory, sizeof(*batch), "malloc",
+			 "struct vy_deferred_delete_batch");
+		return NULL;
+	}
+	batch->task = task;
+	return batch;
+}
+
+static void
+vy_deferred_delete_batch_delete(struct vy_deferred_delete_batch *batch)
+{
+	for (int i = 0; i < batch->count; i++)
+		free((char *)batch->stmts[i].old_data);
+	free(batch->stmts);
+	free(batch);
+}
+
+/**
+ * Send deferred DELETEs accumulated by a task to tx, where they
+ * are written to secondary indexes, see vy_scheduler_f(). Wait
+ * if the task has too many batches in flight. Called from
+ * a worker thread.
+ */
+static int
+vy_task_deferred_delete_flush(struct vy_task *task)
+{
+	struct vy_deferred_delete_batch *batch = task->deferred_delete_batch;
+	if (batch == NULL)
+		return 0;
+	struct vy_scheduler *scheduler = task->scheduler;
+	tt_pthread_mutex_lock(&scheduler->mutex);
+	while (task->deferred_delete_batch_count >=
+	       VY_DEFERRED_DELETE_BATCH_MAX &&
+	       scheduler->is_worker_pool_running)
+		tt_pthread_cond_wait(&scheduler->deferred_delete_cond,
+				     &scheduler->mutex);
+	if (!scheduler->is_worker_pool_running) {
+		tt_pthread_mutex_unlock(&scheduler->mutex);
+		diag_set(FiberIsCancelled);
+		return -1;
+	}
+	stailq_add_tail_entry(&scheduler->deferred_delete_queue,
+			      batch, in_queue);
+	task->deferred_delete_batch_count++;
+	tt_pthread_mutex_unlock(&scheduler->mutex);
+	task->deferred_delete_batch = NULL;
+	ev_async_send(scheduler->scheduler_loop, &scheduler->scheduler_async);
+	return 0;
+}
+
+static int
+vy_task_deferred_delete_process(struct vy_deferred_delete_handler *handler,
+				struct tuple *old_stmt, struct tuple *new_stmt)
+{
+	struct vy_task *task = container_of(handler, struct vy_task,
+					    deferred_delete_handler);
+	struct vy_deferred_delete_batch *batch = task->deferred_delete_batch;
+	if (batch == NULL) {
+		batch = vy_deferred_delete_batch_new(task);
+		if (batch == NULL)
+			return -1;
+		task->deferred_delete_batch = batch;
+	}
+	if (batch->count == batch->capacity) {
+		int capacity = batch->capacity * 2;
+		if (capacity == 0)
+			capacity = 64;
+		size_t size = capacity * sizeof(*batch->stmts);
+		struct vy_deferred_delete *stmts = realloc(batch->stmts, size);
+		if (stmts == NULL) {
+			diag_set(OutOfMemory, size, "realloc",
+				 "struct vy_deferred_delete");
+			return -1;
+		}
+		batch->stmts = stmts;
+		batch->capacity = capacity;
+	}
+	uint32_t old_size, new_size = 0;
+	const char *old_data = tuple_data_range(old_stmt, &old_size);
+	const char *new_data = NULL;
+	if (vy_stmt_type(new_stmt) != IPROTO_DELETE)
+		new_data = tuple_data_range(new_stmt, &new_size);
+	char *buf = malloc(old_size + new_size);
+	if (buf == NULL) {
+		diag_set(OutOfMemory, old_size + new_size, "malloc",
+			 "deferred DELETE");
+		return -1;
+	}
+	struct vy_deferred_delete *stmt = &batch->stmts[batch->count++];
+	stmt->lsn = vy_stmt_lsn(new_stmt);
+	memcpy(buf, old_data, old_size);
+	stmt->old_data = buf;
+	stmt->old_data_end = buf + old_size;
+	if (new_data != NULL) {
+		memcpy(buf + old_size, new_data, new_size);
+		stmt->new_data = buf + old_size;
+		stmt->new_data_end = buf + old_size + new_size;
+	} else {
+		stmt->new_data = NULL;
+		stmt->new_data_end = NULL;
+	}
+	batch->size += old_size + new_size;
+	if (batch->size >= VY_DEFERRED_DELETE_BATCH_SIZE)
+		return vy_task_deferred_delete_flush(task);
+	return 0;
+}
+
+static const struct vy_deferred_delete_handler_iface
+vy_task_deferred_delete_iface = {
+	.process = vy_task_deferred_delete_process,
 };
 
 /**
@@ -142,9 +316,10 @@ struct vy_task {
  * does not free it from under us.
  */
 static struct vy_task *
-vy_task_new(struct mempool *pool, struct vy_lsm *lsm,
+vy_task_new(struct vy_scheduler *scheduler, struct vy_lsm *lsm,
 	    const struct vy_task_ops *ops)
 {
+	struct mempool *pool = &scheduler->task_pool;
 	struct vy_task *task = mempool_alloc(pool);
 	if (task == NULL) {
 		diag_set(OutOfMemory, sizeof(*task),
@@ -153,6 +328,7 @@ vy_task_new(struct mempool *pool, struct vy_lsm *lsm,
 	}
 	memset(task, 0, sizeof(*task));
 	task->ops = ops;
+	task->scheduler = scheduler;
 	task->lsm = lsm;
 	task->cmp_def = key_def_dup(lsm->cmp_def);
 	if (task->cmp_def == NULL) {
@@ -167,6 +343,8 @@ vy_task_new(struct mempool *pool, struct vy_lsm *lsm,
 	}
 	vy_lsm_ref(lsm);
 	diag_create(&task->diag);
+	diag_create(&task->deferred_delete_diag);
+	task->deferred_delete_handler.iface = &vy_task_deferred_delete_iface;
 	return task;
 }
 
@@ -174,6 +352,9 @@ vy_task_new(struct mempool *pool, struct vy_lsm *lsm,
 static void
 vy_task_delete(struct mempool *pool, struct vy_task *task)
 {
+	if (task->deferred_delete_batch != NULL)
+		vy_deferred_delete_batch_delete(task->deferred_delete_batch);
+	diag_destroy(&task->deferred_delete_diag);
 	key_def_delete(task->cmp_def);
 	key_def_delete(task->key_def);
 	vy_lsm_unref(task->lsm);
@@ -283,12 +464,13 @@ vy_scheduler_stop_workers(struct vy_scheduler *scheduler)
 	stailq_create(&task_queue);
 
 	assert(scheduler->is_worker_pool_running);
-	scheduler->is_worker_pool_running = false;
 
 	/* Clear the input queue and wake up worker threads. */
 	tt_pthread_mutex_lock(&scheduler->mutex);
+	scheduler->is_worker_pool_running = false;
 	stailq_concat(&task_queue, &scheduler->input_queue);
 	pthread_cond_broadcast(&scheduler->worker_cond);
+	pthread_cond_broadcast(&scheduler->deferred_delete_cond);
 	tt_pthread_mutex_unlock(&scheduler->mutex);
 
 	/* Wait for worker threads to exit. */
@@ -299,6 +481,19 @@ vy_scheduler_stop_workers(struct vy_scheduler *scheduler)
 	free(scheduler->worker_pool);
 	scheduler->worker_pool = NULL;
 
+	/*
+	 * Drop deferred DELETEs that haven't been processed.
+	 * The tasks that generated them are aborted below, so
+	 * the DELETEs will be generated again after restart.
+	 */
+	struct vy_deferred_delete_batch *batch, *next_batch;
+	stailq_foreach_entry_safe(batch, next_batch,
+				  &scheduler->deferred_delete_queue, in_queue) {
+		batch->task->deferred_delete_batch_count--;
+		vy_deferred_delete_batch_delete(batch);
+	}
+	stailq_create(&scheduler->deferred_delete_queue);
+
 	/* Abort all pending tasks. */
 	struct vy_task *task, *next;
 	stailq_concat(&task_queue, &scheduler->output_queue);
@@ -312,11 +507,13 @@ vy_scheduler_stop_workers(struct vy_scheduler *scheduler)
 void
 vy_scheduler_create(struct vy_scheduler *scheduler, int write_threads,
 		    vy_scheduler_dump_complete_f dump_complete_cb,
+		    vy_scheduler_deferred_delete_f deferred_delete_cb,
 		    struct vy_run_env *run_env, struct rlist *read_views)
 {
 	memset(scheduler, 0, sizeof(*scheduler));
 
 	scheduler->dump_complete_cb = dump_complete_cb;
+	scheduler->deferred_delete_cb = deferred_delete_cb;
 	scheduler->read_views = read_views;
 	scheduler->run_env = run_env;
 
@@ -334,8 +531,10 @@ vy_scheduler_create(struct vy_scheduler *scheduler, int write_threads,
 		       sizeof(struct vy_task));
 	stailq_create(&scheduler->input_queue);
 	stailq_create(&scheduler->output_queue);
+	stailq_create(&scheduler->deferred_delete_queue);
 
 	tt_pthread_cond_init(&scheduler->worker_cond, NULL);
+	tt_pthread_cond_init(&scheduler->deferred_delete_cond, NULL);
 	tt_pthread_mutex_init(&scheduler->mutex, NULL);
 
 	vy_dump_heap_create(&scheduler->dump_heap);
@@ -360,6 +559,7 @@ vy_scheduler_destroy(struct vy_scheduler *scheduler)
 		vy_scheduler_stop_workers(scheduler);
 
 	tt_pthread_cond_destroy(&scheduler->worker_cond);
+	tt_pthread_cond_destroy(&scheduler->deferred_delete_cond);
 	tt_pthread_mutex_destroy(&scheduler->mutex);
 
 	diag_destroy(&scheduler->diag);
@@ -392,7 +592,7 @@ vy_scheduler_remove_lsm(struct vy_scheduler *scheduler, struct vy_lsm *lsm)
 	lsm->in_compact.pos = UINT32_MAX;
 }
 
-static void
+void
 vy_scheduler_update_lsm(struct vy_scheduler *scheduler, struct vy_lsm *lsm)
 {
 	if (lsm->is_dropped) {
@@ -407,7 +607,7 @@ vy_scheduler_update_lsm(struct vy_scheduler *scheduler, struct vy_lsm *lsm)
 	vy_compact_heap_update(&scheduler->compact_heap, &lsm->in_compact);
 }
 
-static void
+void
 vy_scheduler_pin_lsm(struct vy_scheduler *scheduler, struct vy_lsm *lsm)
 {
 	assert(!lsm->is_dumping);
@@ -415,7 +615,7 @@ vy_scheduler_pin_lsm(struct vy_scheduler *scheduler, struct vy_lsm *lsm)
 		vy_scheduler_update_lsm(scheduler, lsm);
 }
 
-static void
+void
 vy_scheduler_unpin_lsm(struct vy_scheduler *scheduler, struct vy_lsm *lsm)
 {
 	assert(!lsm->is_dumping);
@@ -608,18 +808,16 @@ vy_scheduler_end_checkpoint(struct vy_scheduler *scheduler)
 	}
 }
 
-/**
- * Allocate a new run for an LSM tree and write the information
- * about it to the metadata log so that we could still find
- * and delete it in case a write error occured. This function
- * is called from dump/compaction task constructor.
- */
-static struct vy_run *
+struct vy_run *
 vy_run_prepare(struct vy_run_env *run_env, struct vy_lsm *lsm)
 {
 	struct vy_run *run = vy_run_new(run_env, vy_log_next_id());
 	if (run == NULL)
 		return NULL;
+	/* Needed to reload the page index once it's unloaded. */
+	run->dir = lsm->env->path;
+	run->space_id = lsm->space_id;
+	run->iid = lsm->index_id;
 	vy_log_tx_begin();
 	vy_log_prepare_run(lsm->id, run->id);
 	if (vy_log_tx_commit() < 0) {
@@ -629,12 +827,7 @@ vy_run_prepare(struct vy_run_env *run_env, struct vy_lsm *lsm)
 	return run;
 }
 
-/**
- * Free an incomplete run and write a record to the metadata
- * log indicating that the run is not needed any more.
- * This function is called on dump/compaction task abort.
- */
-static void
+void
 vy_run_discard(struct vy_run *run)
 {
 	int64_t run_id = run->id;
@@ -676,8 +869,10 @@ vy_task_write_run(struct vy_scheduler *scheduler, struct vy_task *task)
 	struct vy_run_writer writer;
 	if (vy_run_writer_create(&writer, task->new_run, lsm->env->path,
 				 lsm->space_id, lsm->index_id,
+				 vy_lsm_is_covering(lsm),
 				 task->cmp_def, task->key_def,
-				 task->page_size, task->bloom_fpr) != 0)
+				 task->page_size, task->bloom_fpr,
+				 task->restart_interval) != 0)
 		goto fail;
 
 	if (wi->iface->start(wi) != 0)
@@ -701,6 +896,9 @@ vy_task_write_run(struct vy_scheduler *scheduler, struct vy_task *task)
 	}
 	wi->iface->stop(wi);
 
+	/* Send the remaining deferred DELETEs to tx. */
+	if (rc == 0)
+		rc = vy_task_deferred_delete_flush(task);
 	if (rc == 0)
 		rc = vy_run_writer_commit(&writer);
 	if (rc != 0)
@@ -837,6 +1035,7 @@ vy_task_dump_complete(struct vy_scheduler *scheduler, struct vy_task *task)
 		slice = new_slices[i];
 		vy_lsm_unacct_range(lsm, range);
 		vy_range_add_slice(range, slice);
+		range->load.writes += slice->count.rows;
 		vy_lsm_acct_range(lsm, range);
 		vy_range_update_compact_priority(range, &lsm->opts);
 		if (!vy_range_is_scheduled(range))
@@ -858,6 +1057,7 @@ delete_mems:
 	}
 	lsm->dump_lsn = MAX(lsm->dump_lsn, dump_lsn);
 	lsm->stat.disk.dump.count++;
+	latency_collect(&lsm->stat.disk.dump_latency, task->exec_time);
 
 	/* The iterator has been cleaned up in a worker thread. */
 	task->wi->iface->close(task->wi);
@@ -997,8 +1197,7 @@ vy_task_dump_new(struct vy_scheduler *scheduler, struct vy_lsm *lsm,
 		return 0;
 	}
 
-	struct vy_task *task = vy_task_new(&scheduler->task_pool,
-					   lsm, &dump_ops);
+	struct vy_task *task = vy_task_new(scheduler, lsm, &dump_ops);
 	if (task == NULL)
 		goto err;
 
@@ -1009,10 +1208,17 @@ vy_task_dump_new(struct vy_scheduler *scheduler, struct vy_lsm *lsm,
 	new_run->dump_lsn = dump_lsn;
 
 	struct vy_stmt_stream *wi;
-	bool is_last_level = (lsm->run_count == 0);
+	/*
+	 * An LSM tree that is being built may still receive
+	 * statements older than those we are dumping, so we
+	 * must not discard DELETEs even if it has no runs.
+	 */
+	bool is_last_level = (lsm->run_count == 0 && !lsm->is_building);
 	wi = vy_write_iterator_new(task->cmp_def, lsm->disk_format,
-				   lsm->index_id == 0, is_last_level,
-				   scheduler->read_views);
+				   vy_lsm_is_covering(lsm), is_last_level,
+				   lsm->ttl_field, scheduler->read_views,
+				   lsm->index_id > 0 ? NULL :
+				   &task->deferred_delete_handler);
 	if (wi == NULL)
 		goto err_wi;
 	rlist_foreach_entry(mem, &lsm->sealed, in_sealed) {
@@ -1026,6 +1232,8 @@ vy_task_dump_new(struct vy_scheduler *scheduler, struct vy_lsm *lsm,
 	task->wi = wi;
 	task->bloom_fpr = lsm->opts.bloom_fpr;
 	task->page_size = lsm->opts.page_size;
+	task->restart_interval = lsm->opts.prefix_compression ?
+				 VY_PAGE_RESTART_INTERVAL : 0;
 
 	lsm->is_dumping = true;
 	vy_scheduler_update_lsm(scheduler, lsm);
@@ -1184,10 +1392,13 @@ vy_task_compact_complete(struct vy_scheduler *scheduler, struct vy_task *task)
 			break;
 	}
 	range->n_compactions++;
+	range->load.reads /= 2;
+	range->load.writes /= 2;
 	range->version++;
 	vy_lsm_acct_range(lsm, range);
 	vy_range_update_compact_priority(range, &lsm->opts);
 	lsm->stat.disk.compact.count++;
+	latency_collect(&lsm->stat.disk.compact_latency, task->exec_time);
 
 	/*
 	 * Unaccount unused runs and delete compacted slices.
@@ -1270,8 +1481,8 @@ vy_task_compact_new(struct vy_scheduler *scheduler, struct vy_lsm *lsm,
 		return 0;
 	}
 
-	struct vy_task *task = vy_task_new(&scheduler->task_pool,
-					   lsm, &compact_ops);
+	struct vy_task *task = vy_task_new(scheduler, lsm,
+					   &compact_ops);
 	if (task == NULL)
 		goto err_task;
 
@@ -1282,8 +1493,10 @@ vy_task_compact_new(struct vy_scheduler *scheduler, struct vy_lsm *lsm,
 	struct vy_stmt_stream *wi;
 	bool is_last_level = (range->compact_priority == range->slice_count);
 	wi = vy_write_iterator_new(task->cmp_def, lsm->disk_format,
-				   lsm->index_id == 0, is_last_level,
-				   scheduler->read_views);
+				   vy_lsm_is_covering(lsm), is_last_level,
+				   lsm->ttl_field, scheduler->read_views,
+				   lsm->index_id > 0 ? NULL :
+				   &task->deferred_delete_handler);
 	if (wi == NULL)
 		goto err_wi;
 
@@ -1310,6 +1523,8 @@ vy_task_compact_new(struct vy_scheduler *scheduler, struct vy_lsm *lsm,
 	task->wi = wi;
 	task->bloom_fpr = lsm->opts.bloom_fpr;
 	task->page_size = lsm->opts.page_size;
+	task->restart_interval = lsm->opts.prefix_compression ?
+				 VY_PAGE_RESTART_INTERVAL : 0;
 
 	/*
 	 * Remove the range we are going to compact from the heap
@@ -1485,6 +1700,10 @@ vy_scheduler_complete_task(struct vy_scheduler *scheduler,
 		assert(!diag_is_empty(diag));
 		goto fail; /* ->execute fialed */
 	}
+	if (!diag_is_empty(&task->deferred_delete_diag)) {
+		diag_move(&task->deferred_delete_diag, diag);
+		goto fail;
+	}
 	ERROR_INJECT(ERRINJ_VY_TASK_COMPLETE, {
 			diag_set(ClientError, ER_INJECTION,
 			       "vinyl task completion");
@@ -1504,6 +1723,33 @@ fail:
 	return -1;
 }
 
+/**
+ * Write deferred DELETEs sent by workers to secondary indexes.
+ * If a batch fails, the task that generated it fails too.
+ */
+static void
+vy_scheduler_process_deferred_deletes(struct vy_scheduler *scheduler,
+				      struct stailq *queue)
+{
+	struct vy_deferred_delete_batch *batch, *next;
+	stailq_foreach_entry_safe(batch, next, queue, in_queue) {
+		struct vy_task *task = batch->task;
+		if (diag_is_empty(&task->deferred_delete_diag) &&
+		    !task->lsm->is_dropped &&
+		    scheduler->deferred_delete_cb != NULL &&
+		    scheduler->deferred_delete_cb(scheduler, task->lsm,
+						  batch->stmts,
+						  batch->count) != 0)
+			diag_move(diag_get(), &task->deferred_delete_diag);
+		vy_deferred_delete_batch_delete(batch);
+		/* Let the worker proceed. */
+		tt_pthread_mutex_lock(&scheduler->mutex);
+		task->deferred_delete_batch_count--;
+		tt_pthread_cond_broadcast(&scheduler->deferred_delete_cond);
+		tt_pthread_mutex_unlock(&scheduler->mutex);
+	}
+}
+
 static int
 vy_scheduler_f(va_list va)
 {
@@ -1525,16 +1771,36 @@ vy_scheduler_f(va_list va)
 
 	while (scheduler->scheduler_fiber != NULL) {
 		struct stailq output_queue;
+		struct stailq deferred_delete_queue;
 		struct vy_task *task, *next;
 		int tasks_failed = 0, tasks_done = 0;
 		bool was_empty;
 
-		/* Get the list of processed tasks. */
+		/*
+		 * Get the list of processed tasks along with deferred
+		 * DELETEs. A worker sends all DELETEs generated by
+		 * a task before returning the task so they are written
+		 * before the task is completed.
+		 */
 		stailq_create(&output_queue);
+		stailq_create(&deferred_delete_queue);
 		tt_pthread_mutex_lock(&scheduler->mutex);
 		stailq_concat(&output_queue, &scheduler->output_queue);
+		stailq_concat(&deferred_delete_queue,
+			      &scheduler->deferred_delete_queue);
 		tt_pthread_mutex_unlock(&scheduler->mutex);
 
+		if (!stailq_empty(&deferred_delete_queue)) {
+			vy_scheduler_process_deferred_deletes(scheduler,
+						&deferred_delete_queue);
+			/*
+			 * Writing DELETEs yields, so recheck the queues
+			 * in order not to lose a wakeup, see below.
+			 */
+			if (stailq_empty(&output_queue))
+				continue;
+		}
+
 		/* Complete and delete all processed tasks. */
 		stailq_foreach_entry_safe(task, next, &output_queue, link) {
 			if (vy_scheduler_complete_task(scheduler, task) != 0)
@@ -1642,7 +1908,9 @@ vy_worker_f(void *arg)
 		assert(task != NULL);
 
 		/* Execute task */
+		double start_time = ev_monotonic_time();
 		task->status = task->ops->execute(scheduler, task);
+		task->exec_time = ev_monotonic_time() - start_time;
 		if (task->status != 0) {
 			struct diag *diag = diag_get();
 			assert(!diag_is_empty(diag));
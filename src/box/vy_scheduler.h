@@ -51,6 +51,7 @@ extern "C" {
 struct cord;
 struct fiber;
 struct vy_lsm;
+struct vy_run;
 struct vy_run_env;
 struct vy_scheduler;
 
@@ -58,6 +59,33 @@ typedef void
 (*vy_scheduler_dump_complete_f)(struct vy_scheduler *scheduler,
 				int64_t dump_generation, double dump_duration);
 
+/**
+ * DELETE statement that must be inserted into secondary
+ * indexes of a space, generated on primary index dump or
+ * compaction for a tuple overwritten by a statement marked
+ * with VY_STMT_DEFERRED_DELETE. Tuple data is copied, because
+ * statements read by a worker thread can't be passed to tx.
+ */
+struct vy_deferred_delete {
+	/** LSN of the overwriting statement. */
+	int64_t lsn;
+	/** MessagePack data of the overwritten tuple. */
+	const char *old_data;
+	const char *old_data_end;
+	/**
+	 * MessagePack data of the tuple that overwrote the old
+	 * one or NULL if the old tuple was deleted.
+	 */
+	const char *new_data;
+	const char *new_data_end;
+};
+
+typedef int
+(*vy_scheduler_deferred_delete_f)(struct vy_scheduler *scheduler,
+				  struct vy_lsm *pk,
+				  const struct vy_deferred_delete *stmts,
+				  int count);
+
 struct vy_scheduler {
 	/** Scheduler fiber. */
 	struct fiber *scheduler_fiber;
@@ -84,15 +112,26 @@ struct vy_scheduler {
 	struct stailq input_queue;
 	/** Queue of processed tasks, linked by vy_task::link. */
 	struct stailq output_queue;
+	/**
+	 * Queue of batches of deferred DELETEs sent by workers,
+	 * linked by vy_deferred_delete_batch::in_queue.
+	 */
+	struct stailq deferred_delete_queue;
 	/**
 	 * Signaled to wake up a worker when there is
 	 * a pending task in the input queue. Also used
 	 * to stop worker threads on shutdown.
 	 */
 	pthread_cond_t worker_cond;
+	/**
+	 * Signaled when a batch of deferred DELETEs has been
+	 * processed to wake up a worker waiting for tx to catch
+	 * up. Also used to stop worker threads on shutdown.
+	 */
+	pthread_cond_t deferred_delete_cond;
 	/**
 	 * Mutex protecting input and output queues and
-	 * the condition variable used to wake up worker
+	 * the condition variables used to wake up worker
 	 * threads.
 	 */
 	pthread_mutex_t mutex;
@@ -163,6 +202,13 @@ struct vy_scheduler {
 	 * by the dump.
 	 */
 	vy_scheduler_dump_complete_f dump_complete_cb;
+	/**
+	 * Function called by the scheduler for each batch of
+	 * deferred DELETE statements generated by a primary index
+	 * dump or compaction task. It is supposed to write them
+	 * to secondary indexes. If it fails, the task fails too.
+	 */
+	vy_scheduler_deferred_delete_f deferred_delete_cb;
 	/** List of read views, see tx_manager::read_views. */
 	struct rlist *read_views;
 	/** Context needed for writing runs. */
@@ -175,6 +221,7 @@ struct vy_scheduler {
 void
 vy_scheduler_create(struct vy_scheduler *scheduler, int write_threads,
 		    vy_scheduler_dump_complete_f dump_complete_cb,
+		    vy_scheduler_deferred_delete_f deferred_delete_cb,
 		    struct vy_run_env *run_env, struct rlist *read_views);
 
 /**
@@ -195,6 +242,27 @@ vy_scheduler_add_lsm(struct vy_scheduler *, struct vy_lsm *);
 void
 vy_scheduler_remove_lsm(struct vy_scheduler *, struct vy_lsm *);
 
+/**
+ * Update the position of an LSM tree in scheduler dump/compaction
+ * queues. Needs to be called whenever the LSM tree state changes
+ * in a way that may affect its dump or compaction priority.
+ */
+void
+vy_scheduler_update_lsm(struct vy_scheduler *, struct vy_lsm *);
+
+/**
+ * Pin an LSM tree so that it isn't scheduled for dump until
+ * it is unpinned. The LSM tree must not be being dumped.
+ */
+void
+vy_scheduler_pin_lsm(struct vy_scheduler *, struct vy_lsm *);
+
+/**
+ * Unpin an LSM tree pinned with vy_scheduler_pin_lsm().
+ */
+void
+vy_scheduler_unpin_lsm(struct vy_scheduler *, struct vy_lsm *);
+
 /**
  * Trigger dump of all currently existing in-memory trees.
  */
@@ -215,6 +283,25 @@ void
 vy_scheduler_force_compaction(struct vy_scheduler *scheduler,
 			      struct vy_lsm *lsm);
 
+/**
+ * Allocate a new run for an LSM tree and write the information
+ * about it to the metadata log so that we could still find
+ * and delete it in case a write error occured. This function
+ * is called from dump/compaction task constructor and when
+ * a new index is built.
+ */
+struct vy_run *
+vy_run_prepare(struct vy_run_env *run_env, struct vy_lsm *lsm);
+
+/**
+ * Free an incomplete run and write a record to the metadata
+ * log indicating that the run is not needed any more.
+ * This function is called on dump/compaction task abort and
+ * index build failure.
+ */
+void
+vy_run_discard(struct vy_run *run);
+
 /**
  * Schedule a checkpoint. Please call vy_scheduler_wait_checkpoint()
  * after that.
@@ -33,6 +33,7 @@
 
 #include <stdint.h>
 
+#include "histogram.h"
 #include "latency.h"
 #include "tuple.h"
 
@@ -101,6 +102,22 @@ struct vy_txw_iterator_stat {
 	struct vy_stmt_counter get;
 };
 
+/**
+ * Oldest source that had to be accessed to serve a read.
+ * Used for breaking read latency down by source. Sources
+ * are ordered by age so that a read that accessed several
+ * sources can be accounted to the MAX of them.
+ */
+enum vy_read_source {
+	/** The result was found in the cache. */
+	VY_READ_SOURCE_CACHE,
+	/** The result was found in the TX write set or in memory. */
+	VY_READ_SOURCE_MEMORY,
+	/** Runs had to be read. */
+	VY_READ_SOURCE_DISK,
+	vy_read_source_MAX,
+};
+
 /** Dump/compaction statistics. */
 struct vy_compact_stat {
 	int32_t count;
@@ -120,6 +137,16 @@ struct vy_lsm_stat {
 	struct vy_stmt_counter put;
 	/** Read latency. */
 	struct latency latency;
+	/** Read latency, by source, see enum vy_read_source. */
+	struct latency read_latency[vy_read_source_MAX];
+	/**
+	 * Distribution of the number of runs searched per
+	 * lookup, i.e. read amplification. Runs filtered out
+	 * by bloom filters are not counted.
+	 */
+	struct histogram *read_run_hist;
+	/** Total number of runs accounted in read_run_hist. */
+	int64_t read_run_count;
 	/** Upsert statistics. */
 	struct {
 		/** How many upsert chains have been squashed. */
@@ -127,6 +154,12 @@ struct vy_lsm_stat {
 		/** How many upserts have been applied on read. */
 		int64_t applied;
 	} upsert;
+	/**
+	 * Distribution of the length of UPSERT chains folded
+	 * on read. Reads that didn't apply any UPSERTs are not
+	 * accounted.
+	 */
+	struct histogram *upsert_chain_hist;
 	/** Memory related statistics. */
 	struct {
 		/** Number of statements stored in memory. */
@@ -144,6 +177,10 @@ struct vy_lsm_stat {
 		struct vy_compact_stat dump;
 		/** Compaction statistics. */
 		struct vy_compact_stat compact;
+		/** Time spent on dumping this LSM tree. */
+		struct latency dump_latency;
+		/** Time spent on compacting this LSM tree. */
+		struct latency compact_latency;
 	} disk;
 	/** TX write set statistics. */
 	struct {
@@ -189,13 +226,91 @@ struct vy_tx_stat {
 static inline int
 vy_lsm_stat_create(struct vy_lsm_stat *stat)
 {
-	return latency_create(&stat->latency);
+	static int64_t read_run_buckets[] = {
+		0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 15, 20, 25, 50, 100,
+	};
+	static int64_t upsert_chain_buckets[] = {
+		1, 2, 3, 4, 5, 10, 20, 50, 100, 128, 200, 500, 1000,
+	};
+	int i = 0;
+	if (latency_create(&stat->latency) != 0)
+		goto fail;
+	for (i = 0; i < vy_read_source_MAX; i++) {
+		if (latency_create(&stat->read_latency[i]) != 0)
+			goto fail_read_latency;
+	}
+	if (latency_create(&stat->disk.dump_latency) != 0)
+		goto fail_read_latency;
+	if (latency_create(&stat->disk.compact_latency) != 0)
+		goto fail_dump_latency;
+	stat->read_run_hist = histogram_new(read_run_buckets,
+					    lengthof(read_run_buckets));
+	if (stat->read_run_hist == NULL)
+		goto fail_compact_latency;
+	stat->upsert_chain_hist = histogram_new(upsert_chain_buckets,
+						lengthof(upsert_chain_buckets));
+	if (stat->upsert_chain_hist == NULL)
+		goto fail_read_run_hist;
+	return 0;
+
+fail_read_run_hist:
+	histogram_delete(stat->read_run_hist);
+fail_compact_latency:
+	latency_destroy(&stat->disk.compact_latency);
+fail_dump_latency:
+	latency_destroy(&stat->disk.dump_latency);
+fail_read_latency:
+	while (--i >= 0)
+		latency_destroy(&stat->read_latency[i]);
+	latency_destroy(&stat->latency);
+fail:
+	return -1;
 }
 
 static inline void
 vy_lsm_stat_destroy(struct vy_lsm_stat *stat)
 {
 	latency_destroy(&stat->latency);
+	for (int i = 0; i < vy_read_source_MAX; i++)
+		latency_destroy(&stat->read_latency[i]);
+	latency_destroy(&stat->disk.dump_latency);
+	latency_destroy(&stat->disk.compact_latency);
+	histogram_delete(stat->read_run_hist);
+	histogram_delete(stat->upsert_chain_hist);
+}
+
+/**
+ * Account a read (a point lookup or a read iterator step)
+ * in LSM tree statistics.
+ *
+ * @param stat       LSM tree statistics.
+ * @param source     Oldest source accessed to serve the read.
+ * @param run_count  Number of runs searched.
+ * @param latency    Time it took to serve the read, in seconds.
+ */
+static inline void
+vy_lsm_stat_acct_read(struct vy_lsm_stat *stat, enum vy_read_source source,
+		      int run_count, double latency)
+{
+	latency_collect(&stat->latency, latency);
+	latency_collect(&stat->read_latency[source], latency);
+	histogram_collect(stat->read_run_hist, run_count);
+	stat->read_run_count += run_count;
+}
+
+/**
+ * Account UPSERTs folded while serving a read in LSM tree
+ * statistics.
+ *
+ * @param stat             LSM tree statistics.
+ * @param upserts_applied  Length of the folded UPSERT chain.
+ */
+static inline void
+vy_lsm_stat_acct_upsert_chain(struct vy_lsm_stat *stat, int upserts_applied)
+{
+	stat->upsert.applied += upserts_applied;
+	if (upserts_applied > 0)
+		histogram_collect(stat->upsert_chain_hist, upserts_applied);
 }
 
 static inline void
@@ -112,6 +112,7 @@ vy_stmt_alloc(struct tuple_format *format, uint32_t bsize)
 	tuple->data_offset = sizeof(struct vy_stmt) + meta_size;;
 	vy_stmt_set_lsn(tuple, 0);
 	vy_stmt_set_type(tuple, 0);
+	vy_stmt_set_flags(tuple, 0);
 	return tuple;
 }
 
@@ -485,6 +486,88 @@ vy_stmt_extract_key_raw(const char *data, const char *data_end,
 	return key;
 }
 
+/** Max size of statement metadata encoded by vy_stmt_meta_encode(). */
+enum { VY_STMT_META_SIZE_MAX = 16 };
+
+/**
+ * Encode persistent flags of a statement in a MessagePack map
+ * suitable for storing in the IPROTO_TUPLE_META request field.
+ * @param stmt Statement to encode flags of.
+ * @param buf  Buffer to encode the map to, must be at least
+ *             VY_STMT_META_SIZE_MAX bytes long.
+ * @retval End of the encoded data or @buf if there is no
+ *         metadata to store.
+ */
+static char *
+vy_stmt_meta_encode(const struct tuple *stmt, char *buf)
+{
+	uint8_t flags = vy_stmt_flags(stmt) & VY_STMT_PERSISTENT_FLAGS;
+	if (flags == 0)
+		return buf;
+	char *pos = mp_encode_map(buf, 1);
+	pos = mp_encode_uint(pos, IPROTO_TUPLE_META_FLAGS);
+	pos = mp_encode_uint(pos, flags);
+	return pos;
+}
+
+/**
+ * Decode statement metadata encoded by vy_stmt_meta_encode()
+ * and apply it to the given statement.
+ */
+static int
+vy_stmt_meta_decode(struct tuple *stmt, const char *data)
+{
+	if (mp_typeof(*data) != MP_MAP)
+		goto error;
+	uint32_t size = mp_decode_map(&data);
+	for (uint32_t i = 0; i < size; i++) {
+		if (mp_typeof(*data) != MP_UINT)
+			goto error;
+		uint64_t key = mp_decode_uint(&data);
+		switch (key) {
+		case IPROTO_TUPLE_META_FLAGS:
+			if (mp_typeof(*data) != MP_UINT)
+				goto error;
+			vy_stmt_set_flags(stmt, mp_decode_uint(&data) &
+					  VY_STMT_PERSISTENT_FLAGS);
+			break;
+		default:
+			/* Unknown key, skip for forward compatibility. */
+			mp_next(&data);
+			break;
+		}
+	}
+	return 0;
+error:
+	diag_set(ClientError, ER_INVALID_RUN_FILE,
+		 "Can't decode statement meta");
+	return -1;
+}
+
+/**
+ * Find statement metadata in the body of a row read from a run
+ * file. IPROTO_TUPLE_META isn't a valid request key, so it is
+ * skipped by xrow_decode_dml() and has to be looked up here.
+ * The body must have been checked by xrow_decode_dml().
+ * @retval Pointer to the encoded metadata or NULL if none.
+ */
+static const char *
+vy_stmt_meta_find(const struct xrow_header *xrow)
+{
+	if (xrow->bodycnt == 0)
+		return NULL;
+	const char *data = (const char *)xrow->body[0].iov_base;
+	uint32_t size = mp_decode_map(&data);
+	for (uint32_t i = 0; i < size; i++) {
+		if (mp_typeof(*data) != MP_UINT)
+			mp_next(&data);
+		else if (mp_decode_uint(&data) == IPROTO_TUPLE_META)
+			return data;
+		mp_next(&data);
+	}
+	return NULL;
+}
+
 int
 vy_stmt_encode_primary(const struct tuple *value,
 		       const struct key_def *key_def, uint32_t space_id,
@@ -525,6 +608,12 @@ vy_stmt_encode_primary(const struct tuple *value,
 	default:
 		unreachable();
 	}
+	char meta[VY_STMT_META_SIZE_MAX];
+	char *meta_end = vy_stmt_meta_encode(value, meta);
+	if (meta_end != meta) {
+		request.tuple_meta = meta;
+		request.tuple_meta_end = meta_end;
+	}
 	xrow->bodycnt = xrow_encode_dml(&request, xrow->body);
 	if (xrow->bodycnt < 0)
 		return -1;
@@ -556,6 +645,12 @@ vy_stmt_encode_secondary(const struct tuple *value,
 		request.key = extracted;
 		request.key_end = extracted + size;
 	}
+	char meta[VY_STMT_META_SIZE_MAX];
+	char *meta_end = vy_stmt_meta_encode(value, meta);
+	if (meta_end != meta) {
+		request.tuple_meta = meta;
+		request.tuple_meta_end = meta_end;
+	}
 	xrow->bodycnt = xrow_encode_dml(&request, xrow->body);
 	if (xrow->bodycnt < 0)
 		return -1;
@@ -613,6 +708,11 @@ vy_stmt_decode(struct xrow_header *xrow, const struct key_def *key_def,
 	if (stmt == NULL)
 		return NULL; /* OOM */
 
+	const char *meta = vy_stmt_meta_find(xrow);
+	if (meta != NULL && vy_stmt_meta_decode(stmt, meta) != 0) {
+		tuple_unref(stmt);
+		return NULL;
+	}
 	vy_stmt_set_lsn(stmt, xrow->lsn);
 	return stmt;
 }
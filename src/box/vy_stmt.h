@@ -61,6 +61,31 @@ static_assert(VY_UPSERT_THRESHOLD <= UINT8_MAX, "n_upserts max value");
 static_assert(VY_UPSERT_INF == VY_UPSERT_THRESHOLD + 1,
 	      "inf must be threshold + 1");
 
+/** Vinyl statement flags. */
+enum {
+	/**
+	 * A REPLACE or DELETE statement inserted into the primary
+	 * index without looking up the overwritten tuple. DELETE
+	 * statements for secondary indexes are generated for it
+	 * when the primary index is dumped or compacted, see
+	 * vy_deferred_delete_handler.
+	 */
+	VY_STMT_DEFERRED_DELETE		= 1 << 0,
+	/**
+	 * A deferred DELETE written to a secondary index. It has
+	 * the LSN of the statement that overwrote the deleted
+	 * tuple and may be older than statements stored in newer
+	 * runs, so readers must ignore it. It is only needed to
+	 * purge the stale entry on compaction.
+	 */
+	VY_STMT_SKIP_READ		= 1 << 1,
+	/**
+	 * Mask of flags that must be persisted in run files.
+	 */
+	VY_STMT_PERSISTENT_FLAGS	= VY_STMT_DEFERRED_DELETE |
+					  VY_STMT_SKIP_READ,
+};
+
 /** Vinyl statement vtable. */
 extern struct tuple_format_vtab vy_tuple_format_vtab;
 
@@ -103,6 +128,8 @@ struct vy_stmt {
 	struct tuple base;
 	int64_t lsn;
 	uint8_t  type; /* IPROTO_SELECT/REPLACE/UPSERT/DELETE */
+	/** Statement flags, see VY_STMT_DEFERRED_DELETE. */
+	uint8_t flags;
 	/**
 	 * Offsets array concatenated with MessagePack fields
 	 * array.
@@ -138,6 +165,20 @@ vy_stmt_set_type(struct tuple *stmt, enum iproto_type type)
 	((struct vy_stmt *) stmt)->type = type;
 }
 
+/** Get flags of the vinyl statement. */
+static inline uint8_t
+vy_stmt_flags(const struct tuple *stmt)
+{
+	return ((const struct vy_stmt *) stmt)->flags;
+}
+
+/** Set flags of the vinyl statement. */
+static inline void
+vy_stmt_set_flags(struct tuple *stmt, uint8_t flags)
+{
+	((struct vy_stmt *) stmt)->flags = flags;
+}
+
 /**
  * Get upserts count of the vinyl statement.
  * Only for UPSERT statements allocated on lsregion.
@@ -672,6 +713,40 @@ vy_tuple_key_contains_null(const struct tuple *tuple, const struct key_def *def)
 	return false;
 }
 
+/**
+ * Check if a statement stores an expired tuple.
+ * @param stmt Statement to check.
+ * @param ttl_field 1-based number of the field storing the tuple
+ * expiration time or 0 if tuples never expire, see
+ * space_opts::ttl_field.
+ * @param now Current time, in seconds since the Epoch.
+ * @retval Is the statement a REPLACE or INSERT with expiration
+ * time less than or equal to @a now?
+ */
+static inline bool
+vy_stmt_is_expired(const struct tuple *stmt, uint32_t ttl_field, double now)
+{
+	if (ttl_field == 0 || (vy_stmt_type(stmt) != IPROTO_REPLACE &&
+			       vy_stmt_type(stmt) != IPROTO_INSERT))
+		return false;
+	const char *field = tuple_field(stmt, ttl_field - 1);
+	if (field == NULL)
+		return false;
+	switch (mp_typeof(*field)) {
+	case MP_UINT:
+		return mp_decode_uint(&field) <= now;
+	case MP_INT:
+		return mp_decode_int(&field) <= now;
+	case MP_FLOAT:
+		return mp_decode_float(&field) <= now;
+	case MP_DOUBLE:
+		return mp_decode_double(&field) <= now;
+	default:
+		/* Tuples without expiration time never expire. */
+		return false;
+	}
+}
+
 #if defined(__cplusplus)
 } /* extern "C" */
 #endif /* defined(__cplusplus) */
@@ -371,6 +371,25 @@ vy_tx_abort_readers(struct vy_tx *tx, struct txv *v)
 	}
 }
 
+void
+tx_manager_abort_readers(struct tx_manager *xm, struct vy_lsm *lsm,
+			 int64_t lsn)
+{
+	struct vy_read_view *rv;
+	rlist_foreach_entry(rv, &xm->read_views, in_read_views) {
+		if (rv->vlsn >= lsn)
+			rv->is_aborted = true;
+	}
+	struct vy_read_interval *interval;
+	for (interval = vy_lsm_read_set_first(&lsm->read_set);
+	     interval != NULL;
+	     interval = vy_lsm_read_set_next(&lsm->read_set, interval)) {
+		struct vy_tx *tx = interval->tx;
+		if (tx->state == VINYL_TX_READY && !vy_tx_is_in_read_view(tx))
+			tx->state = VINYL_TX_ABORT;
+	}
+}
+
 struct vy_tx *
 vy_tx_begin(struct tx_manager *xm)
 {
@@ -473,13 +492,19 @@ vy_tx_prepare(struct vy_tx *tx)
 {
 	struct tx_manager *xm = tx->xm;
 
+	if (tx->state == VINYL_TX_ABORT || tx->read_view->is_aborted) {
+		xm->stat.conflict++;
+		diag_set(ClientError, ER_TRANSACTION_CONFLICT);
+		return -1;
+	}
+
 	if (vy_tx_is_ro(tx)) {
 		assert(tx->state == VINYL_TX_READY);
 		tx->state = VINYL_TX_COMMIT;
 		return 0;
 	}
 
-	if (vy_tx_is_in_read_view(tx) || tx->state == VINYL_TX_ABORT) {
+	if (vy_tx_is_in_read_view(tx)) {
 		xm->stat.conflict++;
 		diag_set(ClientError, ER_TRANSACTION_CONFLICT);
 		return -1;
@@ -663,7 +688,8 @@ vy_tx_rollback(struct vy_tx *tx)
 void
 vy_tx_rollback_to_savepoint(struct vy_tx *tx, void *svp)
 {
-	assert(tx->state == VINYL_TX_READY);
+	assert(tx->state == VINYL_TX_READY ||
+	       tx->state == VINYL_TX_ABORT);
 	struct stailq_entry *last = svp;
 	struct stailq tail;
 	stailq_cut_tail(&tx->log, last, &tail);
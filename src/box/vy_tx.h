@@ -262,6 +262,18 @@ tx_manager_new(void);
 void
 tx_manager_delete(struct tx_manager *xm);
 
+/**
+ * Abort all transactions that could see statements with LSN
+ * @lsn inserted into LSM tree @lsm without going through the
+ * transaction manager:
+ * - read views with vlsn >= @lsn are aborted;
+ * - transactions that have read @lsm and are not in a read
+ *   view are sent to conflict.
+ */
+void
+tx_manager_abort_readers(struct tx_manager *xm, struct vy_lsm *lsm,
+			 int64_t lsn);
+
 /** Initialize a tx object. */
 void
 vy_tx_create(struct tx_manager *xm, struct vy_tx *tx);
@@ -299,7 +311,8 @@ vy_tx_rollback(struct vy_tx *tx);
 static inline void *
 vy_tx_savepoint(struct vy_tx *tx)
 {
-	assert(tx->state == VINYL_TX_READY);
+	assert(tx->state == VINYL_TX_READY ||
+	       tx->state == VINYL_TX_ABORT);
 	return stailq_last(&tx->log);
 }
 
@@ -34,6 +34,7 @@
 #include "vy_upsert.h"
 #include "column_mask.h"
 #include "fiber.h"
+#include "clock.h"
 
 #define HEAP_FORWARD_DECLARATION
 #include "salad/heap.h"
@@ -177,6 +178,24 @@ struct vy_write_iterator {
 	 * key and its tuple format is different.
 	 */
 	bool is_primary;
+	/**
+	 * Number of the field storing the tuple expiration time
+	 * or 0 if tuples never expire, see space_opts::ttl_field.
+	 */
+	uint32_t ttl_field;
+	/** Time expiration is checked against, if ttl_field is set. */
+	double now;
+	/** Deferred DELETE handler, may be NULL. */
+	struct vy_deferred_delete_handler *deferred_delete_handler;
+	/**
+	 * Last scanned statement of the current key that was
+	 * marked with VY_STMT_DEFERRED_DELETE, waiting for the
+	 * statement it overwrote. If it is still set when the
+	 * key history has been built, the overwritten statement
+	 * is stored in an older level so the statement keeps the
+	 * flag in the output. Other statements have it cleared.
+	 */
+	struct tuple *deferred_delete_stmt;
 
 	/** Length of the @read_views. */
 	int rv_count;
@@ -329,7 +348,8 @@ struct vy_stmt_stream *
 vy_write_iterator_new(const struct key_def *cmp_def,
 		      struct tuple_format *format,
 		      bool is_primary, bool is_last_level,
-		      struct rlist *read_views)
+		      uint32_t ttl_field, struct rlist *read_views,
+		      struct vy_deferred_delete_handler *handler)
 {
 	/*
 	 * One is reserved for INT64_MAX - maximal read view.
@@ -364,6 +384,10 @@ vy_write_iterator_new(const struct key_def *cmp_def,
 	tuple_format_ref(stream->format);
 	stream->is_primary = is_primary;
 	stream->is_last_level = is_last_level;
+	stream->ttl_field = ttl_field;
+	if (ttl_field != 0)
+		stream->now = clock_realtime();
+	stream->deferred_delete_handler = handler;
 	return &stream->base;
 }
 
@@ -395,6 +419,10 @@ vy_write_iterator_stop(struct vy_stmt_stream *vstream)
 	struct vy_write_iterator *stream = (struct vy_write_iterator *)vstream;
 	for (int i = 0; i < stream->rv_count; ++i)
 		vy_read_view_stmt_destroy(&stream->read_views[i]);
+	if (stream->deferred_delete_stmt != NULL) {
+		vy_stmt_unref_if_possible(stream->deferred_delete_stmt);
+		stream->deferred_delete_stmt = NULL;
+	}
 	struct vy_write_src *src, *tmp;
 	rlist_foreach_entry_safe(src, &stream->src_list, in_src_list, tmp)
 		vy_write_iterator_delete_src(stream, src);
@@ -547,6 +575,47 @@ vy_write_iterator_pop_read_view_stmt(struct vy_write_iterator *stream)
 	return rv->tuple;
 }
 
+/**
+ * Generate a deferred DELETE for a statement overwritten by
+ * a REPLACE or DELETE inserted into the primary index without
+ * looking up the old tuple (see VY_STMT_DEFERRED_DELETE).
+ * Statements of the same key are passed to this function one
+ * by one, from the newest to the oldest.
+ *
+ * @param stream Write iterator.
+ * @param stmt   Current statement.
+ *
+ * @retval  0 Success.
+ * @retval -1 Error.
+ */
+static NODISCARD int
+vy_write_iterator_deferred_delete(struct vy_write_iterator *stream,
+				  struct tuple *stmt)
+{
+	int rc = 0;
+	struct vy_deferred_delete_handler *handler =
+					stream->deferred_delete_handler;
+	/*
+	 * UPSERTs and DELETEs don't have a tuple to delete from
+	 * secondary indexes so we only need to handle REPLACEs
+	 * and INSERTs. Entries left in secondary indexes for
+	 * other statement types are filtered out on read.
+	 */
+	if (stream->deferred_delete_stmt != NULL) {
+		if (vy_stmt_type(stmt) == IPROTO_REPLACE ||
+		    vy_stmt_type(stmt) == IPROTO_INSERT)
+			rc = handler->iface->process(handler, stmt,
+						stream->deferred_delete_stmt);
+		vy_stmt_unref_if_possible(stream->deferred_delete_stmt);
+		stream->deferred_delete_stmt = NULL;
+	}
+	if (vy_stmt_flags(stmt) & VY_STMT_DEFERRED_DELETE) {
+		vy_stmt_ref_if_possible(stmt);
+		stream->deferred_delete_stmt = stmt;
+	}
+	return rc;
+}
+
 /**
  * Build the history of the current key.
  * Apply optimizations 1, 2 and 3 (@sa vy_write_iterator.h).
@@ -609,6 +678,13 @@ vy_write_iterator_build_history(struct vy_write_iterator *stream,
 	uint64_t key_mask = stream->cmp_def->column_mask;
 
 	while (true) {
+		if (stream->deferred_delete_handler != NULL) {
+			rc = vy_write_iterator_deferred_delete(stream,
+							       src->tuple);
+			if (rc != 0)
+				break;
+		}
+
 		*is_first_insert = vy_stmt_type(src->tuple) == IPROTO_INSERT;
 
 		if (!stream->is_primary &&
@@ -648,10 +724,13 @@ vy_write_iterator_build_history(struct vy_write_iterator *stream,
 
 		/*
 		 * Optimization 1: skip last level delete.
+		 * An expired tuple is as good as a DELETE.
 		 * @sa vy_write_iterator for details about this
 		 * and other optimizations.
 		 */
-		if (vy_stmt_type(src->tuple) == IPROTO_DELETE &&
+		if ((vy_stmt_type(src->tuple) == IPROTO_DELETE ||
+		     vy_stmt_is_expired(src->tuple, stream->ttl_field,
+					stream->now)) &&
 		    stream->is_last_level && merge_until_lsn == 0) {
 			current_rv_lsn = 0; /* Force skip */
 			goto next_lsn;
@@ -704,6 +783,11 @@ next_lsn:
 			break;
 	}
 
+	if (stream->deferred_delete_stmt != NULL && stream->is_last_level) {
+		/* Nothing is overwritten by the oldest statement. */
+		vy_stmt_unref_if_possible(stream->deferred_delete_stmt);
+		stream->deferred_delete_stmt = NULL;
+	}
 	vy_source_heap_delete(&stream->src_heap, &end_of_key_src.heap_node);
 	vy_stmt_unref_if_possible(end_of_key_src.tuple);
 	return rc;
@@ -831,6 +915,43 @@ vy_read_view_merge(struct vy_write_iterator *stream, struct tuple *hint,
 	return 0;
 }
 
+/**
+ * Clear VY_STMT_DEFERRED_DELETE flag of the statements returned
+ * for the current key, because DELETEs for the tuples they
+ * overwrote have been generated, except for the statement that
+ * overwrote a tuple stored in an older level. A statement read
+ * from memory is shared with tx, so we clear the flag of a copy.
+ *
+ * @retval  0 Success.
+ * @retval -1 Memory error.
+ */
+static NODISCARD int
+vy_write_iterator_clear_deferred_delete(struct vy_write_iterator *stream)
+{
+	int rc = 0;
+	for (int i = 0; i < stream->rv_count; i++) {
+		struct vy_read_view_stmt *rv = &stream->read_views[i];
+		if (rv->tuple == NULL || rv->tuple ==
+		    stream->deferred_delete_stmt ||
+		    (vy_stmt_flags(rv->tuple) & VY_STMT_DEFERRED_DELETE) == 0)
+			continue;
+		struct tuple *copy = vy_stmt_dup(rv->tuple);
+		if (copy == NULL) {
+			rc = -1;
+			break;
+		}
+		vy_stmt_set_flags(copy, vy_stmt_flags(copy) &
+				  ~VY_STMT_DEFERRED_DELETE);
+		vy_stmt_unref_if_possible(rv->tuple);
+		rv->tuple = copy;
+	}
+	if (stream->deferred_delete_stmt != NULL) {
+		vy_stmt_unref_if_possible(stream->deferred_delete_stmt);
+		stream->deferred_delete_stmt = NULL;
+	}
+	return rc;
+}
+
 /**
  * Split the current key into a sequence of read view
  * statements. @sa struct vy_write_iterator comment for details
@@ -856,6 +977,10 @@ vy_write_iterator_build_read_views(struct vy_write_iterator *stream, int *count)
 		goto error;
 	if (raw_count == 0) {
 		/* A key is fully optimized. */
+		if (stream->deferred_delete_stmt != NULL) {
+			vy_stmt_unref_if_possible(stream->deferred_delete_stmt);
+			stream->deferred_delete_stmt = NULL;
+		}
 		region_truncate(region, used);
 		return 0;
 	}
@@ -883,6 +1008,9 @@ vy_write_iterator_build_read_views(struct vy_write_iterator *stream, int *count)
 		++*count;
 		hint = rv->tuple;
 	}
+	if (stream->deferred_delete_handler != NULL &&
+	    vy_write_iterator_clear_deferred_delete(stream) != 0)
+		goto error;
 	region_truncate(region, used);
 	return 0;
 error:
@@ -103,6 +103,11 @@
  * As for all other read views, if a DELETE is visible to a read
  * view, it has to be preserved.
  *
+ * A REPLACE or INSERT of an expired tuple (see space_opts::ttl_field)
+ * is treated as a DELETE here, because expiration doesn't depend
+ * on the read view. Above the last level it is kept and filtered
+ * out on read.
+ *
  * ---------------------------------------------------------------
  * Optimization #2: once we found a REPLACE or DELETE, we can skip
  * the rest of the stream until the next read view:
@@ -218,6 +223,33 @@ struct tuple_format;
 struct tuple;
 struct vy_mem;
 struct vy_slice;
+struct vy_deferred_delete_handler;
+
+struct vy_deferred_delete_handler_iface {
+	/**
+	 * Process a deferred DELETE.
+	 *
+	 * @param handler   Deferred DELETE handler.
+	 * @param old_stmt  Overwritten tuple.
+	 * @param new_stmt  Statement that overwrote @old_stmt,
+	 *                  marked with VY_STMT_DEFERRED_DELETE.
+	 *
+	 * @retval  0 Success.
+	 * @retval -1 Error.
+	 */
+	int (*process)(struct vy_deferred_delete_handler *handler,
+		       struct tuple *old_stmt, struct tuple *new_stmt);
+};
+
+/**
+ * Callback invoked by the write iterator for each statement
+ * overwritten by a REPLACE or DELETE inserted into a primary
+ * index without looking up the old tuple, so that the caller
+ * can generate DELETE statements for secondary indexes.
+ */
+struct vy_deferred_delete_handler {
+	const struct vy_deferred_delete_handler_iface *iface;
+};
 
 /**
  * Open an empty write iterator. To add sources to the iterator
@@ -226,14 +258,19 @@ struct vy_slice;
  * @param format - dormat to allocate new REPLACE and DELETE tuples from vy_run.
  * @param LSM tree is_primary - set if this iterator is for a primary index.
  * @param is_last_level - there is no older level than the one we're writing to.
+ * @param ttl_field - number of the field storing the tuple expiration time
+ * or 0 if tuples never expire, see space_opts::ttl_field.
  * @param read_views - Opened read views.
+ * @param handler - Deferred DELETE handler or NULL if no deferred DELETEs
+ * is expected. Only relevant to primary index compaction.
  * @return the iterator or NULL on error (diag is set).
  */
 struct vy_stmt_stream *
 vy_write_iterator_new(const struct key_def *cmp_def,
 		      struct tuple_format *format,
 		      bool is_primary, bool is_last_level,
-		      struct rlist *read_views);
+		      uint32_t ttl_field, struct rlist *read_views,
+		      struct vy_deferred_delete_handler *handler);
 
 /**
  * Add a mem as a source to the iterator.
@@ -30,6 +30,7 @@
  * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
  * SUCH DAMAGE.
  */
+#include <assert.h>
 #include <stdio.h>
 #include <stdbool.h>
 #include <sys/stat.h>
@@ -731,6 +732,25 @@ xlog_cursor_tx_pos(struct xlog_cursor *cursor)
 {
 	return xlog_tx_cursor_pos(&cursor->tx_cursor);
 }
+
+/**
+ * Move a file cursor which hasn't read any tx yet to
+ * the given position, so that the file can be read by
+ * a new cursor from where the previous one stopped.
+ *
+ * @param cursor xlog cursor
+ * @param offset position returned by xlog_cursor_pos()
+ *               of a cursor which has read a tx
+ */
+static inline void
+xlog_cursor_seek(struct xlog_cursor *cursor, off_t offset)
+{
+	assert(cursor->fd >= 0);
+	assert(cursor->state == XLOG_CURSOR_ACTIVE);
+	assert(offset >= xlog_cursor_pos(cursor));
+	ibuf_reset(&cursor->rbuf);
+	cursor->read_offset = offset;
+}
 /* }}} */
 
 /** {{{ miscellaneous log io functions. */
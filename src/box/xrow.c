@@ -133,6 +133,9 @@ error:
 		case IPROTO_SCHEMA_VERSION:
 			header->schema_version = mp_decode_uint(pos);
 			break;
+		case IPROTO_STREAM_ID:
+			header->stream_id = mp_decode_uint(pos);
+			break;
 		default:
 			/* unknown header */
 			mp_next(pos);
@@ -490,11 +493,19 @@ iproto_reply_map_key(struct obuf *buf, uint32_t size, uint8_t key)
 void
 iproto_reply_select(struct obuf *buf, struct obuf_svp *svp, uint64_t sync,
 		    uint32_t schema_version, uint32_t count)
+{
+	iproto_reply_select_ext(buf, svp, sync, schema_version, count, 0);
+}
+
+void
+iproto_reply_select_ext(struct obuf *buf, struct obuf_svp *svp,
+			uint64_t sync, uint32_t schema_version,
+			uint32_t count, uint32_t ext_size)
 {
 	char *pos = (char *) obuf_svp_to_ptr(buf, svp);
 	iproto_header_encode(pos, IPROTO_OK, sync, schema_version,
 			        obuf_size(buf) - svp->used -
-				IPROTO_HEADER_LEN);
+				IPROTO_HEADER_LEN + ext_size);
 
 	struct iproto_body_bin body = iproto_body_bin;
 	body.v_data_len = mp_bswap_u32(count);
@@ -585,6 +596,9 @@ error:
 		case IPROTO_ITERATOR:
 			request->iterator = mp_decode_uint(&value);
 			break;
+		case IPROTO_CHUNK_SIZE:
+			request->chunk_size = mp_decode_uint(&value);
+			break;
 		case IPROTO_TUPLE:
 			request->tuple = value;
 			request->tuple_end = data;
@@ -650,7 +664,8 @@ xrow_encode_dml(const struct request *request, struct iovec *iov)
 	const int MAP_LEN_MAX = 40;
 	uint32_t key_len = request->key_end - request->key;
 	uint32_t ops_len = request->ops_end - request->ops;
-	uint32_t len = MAP_LEN_MAX + key_len + ops_len;
+	uint32_t tuple_meta_len = request->tuple_meta_end - request->tuple_meta;
+	uint32_t len = MAP_LEN_MAX + key_len + ops_len + tuple_meta_len;
 	char *begin = (char *) region_alloc(&fiber()->gc, len);
 	if (begin == NULL) {
 		diag_set(OutOfMemory, len, "region_alloc", "begin");
@@ -685,6 +700,12 @@ xrow_encode_dml(const struct request *request, struct iovec *iov)
 		pos += ops_len;
 		map_size++;
 	}
+	if (request->tuple_meta) {
+		pos = mp_encode_uint(pos, IPROTO_TUPLE_META);
+		memcpy(pos, request->tuple_meta, tuple_meta_len);
+		pos += tuple_meta_len;
+		map_size++;
+	}
 	if (request->tuple) {
 		pos = mp_encode_uint(pos, IPROTO_TUPLE);
 		iov[iovcnt].iov_base = (void *) request->tuple;
@@ -867,6 +888,59 @@ error:
 	return 0;
 }
 
+int
+xrow_decode_compress(const struct xrow_header *row, uint32_t *compression)
+{
+	if (row->bodycnt == 0) {
+		diag_set(ClientError, ER_INVALID_MSGPACK,
+			 "missing request body");
+		return -1;
+	}
+	assert(row->bodycnt == 1);
+	const char *data = (const char *) row->body[0].iov_base;
+	const char *end = data + row->body[0].iov_len;
+	assert((end - data) > 0);
+
+	if (mp_typeof(*data) != MP_MAP || mp_check_map(data, end) > 0) {
+error:
+		diag_set(ClientError, ER_INVALID_MSGPACK, "packet body");
+		return -1;
+	}
+	bool is_set = false;
+	uint32_t map_size = mp_decode_map(&data);
+	for (uint32_t i = 0; i < map_size; ++i) {
+		if ((end - data) < 1 || mp_typeof(*data) != MP_UINT)
+			goto error;
+		uint64_t key = mp_decode_uint(&data);
+		const char *value = data;
+		if (mp_check(&data, end) != 0)
+			goto error;
+		if (key != IPROTO_COMPRESSION)
+			continue; /* unknown key */
+		if (mp_typeof(*value) != MP_UINT)
+			goto error;
+		uint64_t algo = mp_decode_uint(&value);
+		if (algo >= IPROTO_COMPRESSION_MAX) {
+			diag_set(ClientError, ER_UNSUPPORTED, "Tarantool",
+				 tt_sprintf("compression algorithm %llu",
+					    (unsigned long long) algo));
+			return -1;
+		}
+		*compression = algo;
+		is_set = true;
+	}
+	if (data != end) {
+		diag_set(ClientError, ER_INVALID_MSGPACK, "packet end");
+		return -1;
+	}
+	if (!is_set) {
+		diag_set(ClientError, ER_MISSING_REQUEST_FIELD,
+			 iproto_key_name(IPROTO_COMPRESSION));
+		return -1;
+	}
+	return 0;
+}
+
 int
 xrow_encode_auth(struct xrow_header *packet, const char *salt, size_t salt_len,
 		 const char *login, size_t login_len,
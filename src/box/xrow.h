@@ -77,6 +77,11 @@ struct xrow_header {
 
 	int bodycnt;
 	uint32_t schema_version;
+	/**
+	 * Stream the request belongs to, 0 if none. Is never
+	 * written to WAL.
+	 */
+	uint64_t stream_id;
 	struct iovec body[XROW_BODY_IOVMAX];
 };
 
@@ -131,6 +136,8 @@ struct request {
 	uint32_t offset;
 	uint32_t limit;
 	uint32_t iterator;
+	/** SELECT result chunk size, see IPROTO_CHUNK_SIZE. */
+	uint32_t chunk_size;
 	/** Search key. */
 	const char *key;
 	const char *key_end;
@@ -140,6 +147,12 @@ struct request {
 	/** Upsert operations. */
 	const char *ops;
 	const char *ops_end;
+	/**
+	 * Tuple metadata, see IPROTO_TUPLE_META. Only used for
+	 * encoding, xrow_decode_dml() doesn't set it.
+	 */
+	const char *tuple_meta;
+	const char *tuple_meta_end;
 	/** Base field offset for UPDATE/UPSERT, e.g. 0 for C and 1 for Lua. */
 	int index_base;
 };
@@ -218,6 +231,17 @@ struct auth_request {
 int
 xrow_decode_auth(const struct xrow_header *row, struct auth_request *request);
 
+/**
+ * Decode COMPRESS request from MessagePack.
+ * @param row request header.
+ * @param[out] compression Compression algorithm,
+ *             enum iproto_compression.
+ * @retval  0 on success
+ * @retval -1 on error
+ */
+int
+xrow_decode_compress(const struct xrow_header *row, uint32_t *compression);
+
 /**
  * Encode AUTH command.
  * @param[out] Row.
@@ -406,6 +430,16 @@ void
 iproto_reply_select(struct obuf *buf, struct obuf_svp *svp, uint64_t sync,
 		    uint32_t schema_version, uint32_t count);
 
+/**
+ * Same as iproto_reply_select(), but the body also includes
+ * @a ext_size bytes which are not stored in the buffer, but
+ * are sent to the client directly from the tuple memory.
+ */
+void
+iproto_reply_select_ext(struct obuf *buf, struct obuf_svp *svp,
+			uint64_t sync, uint32_t schema_version,
+			uint32_t count, uint32_t ext_size);
+
 /**
  * Write header of the key to a preallocated buffer by svp.
  * @param buf Buffer to write to.
@@ -173,14 +173,13 @@ coio_connect_timeout(struct ev_io *coio, struct uri *uri, struct sockaddr *addr,
 	if (strcmp(host, URI_HOST_UNIX) == 0) {
 		/* UNIX socket */
 		struct sockaddr_un un;
-		snprintf(un.sun_path, sizeof(un.sun_path), "%s", service);
-		un.sun_family = AF_UNIX;
-		if (coio_connect_addr(coio, (struct sockaddr *) &un, sizeof(un),
+		socklen_t un_len = sio_unix_addr(&un, service);
+		if (coio_connect_addr(coio, (struct sockaddr *) &un, un_len,
 				      delay) != 0)
 			return -1;
 		if (addr != NULL) {
 			assert(addr_len != NULL);
-			*addr_len = MIN(sizeof(un), *addr_len);
+			*addr_len = MIN(un_len, *addr_len);
 			memcpy(addr, &un, *addr_len);
 		}
 		return 0;
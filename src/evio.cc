@@ -42,7 +42,16 @@
 #include "exception.h"
 
 static void
-evio_setsockopt_server(int fd, int family, int type);
+evio_setsockopt_server(int fd, int family, int type, bool is_reuseport);
+
+enum {
+	/**
+	 * The maximal number of connections accepted in one
+	 * event loop iteration, so that a storm of new
+	 * connections doesn't delay the established ones.
+	 */
+	EVIO_ACCEPT_BATCH_MAX = 64,
+};
 
 /** Note: this function does not throw. */
 void
@@ -132,7 +141,7 @@ evio_setsockopt_client(int fd, int family, int type)
 
 /** Set options for server sockets. */
 static void
-evio_setsockopt_server(int fd, int family, int type)
+evio_setsockopt_server(int fd, int family, int type, bool is_reuseport)
 {
 	int on = 1;
 	/* In case this throws, the socket is not leaked. */
@@ -142,6 +151,14 @@ evio_setsockopt_server(int fd, int family, int type)
 	if (sio_setsockopt(fd, SOL_SOCKET, SO_REUSEADDR,
 		       &on, sizeof(on)))
 		diag_raise();
+#ifdef SO_REUSEPORT
+	/* Allow several sockets to be bound to one port. */
+	if (is_reuseport && family != AF_UNIX &&
+	    sio_setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &on, sizeof(on)))
+		diag_raise();
+#else
+	(void) is_reuseport;
+#endif
 
 	/* Send all buffered messages on socket before take
 	 * control out from close(2) or shutdown(2). */
@@ -171,11 +188,12 @@ evio_service_accept_cb(ev_loop * /* loop */, ev_io *watcher,
 {
 	struct evio_service *service = (struct evio_service *) watcher->data;
 
-	while (1) {
+	for (int i = 0; i < EVIO_ACCEPT_BATCH_MAX; i++) {
 		/*
-		 * Accept all pending connections from backlog during event
+		 * Accept pending connections from backlog during event
 		 * loop iteration. Significally speed up acceptor with enabled
-		 * io_collect_interval.
+		 * io_collect_interval. The rest, if any, are accepted
+		 * on the next iteration.
 		 */
 		int fd = -1;
 		try {
@@ -211,7 +229,10 @@ evio_service_accept_cb(ev_loop * /* loop */, ev_io *watcher,
 static int
 evio_service_reuse_addr(struct evio_service *service, int fd)
 {
-	if ((service->addr.sa_family != AF_UNIX) || (errno != EADDRINUSE)) {
+	struct sockaddr_un *un = (struct sockaddr_un *) &service->addr;
+	/* An abstract socket doesn't outlive its owner. */
+	if (service->addr.sa_family != AF_UNIX || errno != EADDRINUSE ||
+	    un->sun_path[0] == '\0') {
 		diag_set(SocketError, sio_socketname(fd),
 			 "evio_service_reuse_addr");
 		return -1;
@@ -227,7 +248,7 @@ evio_service_reuse_addr(struct evio_service *service, int fd)
 	if (errno != ECONNREFUSED)
 		goto err;
 
-	if (unlink(((struct sockaddr_un *)(&service->addr))->sun_path))
+	if (unlink(un->sun_path))
 		goto err;
 	close(cl_fd);
 
@@ -257,7 +278,8 @@ evio_service_bind_addr(struct evio_service *service)
 
 	auto fd_guard = make_scoped_guard([=]{ close(fd); });
 
-	evio_setsockopt_server(fd, service->addr.sa_family, SOCK_STREAM);
+	evio_setsockopt_server(fd, service->addr.sa_family, SOCK_STREAM,
+			       service->is_reuseport);
 
 	if (sio_bind(fd, &service->addr, service->addr_len)) {
 		if (errno != EADDRINUSE)
@@ -282,6 +304,37 @@ evio_service_bind_addr(struct evio_service *service)
 	fd_guard.is_active = false;
 }
 
+/**
+ * Check that nobody is bound to the configured address.
+ *
+ * SO_REUSEPORT lets a socket be bound to an address that is
+ * already taken by another SO_REUSEPORT socket of the same user,
+ * e.g. of another instance started with the same listen URI.
+ * So before binding with SO_REUSEPORT, bind a socket without it
+ * to make sure the address is free.
+ *
+ * Throws an exception if the address is in use.
+ */
+static void
+evio_service_probe_addr(struct evio_service *service)
+{
+	int fd = sio_socket(service->addr.sa_family,
+			    SOCK_STREAM, IPPROTO_TCP);
+	if (fd < 0)
+		diag_raise();
+
+	auto fd_guard = make_scoped_guard([=]{ close(fd); });
+
+	evio_setsockopt_server(fd, service->addr.sa_family, SOCK_STREAM,
+			       false);
+
+	if (sio_bind(fd, &service->addr, service->addr_len)) {
+		if (errno == EADDRINUSE)
+			diag_set(SocketError, sio_socketname(fd), "bind");
+		diag_raise();
+	}
+}
+
 /**
  * Listen on bounded port.
  *
@@ -347,10 +400,7 @@ evio_service_bind(struct evio_service *service, const char *uri)
 	if (strcmp(service->host, URI_HOST_UNIX) == 0) {
 		/* UNIX domain socket */
 		struct sockaddr_un *un = (struct sockaddr_un *) &service->addr;
-		service->addr_len = sizeof(*un);
-		snprintf(un->sun_path, sizeof(un->sun_path), "%s",
-			 service->serv);
-		un->sun_family = AF_UNIX;
+		service->addr_len = sio_unix_addr(un, service->serv);
 		return evio_service_bind_addr(service);
 	}
 
@@ -372,6 +422,8 @@ evio_service_bind(struct evio_service *service, const char *uri)
 		memcpy(&service->addr, ai->ai_addr, ai->ai_addrlen);
 		service->addr_len = ai->ai_addrlen;
 		try {
+			if (service->is_reuseport)
+				evio_service_probe_addr(service);
 			return evio_service_bind_addr(service);
 		} catch (SocketError *e) {
 			say_error("%s: failed to bind on %s: %s",
@@ -385,6 +437,51 @@ evio_service_bind(struct evio_service *service, const char *uri)
 		  evio_service_name(service));
 }
 
+void
+evio_service_attach(struct evio_service *dst, const struct evio_service *src)
+{
+	assert(! ev_is_active(&dst->ev));
+	assert(evio_service_is_active(src));
+	snprintf(dst->host, sizeof(dst->host), "%s", src->host);
+	snprintf(dst->serv, sizeof(dst->serv), "%s", src->serv);
+	memcpy(&dst->addrstorage, &src->addrstorage, sizeof(src->addrstorage));
+	dst->addr_len = src->addr_len;
+#ifdef SO_REUSEPORT
+	if (src->is_reuseport && src->addr.sa_family != AF_UNIX) {
+		/*
+		 * Bind to the address the source is actually
+		 * bound to, in case it asked for any port.
+		 */
+		socklen_t addr_len = sizeof(dst->addrstorage);
+		if (getsockname(src->ev.fd, &dst->addr, &addr_len) != 0) {
+			tnt_raise(SocketError, sio_socketname(src->ev.fd),
+				  "getsockname");
+		}
+		dst->addr_len = addr_len;
+		dst->is_reuseport = true;
+		dst->is_attached = false;
+		evio_service_bind_addr(dst);
+		evio_service_listen(dst);
+		return;
+	}
+#endif
+	dst->is_attached = true;
+	ev_io_set(&dst->ev, src->ev.fd, EV_READ);
+	ev_io_start(dst->loop, &dst->ev);
+}
+
+void
+evio_service_detach(struct evio_service *service)
+{
+	if (!service->is_attached) {
+		evio_service_stop(service);
+		return;
+	}
+	if (ev_is_active(&service->ev))
+		ev_io_stop(service->loop, &service->ev);
+	ev_io_set(&service->ev, -1, 0);
+}
+
 /** It's safe to stop a service which is not started yet. */
 void
 evio_service_stop(struct evio_service *service)
@@ -398,8 +495,10 @@ evio_service_stop(struct evio_service *service)
 	if (service->ev.fd >= 0) {
 		close(service->ev.fd);
 		ev_io_set(&service->ev, -1, 0);
-		if (service->addr.sa_family == AF_UNIX) {
-			unlink(((struct sockaddr_un *) &service->addr)->sun_path);
+		struct sockaddr_un *un = (struct sockaddr_un *) &service->addr;
+		if (service->addr.sa_family == AF_UNIX &&
+		    un->sun_path[0] != '\0') {
+			unlink(un->sun_path);
 		}
 	}
 }
@@ -76,6 +76,17 @@ struct evio_service
 		struct sockaddr_storage addrstorage;
 	};
 	socklen_t addr_len;
+	/**
+	 * Set SO_REUSEPORT on the acceptor socket, so that the
+	 * services attached to this one bind sockets of their own
+	 * to the same address, and the kernel balances incoming
+	 * connections among them. Is ignored for unix sockets.
+	 * evio_service_bind() still fails if another socket is
+	 * bound to the address, even with SO_REUSEPORT.
+	 */
+	bool is_reuseport;
+	/** True if the acceptor socket is owned by another service. */
+	bool is_attached;
 
 	/**
 	 * A callback invoked on every accepted client socket.
@@ -112,6 +123,24 @@ evio_service_bind(struct evio_service *service, const char *uri);
 void
 evio_service_listen(struct evio_service *service);
 
+/**
+ * Start accepting connections on the address of another, already
+ * listening service, in the event loop of @a dst. Used to accept
+ * on one address in several threads. If @a src is_reuseport,
+ * @a dst binds a socket of its own, otherwise the acceptor socket
+ * of @a src is shared.
+ */
+void
+evio_service_attach(struct evio_service *dst, const struct evio_service *src);
+
+/**
+ * Stop event flow of an attached service. Unlike
+ * evio_service_stop(), doesn't close the acceptor socket if it
+ * is owned by the service it was attached to.
+ */
+void
+evio_service_detach(struct evio_service *service);
+
 /** If started, stop event flow and close the acceptor socket. */
 void
 evio_service_stop(struct evio_service *service);
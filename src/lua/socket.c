@@ -50,6 +50,7 @@
 #include <lualib.h>
 
 #include <coio.h> /* coio_wait() */
+#include <sio.h> /* sio_unix_addr() */
 #include <coio_task.h> /* coio_getaddrinfo() */
 #include <fiber.h>
 #include "lua/utils.h"
@@ -256,6 +257,9 @@ static const struct lbox_sockopt_reg so_opts[] = {
 #ifdef SO_REUSEADDR
 	{"SO_REUSEADDR",	SO_REUSEADDR,		1,	1, },
 #endif
+#ifdef SO_REUSEPORT
+	{"SO_REUSEPORT",	SO_REUSEPORT,		1,	1, },
+#endif
 #ifdef SO_SNDBUF
 	{"SO_SNDBUF",		SO_SNDBUF,		1,	1, },
 #endif
@@ -410,10 +414,7 @@ lbox_socket_local_resolve(const char *host, const char *port,
 			errno = ENOBUFS;
 			return -1;
 		}
-		memset(uaddr, 0, sizeof(*uaddr));
-		uaddr->sun_family = AF_UNIX;
-		snprintf(uaddr->sun_path, sizeof(uaddr->sun_path), "%s", port);
-		*socklen = sizeof(*uaddr);
+		*socklen = sio_unix_addr(uaddr, port);
 		return 0;
 	}
 
@@ -714,9 +715,19 @@ lbox_socket_push_addr(struct lua_State *L,
 		lua_rawset(L, -3);
 
 		if (alen > sizeof(addr->sa_family)) {
+			const char *path =
+				((struct sockaddr_un *)addr)->sun_path;
 			lua_pushliteral(L, "port");
-			lua_pushstring(L,
-				       ((struct sockaddr_un *)addr)->sun_path);
+			if (*path == '\0') {
+				/* Abstract namespace, see sio_unix_addr(). */
+				lua_pushliteral(L, "@");
+				lua_pushlstring(L, path + 1, alen - 1 -
+						offsetof(struct sockaddr_un,
+							 sun_path));
+				lua_concat(L, 2);
+			} else {
+				lua_pushstring(L, path);
+			}
 			lua_rawset(L, -3);
 		} else {
 			lua_pushliteral(L, "port");
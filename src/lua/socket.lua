@@ -1030,7 +1030,8 @@ end
 
 local function tcp_server_do_bind(s, addr)
     if socket_bind(s, addr.host, addr.port) then
-        if addr.family == 'AF_UNIX' then
+        -- An abstract unix socket ('@name') has no file.
+        if addr.family == 'AF_UNIX' and addr.port:sub(1, 1) ~= '@' then
             -- Make close() remove the unix socket file created
             -- by bind(). Note, this must be done before closing
             -- the socket fd so that no other tcp server can
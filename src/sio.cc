@@ -35,6 +35,7 @@
 #include <errno.h>
 #include <stdio.h>
 #include <limits.h>
+#include <stddef.h> /* offsetof */
 #include <netinet/in.h> /* TCP_NODELAY */
 #include <netinet/tcp.h> /* TCP_NODELAY */
 #include <arpa/inet.h> /* inet_ntoa */
@@ -496,14 +497,39 @@ sio_getpeername(int fd, struct sockaddr *addr, socklen_t *addrlen)
 	return 0;
 }
 
+socklen_t
+sio_unix_addr(struct sockaddr_un *addr, const char *path)
+{
+	memset(addr, 0, sizeof(*addr));
+	addr->sun_family = AF_UNIX;
+	if (*path != '@') {
+		snprintf(addr->sun_path, sizeof(addr->sun_path), "%s", path);
+		return sizeof(*addr);
+	}
+	/*
+	 * An abstract name starts with '\0' instead of '@' and
+	 * is not terminated, its length is given by the address
+	 * length.
+	 */
+	size_t len = MIN(strlen(path + 1), sizeof(addr->sun_path) - 1);
+	memcpy(addr->sun_path + 1, path + 1, len);
+	return offsetof(struct sockaddr_un, sun_path) + 1 + len;
+}
+
 /** Pretty print a peer address. */
 const char *
 sio_strfaddr(struct sockaddr *addr, socklen_t addrlen)
 {
 	static __thread char name[NI_MAXHOST + _POSIX_PATH_MAX + 2];
+	const size_t path_offset = offsetof(struct sockaddr_un, sun_path);
 	switch(addr->sa_family) {
 		case AF_UNIX:
-			if (addrlen >= sizeof(sockaddr_un)) {
+			if (addrlen > path_offset &&
+			    ((struct sockaddr_un *)addr)->sun_path[0] == '\0') {
+				snprintf(name, sizeof(name), "unix/:@%.*s",
+					 (int) (addrlen - path_offset - 1),
+					 ((struct sockaddr_un *)addr)->sun_path + 1);
+			} else if (addrlen >= sizeof(sockaddr_un)) {
 				snprintf(name, sizeof(name), "unix/:%s",
 					((struct sockaddr_un *)addr)->sun_path);
 			} else {
@@ -49,6 +49,18 @@ extern "C" {
 const char *
 sio_strfaddr(struct sockaddr *addr, socklen_t addrlen);
 
+struct sockaddr_un;
+
+/**
+ * Fill a unix socket address. A path starting with '@' is a
+ * name in the abstract namespace (Linux-only), which doesn't
+ * refer to a file and disappears when the socket is closed.
+ *
+ * @return The address length.
+ */
+socklen_t
+sio_unix_addr(struct sockaddr_un *addr, const char *path);
+
 int
 sio_getpeername(int fd, struct sockaddr *addr, socklen_t *addrlen);
 
@@ -46,6 +46,22 @@ uri_parse(struct uri *uri, const char *p)
 	const char *s = NULL, *login = NULL, *scheme = NULL;
 	size_t login_len = 0, scheme_len = 0;
 
+	/*
+	 * Non-standard: a unix socket in the abstract namespace,
+	 * "unix/:@name". The name doesn't refer to a file, so it
+	 * doesn't match the socket path grammar.
+	 */
+	const char *abstract = URI_HOST_UNIX ":@";
+	if (strncmp(p, abstract, strlen(abstract)) == 0 &&
+	    pe - p > (ptrdiff_t) strlen(abstract)) {
+		uri->host = URI_HOST_UNIX;
+		uri->host_len = strlen(URI_HOST_UNIX);
+		uri->host_hint = 3;
+		uri->service = p + strlen(URI_HOST_UNIX ":");
+		uri->service_len = pe - uri->service;
+		return uri->service_len < URI_MAXSERVICE ? 0 : -1;
+	}
+
 	%%{
 		machine uri;
 		write data;
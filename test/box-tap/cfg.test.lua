@@ -6,7 +6,7 @@ local socket = require('socket')
 local fio = require('fio')
 local uuid = require('uuid')
 local msgpack = require('msgpack')
-test:plan(95)
+test:plan(98)
 
 --------------------------------------------------------------------------------
 -- Invalid values
@@ -39,6 +39,8 @@ invalid('listen', '//!')
 invalid('log', ':')
 invalid('log', 'syslog:xxx=')
 invalid('log_level', 'unknown')
+invalid('iproto_threads', 0)
+invalid('iproto_threads', 1001)
 invalid('vinyl_memory', -1)
 invalid('vinyl_read_threads', 0)
 invalid('vinyl_write_threads', 1)
@@ -48,6 +50,7 @@ invalid('vinyl_run_count_per_level', 0)
 invalid('vinyl_run_size_ratio', 1)
 invalid('vinyl_bloom_fpr', 0)
 invalid('vinyl_bloom_fpr', 1.1)
+invalid('vinyl_scrub_rate', -1)
 
 local function invalid_combinations(name, val)
     local status, result = pcall(box.cfg, val)
@@ -105,6 +108,8 @@ test:ok(status and result == 'table', 'configured box')
 --------------------------------------------------------------------------------
 
 invalid('log_level', 'unknown')
+invalid('iproto_threads', 0)
+invalid('iproto_threads', 1001)
 
 --------------------------------------------------------------------------------
 -- gh-534: Segmentation fault after two bad wal_mode settings
@@ -0,0 +1,76 @@
+test_run = require('test_run').new()
+net_box = require('net.box')
+msgpack = require('msgpack')
+urilib = require('uri')
+--
+-- With iproto_batch_dml consecutive DML requests read from a
+-- connection at once are executed in one transaction, but
+-- still get a reply each.
+--
+box.cfg.iproto_batch_dml
+box.cfg{iproto_batch_dml = true}
+box.schema.user.grant('guest', 'read,write,execute', 'universe')
+s = box.schema.space.create('test')
+_ = s:create_index('pk')
+v = box.schema.space.create('test_vinyl', {engine = 'vinyl'})
+_ = v:create_index('pk')
+uri = urilib.parse(tostring(box.cfg.listen))
+sock = net_box.establish_connection(uri.host, uri.service)
+test_run:cmd("setopt delimiter ';'")
+function insert(space, tuple)
+    return {0x02, {[0x10] = space.id, [0x21] = tuple}}
+end;
+function replace(space, tuple)
+    return {0x03, {[0x10] = space.id, [0x21] = tuple}}
+end;
+function delete(space, key)
+    return {0x05, {[0x10] = space.id, [0x11] = 0, [0x20] = key}}
+end;
+-- Send all requests with a single write and return the replies
+-- in the order of requests.
+function pipeline(...)
+    local requests = {...}
+    local data = ''
+    for sync, r in ipairs(requests) do
+        local header = msgpack.encode({[0x00] = r[1], [0x01] = sync})
+        local body = msgpack.encode(r[2])
+        data = data .. msgpack.encode(#header + #body) .. header .. body
+    end
+    sock:write(data)
+    local replies = {}
+    for i = 1, #requests do
+        local len = msgpack.decode(sock:read(5))
+        local data = sock:read(len)
+        local header, pos = msgpack.decode(data)
+        local body = msgpack.decode(data, pos)
+        if header[0x00] ~= 0 then
+            replies[header[0x01]] = body[0x31]
+        else
+            replies[header[0x01]] = body[0x30][1] or 'nil'
+        end
+    end
+    return replies
+end;
+test_run:cmd("setopt delimiter ''");
+-- A failed request doesn't affect the others.
+pipeline(insert(s, {1}), insert(s, {2}), insert(s, {1, 1}), replace(s, {3}))
+s:select()
+pipeline(delete(s, {1}), delete(s, {4}), replace(s, {2, 2}), insert(s, {4}))
+s:select()
+-- Requests to spaces of different engines are executed one
+-- by one.
+pipeline(insert(s, {5}), insert(v, {1}), insert(v, {1, 1}), insert(s, {5}))
+s:select()
+v:select()
+-- Requests to system spaces are not batched.
+pipeline(insert(s, {6}), insert(box.space._schema, {'test'}), insert(s, {7}))
+box.space._schema:get{'test'}
+box.space._schema:delete{'test'}
+s:select()
+box.cfg{iproto_batch_dml = false}
+pipeline(insert(s, {8}), insert(s, {8}), insert(s, {9}))
+s:select()
+sock:close()
+s:drop()
+v:drop()
+box.schema.user.revoke('guest', 'read,write,execute', 'universe')
@@ -0,0 +1,47 @@
+net_box = require('net.box')
+--
+-- SELECT with IPROTO_CHUNK_SIZE streams its result in
+-- IPROTO_CHUNK packets of chunk_size tuples while the iterator
+-- advances. The response has the rest of the tuples.
+--
+box.schema.user.grant('guest', 'read,write,execute', 'universe')
+s = box.schema.space.create('test')
+_ = s:create_index('pk')
+for i = 1, 10 do s:replace{i} end
+c = net_box.connect(box.cfg.listen)
+chunks = {}
+c.space.test:select({}, {chunk_size = 3, on_push = table.insert, on_push_ctx = chunks})
+#chunks
+chunks[1][1][1], chunks[1][3][1], chunks[3][1][1], chunks[3][3][1]
+-- A result of whole chunks.
+chunks = {}
+c.space.test:select({}, {limit = 6, chunk_size = 3, on_push = table.insert, on_push_ctx = chunks})
+#chunks
+-- Offset, limit and iterator are respected.
+chunks = {}
+c.space.test:select({8}, {iterator = 'LE', offset = 1, limit = 5, chunk_size = 2, on_push = table.insert, on_push_ctx = chunks})
+#chunks
+chunks[1][1][1], chunks[1][2][1], chunks[2][1][1], chunks[2][2][1]
+-- No chunks if the result is smaller than a chunk.
+chunks = {}
+c.space.test:select({1}, {chunk_size = 3, on_push = table.insert, on_push_ctx = chunks})
+#chunks
+-- Without on_push a synchronous select collects chunks
+-- into the result.
+res = c.space.test:select({}, {chunk_size = 3})
+#res
+res[1][1], res[4][1], res[10][1]
+#c.space.test:select({3}, {iterator = 'GE', chunk_size = 2, limit = 5})
+-- Buffer and raw modes need on_push.
+ok, err = pcall(c.space.test.select, c.space.test, {}, {chunk_size = 3, raw = true})
+ok, err:match('requires `on_push`') ~= nil
+-- A result much bigger than the output limit of a chunked
+-- select is streamed as the client reads it.
+for i = 1, 40 do s:replace{i, string.rep('x', 100000)} end
+stat = {chunks = 0, tuples = 0}
+function on_chunk(stat, chunk) stat.chunks = stat.chunks + 1 stat.tuples = stat.tuples + #chunk end
+#c.space.test:select({}, {chunk_size = 3, on_push = on_chunk, on_push_ctx = stat})
+stat.chunks, stat.tuples
+c:close()
+s:drop()
+box.schema.user.revoke('guest', 'read,write,execute', 'universe')
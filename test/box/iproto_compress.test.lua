@@ -0,0 +1,80 @@
+test_run = require('test_run').new()
+net_box = require('net.box')
+msgpack = require('msgpack')
+urilib = require('uri')
+--
+-- IPROTO_COMPRESS makes the server compress all further
+-- responses on the connection.
+--
+box.schema.user.grant('guest', 'read,write,execute', 'universe')
+s = box.schema.space.create('test')
+_ = s:create_index('pk')
+for i = 1, 1000 do s:replace{i, string.rep('x', 100)} end
+c = net_box.connect(box.cfg.listen, {compression = 'zstd'})
+c.state
+c:ping()
+#c.space.test:select()
+c.space.test:get{1000}
+#c:call('string.rep', {'abc', 100000})
+c:eval('return ...', {1, 2, 3})
+-- Pipelined requests.
+test_run:cmd("setopt delimiter ';'")
+futures = {};
+for i = 1, 100 do
+    futures[i] = c.space.test:get({i}, {is_async = true})
+end;
+ok = true;
+for i = 1, 100 do
+    ok = ok and futures[i]:wait_result()[1] == i
+end;
+test_run:cmd("setopt delimiter ''");
+ok
+-- Big tuples are sent by reference, one iovec each. A frame
+-- must not end in the middle of a reply however many of them
+-- the reply has.
+for i = 1, 1000 do s:replace{i, string.rep('x', 1000)} end
+#c.space.test:select()
+c.space.test:select({}, {iterator = 'LE', limit = 1})[1][1]
+ok = true
+for _, t in ipairs(c.space.test:select()) do ok = ok and #t[2] == 1000 end
+ok
+-- Output bigger than the frame size limit is sent in several
+-- frames, each ending at a reply boundary.
+test_run:cmd("setopt delimiter ';'")
+futures = {};
+for i = 1, 1000 do
+    futures[i] = c.space.test:get({i}, {is_async = true})
+end;
+ok = true;
+for i = 1, 1000 do
+    local t = futures[i]:wait_result()
+    ok = ok and t[1] == i and #t[2] == 1000
+end;
+test_run:cmd("setopt delimiter ''");
+ok
+c:close()
+-- Unknown compression.
+c = net_box.connect(box.cfg.listen, {compression = 'lz4'})
+c.state
+c.error
+c:close()
+-- Invalid request.
+uri = urilib.parse(tostring(box.cfg.listen))
+sock = net_box.establish_connection(uri.host, uri.service)
+test_run:cmd("setopt delimiter ';'")
+function compress(body)
+    local header = msgpack.encode({[0x00] = 69, [0x01] = 1})
+    body = msgpack.encode(body)
+    sock:write(msgpack.encode(#header + #body) .. header .. body)
+    local len = msgpack.decode(sock:read(5))
+    local data = sock:read(len)
+    local header, pos = msgpack.decode(data)
+    return msgpack.decode(data, pos)[0x31]
+end;
+test_run:cmd("setopt delimiter ''");
+compress({[0x2c] = 10})
+compress({[0x2c] = 'zstd'})
+compress(setmetatable({}, {__serialize = 'map'}))
+sock:close()
+s:drop()
+box.schema.user.revoke('guest', 'read,write,execute', 'universe')
@@ -0,0 +1,36 @@
+net_box = require('net.box')
+fiber = require('fiber')
+--
+-- iproto_rate_limit throttles reading of requests from a
+-- connection which sends them too fast.
+--
+box.cfg.iproto_rate_limit
+box.cfg{iproto_rate_limit = -1}
+box.schema.user.grant('guest', 'execute', 'universe')
+c1 = net_box.connect(box.cfg.listen)
+c2 = net_box.connect(box.cfg.listen)
+box.cfg{iproto_rate_limit = 10}
+-- A burst of a second worth of requests is not throttled.
+futures = {}
+start = fiber.clock()
+for i = 1, 30 do futures[i] = c1:call('tostring', {i}, {is_async = true}) end
+futures[10]:wait_result()[1]
+fiber.clock() - start < 0.5
+-- The others are throttled, but other connections are not.
+c2:ping()
+fiber.clock() - start < 0.5
+futures[30]:is_ready()
+futures[30]:wait_result()[1]
+fiber.clock() - start >= 1.5
+-- Removing the limit resumes throttled connections at once.
+box.cfg{iproto_rate_limit = 1}
+start = fiber.clock()
+for i = 1, 10 do futures[i] = c1:call('tostring', {i}, {is_async = true}) end
+fiber.sleep(0.1)
+futures[10]:is_ready()
+box.cfg{iproto_rate_limit = 0}
+futures[10]:wait_result()[1]
+fiber.clock() - start < 1
+c1:close()
+c2:close()
+box.schema.user.revoke('guest', 'execute', 'universe')
@@ -0,0 +1,118 @@
+test_run = require('test_run').new()
+net_box = require('net.box')
+msgpack = require('msgpack')
+fiber = require('fiber')
+urilib = require('uri')
+--
+-- Requests sharing IPROTO_STREAM_ID are executed one by one and
+-- may form an interactive transaction with IPROTO_BEGIN,
+-- IPROTO_COMMIT and IPROTO_ROLLBACK.
+--
+box.schema.user.grant('guest', 'read,write,execute', 'universe')
+s = box.schema.space.create('test', {engine = 'vinyl'})
+_ = s:create_index('pk')
+uri = urilib.parse(tostring(box.cfg.listen))
+test_run:cmd("setopt delimiter ';'")
+function connect()
+    local sock = net_box.establish_connection(uri.host, uri.service)
+    return {sock = sock, sync = 0}
+end;
+function request(con, type, stream_id, body)
+    con.sync = con.sync + 1
+    local header = msgpack.encode({[0x00] = type, [0x01] = con.sync,
+                                   [0x08] = stream_id})
+    body = msgpack.encode(body or setmetatable({}, {__serialize = 'map'}))
+    con.sock:write(msgpack.encode(#header + #body) .. header .. body)
+    local len = msgpack.decode(con.sock:read(5))
+    local data = con.sock:read(len)
+    local header, pos = msgpack.decode(data)
+    body = msgpack.decode(data, pos)
+    if header[0x00] ~= 0 then
+        return {error = body[0x31]}
+    end
+    return body[0x30] and setmetatable(body[0x30], nil) or true
+end;
+function begin(con, stream_id) return request(con, 14, stream_id) end;
+function commit(con, stream_id) return request(con, 15, stream_id) end;
+function rollback(con, stream_id) return request(con, 16, stream_id) end;
+function insert(con, stream_id, space, tuple)
+    return request(con, 2, stream_id, {[0x10] = space.id, [0x21] = tuple})
+end;
+function select_all(con, stream_id, space)
+    return request(con, 1, stream_id, {[0x10] = space.id, [0x11] = 0,
+                                       [0x12] = 1000, [0x20] = {}})
+end;
+test_run:cmd("setopt delimiter ''");
+c = connect()
+-- A transaction request must belong to a stream.
+begin(c, nil)
+commit(c, nil)
+-- Changes of a stream transaction are visible in the stream only.
+begin(c, 1)
+insert(c, 1, s, {1, 10})
+insert(c, 1, s, {2, 20})
+select_all(c, 1, s)
+select_all(c, 2, s)
+select_all(c, nil, s)
+s:select()
+commit(c, 1)
+select_all(c, 2, s)
+s:select()
+-- Rollback.
+begin(c, 1)
+insert(c, 1, s, {3, 30})
+select_all(c, 1, s)
+rollback(c, 1)
+select_all(c, 1, s)
+-- Several streams of a connection run their transactions
+-- independently.
+begin(c, 1)
+begin(c, 2)
+insert(c, 1, s, {3, 30})
+insert(c, 2, s, {4, 40})
+select_all(c, 1, s)
+select_all(c, 2, s)
+commit(c, 2)
+rollback(c, 1)
+s:select()
+-- Nested BEGIN is an error.
+begin(c, 1)
+begin(c, 1)
+-- CALL and EVAL can't join a stream transaction.
+request(c, 8, 1, {[0x27] = 'return 1', [0x21] = {}})
+rollback(c, 1)
+request(c, 8, 1, {[0x27] = 'return 1', [0x21] = {}})
+-- A transaction left open is rolled back on disconnect.
+disconnected = false
+trigger = box.session.on_disconnect(function() disconnected = true end)
+begin(c, 1)
+insert(c, 1, s, {5, 50})
+c.sock:close()
+while not disconnected do fiber.sleep(0.01) end
+box.session.on_disconnect(nil, trigger)
+s:select()
+-- Memtx aborts a transaction on yield, and a stream yields
+-- while waiting for the next request.
+m = box.schema.space.create('test_memtx')
+_ = m:create_index('pk')
+c = connect()
+begin(c, 1)
+insert(c, 1, m, {1})
+commit(c, 1)
+m:select()
+-- Streams count against net_msg_max: a network thread may
+-- have at most net_msg_max / 2 streams.
+net_msg_max = box.cfg.net_msg_max
+box.cfg{net_msg_max = 20}
+n = 0
+for i = 1, 10 do if begin(c, i) == true then n = n + 1 end end
+n
+begin(c, 11)
+rollback(c, 1)
+begin(c, 11)
+for i = 2, 11 do rollback(c, i) end
+box.cfg{net_msg_max = net_msg_max}
+c.sock:close()
+m:drop()
+s:drop()
+box.schema.user.revoke('guest', 'read,write,execute', 'universe')
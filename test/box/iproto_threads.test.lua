@@ -0,0 +1,100 @@
+test_run = require('test_run').new()
+net_box = require('net.box')
+fiber = require('fiber')
+
+--
+-- Connections are served by several network threads.
+--
+test_run:cmd('create server iproto_threads with script = "box/lua/iproto_threads.lua"')
+test_run:cmd('start server iproto_threads')
+test_run:cmd('switch iproto_threads')
+box.cfg.iproto_threads
+box.cfg{iproto_threads = 2}
+s = box.schema.space.create('test')
+_ = s:create_index('pk')
+test_run:cmd('switch default')
+
+uri = test_run:eval('iproto_threads', 'return box.cfg.listen')[1]
+conns = {}
+for i = 1, 16 do conns[i] = net_box.connect(uri) end
+ch = fiber.channel(16)
+test_run:cmd("setopt delimiter ';'")
+for i = 1, 16 do
+    fiber.create(function()
+        local c = conns[i]
+        for j = 1, 100 do
+            c.space.test:insert{i * 1000 + j}
+        end
+        ch:put(true)
+    end)
+end;
+test_run:cmd("setopt delimiter ''");
+for i = 1, 16 do ch:get() end
+conns[1].space.test:count()
+conns[16]:ping()
+for i = 1, 16 do conns[i]:close() end
+
+--
+-- A TCP socket is bound in each thread with SO_REUSEPORT,
+-- and the kernel spreads connections among the threads.
+--
+test_run:cmd('switch iproto_threads')
+socket = require('socket')
+sock = socket('AF_INET', 'SOCK_STREAM', 'tcp')
+sock:bind('127.0.0.1', 0)
+port = sock:name().port
+sock:close()
+listen = box.cfg.listen
+box.cfg{listen = '127.0.0.1:' .. port}
+function thread_received() local r = {} for i, t in ipairs(box.stat.net.thread()) do r[i] = t.RECEIVED.total end return r end
+received = thread_received()
+#received
+test_run:cmd('switch default')
+uri = '127.0.0.1:' .. test_run:eval('iproto_threads', 'return port')[1]
+for i = 1, 100 do conns[i] = net_box.connect(uri) end
+ok = true
+for i = 1, 100 do ok = ok and conns[i]:ping() end
+ok
+test_run:cmd('switch iproto_threads')
+new_received = thread_received()
+idle = 0
+for i = 1, #received do if new_received[i] == received[i] then idle = idle + 1 end end
+idle
+test_run:cmd('switch default')
+for i = 1, 100 do conns[i]:close() end
+
+--
+-- SO_REUSEPORT doesn't let an instance listen on an address
+-- taken by somebody else, even with SO_REUSEPORT.
+--
+test_run:cmd('switch iproto_threads')
+sock = socket('AF_INET', 'SOCK_STREAM', 'tcp')
+sock:setsockopt('SOL_SOCKET', 'SO_REUSEPORT', true)
+sock:bind('127.0.0.1', 0)
+sock:listen(128)
+busy_port = sock:name().port
+ok = pcall(box.cfg, {listen = '127.0.0.1:' .. busy_port})
+ok
+sock:close()
+test_run:cmd('switch default')
+
+--
+-- A unix socket in the abstract namespace.
+--
+test_run:cmd('switch iproto_threads')
+box.cfg{listen = 'unix/:@tarantool-iproto-threads'}
+test_run:cmd('switch default')
+c = net_box.connect('unix/:@tarantool-iproto-threads')
+c:ping()
+c:close()
+test_run:cmd('switch iproto_threads')
+box.cfg{listen = listen}
+test_run:cmd('switch default')
+
+test_run:cmd('switch iproto_threads')
+box.stat.net().SENT.total > 0
+box.stat.net().RECEIVED.total > 0
+box.space.test:drop()
+test_run:cmd('switch default')
+test_run:cmd('stop server iproto_threads')
+test_run:cmd('cleanup server iproto_threads')
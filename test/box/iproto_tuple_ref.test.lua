@@ -0,0 +1,60 @@
+test_run = require('test_run').new()
+net_box = require('net.box')
+
+--
+-- Big tuples of a SELECT result are sent to the client right
+-- from the tuple memory, small ones are copied to the output
+-- buffer.
+--
+box.schema.user.grant('guest', 'read,write,execute', 'universe')
+s = box.schema.space.create('test')
+_ = s:create_index('pk')
+c = net_box.connect(box.cfg.listen)
+
+test_run:cmd("setopt delimiter ';'")
+function fill(count, big, small)
+    for i = 1, count do
+        local len = i % 3 == 0 and small or big
+        s:replace{i, string.rep(tostring(i % 10), len)}
+    end
+end;
+function equal(res, expected)
+    if #res ~= #expected then
+        return false
+    end
+    for i = 1, #res do
+        if res[i][1] ~= expected[i][1] or res[i][2] ~= expected[i][2] then
+            return false
+        end
+    end
+    return true
+end;
+function check(key, opts)
+    return equal(c.space.test:select(key, opts), s:select(key, opts))
+end;
+test_run:cmd("setopt delimiter ''");
+
+fill(100, 10000, 10)
+check()
+check({}, {limit = 10})
+check({3})
+check({4})
+check({50}, {iterator = 'GE', limit = 20})
+
+-- The output is not corrupted when the tuples are replaced
+-- or deleted right after the select.
+expected = s:select()
+res = c.space.test:select()
+fill(100, 20000, 20)
+equal(res, expected)
+check()
+s:truncate()
+check()
+
+-- More big tuples than can be referenced in one output buffer.
+fill(5000, 600, 6)
+check({}, {limit = 5000})
+
+c:close()
+s:drop()
+box.schema.user.revoke('guest', 'read,write,execute', 'universe')
@@ -0,0 +1,59 @@
+test_run = require('test_run').new()
+net_box = require('net.box')
+fiber = require('fiber')
+--
+-- connect_pool() opens several connections to a peer and sends
+-- each request over the one having the least requests in flight.
+--
+box.schema.user.grant('guest', 'read,write,execute', 'universe')
+s = box.schema.space.create('test')
+_ = s:create_index('pk')
+net_box.connect_pool(box.cfg.listen, {size = 0})
+p = net_box.connect_pool(box.cfg.listen, {size = 3})
+p:is_connected()
+#p._connections
+p:ping()
+p.space.test:insert{1, 'a'}
+p.space.test:select()
+p.space.test.index.pk:get{1}
+p:call('string.rep', {'x', 3})
+p:eval('return 1 + 1')
+-- Requests in flight are spread over all connections.
+cond = fiber.cond()
+sessions = {}
+test_run:cmd("setopt delimiter ';'")
+function block()
+    sessions[box.session.id()] = true
+    cond:wait()
+    return true
+end;
+function session_count()
+    local count = 0
+    for _ in pairs(sessions) do count = count + 1 end
+    return count
+end;
+test_run:cmd("setopt delimiter ''");
+futures = {}
+for i = 1, 3 do futures[i] = p:call('block', {}, {is_async = true}) end
+while session_count() < 3 do fiber.sleep(0.01) end
+session_count()
+cond:broadcast()
+futures[1]:wait_result()
+futures[3]:wait_result()
+-- The schema is fetched by the first connection only and shared.
+p._connections[2].space == nil
+s2 = box.schema.space.create('test2')
+_ = s2:create_index('pk')
+-- A newer schema version seen by any connection makes the first
+-- one reload the schema.
+future = p:call('block', {}, {is_async = true})
+p:eval('return 1 + 1')
+p.space.test2:replace{1}
+cond:broadcast()
+future:wait_result()
+s2:select()
+p:close()
+p:is_connected()
+s2:drop()
+s:drop()
+box.schema.user.revoke('guest', 'read,write,execute', 'universe')
@@ -0,0 +1,39 @@
+net_box = require('net.box')
+msgpack = require('msgpack')
+--
+-- With raw = true a request returns IPROTO_DATA of the response
+-- as a MessagePack string, without decoding it into Lua tables
+-- and tuples.
+--
+box.schema.user.grant('guest', 'read,write,execute', 'universe')
+s = box.schema.space.create('test')
+_ = s:create_index('pk')
+c = net_box.connect(box.cfg.listen)
+raw = c.space.test:insert({1, 'a'}, {raw = true})
+type(raw)
+raw == msgpack.encode({{1, 'a'}})
+c.space.test:replace({2, 'b'}, {raw = true}) == msgpack.encode({{2, 'b'}})
+c.space.test:select({}, {raw = true}) == msgpack.encode({{1, 'a'}, {2, 'b'}})
+c.space.test:select({3}, {raw = true}) == msgpack.encode({})
+c:call('string.rep', {'x', 3}, {raw = true}) == msgpack.encode({'xxx'})
+c:eval('return 1, 2, 3', {}, {raw = true}) == msgpack.encode({1, 2, 3})
+-- Async requests.
+f = c:call('string.rep', {'y', 2}, {is_async = true, raw = true})
+f:wait_result() == msgpack.encode({'yy'})
+-- Pushes are returned raw too.
+function do_pushes() box.session.push(1) box.session.push(2) return 3 end
+pushes = {}
+c:call('do_pushes', {}, {raw = true, on_push = table.insert, on_push_ctx = pushes}) == msgpack.encode({3})
+#pushes
+pushes[1] == msgpack.encode({1})
+pushes[2] == msgpack.encode({2})
+-- Errors are not affected.
+c:call('box.error', {box.error.PROC_LUA, 'raw error'}, {raw = true})
+-- Methods which post-process the result don't support raw.
+ok, err = pcall(c.space.test.index.pk.get, c.space.test.index.pk, {1}, {raw = true})
+ok, err:match("doesn't support `raw` argument") ~= nil
+ok, err = pcall(c.space.test.select, c.space.test, {}, {raw = true, buffer = require('buffer').IBUF_SHARED})
+ok, err:match('mutually exclusive') ~= nil
+c:close()
+s:drop()
+box.schema.user.revoke('guest', 'read,write,execute', 'universe')
@@ -18,6 +18,8 @@ cn.space.tweedledum:select() --small request
 
 box.stat.net.SENT.total > 0
 box.stat.net.RECEIVED.total > 0
+box.stat.net.WRITES.total > 0
+box.stat.net.RESPONSES.total > 0
 -- box.stat.net.EVENTS.total > 0
 -- box.stat.net.LOCKS.total > 0
 
@@ -25,6 +27,15 @@ box.stat.net.RECEIVED.total > 0
 box.stat.reset()
 box.stat.net.SENT.total
 box.stat.net.RECEIVED.total
+box.stat.net.WRITES.total
+box.stat.net.RESPONSES.total
+
+-- Replies to pipelined requests are coalesced.
+futures = {}
+for i = 1, 100 do futures[i] = cn:call('tostring', {i}, {is_async = true}) end
+for i = 1, 100 do futures[i]:wait_result() end
+box.stat.net.RESPONSES.total >= 100
+box.stat.net.WRITES.total < box.stat.net.RESPONSES.total
 
 space:drop()
 cn:close()
@@ -201,6 +201,54 @@ future4:wait_result()
 cn:close()
 box.sql.execute('drop table test')
 
+--
+-- Prepared statements.
+--
+cn = remote.connect(box.cfg.listen)
+cn:execute('create table test (id integer primary key, a integer)')
+insert_id = cn:prepare('insert into test values (?, ?)')
+select_id = cn:prepare('select * from test where id = ?')
+type(insert_id)
+insert_id ~= select_id
+-- The same statement gets the same id.
+cn:prepare('insert into test values (?, ?)') == insert_id
+cn:execute(insert_id, {1, 1})
+cn:execute(insert_id, {2, 2})
+cn:execute(select_id, {2})
+cn:execute(select_id, {3})
+-- Bind errors do not break the statement.
+cn:execute(select_id, {{[':x'] = 1}})
+cn:execute(select_id, {1})
+-- Statements are recompiled after schema change.
+cn:execute('drop table test')
+cn:execute(select_id, {1})
+cn:execute('create table test (id integer primary key, a integer)')
+cn:execute(insert_id, {3, 3})
+cn:execute(select_id, {3})
+-- Compilation errors.
+cn:prepare('selec 1')
+cn:prepare('select * from not_existing_table')
+-- Statements are local to a session.
+cn2 = remote.connect(box.cfg.listen)
+_, err = pcall(cn2.execute, cn2, select_id, {3})
+err.code == box.error.SQL_NO_SUCH_STATEMENT
+cn2:close()
+-- Unprepare.
+cn:unprepare(select_id)
+_, err = pcall(cn.execute, cn, select_id, {3})
+err.code == box.error.SQL_NO_SUCH_STATEMENT
+_, err = pcall(cn.unprepare, cn, select_id)
+err.code == box.error.SQL_NO_SUCH_STATEMENT
+-- The number of prepared statements is limited.
+ok, err = true, nil
+for i = 1, 1100 do ok, err = pcall(cn.prepare, cn, 'select ' .. i) if not ok then break end end
+ok
+err.code == box.error.SQL_STMT_LIMIT
+cn:unprepare(insert_id)
+type(cn:prepare('select 0'))
+cn:close()
+box.sql.execute('drop table test')
+
 box.schema.user.revoke('guest', 'read,write,execute', 'universe')
 space = nil
 
@@ -62,7 +62,7 @@ test_invalid()
 int
 main(void)
 {
-	plan(63);
+	plan(64);
 
 	/* General */
 	test("host", NULL, NULL, NULL, "host", NULL, NULL, NULL, NULL, 0);
@@ -215,6 +215,9 @@ main(void)
 	     "./relative/path.sock", "/test", NULL, NULL, 3);
 	test("scheme://unix/:./relative/path.sock:/test", "scheme", NULL, NULL,
 	     "unix/", "./relative/path.sock", "/test", NULL, NULL, 3);
+	/* Abstract namespace */
+	test("unix/:@tarantool", NULL, NULL, NULL, "unix/", "@tarantool",
+	     NULL, NULL, NULL, 3);
 
 	/* Web */
 	test("http://tarantool.org/dist/master/debian/pool/main/t/tarantool/"
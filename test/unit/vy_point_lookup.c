@@ -16,13 +16,14 @@ uint32_t space_cache_version;
 
 static int
 write_run(struct vy_run *run, const char *dir_name,
-	  struct vy_lsm *lsm, struct vy_stmt_stream *wi)
+	  struct vy_lsm *lsm, struct vy_stmt_stream *wi,
+	  uint32_t restart_interval)
 {
 	struct vy_run_writer writer;
 	if (vy_run_writer_create(&writer, run, dir_name,
-				 lsm->space_id, lsm->index_id,
+				 lsm->space_id, lsm->index_id, true,
 				 lsm->cmp_def, lsm->key_def,
-				 4096, 0.1) != 0)
+				 4096, 0.1, restart_interval) != 0)
 		goto fail;
 
 	if (wi->iface->start(wi) != 0)
@@ -53,7 +54,7 @@ static void
 test_basic()
 {
 	header();
-	plan(15);
+	plan(16);
 
 	/** Suppress info messages from vy_run_writer. */
 	say_set_log_level(S_WARN);
@@ -192,12 +193,12 @@ test_basic()
 	}
 	struct vy_stmt_stream *write_stream
 		= vy_write_iterator_new(pk->cmp_def, pk->disk_format,
-					true, true, &read_views);
+					true, true, 0, &read_views, NULL);
 	vy_write_iterator_new_mem(write_stream, run_mem);
 	struct vy_run *run = vy_run_new(&run_env, 1);
 	isnt(run, NULL, "vy_run_new");
 
-	rc = write_run(run, dir_name, pk, write_stream);
+	rc = write_run(run, dir_name, pk, write_stream, 0);
 	is(rc, 0, "vy_run_write");
 
 	write_stream->iface->close(write_stream);
@@ -225,12 +226,14 @@ test_basic()
 	}
 	write_stream
 		= vy_write_iterator_new(pk->cmp_def, pk->disk_format,
-					true, true, &read_views);
+					true, true, 0, &read_views, NULL);
 	vy_write_iterator_new_mem(write_stream, run_mem);
 	run = vy_run_new(&run_env, 2);
 	isnt(run, NULL, "vy_run_new");
 
-	rc = write_run(run, dir_name, pk, write_stream);
+	/* Use prefix compression for the second run. */
+	rc = write_run(run, dir_name, pk, write_stream,
+		       VY_PAGE_RESTART_INTERVAL);
 	is(rc, 0, "vy_run_write");
 
 	write_stream->iface->close(write_stream);
@@ -302,6 +305,42 @@ test_basic()
 	is(results_ok, true, "select results");
 	is(has_errors, false, "no errors happened");
 
+	/* Look up all keys in one batch */
+	struct tuple *keys[num_of_keys];
+	struct tuple *batch_res[num_of_keys];
+	for (size_t i = 0; i < num_of_keys; i++) {
+		struct vy_stmt_template tmpl_key =
+			STMT_TEMPLATE(0, SELECT, i);
+		keys[i] = vy_new_simple_stmt(format,
+				pk->mem_format_with_colmask, &tmpl_key);
+	}
+	struct vy_read_view batch_rv;
+	batch_rv.vlsn = INT64_MAX;
+	const struct vy_read_view *batch_prv = &batch_rv;
+	rc = vy_point_lookup_batch(pk, NULL, &batch_prv, keys,
+				   num_of_keys, batch_res);
+	results_ok = rc == 0;
+	for (size_t i = 0; i < num_of_keys; i++) {
+		tuple_unref(keys[i]);
+		if (rc != 0)
+			continue;
+		if (expect[i] == 0) {
+			if (batch_res[i] != NULL)
+				results_ok = false;
+			continue;
+		}
+		if (batch_res[i] == NULL) {
+			results_ok = false;
+			continue;
+		}
+		uint32_t got = 0;
+		tuple_field_u32(batch_res[i], 1, &got);
+		if (got != expect[i])
+			results_ok = false;
+		tuple_unref(batch_res[i]);
+	}
+	is(results_ok, true, "batch select results");
+
 	vy_lsm_unref(pk);
 	index_def_delete(index_def);
 	tuple_format_unref(format);
@@ -39,7 +39,8 @@ compare_write_iterator_results(const struct vy_stmt_template *content,
 	init_read_views_list(&rv_list, rv_array, vlsns, vlsns_count);
 
 	struct vy_stmt_stream *wi = vy_write_iterator_new(key_def, mem->format,
-					is_primary, is_last_level, &rv_list);
+					is_primary, is_last_level, 0,
+					&rv_list, NULL);
 	fail_if(wi == NULL);
 	fail_if(vy_write_iterator_new_mem(wi, mem) != 0);
 
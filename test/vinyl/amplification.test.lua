@@ -0,0 +1,71 @@
+test_run = require('test_run').new()
+fiber = require('fiber')
+
+-- Disable the cache so that all lookups go to disk.
+vinyl_cache = box.cfg.vinyl_cache
+box.cfg{vinyl_cache = 0}
+
+s = box.schema.space.create('test', {engine = 'vinyl'})
+_ = s:create_index('pk', {run_count_per_level = 10, bloom_fpr = 1})
+
+s:replace{1}
+box.snapshot()
+s:replace{2}
+box.snapshot()
+s:replace{3}
+box.snapshot()
+s.index.pk:stat().run_count -- 3
+
+--
+-- Read amplification.
+--
+s:get{1} -- all runs
+s:get{3} -- newest run
+st = s.index.pk:stat()
+st.amplification.read_histogram -- [1]:1 [3]:1
+st.amplification.read -- 2
+st.latency.disk.p99 >= 0
+st.latency.memory.p99 >= 0
+
+s:replace{4}
+s:get{4} -- memory
+s.index.pk:stat().amplification.read_histogram -- [0]:1 [1]:1 [3]:1
+
+--
+-- Write amplification.
+--
+st = s.index.pk:stat()
+st.amplification.write -- 1
+st.latency.dump.p99 >= 0
+s.index.pk:compact()
+while s.index.pk:stat().disk.compact.count == 0 do fiber.sleep(0.01) end
+st = s.index.pk:stat()
+st.amplification.write > 1
+st.latency.compact.p99 >= 0
+
+box.stat.reset()
+st = s.index.pk:stat()
+st.amplification.read_histogram -- empty
+st.amplification.read -- 0
+st.amplification.write -- 0
+
+s:drop()
+
+--
+-- Runs filtered out by the bloom filter are counted neither in
+-- read amplification nor in its histogram.
+--
+s = box.schema.space.create('test', {engine = 'vinyl'})
+_ = s:create_index('pk', {run_count_per_level = 10, bloom_fpr = 0.01})
+s:replace{1}
+box.snapshot()
+s:replace{2}
+box.snapshot()
+s:get{1} -- oldest run, the newest one is filtered out
+st = s.index.pk:stat()
+st.amplification.read_histogram -- [1]:1
+st.amplification.read -- 1
+st.disk.iterator.bloom.hit -- 1
+s:drop()
+
+box.cfg{vinyl_cache = vinyl_cache}
@@ -0,0 +1,80 @@
+test_run = require('test_run').new()
+
+s = box.schema.space.create('test', {engine = 'vinyl'})
+_ = s:create_index('pk')
+
+-- Tuples added later replace earlier ones with the same key.
+s:bulk_load({{3, 'c'}, {1, 'a'}, {2, 'b'}, {1, 'aa'}})
+s:select()
+s.index.pk:stat().run_count
+s.index.pk:stat().memory.rows
+s:replace{2, 'bb'}
+s:select()
+
+-- Only an empty space can be loaded.
+s:bulk_load({{4, 'd'}})
+s:truncate()
+
+-- Check tuples against the space format.
+s:bulk_load({{'x'}})
+s:count()
+
+-- Load more tuples than fit in a batch so that
+-- sorted runs have to be merged.
+pad = string.rep('x', 100)
+i = 2000
+function gen() if i == 0 then return nil end i = i - 1 return {i, pad} end
+s:bulk_load(gen)
+s:count()
+s.index.pk:stat().run_count
+s:get{0}[1]
+s:get{1999}[1]
+#s:select({}, {limit = 10})
+
+-- Merged runs are cut so that each range gets one run.
+s2 = box.schema.space.create('test2', {engine = 'vinyl'})
+_ = s2:create_index('pk', {range_size = 65536, page_size = 4096})
+i = 2000
+s2:bulk_load(gen)
+s2:count()
+s2.index.pk:stat().range_count > 1
+s2.index.pk:stat().run_count == s2.index.pk:stat().range_count
+s2:get{1000}[1]
+s2:drop()
+
+test_run:cmd('restart server default')
+
+s = box.space.test
+s:count()
+s:get{1000}[1]
+s.index.pk:stat().run_count
+
+-- Secondary indexes are not supported.
+s:truncate()
+_ = s:create_index('sk', {parts = {2, 'string'}})
+s:bulk_load({{1, 'a'}})
+s:drop()
+
+-- Only vinyl spaces are supported.
+s = box.schema.space.create('test', {engine = 'memtx'})
+_ = s:create_index('pk')
+s:bulk_load({{1}})
+s:drop()
+
+-- Transactions that have read the space are aborted.
+txn_proxy = require('txn_proxy')
+s = box.schema.space.create('test', {engine = 'vinyl'})
+_ = s:create_index('pk')
+c1 = txn_proxy.new()
+c2 = txn_proxy.new()
+c1:begin()
+c1("s:select()")
+c2:begin()
+c2("s:get{1}")
+s:bulk_load({{1}, {2}})
+c1("s:select()")
+c1:rollback()
+c2("s:replace{3}")
+c2:commit()
+s:select()
+s:drop()
@@ -380,3 +380,74 @@ st2.put.rows - st1.put.rows
 box.stat.vinyl().cache.used
 s:drop()
 box.cfg{vinyl_cache = vinyl_cache}
+
+--
+-- A full scan must not flush tuples that are read often.
+--
+box.cfg{vinyl_cache = 100 * 1000}
+s = box.schema.space.create('test', {engine = 'vinyl'})
+_ = s:create_index('pk')
+for i = 1, 200 do s:replace{i, string.rep('x', 1000)} end
+-- Read hot tuples twice to protect them.
+for i = 1, 10 do s:get{i} end
+for i = 1, 10 do s:get{i} end
+#s:select()
+st1 = s.index.pk:stat().cache
+st1.evict.rows > 0
+for i = 1, 10 do s:get{i} end
+st2 = s.index.pk:stat().cache
+st2.get.rows - st1.get.rows
+s:drop()
+box.cfg{vinyl_cache = vinyl_cache}
+
+--
+-- Per index cache reservation and limit.
+--
+s = box.schema.space.create('test', {engine = 'vinyl'})
+s:create_index('pk', {cache_limit = -1})
+s:create_index('pk', {cache_reserve = 2000, cache_limit = 1000})
+s:drop()
+box.cfg{vinyl_cache = 50 * 1000}
+s1 = box.schema.space.create('test1', {engine = 'vinyl'})
+_ = s1:create_index('pk', {cache_reserve = 20 * 1000})
+s2 = box.schema.space.create('test2', {engine = 'vinyl'})
+_ = s2:create_index('pk', {cache_limit = 10 * 1000})
+s3 = box.schema.space.create('test3', {engine = 'vinyl'})
+_ = s3:create_index('pk')
+pad = string.rep('x', 1000)
+for i = 1, 100 do s1:replace{i, pad} s2:replace{i, pad} s3:replace{i, pad} end
+for i = 1, 10 do s1:get{i} end
+-- The cache of an index with a limit doesn't grow beyond it.
+for i = 1, 100 do s2:get{i} end
+st = s2.index.pk:stat().cache
+st.limit
+st.rows
+st.evict.rows
+-- Reserved entries are not evicted.
+for i = 1, 100 do s3:get{i} end
+s3.index.pk:stat().cache.evict.rows > 0
+st = s1.index.pk:stat().cache
+st.reserve
+st.rows
+st.evict.rows
+s1:drop()
+s2:drop()
+s3:drop()
+box.cfg{vinyl_cache = vinyl_cache}
+-- An index with a limit evicts its own oldest entries even if
+-- they are far from the tail of the global LRU list.
+box.cfg{vinyl_cache = 1000 * 1000}
+s1 = box.schema.space.create('test1', {engine = 'vinyl'})
+_ = s1:create_index('pk', {cache_limit = 10 * 1000})
+s2 = box.schema.space.create('test2', {engine = 'vinyl'})
+_ = s2:create_index('pk')
+for i = 1, 100 do s1:replace{i, pad} s2:replace{i, pad} end
+for i = 1, 100 do s2:get{i} end
+for i = 1, 100 do s1:get{i} end
+st = s1.index.pk:stat().cache
+st.rows > 0
+st.evict.rows > 0
+s2.index.pk:stat().cache.evict.rows
+s1:drop()
+s2:drop()
+box.cfg{vinyl_cache = vinyl_cache}
@@ -332,6 +332,74 @@ box.space.test.index.sk:count()
 box.space.test.index.sk:drop()
 box.snapshot()
 
+--
+-- Check that a non-unique secondary index is built by writing
+-- runs directly to disk, bypassing the memory level, and that
+-- the runs are merged so that each range gets exactly one run.
+--
+_ = box.space.test:create_index('sk', {unique = false, parts = {2, 'unsigned'}, range_size = 4096, page_size = 1024})
+box.space.test.index.sk:stat().disk.dump.count
+box.space.test.index.sk:stat().disk.compact.count
+box.space.test.index.sk:stat().range_count > 1
+box.space.test.index.sk:stat().run_count == box.space.test.index.sk:stat().range_count
+box.space.test.index.sk:count()
+
+test_run:cmd("restart server test with args='1048576'")
+
+box.space.test.index.sk:count()
+box.space.test.index.sk:drop()
+box.snapshot()
+
+--
+-- Check that inserts and deletes done concurrently with building
+-- a non-unique secondary index on disk are reflected in it.
+--
+fiber = require('fiber')
+s = box.schema.space.create('test2', {engine = 'vinyl'})
+_ = s:create_index('pk')
+pad = string.rep('x', 1000)
+test_run:cmd("setopt delimiter ';'")
+box.begin();
+for i = 1, 1000 do
+    if (i % 100 == 0) then
+        box.commit()
+        box.begin()
+    end
+    s:replace{i, i, pad}
+end;
+box.commit();
+function gen_load()
+    for i = 1, 100 do
+        s:insert{1000 + i, math.random(2000), pad}
+        s:delete{math.random(1000)}
+    end
+end;
+function check_sk()
+    local sk = {}
+    local sk_count = 0
+    for _, t in s.index.sk:pairs() do
+        sk[t[1]] = t[2]
+        sk_count = sk_count + 1
+    end
+    local pk_count = 0
+    for _, t in s.index.pk:pairs() do
+        if sk[t[1]] ~= t[2] then
+            return false
+        end
+        pk_count = pk_count + 1
+    end
+    return pk_count == sk_count
+end;
+test_run:cmd("setopt delimiter ''");
+ch = fiber.channel(1)
+_ = fiber.create(function() gen_load() ch:put(true) end)
+_ = s:create_index('sk', {unique = false, parts = {2, 'unsigned'}})
+ch:get()
+check_sk()
+box.snapshot()
+check_sk()
+s:drop()
+
 --
 -- Check that run files left from an index we failed to build
 -- are removed by garbage collection.
@@ -0,0 +1,121 @@
+test_run = require('test_run').new()
+fiber = require('fiber')
+
+--
+-- REPLACE and DELETE by the primary key in a space with
+-- defer_deletes don't look up old tuples. Secondary index
+-- entries of overwritten tuples are deleted when the primary
+-- index is compacted.
+--
+s = box.schema.space.create('test', {engine = 'vinyl', defer_deletes = true})
+pk = s:create_index('pk', {run_count_per_level = 10})
+sk = s:create_index('sk', {unique = false, parts = {2, 'unsigned'}})
+for i = 1, 10 do s:replace{i, i} end
+box.snapshot()
+for i = 1, 10, 2 do s:replace{i, i * 10} end
+for i = 2, 10, 2 do s:delete{i} end
+pk:stat().lookup -- 0
+
+-- Stale secondary index entries are skipped on read.
+sk:select()
+sk:select{1}
+sk:select{2}
+
+box.snapshot()
+sk:stat().memory.rows -- 0
+sk:stat().disk.rows -- 15
+test_run:cmd("setopt delimiter ';'")
+function compact(index)
+    index:compact()
+    repeat
+        fiber.sleep(0.001)
+        local info = index:stat()
+    until info.range_count == info.run_count
+end;
+test_run:cmd("setopt delimiter ''");
+compact(pk)
+
+-- DELETEs of overwritten tuples were written to a new run of
+-- the secondary index. Reads ignore them.
+sk:stat().memory.rows -- 0
+sk:stat().run_count -- 3
+sk:stat().disk.rows -- 25
+sk:select()
+
+-- The DELETEs survive restart.
+test_run:cmd('restart server default')
+fiber = require('fiber')
+s = box.space.test
+pk = s.index.pk
+sk = s.index.sk
+sk:stat().run_count -- 3
+sk:stat().disk.rows -- 25
+sk:select()
+
+-- Compaction of the secondary index purges stale entries.
+test_run:cmd("setopt delimiter ';'")
+function compact(index)
+    index:compact()
+    repeat
+        fiber.sleep(0.001)
+        local info = index:stat()
+    until info.range_count == info.run_count
+end;
+test_run:cmd("setopt delimiter ''");
+compact(sk)
+sk:stat().disk.rows -- 5
+sk:select()
+
+-- Unique secondary indexes need the old tuple.
+uk = s:create_index('uk', {parts = {2, 'unsigned'}})
+lookup = pk:stat().lookup
+s:replace{1, 100}
+pk:stat().lookup - lookup -- 1
+uk:select{10}
+uk:get{100}
+uk:drop()
+
+-- defer_deletes can't be disabled for a non-empty space.
+_ = box.space._space:update(s.id, {{'=', 6, {}}})
+s:truncate()
+_ = box.space._space:update(s.id, {{'=', 6, {}}})
+s:drop()
+
+--
+-- A covering secondary index stores full tuples.
+--
+s = box.schema.space.create('test', {engine = 'vinyl'})
+pk = s:create_index('pk')
+sk = s:create_index('sk', {parts = {2, 'unsigned'}, covering = true})
+for i = 1, 5 do s:replace{i, i * 10, string.rep('x', i)} end
+box.snapshot()
+lookup = pk:stat().lookup
+sk:select()
+sk:get{30}
+pk:stat().lookup - lookup -- 0
+s:drop()
+
+--
+-- Check that a deferred DELETE doesn't shadow a newer statement
+-- with the same secondary key that has already been dumped to
+-- disk, neither on read nor on compaction.
+--
+s = box.schema.space.create('test', {engine = 'vinyl', defer_deletes = true})
+pk = s:create_index('pk', {run_count_per_level = 10})
+sk = s:create_index('sk', {unique = false, parts = {2, 'unsigned'}})
+s:replace{1, 10}
+box.snapshot()
+s:replace{1, 20}
+box.snapshot()
+s:replace{1, 10}
+box.snapshot()
+compact(pk)
+sk:stat().memory.rows -- 0
+sk:stat().disk.rows -- 5
+sk:select()
+sk:select{20}
+compact(sk)
+sk:stat().disk.rows -- 1
+sk:select()
+sk:select{20}
+s:drop()
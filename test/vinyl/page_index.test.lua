@@ -0,0 +1,45 @@
+test_run = require('test_run').new()
+
+--
+-- Check that the page index of a run is loaded lazily
+-- after recovery.
+--
+s = box.schema.space.create('test', {engine = 'vinyl'})
+_ = s:create_index('pk', {page_size = 128, range_size = 1024 * 1024})
+for i = 1, 1000 do s:replace{i, string.rep('x', 32)} end
+box.snapshot()
+stat = s.index.pk:stat()
+pages = stat.disk.pages
+pages > 1
+index_size = stat.disk.index_size
+index_size > 0
+disk = stat.disk.bytes
+rows = stat.disk.rows
+
+test_run:cmd('restart server default')
+
+s = box.space.test
+stat = s.index.pk:stat()
+-- Run statistics are restored without loading the page index.
+stat.disk.pages == pages
+stat.disk.index_size == index_size
+stat.disk.bytes == disk
+stat.disk.rows == rows
+
+s:get{1}
+s:get{500}
+s:get{1000}
+s:get{1001}
+s:count()
+s:select({995}, {iterator = 'GE'})
+s:select({5}, {iterator = 'LE'})
+
+-- Compaction of a recovered run.
+for i = 1, 1000, 2 do s:delete{i} end
+box.snapshot()
+s.index.pk:compact()
+while s.index.pk:stat().disk.compact.count == 0 do require('fiber').sleep(0.01) end
+s:count()
+s:select({995}, {iterator = 'GE'})
+
+s:drop()
@@ -0,0 +1,34 @@
+--
+-- Run pages written with prefix compression store statements
+-- with common prefixes of adjacent statements elided.
+--
+fiber = require('fiber')
+s1 = box.schema.space.create('test1', {engine = 'vinyl'})
+_ = s1:create_index('pk', {parts = {1, 'string'}, prefix_compression = true})
+s2 = box.schema.space.create('test2', {engine = 'vinyl'})
+_ = s2:create_index('pk', {parts = {1, 'string'}})
+for i = 1, 100 do local k = string.format('key-prefix-%03d', i) s1:insert{k, i} s2:insert{k, i} end
+box.snapshot()
+
+s1.index.pk:stat().disk.rows -- 100
+s1.index.pk:stat().disk.bytes < s2.index.pk:stat().disk.bytes -- true
+
+s1:get{'key-prefix-050'}
+s1:get{'key-prefix-101'}
+s1:select({'key-prefix-095'}, {iterator = 'GE'})
+s1:select({'key-prefix-005'}, {iterator = 'LT'})
+s1:select({'key-prefix-033'}, {iterator = 'GT', limit = 3})
+s1:select({'key-prefix-017'}, {iterator = 'LE', limit = 3})
+#s1:select()
+
+-- Compaction reads and writes prefix compressed pages.
+for i = 1, 100, 2 do s1:replace{string.format('key-prefix-%03d', i), -i} end
+box.snapshot()
+s1.index.pk:compact()
+while s1.index.pk:stat().disk.compact.count == 0 do fiber.sleep(0.01) end
+s1.index.pk:stat().run_count -- 1
+s1:select({'key-prefix-010'}, {iterator = 'LE', limit = 4})
+s1.index.pk:stat().disk.rows -- 100
+
+s1:drop()
+s2:drop()
@@ -0,0 +1,35 @@
+test_run = require('test_run').new()
+fiber = require('fiber')
+fio = require('fio')
+
+-- Negative rate is not allowed.
+box.cfg{vinyl_scrub_rate = -1}
+box.cfg.vinyl_scrub_rate
+
+s = box.schema.space.create('test', {engine = 'vinyl'})
+_ = s:create_index('pk')
+for i = 1, 100 do s:insert{i, string.rep('x', 100)} end
+box.snapshot()
+
+-- Check that the scrubber verifies runs in background.
+box.stat.reset()
+box.cfg{vinyl_scrub_rate = 1000 * 1000 * 1000}
+while box.stat.vinyl().scrub.runs == 0 do fiber.sleep(0.01) end
+box.stat.vinyl().scrub.bytes > 0
+box.stat.vinyl().scrub.corrupted
+
+-- Corrupt the run file and check that the scrubber notices.
+path = fio.pathjoin(box.cfg.vinyl_dir, tostring(s.id), tostring(s.index.pk.id))
+files = fio.glob(fio.pathjoin(path, '*.run'))
+#files
+f = fio.open(files[1], {'O_WRONLY'})
+_ = f:seek(fio.stat(files[1]).size - 20)
+f:write(string.rep('x', 20))
+f:close()
+while box.stat.vinyl().scrub.corrupted == 0 do fiber.sleep(0.01) end
+
+-- Disable the scrubber.
+box.cfg{vinyl_scrub_rate = 0}
+box.cfg.vinyl_scrub_rate
+
+s:drop()
@@ -113,3 +113,55 @@ s:count() == key_count_left
 
 s:drop()
 var:drop()
+
+--
+-- A range with a high read load is split even though it is
+-- smaller than range_size.
+--
+fiber = require('fiber')
+vinyl_cache = box.cfg.vinyl_cache
+box.cfg{vinyl_cache = 0}
+
+s = box.schema.space.create('test', {engine='vinyl'})
+_ = s:create_index('primary', {unique=true, parts={1, 'unsigned'}, page_size=256, range_size=2048, run_count_per_level=1, run_size_ratio=1000})
+
+function vyinfo() return box.space.test.index.primary:stat() end
+
+range_count = 8
+tuple_size = math.ceil(s.index.primary.options.page_size / 4)
+pad_size = tuple_size - 30
+keys_per_range = math.floor(s.index.primary.options.range_size / tuple_size)
+key_count = range_count * keys_per_range
+
+test_run:cmd("setopt delimiter ';'")
+function gen_tuple(k)
+    local pad = {}
+    for i = 1,pad_size do
+        pad[i] = string.char(math.random(65, 90))
+    end
+    return {k, table.concat(pad)}
+end
+while vyinfo().range_count < range_count do
+    for k = key_count,1,-1 do s:replace(gen_tuple(k)) end
+    box.snapshot()
+    fiber.sleep(0.01)
+end;
+test_run:cmd("setopt delimiter ''");
+
+-- Read the first keys, which belong to the first range, until
+-- the range is split. Rewrite one of them to trigger compaction.
+range_count = vyinfo().range_count
+test_run:cmd("setopt delimiter ';'")
+while vyinfo().range_count == range_count do
+    for i = 1,1000 do s:get(i % 4 + 1) end
+    s:replace(gen_tuple(1))
+    box.snapshot()
+    fiber.sleep(0.01)
+end;
+test_run:cmd("setopt delimiter ''");
+
+vyinfo().range_count > range_count
+s:count() == key_count
+
+s:drop()
+box.cfg{vinyl_cache = vinyl_cache}
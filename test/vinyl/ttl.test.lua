@@ -0,0 +1,64 @@
+test_run = require('test_run').new()
+fiber = require('fiber')
+function keys(t) local r = {} for _, v in ipairs(t) do table.insert(r, v[1]) end return r end
+
+--
+-- Tuple expiration (space option ttl_field).
+--
+s = box.schema.space.create('test', {engine = 'vinyl', ttl_field = 2})
+pk = s:create_index('pk')
+-- Secondary indexes must store full tuples.
+s:create_index('sk', {parts = {3, 'unsigned'}})
+sk = s:create_index('sk', {parts = {3, 'unsigned'}, covering = true})
+
+now = math.floor(fiber.time())
+_ = s:replace{1, now - 100, 10}
+_ = s:replace{2, now + 1000, 20}
+_ = s:replace{3, now - 100, 30}
+_ = s:replace{4, 'never', 40}
+_ = s:replace{5, now + 1000, 50}
+
+-- Expired tuples are filtered out on read.
+s:get(1)
+s:get(3)
+keys(s:select())
+keys(s:select({}, {iterator = 'LE'}))
+keys(sk:select())
+sk:get(30)
+s:count()
+
+-- An expired key can be inserted again.
+_ = s:insert{1, now + 1000, 11}
+s:get(1)[3]
+
+-- A tuple expires while stored in memory.
+_ = s:replace{6, fiber.time() + 0.5, 60}
+s:get(6) ~= nil
+fiber.sleep(1)
+s:get(6)
+sk:get(60)
+
+-- The first dump writes the last level of the LSM tree,
+-- so expired tuples are not written to disk.
+box.snapshot()
+pk:stat().disk.rows
+sk:stat().disk.rows
+
+-- Dump above the last level keeps expired tuples.
+_ = s:replace{7, now - 100, 70}
+box.snapshot()
+pk:stat().disk.rows
+sk:stat().disk.rows
+keys(s:select())
+
+-- Compaction of the last level drops them.
+pk:compact()
+sk:compact()
+while pk:stat().disk.compact.count == 0 do fiber.sleep(0.01) end
+while sk:stat().disk.compact.count == 0 do fiber.sleep(0.01) end
+pk:stat().disk.rows
+sk:stat().disk.rows
+keys(s:select())
+keys(sk:select())
+
+s:drop()
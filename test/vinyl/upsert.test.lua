@@ -322,3 +322,31 @@ s:upsert({100}, {{'+', 2, 100}})
 s:select({100}, 'GE')
 
 s:drop()
+
+--
+-- Squash threshold and UPSERT chain statistics.
+--
+fiber = require('fiber')
+s = box.schema.space.create('test', {engine = 'vinyl'})
+s:create_index('pk', {upsert_threshold = 0})
+s:create_index('pk', {upsert_threshold = 129})
+pk = s:create_index('pk', {upsert_threshold = 4})
+s:insert{1, 0}
+box.snapshot()
+st = pk:stat()
+for i = 1, 4 do s:upsert({1, 0}, {{'+', 2, 1}}) end
+s:get(1)
+pk:stat().upsert.chain_histogram
+pk:stat().upsert.squashed - st.upsert.squashed
+-- the next UPSERT reaches the threshold and schedules squashing
+s:upsert({1, 0}, {{'+', 2, 1}})
+while pk:stat().upsert.squashed == st.upsert.squashed do fiber.sleep(0.01) end
+-- the squashed REPLACE is found in memory, no UPSERTs to apply;
+-- the squashing itself folded a chain of five UPSERTs
+st = pk:stat()
+s:get(1)
+pk:stat().upsert.applied - st.upsert.applied
+pk:stat().upsert.chain_histogram
+box.stat.reset()
+pk:stat().upsert.chain_histogram
+s:drop()